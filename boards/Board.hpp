@@ -9,6 +9,8 @@
 
 #include <systemc>
 #include "mcu/Microcontroller.hpp"
+#include "ps/PowerModelBridge.hpp"
+#include "ps/PowerModelChannel.hpp"
 
 /**
  * @brief Board base class for PCB-level models in Fused.
@@ -18,4 +20,8 @@ SC_MODULE(Board) {
   SC_CTOR(Board) {}
 
   virtual Microcontroller& getMicrocontroller() = 0;
+
+  virtual PowerModelBridge& getPowerModelBridge() = 0;
+
+  virtual PowerModelChannel& getPowerModelChannel() = 0;
 };
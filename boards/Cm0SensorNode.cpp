@@ -24,7 +24,9 @@ Cm0SensorNode::Cm0SensorNode(const sc_module_name name)
       powerModelChannel(
           "powerModelChannel", /*logfile=*/
           Config::get().getString("OutputDirectory"),
-          sc_time::from_seconds(Config::get().getDouble("LogTimestep"))) {
+          sc_time::from_seconds(Config::get().getDouble("LogTimestep")),
+          PowerModelChannel::parseLogFormat(
+              Config::get().getString("EventLogFormat"))) {
   /* ------ Bind ------ */
   // Reset
   resetCtrl.vcc.bind(vcc);
@@ -110,3 +112,11 @@ Cm0SensorNode::~Cm0SensorNode() {
 }
 
 Microcontroller &Cm0SensorNode::getMicrocontroller() { return mcu; }
+
+PowerModelBridge &Cm0SensorNode::getPowerModelBridge() {
+  return powerModelBridge;
+}
+
+PowerModelChannel &Cm0SensorNode::getPowerModelChannel() {
+  return powerModelChannel;
+}
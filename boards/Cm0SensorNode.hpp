@@ -57,6 +57,16 @@ class Cm0SensorNode : public Board {
    */
   virtual Microcontroller &getMicrocontroller() override;
 
+  /**
+   * @brief getPowerModelBridge get a reference to the power model bridge
+   */
+  virtual PowerModelBridge &getPowerModelBridge() override;
+
+  /**
+   * @brief getPowerModelChannel get a reference to the power model channel
+   */
+  virtual PowerModelChannel &getPowerModelChannel() override;
+
   /* ------ GPIO pin numbers ------ */
   struct GpioPinAssignment {
     static const int KEEP_ALIVE = 5;
@@ -24,7 +24,9 @@ Cm0TestBoard::Cm0TestBoard(const sc_module_name name)
       powerModelChannel(
           "powerModelChannel", /*logfile=*/
           Config::get().getString("OutputDirectory"),
-          sc_time::from_seconds(Config::get().getDouble("LogTimestep"))) {
+          sc_time::from_seconds(Config::get().getDouble("LogTimestep")),
+          PowerModelChannel::parseLogFormat(
+              Config::get().getString("EventLogFormat"))) {
   /* ------ Bind ------ */
   // Reset
   resetCtrl.vcc.bind(vcc);
@@ -99,3 +101,11 @@ Cm0TestBoard::~Cm0TestBoard() {
 }
 
 Microcontroller &Cm0TestBoard::getMicrocontroller() { return mcu; }
+
+PowerModelBridge &Cm0TestBoard::getPowerModelBridge() {
+  return powerModelBridge;
+}
+
+PowerModelChannel &Cm0TestBoard::getPowerModelChannel() {
+  return powerModelChannel;
+}
@@ -56,6 +56,16 @@ class Cm0TestBoard : public Board {
    */
   virtual Microcontroller &getMicrocontroller() override;
 
+  /**
+   * @brief getPowerModelBridge get a reference to the power model bridge
+   */
+  virtual PowerModelBridge &getPowerModelBridge() override;
+
+  /**
+   * @brief getPowerModelChannel get a reference to the power model channel
+   */
+  virtual PowerModelChannel &getPowerModelChannel() override;
+
   /* ------ Channels & signals ------ */
   PowerModelChannel powerModelChannel;
   sc_core::sc_signal<double> vcc{"vcc", 0.0};
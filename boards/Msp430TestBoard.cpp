@@ -19,7 +19,9 @@ Msp430TestBoard::Msp430TestBoard(const sc_module_name name)
       powerModelChannel(
           "powerModelChannel", /*logfile=*/
           Config::get().getString("OutputDirectory"),
-          sc_time::from_seconds(Config::get().getDouble("LogTimestep"))) {
+          sc_time::from_seconds(Config::get().getDouble("LogTimestep")),
+          PowerModelChannel::parseLogFormat(
+              Config::get().getString("EventLogFormat"))) {
   /* ------ Bind ------ */
   // Reset
   mcu.pmm->pwrGood.bind(nReset);
@@ -101,3 +103,11 @@ Msp430TestBoard::~Msp430TestBoard() {
 }
 
 Microcontroller &Msp430TestBoard::getMicrocontroller() { return mcu; }
+
+PowerModelBridge &Msp430TestBoard::getPowerModelBridge() {
+  return powerModelBridge;
+}
+
+PowerModelChannel &Msp430TestBoard::getPowerModelChannel() {
+  return powerModelChannel;
+}
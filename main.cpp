@@ -19,6 +19,7 @@
 #include <chrono>
 #include <cstdlib>
 #include <ihex-parser/IntelHexFile.hpp>
+#include <memory>
 #include <string>
 #include <systemc-ams>
 #include <systemc>
@@ -27,8 +28,12 @@
 #include "boards/Cm0SensorNode.hpp"
 #include "boards/Cm0TestBoard.hpp"
 #include "boards/Msp430TestBoard.hpp"
+#include "libs/make_unique.hpp"
+#include "utilities/Checkpoint.hpp"
 #include "utilities/Config.hpp"
+#include "utilities/Profiler.hpp"
 #include "utilities/SimulationController.hpp"
+#include "utilities/SweepRunner.hpp"
 
 #ifdef GDB_SERVER
 #include <gdb-server/GdbServer.hpp>
@@ -63,14 +68,20 @@ SC_MODULE(DummyModule){
 };
 // clang-format on
 
-int sc_main(int argc, char *argv[]) {
+//! Whether an optional path in the config is set
+bool isSet(const std::string &key) {
+  return Config::get().contains(key) && Config::get().getString(key) != "none";
+}
+
+/**
+ * @brief simulate instantiate the board and run a single simulation.
+ * @param programFile program to load, or nullptr when running the gdb server.
+ * @retval summary metrics of the simulation.
+ */
+SweepRunner::KeyValues simulate(IntelHexFile *programFile) {
   // sc_set_time_resolution(1, SC_NS);
   int rspPort = DEFAULT_RSP_PORT;
-
-  // Parse CLI arguments & config file
   auto &config = Config::get();
-  config.parseCli(argc, argv);
-  config.parseFile();
 
   // Instantiate board
   Board *board;
@@ -99,8 +110,16 @@ int sc_main(int argc, char *argv[]) {
     exit(1);
   }
 
+  // Attribute energy to the code being executed
+  auto *const profiler = Profiler::get();
+  if (profiler != nullptr) {
+    board->getPowerModelChannel().setEnergyAccumulator(
+        profiler->energyAccumulator());
+  }
+
   /* ------ Simulation control ------ */
   SimulationController simCtrl(&board->getMicrocontroller());
+  std::unique_ptr<Checkpoint> checkpoint;
   [[maybe_unused]] DummyModule d(
       "dummy", &simCtrl);  // Used to access end_of_simulation callback
 
@@ -118,20 +137,28 @@ int sc_main(int argc, char *argv[]) {
     spdlog::error("'GdbServer' true in config, but GDB_SERVER is undefined.");
     exit(1);
 #endif
+  } else if (isSet("CheckpointRestoreFile")) {
+    // Resume from a checkpoint instead of loading the program. The power
+    // supply is restored before the simulation starts. If the mcu was
+    // powered, the rest of the system is restored once it has powered up
+    // again, so that its power-on reset doesn't undo the restore.
+    checkpoint = std::make_unique<Checkpoint>(
+        config.getString("CheckpointRestoreFile"));
+    checkpoint->restore(/*powerSupply=*/true);
+    sc_start(SC_ZERO_TIME);  // Finish elaboration before restoring
+    if (checkpoint->isPowered()) {
+      board->getMicrocontroller().setPowerOnHook(
+          [&checkpoint]() { checkpoint->restore(/*powerSupply=*/false); });
+    } else {
+      checkpoint->restore(/*powerSupply=*/false);
+    }
+    spdlog::info("Restored checkpoint taken at {:s}",
+                 checkpoint->getTime().to_string());
+    simCtrl.unstall();
   } else {
     // Load binary to mcu
-    auto fn = Config::get().getString("ProgramHexFile");
-    if (fn.find(".hex") == std::string::npos &&
-        fn.find(".ihex") == std::string::npos) {
-      spdlog::error(
-          "-x: Invalid file format for input file {:s}, must be '.hex' or "
-          "'.ihex'",
-          fn);
-      return 1;
-    }
-    IntelHexFile programFile(fn);
     sc_start(SC_ZERO_TIME);  // Finish elaboration before programming
-    for (const auto &s : programFile.getProgramData()) {
+    for (const auto &s : programFile->getProgramData()) {
       simCtrl.writeMem(&s.second[0], s.first, s.second.size());
     }
     simCtrl.unstall();
@@ -142,8 +169,37 @@ int sc_main(int argc, char *argv[]) {
 
   spdlog::info("Starting simulation with time limit {:s}.",
                timeLimit.to_string());
-  sc_start(timeLimit);
+  bool checkpointSaved = false;
+  const auto saveCheckpoint = [&](const bool powered) {
+    Checkpoint::save(config.getString("CheckpointSaveFile"), powered);
+    checkpointSaved = true;
+  };
+  if (isSet("CheckpointSaveFile")) {
+    const auto saveTime =
+        sc_time::from_seconds(config.getDouble("CheckpointSaveTime"));
+    if (saveTime < timeLimit) {
+      sc_start(saveTime - sc_time_stamp());
+      auto &mcu = board->getMicrocontroller();
+      if (!sc_end_of_simulation_invoked()) {
+        if (mcu.nReset.read()) {
+          // The CPU may be part-way through an instruction, so let it finish
+          // before saving its registers
+          mcu.setInstructionBoundaryHook(saveCheckpoint);
+        } else {
+          saveCheckpoint(/*powered=*/false);
+        }
+      }
+    }
+  }
+  if (!sc_end_of_simulation_invoked()) {
+    sc_start(timeLimit - sc_time_stamp());
+  }
 
+  if (isSet("CheckpointSaveFile") && !checkpointSaved) {
+    spdlog::warn("Simulation ended before the checkpoint was saved");
+  }
+
+  bool completed = false;
   if (sc_time_stamp() >= timeLimit) {
     spdlog::warn("Simulation stopped at SimTimeLimit {:s}",
                  sc_time_stamp().to_string());
@@ -152,6 +208,8 @@ int sc_main(int argc, char *argv[]) {
     spdlog::warn("Simulation stopped without explicit sc_stop() at {:s}",
                  sc_time_stamp().to_string());
     sc_stop();
+  } else {
+    completed = true;
   }
 
 #ifdef GDB_SERVER
@@ -163,5 +221,72 @@ int sc_main(int argc, char *argv[]) {
   }
 #endif
 
-  return 0;
+  if (profiler != nullptr) {
+    profiler->write(config.getString("OutputDirectory"));
+  }
+
+  const auto &bridge = board->getPowerModelBridge();
+  const unsigned powerOns = bridge.getPowerOns();
+  return {{"completed", completed ? "True" : "False"},
+          {"time", fmt::format("{:.9g}", sc_time_stamp().to_seconds())},
+          {"energy", fmt::format("{:.9g}", bridge.getEnergy())},
+          {"onTime", fmt::format("{:.9g}", bridge.getOnTime().to_seconds())},
+          {"reboots", std::to_string(powerOns > 0 ? powerOns - 1 : 0)}};
+}
+
+int sc_main(int argc, char *argv[]) {
+  // Parse CLI arguments & config file
+  auto &config = Config::get();
+  config.parseCli(argc, argv);
+  config.parseFile();
+
+  // Load the program before forking any sweep workers, so that it is shared
+  std::unique_ptr<IntelHexFile> programFile;
+  if (!config.getBool("GdbServer") && !isSet("CheckpointRestoreFile")) {
+    auto fn = Config::get().getString("ProgramHexFile");
+    if (fn.find(".hex") == std::string::npos &&
+        fn.find(".ihex") == std::string::npos) {
+      spdlog::error(
+          "-x: Invalid file format for input file {:s}, must be '.hex' or "
+          "'.ihex'",
+          fn);
+      return 1;
+    }
+    programFile = std::make_unique<IntelHexFile>(fn);
+  }
+
+  if (!config.contains("SweepFile")) {
+    simulate(programFile.get());
+    return 0;
+  }
+
+  /* ------ Parameter sweep ------ */
+  if (config.getBool("GdbServer")) {
+    spdlog::error("Parameter sweeps can't use the gdb server, use -x.");
+    return 1;
+  }
+  SweepRunner sweep(config.getString("SweepFile"));
+  const auto outputDirectory = config.getString("OutputDirectory");
+  if (system(std::string("mkdir -p " + outputDirectory).c_str())) {
+    spdlog::error("Failed to create output directory at {} ... exiting",
+                  outputDirectory);
+    return 1;
+  }
+  const unsigned nJobs = config.contains("SweepJobs")
+                             ? config.getUint("SweepJobs")
+                             : std::thread::hardware_concurrency();
+
+  // Each point runs in its own worker, with its own output directory
+  const bool success = sweep.run(
+      nJobs,
+      [&](const size_t idx) {
+        for (const auto &kv : sweep.point(idx)) {
+          config.set(kv.first, kv.second);
+        }
+        config.set("OutputDirectory",
+                   fmt::format("{}/point{:05d}", outputDirectory, idx));
+        return simulate(programFile.get());
+      },
+      outputDirectory + "/sweep.csv");
+  return success ? 0 : 1;
 }
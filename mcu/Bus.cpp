@@ -19,31 +19,77 @@
 #include "mcu/Bus.hpp"
 #include "mcu/BusTarget.hpp"
 #include "utilities/Config.hpp"
+#include "utilities/Tracer.hpp"
+
+const unsigned Bus::PAGE_BITS = 8;
+const unsigned Bus::TABLE_BITS = 12;
+const int Bus::NO_TARGET = -1;
+const int Bus::MULTIPLE_TARGETS = -2;
 
 Bus::Bus(const sc_core::sc_module_name name)
-    : sc_core::sc_module(name), iSocket("iSocket"), tSocket("tSocket") {
+    : sc_core::sc_module(name),
+      iSocket("iSocket"),
+      tSocket("tSocket"),
+      m_pageTable(1u << (32 - PAGE_BITS - TABLE_BITS)) {
+  m_traceEnabled =
+      !Config::get().contains("BusTrace") || Config::get().getBool("BusTrace");
+
   tSocket.register_b_transport(this, &Bus::b_transport);
   tSocket.register_transport_dbg(this, &Bus::transport_dbg);
+  tSocket.register_get_direct_mem_ptr(this, &Bus::get_direct_mem_ptr);
+  iSocket.register_invalidate_direct_mem_ptr(this,
+                                             &Bus::invalidate_direct_mem_ptr);
 }
 
 void Bus::bindTarget(BusTarget &t) {
   m_routingTable.emplace_back(std::make_pair(t.startAddress(), t.endAddress()));
   iSocket.bind(t.tSocket);
   sc_assert(m_routingTable.size() == iSocket.size());
+  addToPageTable(t.startAddress(), t.endAddress(), m_routingTable.size() - 1);
+}
+
+void Bus::addToPageTable(const unsigned startAddress,
+                         const unsigned endAddress, const int port) {
+  for (uint64_t page = startAddress >> PAGE_BITS;
+       page <= (endAddress >> PAGE_BITS); ++page) {
+    auto &table = m_pageTable[page >> TABLE_BITS];
+    if (table.empty()) {
+      table.assign(1u << TABLE_BITS, NO_TARGET);
+    }
+    auto &entry = table[page & ((1u << TABLE_BITS) - 1)];
+    entry = (entry == NO_TARGET) ? port : MULTIPLE_TARGETS;
+  }
 }
 
 int Bus::routeForward(tlm::tlm_generic_payload &trans) const {
-  auto addr = trans.get_address();
-  auto it = std::find_if(
-      m_routingTable.begin(), m_routingTable.end(),
-      [addr, this](const std::pair<const unsigned, const unsigned> &rt) {
-        return this->inRange(addr, rt);
-      });
-  if (it == m_routingTable.end()) {
+  const auto addr = trans.get_address();
+  if (addr > 0xffffffff) {
     return -1;
   }
-  trans.set_address(addr - it->first);
-  return it - m_routingTable.begin();
+
+  int port = m_lastHit;
+  if (port == NO_TARGET || !inRange(addr, m_routingTable[port])) {
+    port = lookupPage(addr);
+    if (port == MULTIPLE_TARGETS) {
+      auto it = std::find_if(
+          m_routingTable.begin(), m_routingTable.end(),
+          [addr, this](const std::pair<const unsigned, const unsigned> &rt) {
+            return this->inRange(addr, rt);
+          });
+      port = (it == m_routingTable.end()) ? NO_TARGET
+                                          : it - m_routingTable.begin();
+    } else if (port != NO_TARGET && !inRange(addr, m_routingTable[port])) {
+      // Page is only partially mapped
+      port = NO_TARGET;
+    }
+    if (port == NO_TARGET) {
+      return -1;
+    }
+    m_lastHit = port;
+  }
+
+  trans.set_address(addr - m_routingTable[port].first);
+  return port;
 }
 
 void Bus::b_transport([[maybe_unused]] const int id,
@@ -62,8 +108,15 @@ void Bus::b_transport([[maybe_unused]] const int id,
             .c_str());
   }
   checkTransaction(trans, port);
+  const auto start = sc_core::sc_time_stamp() + delay;
   iSocket[port]->b_transport(trans, delay);
-  updateTrace(trans, addr);
+  if (m_traceEnabled) {
+    updateTrace(trans, addr);
+  }
+  if (m_tracer != nullptr) {
+    m_tracer->access(start.value(), addr, trans.is_write(), port,
+                     trans.get_data_ptr(), trans.get_data_length());
+  }
 }
 
 unsigned int Bus::transport_dbg([[maybe_unused]] const int id,
@@ -90,6 +143,41 @@ unsigned int Bus::transport_dbg([[maybe_unused]] const int id,
   }
 }
 
+bool Bus::get_direct_mem_ptr([[maybe_unused]] const int id,
+                             tlm::tlm_generic_payload &trans,
+                             tlm::tlm_dmi &dmi) {
+  const auto addr = trans.get_address();
+  const auto port = routeForward(trans);
+  if (port == -1) {
+    // Deny, only for this address
+    dmi.allow_none();
+    dmi.set_start_address(addr);
+    dmi.set_end_address(addr);
+    return false;
+  }
+
+  const bool granted = iSocket[port]->get_direct_mem_ptr(trans, dmi);
+
+  // Translate to bus addresses, and clamp to the target's range
+  const auto &rt = m_routingTable[port];
+  const sc_dt::uint64 size = rt.second - rt.first;
+  dmi.set_start_address(std::min(dmi.get_start_address(), size) + rt.first);
+  dmi.set_end_address(std::min(dmi.get_end_address(), size) + rt.first);
+  trans.set_address(addr);
+  return granted;
+}
+
+void Bus::invalidate_direct_mem_ptr(const int id, sc_dt::uint64 start,
+                                    sc_dt::uint64 end) {
+  const auto &rt = m_routingTable[id];
+  const sc_dt::uint64 size = rt.second - rt.first;
+  start = std::min(start, size) + rt.first;
+  end = std::min(end, size) + rt.first;
+  for (unsigned i = 0; i < tSocket.size(); ++i) {
+    tSocket[i]->invalidate_direct_mem_ptr(start, end);
+  }
+}
+
 bool Bus::overlapsExistingTarget(const int startAddress,
                                  const int endAddress) const {
   const auto hit = std::find_if(
@@ -21,6 +21,7 @@
 #include <vector>
 #include "mcu/BusTarget.hpp"
 #include "utilities/Config.hpp"
+#include "utilities/Tracer.hpp"
 
 class Bus : sc_core::sc_module {
  public:
@@ -41,6 +42,9 @@ class Bus : sc_core::sc_module {
   /**
    * @brief routeForward Find outgoing port of a transaction, and adjust the
    * transaction's address by subtracting the target's start address.
+   * The most recently hit target is checked first, then the page table is
+   * consulted. Only pages shared by several targets fall back to a scan of
+   * the routing table.
    * @param trans transaction object
    * @retval the outgoing port number, returns -1 if the target was not found.
    */
@@ -59,6 +63,23 @@ class Bus : sc_core::sc_module {
   unsigned int transport_dbg([[maybe_unused]] const int id,
                              tlm::tlm_generic_payload &trans);
 
+  /**
+   * @brief get_direct_mem_ptr Forward DMI request to target, and translate the
+   * returned DMI range from the target's address space to the bus' address
+   * space.
+   */
+  bool get_direct_mem_ptr([[maybe_unused]] const int id,
+                          tlm::tlm_generic_payload &trans, tlm::tlm_dmi &dmi);
+
+  /**
+   * @brief invalidate_direct_mem_ptr Translate invalidated range from the
+   * target's address space to the bus' address space, and forward to all
+   * initiators.
+   * @param id port number of target
+   */
+  void invalidate_direct_mem_ptr(const int id, sc_dt::uint64 start,
+                                 sc_dt::uint64 end);
+
   /* ------ Trace variables ------ */
  public:
   unsigned addressTrace{0xffffffff};
@@ -66,11 +87,45 @@ class Bus : sc_core::sc_module {
   unsigned dataTrace{0};
 
  private:
+  /* ------ Constants ------ */
+  static const unsigned PAGE_BITS;    //! log2 of page size (bytes)
+  static const unsigned TABLE_BITS;   //! log2 of 2nd-level table size
+  static const int NO_TARGET;         //! Page table entry: unmapped page
+  static const int MULTIPLE_TARGETS;  //! Page table entry: shared page
+
   /* ------ Private variables ------ */
   /* Routing table, index is port number, holds <startAddress, endAddress> */
   std::vector<std::pair<const unsigned, const unsigned>> m_routingTable{};
 
+  /* Two-level page table, maps (address >> PAGE_BITS) to a port number,
+   * NO_TARGET, or MULTIPLE_TARGETS. Second-level tables are only allocated for
+   * mapped regions. */
+  std::vector<std::vector<int>> m_pageTable;
+
+  mutable int m_lastHit{NO_TARGET};  //! Port of the most recent transaction
+  bool m_traceEnabled{true};         //! Whether to update trace variables
+  Tracer *const m_tracer{Tracer::get()};  //! Access tracer (if enabled)
+
   /* ------ Private methods ------ */
+  /**
+   * @brief addToPageTable Map the pages covering [startAddress, endAddress]
+   * to port.
+   */
+  void addToPageTable(const unsigned startAddress, const unsigned endAddress,
+                      const int port);
+
+  /**
+   * @brief lookupPage Look up the page table entry of an address.
+   * @retval port number, NO_TARGET or MULTIPLE_TARGETS
+   */
+  int lookupPage(const unsigned addr) const {
+    const auto &table = m_pageTable[addr >> (PAGE_BITS + TABLE_BITS)];
+    if (table.empty()) {
+      return NO_TARGET;
+    }
+    return table[(addr >> PAGE_BITS) & ((1u << TABLE_BITS) - 1)];
+  }
+
   /**
    * @brief Check if a is within the bounds specified by min and max
    * @param a address to check
@@ -74,6 +74,21 @@ unsigned int BusTarget::transport_dbg(tlm::tlm_generic_payload &trans) {
   return trans.get_data_length();
 }
 
+bool BusTarget::get_direct_mem_ptr(
+    tlm::tlm_generic_payload &trans[[maybe_unused]], tlm::tlm_dmi &dmi) {
+  dmi.allow_none();
+  dmi.set_start_address(0);
+  dmi.set_end_address(m_endAddress - m_startAddress);
+  return false;
+}
+
+void BusTarget::saveState(CheckpointOut &out) { m_regs.saveState(out); }
+
+void BusTarget::restoreState(CheckpointIn &in) {
+  m_regs.restoreState(in);
+  m_writeEvent.notify(SC_ZERO_TIME);
+}
+
 std::ostream &operator<<(std::ostream &os, const BusTarget &rhs) {
   os << "<BusTarget> " << rhs.name() << "\n"
      << "StartAddress: 0x" << std::hex << rhs.startAddress() << '\n'
@@ -13,8 +13,11 @@
 #include "mcu/ClockSourceIf.hpp"
 #include "mcu/RegisterFile.hpp"
 #include "ps/PowerModelChannelIf.hpp"
+#include "utilities/Checkpoint.hpp"
 
-class BusTarget : public sc_core::sc_module, public tlm::tlm_fw_transport_if<> {
+class BusTarget : public sc_core::sc_module,
+                  public tlm::tlm_fw_transport_if<>,
+                  public Checkpointable {
  public:
   /* ------ Ports ------ */
   //! Bus clock
@@ -55,11 +58,33 @@ class BusTarget : public sc_core::sc_module, public tlm::tlm_fw_transport_if<> {
    */
   virtual unsigned int transport_dbg(tlm::tlm_generic_payload &trans) override;
 
+  /**
+   * @brief get_direct_mem_ptr Request a DMI pointer.
+   * Default implementation denies DMI for the whole address range of this
+   * target, since accesses to peripheral registers have side effects.
+   * @param trans
+   * @param dmi DMI descriptor, set to the (denied) range of this target.
+   * @return true if DMI was granted.
+   */
+  virtual bool get_direct_mem_ptr(tlm::tlm_generic_payload &trans,
+                                  tlm::tlm_dmi &dmi) override;
+
   /**
    * @brief reset Resets to power-up defaults.
    */
   virtual void reset(void) = 0;
 
+  /**
+   * @brief saveState Default implementation saves m_regs.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState Default implementation restores m_regs, and triggers
+   * m_writeEvent so that processes sensitive to register writes update.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
   /**
    * @brief inRange Check whether an address is in range for this target.
    *        The bus is assumed to decrement the address before sending the
@@ -99,13 +124,6 @@ class BusTarget : public sc_core::sc_module, public tlm::tlm_fw_transport_if<> {
     exit(1);
   }
 
-  // dummy method
-  [[noreturn]] virtual bool get_direct_mem_ptr(
-      tlm::tlm_generic_payload &trans[[maybe_unused]],
-      tlm::tlm_dmi &data[[maybe_unused]]) override {
-    SC_REPORT_ERROR(this->name(), "not implemented");
-    exit(1);
-  }
 
  protected:
   const unsigned int m_startAddress;
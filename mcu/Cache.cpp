@@ -7,38 +7,21 @@
 
 #include <spdlog/fmt/fmt.h>
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
 #include <string>
 #include <systemc>
 #include <tlm>
 #include "libs/make_unique.hpp"
 #include "mcu/Cache.hpp"
-#include "mcu/CacheReplacementPolicies.hpp"
 #include "ps/ConstantEnergyEvent.hpp"
 #include "utilities/Config.hpp"
 
 using namespace sc_core;
 
-CacheSet::CacheSet(const int nLines, const int lineWidth,
-                   CacheReplacementIf *replacementPolicy)
-    : replacementPolicy(replacementPolicy), lines(nLines, lineWidth) {}
-
-int CacheSet::findLine(const unsigned tag) {
-  for (unsigned int i = 0; i < lines.size(); i++) {
-    if (lines[i].tag == tag && lines[i].valid) {
-      return i;  // Cache hit
-    }
-  }
-  return -1;  // Cache miss
-}
-
-void CacheSet::reset() {
-  for (auto &l : lines) {
-    l.reset();
-  }
-  replacementPolicy->reset();
-}
-
 Cache::Cache(const sc_module_name name, const unsigned startAddress,
              const unsigned endAddress)
     : BusTarget(name, startAddress, endAddress) {
@@ -46,7 +29,7 @@ Cache::Cache(const sc_module_name name, const unsigned startAddress,
 
   // Config
   std::string strname = this->name();
-  auto cfg = m_lineWidth = Config::get().getUint(strname + ".CacheLineWidth");
+  m_lineWidth = Config::get().getUint(strname + ".CacheLineWidth");
   m_nSets = Config::get().getUint(strname + ".CacheNSets");
   m_nLines = Config::get().getUint(strname + ".CacheNLines");
   m_nOffsetBits = static_cast<int>(log2(m_lineWidth));
@@ -64,29 +47,34 @@ Cache::Cache(const sc_module_name name, const unsigned startAddress,
     m_writePolicy = WP_WRITE_BACK;
   }
 
-  // Construct sets
-  auto setCfg = Config::get().getString(std::string(this->name()) +
-                                        ".CacheReplacementPolicy");
+  // Allocate lines
+  m_data.resize(m_nSets * m_nLines * m_lineWidth);
+  auto setCfg = Config::get().getString(strname + ".CacheReplacementPolicy");
+  try {
+    m_lines = CacheTags(m_nSets, m_nLines, setCfg);
+  } catch (const std::invalid_argument &e) {
+    spdlog::error("{}: {}", strname, e.what());
+    SC_REPORT_ERROR(this->name(), "Invalid replacement policy.");
+  }
 
-  for (unsigned int i = 0; i < m_nSets; i++) {
-    if (setCfg == "LRU") {
-      m_sets.push_back(
-          CacheSet(m_nLines, m_lineWidth, new CacheReplacementLru(m_nLines)));
-    } else if (setCfg == "LFU") {
-      m_sets.push_back(CacheSet(m_nLines, m_lineWidth,
-                                new CacheReplacementLfu(m_nLines, 64)));
-    } else if (setCfg == "RoundRobin") {
-      m_sets.push_back(CacheSet(m_nLines, m_lineWidth,
-                                new CacheReplacementRoundRobin(m_nLines)));
-    } else if (setCfg == "PseudoRandom") {
-      m_sets.push_back(CacheSet(m_nLines, m_lineWidth,
-                                new CacheReplacementPseudoRandom(m_nLines)));
-    } else {
-      spdlog::error("FRAM Cache set: invalid replacement policy {}", setCfg);
-      SC_REPORT_ERROR("FRAM Cache set", "Invalid replacement policy.");
+  // Shadow caches, one per point of the grid in the shadow cache file
+  if (Config::get().contains(strname + ".ShadowCacheFile") &&
+      Config::get().getString(strname + ".ShadowCacheFile") != "none") {
+    const SweepRunner grid(
+        Config::get().getString(strname + ".ShadowCacheFile"));
+    m_shadows.reserve(grid.nPoints());
+    for (size_t i = 0; i < grid.nPoints(); i++) {
+      m_shadowParams.push_back(grid.point(i));
+      try {
+        m_shadows.emplace_back(strname, m_shadowParams.back());
+      } catch (const std::invalid_argument &e) {
+        spdlog::error("{}: shadow cache {}: {}", strname, i, e.what());
+        SC_REPORT_ERROR(this->name(), "Invalid shadow cache.");
+      }
     }
+    spdlog::info("{}: simulating {} shadow caches", strname, m_shadows.size());
   }
-};
+}
 
 void Cache::end_of_elaboration() {
   BusTarget::end_of_elaboration();
@@ -116,6 +104,38 @@ void Cache::end_of_elaboration() {
   sensitive << pwrOn;
 }
 
+void Cache::end_of_simulation() {
+  if (m_shadows.empty()) {
+    return;
+  }
+  const auto fileName = fmt::format("{}/{}.shadow.csv",
+                                    Config::get().getString("OutputDirectory"),
+                                    this->name());
+  std::ofstream csv(fileName);
+  for (const auto &kv : m_shadowParams.front()) {
+    csv << kv.first << ",";
+  }
+  csv << "readHits,readMisses,writeHits,writeMisses,writebacks,"
+         "memoryBytesRead,memoryBytesWritten,missRate,energy(J)\n";
+  for (size_t i = 0; i < m_shadows.size(); i++) {
+    for (const auto &kv : m_shadowParams[i]) {
+      csv << kv.second << ",";
+    }
+    const auto &s = m_shadows[i].stats();
+    const auto accesses =
+        s.readHits + s.readMisses + s.writeHits + s.writeMisses;
+    const double missRate =
+        accesses ? static_cast<double>(s.readMisses + s.writeMisses) / accesses
+                 : 0.0;
+    csv << fmt::format("{},{},{},{},{},{},{},{:.6f},{:.9g}\n", s.readHits,
+                       s.readMisses, s.writeHits, s.writeMisses, s.writebacks,
+                       s.memoryBytesRead, s.memoryBytesWritten, missRate,
+                       m_shadows[i].energy());
+  }
+  spdlog::info("{}: shadow cache statistics written to {}", this->name(),
+               fileName);
+}
+
 void Cache::b_transport(tlm::tlm_generic_payload &trans, sc_time &delay) {
   auto addr = trans.get_address();
   uint8_t *dataPtr = trans.get_data_ptr();
@@ -130,20 +150,13 @@ void Cache::b_transport(tlm::tlm_generic_payload &trans, sc_time &delay) {
     SC_REPORT_FATAL(this->name(), "Access unaligned to cache line.");
   }
 
-  int lineIdx = m_sets[index(addr)].findLine(tag(addr));
-  assert(lineIdx >= 0 ? lineIdx < m_nLines : 1);
-  bool hit = lineIdx >= 0;
-  if (hit) {
-    m_sets[index(addr)].replacementPolicy->hit(
-        lineIdx, trans.get_command() == tlm::TLM_WRITE_COMMAND);
-  } else {  // Miss -- pick victim line
-    lineIdx = m_sets[index(addr)].replacementPolicy->miss(
-        trans.get_command() == tlm::TLM_WRITE_COMMAND);
-    assert(lineIdx < m_nLines);
+  bool hit;
+  const unsigned line = m_lines.lookup(index(addr), tag(addr), hit);
+  uint8_t *data = lineData(line);
+  for (auto &s : m_shadows) {
+    s.access(addr, len, trans.get_command() == tlm::TLM_WRITE_COMMAND);
   }
 
-  auto &line = m_sets[index(addr)].lines[lineIdx];
-
   if (trans.get_command() == tlm::TLM_WRITE_COMMAND) {
     m_writeEvent.notify(delay + systemClk->getPeriod());
     powerModelPort->reportEvent(m_writeEventId);
@@ -158,24 +171,24 @@ void Cache::b_transport(tlm::tlm_generic_payload &trans, sc_time &delay) {
     tlm::tlm_generic_payload outputTrans;
     switch (m_writePolicy) {
       case WP_WRITE_AROUND:  // Update memory only
-        sc_assert(line.dirty == false);
+        sc_assert(!m_lines.dirty[line]);
         outputTrans.set_address(addr);
         outputTrans.set_data_length(len);
         outputTrans.set_data_ptr(dataPtr);
         outputTrans.set_command(tlm::TLM_WRITE_COMMAND);
         iSocket->b_transport(outputTrans, delay);
         if (hit) {
-          line.valid = false;
+          m_lines.valid[line] = false;
         }
         break;
       case WP_WRITE_THROUGH:  // Update cache line & memory
-        sc_assert(line.dirty == false);
+        sc_assert(!m_lines.dirty[line]);
         if (!hit) {
           readLine(addr, line, delay);  // load new line
         }
 
         // Update cached data
-        memcpy(&line.data[offset(addr)], dataPtr, len);
+        memcpy(&data[offset(addr)], dataPtr, len);
 
         // Update memory
         outputTrans.set_address(addr);
@@ -185,15 +198,15 @@ void Cache::b_transport(tlm::tlm_generic_payload &trans, sc_time &delay) {
         iSocket->b_transport(outputTrans, delay);
         break;
       case WP_WRITE_BACK:  // Update cache line only
-        if (!hit && line.valid && line.dirty) {
+        if (!hit && m_lines.valid[line] && m_lines.dirty[line]) {
           writeLine(line, addr, delay);  // Write back victim
         }
         if (!hit) {
           readLine(addr, line, delay);  // load new line
         }
         // Update cached data
-        memcpy(&line.data[offset(addr)], dataPtr, len);
-        line.dirty = true;
+        memcpy(&data[offset(addr)], dataPtr, len);
+        m_lines.dirty[line] = true;
         break;
       default:
         SC_REPORT_FATAL(this->name(), "Invalid write policy.");
@@ -212,14 +225,14 @@ void Cache::b_transport(tlm::tlm_generic_payload &trans, sc_time &delay) {
 
     if (!hit) {
       // Miss -- Fetch data from memory before serving
-      if (line.valid && line.dirty) {
+      if (m_lines.valid[line] && m_lines.dirty[line]) {
         writeLine(line, addr, delay);  // Write back victim first
       }
       readLine(addr, line, delay);  // Fetch new line
     }
 
     // Return data
-    std::memcpy(dataPtr, &line.data[offset(addr)], len);
+    std::memcpy(dataPtr, &data[offset(addr)], len);
   } else {
     SC_REPORT_FATAL(this->name(), "Transaction command not supported.");
   }
@@ -236,51 +249,78 @@ unsigned int Cache::transport_dbg(tlm::tlm_generic_payload &trans) {
 }
 
 void Cache::reset() {
-  for (auto &s : m_sets) {
+  std::fill(m_data.begin(), m_data.end(), 0xAA);
+  m_lines.reset();
+  for (auto &s : m_shadows) {
     s.reset();
   }
 }
 
-void Cache::writeLine(CacheLine &line, const uint32_t addr, sc_time &delay) {
-  sc_assert(line.dirty);  // Don't write back clean lines
-  sc_assert(line.valid);  // Don't write back valid lines
+void Cache::writeLine(const unsigned line, const uint32_t addr,
+                      sc_time &delay) {
+  sc_assert(m_lines.dirty[line]);  // Don't write back clean lines
+  sc_assert(m_lines.valid[line]);  // Don't write back valid lines
   tlm::tlm_generic_payload trans;
-  uint32_t wbaddr = ((line.tag << (m_nOffsetBits + m_nIdBits)) |
+  uint32_t wbaddr = ((m_lines.tags[line] << (m_nOffsetBits + m_nIdBits)) |
                      (index(addr) << m_nOffsetBits));
   trans.set_address(wbaddr);
   trans.set_data_length(m_lineWidth);
-  trans.set_data_ptr(&line.data[0]);
+  trans.set_data_ptr(lineData(line));
   trans.set_command(tlm::TLM_WRITE_COMMAND);
   iSocket->b_transport(trans, delay);
-  line.dirty = false;
+  m_lines.dirty[line] = false;
 }
 
-void Cache::readLine(const uint32_t addr, CacheLine &line, sc_time &delay) {
-  sc_assert(!line.dirty);  // Don't overwrite dirty lines
+void Cache::readLine(const uint32_t addr, const unsigned line,
+                     sc_time &delay) {
+  sc_assert(!m_lines.dirty[line]);  // Don't overwrite dirty lines
   tlm::tlm_generic_payload trans;
   trans.set_address(addr & (~m_offsetMask));
   trans.set_data_length(m_lineWidth);
-  trans.set_data_ptr(&line.data[0]);
+  trans.set_data_ptr(lineData(line));
   trans.set_command(tlm::TLM_READ_COMMAND);
   iSocket->b_transport(trans, delay);
-  line.tag = tag(addr);
-  line.valid = true;
-  line.dirty = false;
+  m_lines.tags[line] = tag(addr);
+  m_lines.valid[line] = true;
+  m_lines.dirty[line] = false;
+}
+
+void Cache::saveState(CheckpointOut &out) {
+  BusTarget::saveState(out);
+  for (unsigned line = 0; line < m_lines.size(); line++) {
+    out.put<bool>(m_lines.valid[line]);
+    out.put<bool>(m_lines.dirty[line]);
+    out.put<unsigned>(m_lines.tags[line]);
+    out.putBytes(lineData(line), m_lineWidth);
+  }
+}
+
+void Cache::restoreState(CheckpointIn &in) {
+  BusTarget::restoreState(in);
+  for (unsigned line = 0; line < m_lines.size(); line++) {
+    m_lines.valid[line] = in.get<bool>();
+    m_lines.dirty[line] = in.get<bool>();
+    m_lines.tags[line] = in.get<unsigned>();
+    in.getBytes(lineData(line), m_lineWidth);
+  }
 }
 
 std::ostream &operator<<(std::ostream &os, const Cache &rhs) {
   os << "Cache: " << rhs.name();
   os << "\nContent";
   os << "\nID L  TAG        V D DATA\n";
-  for (unsigned i = 0; i < rhs.m_sets.size(); i++) {
-    for (unsigned j = 0; j < rhs.m_sets[i].lines.size(); j++) {
-      const auto &line = rhs.m_sets[i].lines[j];
+  for (int i = 0; i < rhs.m_nSets; i++) {
+    for (int j = 0; j < rhs.m_nLines; j++) {
+      const unsigned line = i * rhs.m_nLines + j;
       std::string s = fmt::format("{:02d} {:02d} 0x{:08x} {:1d} {:1d} ", i, j,
-                                  line.tag, line.valid, line.dirty);
+                                  rhs.m_lines.tags[line],
+                                  rhs.m_lines.valid[line],
+                                  rhs.m_lines.dirty[line]);
       os << s << "[" << std::hex;
-      for (unsigned k = 0; k < line.data.size(); k++) {
-        os << "0x" << std::hex << static_cast<unsigned>(line.data[k]);
-        if (k < line.data.size() - 1) {
+      for (int k = 0; k < rhs.m_lineWidth; k++) {
+        os << "0x" << std::hex
+           << static_cast<unsigned>(rhs.m_data[line * rhs.m_lineWidth + k]);
+        if (k < rhs.m_lineWidth - 1) {
           os << ",";
         }
       }
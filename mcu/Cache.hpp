@@ -9,48 +9,20 @@
 
 #include <stdint.h>
 #include <iostream>
-#include <list>
 #include <string>
 #include <systemc>
 #include <tlm>
 #include <vector>
 #include "mcu/BusTarget.hpp"
-#include "mcu/CacheReplacementPolicies.hpp"
+#include "mcu/CacheTags.hpp"
+#include "mcu/ShadowCache.hpp"
 #include "utilities/Config.hpp"
 
-/* Cache line */
-struct CacheLine {
-  bool valid{false};
-  bool dirty{false};
-  unsigned tag{0};
-  std::vector<uint8_t> data;
-  CacheLine(const int lineWidth) : data(lineWidth, 0) {}
-  void reset() {
-    valid = false;
-    dirty = false;
-    tag = 0;
-    for (auto &d : data) {
-      d = 0xAA;
-    }
-  }
-};
-
-/* Cache set */
-class CacheSet {
- public:
-  /* ------ Public methods ------ */
-  CacheSet(const int nLines, const int lineWidth,
-           CacheReplacementIf *replacementPolicy);
-  int findLine(const unsigned tag);
-  unsigned miss(const unsigned tag);
-  void hit(const unsigned tag);
-  void reset();
-
-  /* ------ Public variables ------ */
-  CacheReplacementIf *replacementPolicy;
-  std::vector<CacheLine> lines;
-};
-
+/**
+ * @brief The Cache class Set-associative cache. Lines are stored in contiguous
+ * data/tag/valid/dirty arrays indexed by set * nLines + way, and the
+ * replacement policy is selected when the cache is constructed.
+ */
 class Cache : public BusTarget, public tlm::tlm_bw_transport_if<> {
   SC_HAS_PROCESS(Cache);
 
@@ -80,12 +52,29 @@ class Cache : public BusTarget, public tlm::tlm_bw_transport_if<> {
    * states
    */
   virtual void end_of_elaboration() override;
+
+  /**
+   * @brief end_of_simulation write the statistics of the shadow caches to
+   * <OutputDirectory>/<name>.shadow.csv
+   */
+  virtual void end_of_simulation() override;
   /**
    * @brief transport_dbg forward directly to memory
    * @param trans
    */
   unsigned int transport_dbg(tlm::tlm_generic_payload &trans) override;
 
+  /**
+   * @brief saveState save the tag, valid, dirty, and data of each line. The
+   * replacement policy state is not saved.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState restore the lines saved by saveState.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
   /**
    * @brief << operator debug printout
    */
@@ -95,16 +84,22 @@ class Cache : public BusTarget, public tlm::tlm_bw_transport_if<> {
   /* ------ Constants ------ */
   /* ------ Types ------ */
   /* ------ Private variables ------ */
-  std::vector<CacheSet> m_sets;
   int m_lineWidth;
   int m_nSets;
-  int m_nLines;
+  int m_nLines;  //! Lines (ways) per set
   int m_nOffsetBits;
   int m_nIdBits;
   unsigned m_offsetMask;
   unsigned m_idMask;
   unsigned m_tagMask;
 
+  std::vector<uint8_t> m_data;  //! Line data, m_lineWidth bytes per line
+  CacheTags m_lines;             //! Tag, valid, and dirty bit of each line
+
+  //! Tag-only models of other configurations, fed with the same accesses
+  std::vector<ShadowCache> m_shadows;
+  std::vector<SweepRunner::KeyValues> m_shadowParams;  //! Of each shadow
+
   enum write_policy {
     WP_WRITE_THROUGH,
     WP_WRITE_AROUND,
@@ -125,6 +120,11 @@ class Cache : public BusTarget, public tlm::tlm_bw_transport_if<> {
    */
   virtual void reset() override;
 
+  /**
+   * @brief lineData pointer to the data of a line
+   */
+  uint8_t *lineData(const unsigned line) { return &m_data[line * m_lineWidth]; }
+
   /**
    * @brief writeLine write a line to memory (master port) and update line state
    * accordingly
@@ -132,7 +132,8 @@ class Cache : public BusTarget, public tlm::tlm_bw_transport_if<> {
    * @param addr address (used for the index field of the writeback address)
    * @param delay accumulative access delay
    */
-  void writeLine(CacheLine &line, const uint32_t addr, sc_core::sc_time &delay);
+  void writeLine(const unsigned line, const uint32_t addr,
+                 sc_core::sc_time &delay);
 
   /**
    * @brief readLine read a line from memory (master port), and update line
@@ -141,7 +142,8 @@ class Cache : public BusTarget, public tlm::tlm_bw_transport_if<> {
    * @param line line to write
    * @param delay accumulative access delay
    */
-  void readLine(const uint32_t addr, CacheLine &line, sc_core::sc_time &delay);
+  void readLine(const uint32_t addr, const unsigned line,
+                sc_core::sc_time &delay);
 
   /**
    * @brief Get index of address
@@ -167,14 +169,14 @@ class Cache : public BusTarget, public tlm::tlm_bw_transport_if<> {
     return (addr & m_offsetMask);
   }
 
+  /**
+   * @brief invalidate_direct_mem_ptr The cache never grants DMI (see
+   * BusTarget::get_direct_mem_ptr), so there is nothing to invalidate.
+   */
+  void invalidate_direct_mem_ptr(sc_dt::uint64 start_range[[maybe_unused]],
+                                 sc_dt::uint64 end_range[[maybe_unused]]) {}
+
   /* ------ Dummy methods ------ */
-  // Dummy method:
-  [[noreturn]] void invalidate_direct_mem_ptr(
-      sc_dt::uint64 start_range[[maybe_unused]],
-      sc_dt::uint64 end_range[[maybe_unused]]) {
-    SC_REPORT_FATAL(this->name(), "invalidate_direct_mem_ptr not implement");
-    exit(1);
-  }
 
       // Dummy method:
       [[noreturn]] tlm::tlm_sync_enum
@@ -7,166 +7,265 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <algorithm>
-#include <array>
-#include <list>
-#include <queue>
+#include <vector>
 
 /**
  * Collection of cache replacement policies
  *
+ * Each policy keeps the replacement state of all sets of a cache in flat
+ * arrays. hit() and miss() are deliberately not virtual: the cache
+ * instantiates its lookup for the policy chosen at construction (see
+ * Cache::lookup), so they are inlined into the access path. Only reset() goes
+ * through the base class.
  */
-class CacheReplacementIf {
+class CacheReplacementPolicy {
  public:
-  /**
-   * @brief hit register an access hit on a cache line, update internal dirty
-   * bit if the access was a write.
-   * @param lineNo line number that was hit.
-   * @param isWrite Set to true if the access was a write, set to false if it
-   * was a read.
-   */
-  virtual void hit(const int lineNo, bool isWrite) = 0;
+  CacheReplacementPolicy(const unsigned nSets, const unsigned nWays)
+      : m_nSets(nSets), m_nWays(nWays) {}
 
-  /**
-   * @brief miss register an access miss, and return a victim cache line.
-   * @param isWrite Set to true if the access was a write, set to false if it
-   * @retval victim cache line number.
+  virtual ~CacheReplacementPolicy() = default;
+
+  /*
+   * Interface of derived policies:
+   *
+   * void hit(const unsigned set, const unsigned way);
+   *   register an access hit on a way of a set.
+   *
+   * unsigned miss(const unsigned set);
+   *   register an access miss, and return the victim way, which is refilled
+   *   with the missing line.
    */
-  virtual int miss(bool isWrite) = 0;
 
   /**
    * @brief reset reset to power-on defaults.
    */
   virtual void reset() = 0;
+
+ protected:
+  const unsigned m_nSets;
+  const unsigned m_nWays;
 };
 
 /**
- * Least recently used replacement policy
+ * Least recently used replacement policy. Each line holds the time of its last
+ * access, so hits are O(1), and misses evict the oldest line of the set.
  */
-class CacheReplacementLru : public CacheReplacementIf {
+class CacheReplacementLru : public CacheReplacementPolicy {
  public:
-  CacheReplacementLru(const int nLines) {
+  CacheReplacementLru(const unsigned nSets, const unsigned nWays)
+      : CacheReplacementPolicy(nSets, nWays), m_lastAccess(nSets * nWays) {
+    reset();
+  }
+
+  void hit(const unsigned set, const unsigned way) {
+    m_lastAccess[set * m_nWays + way] = ++m_time;
+  }
+
+  unsigned miss(const unsigned set) {
+    const auto first = m_lastAccess.begin() + set * m_nWays;
+    const auto victim = std::min_element(first, first + m_nWays);
+    *victim = ++m_time;
+    return victim - first;
+  }
+
+  virtual void reset() override {
     // Initialize in arbitrary order
-    for (auto i = 0; i < nLines; i++) {
-      m_lru.push_back(i);
+    m_time = 0;
+    for (auto &t : m_lastAccess) {
+      t = m_time++;
+    }
+  }
+
+ private:
+  /* ------ Private variables ------ */
+  std::vector<uint64_t> m_lastAccess;  //! Indexed by set * nWays + way
+  uint64_t m_time{0};                  //! Access counter
+};
+
+/**
+ * Tree pseudo-LRU replacement policy. Each set has a binary tree of nWays - 1
+ * bits, each pointing towards the less recently used half of its subtree.
+ * Requires a power-of-two number of ways.
+ */
+class CacheReplacementPlru : public CacheReplacementPolicy {
+ public:
+  CacheReplacementPlru(const unsigned nSets, const unsigned nWays)
+      : CacheReplacementPolicy(nSets, nWays), m_tree(nSets * nWays, 0) {}
+
+  void hit(const unsigned set, const unsigned way) {
+    // Walk from the leaf to the root, pointing each node away from way
+    uint8_t *tree = &m_tree[set * m_nWays];
+    for (unsigned node = way + m_nWays; node > 1; node >>= 1) {
+      tree[node >> 1] = !(node & 1);
     }
   }
 
-  virtual void hit(const int lineNo, [[maybe_unused]] bool isWrite) override {
-    m_lru.remove(lineNo);
-    m_lru.push_front(lineNo);
+  unsigned miss(const unsigned set) {
+    const uint8_t *tree = &m_tree[set * m_nWays];
+    unsigned node = 1;
+    while (node < m_nWays) {
+      node = (node << 1) | tree[node];
+    }
+    const unsigned way = node - m_nWays;
+    hit(set, way);
+    return way;
   }
 
-  virtual int miss([[maybe_unused]] bool isWrite) override {
-    m_lru.push_front(m_lru.back());
-    m_lru.pop_back();
-    return m_lru.front();
+  virtual void reset() override { std::fill(m_tree.begin(), m_tree.end(), 0); }
+
+ private:
+  /* ------ Private variables ------ */
+  //! Tree nodes 1..nWays-1 of each set, node n has children 2n and 2n+1
+  std::vector<uint8_t> m_tree;
+};
+
+/**
+ * Static re-reference interval prediction (SRRIP-HP) with 2-bit prediction
+ * values. Lines are inserted with a long re-reference interval, and promoted
+ * to near-immediate on a hit, so lines that are only used once are evicted
+ * first.
+ */
+class CacheReplacementRrip : public CacheReplacementPolicy {
+ public:
+  CacheReplacementRrip(const unsigned nSets, const unsigned nWays)
+      : CacheReplacementPolicy(nSets, nWays), m_rrpv(nSets * nWays) {
+    reset();
+  }
+
+  void hit(const unsigned set, const unsigned way) {
+    m_rrpv[set * m_nWays + way] = 0;
+  }
+
+  unsigned miss(const unsigned set) {
+    const auto first = m_rrpv.begin() + set * m_nWays;
+    const auto last = first + m_nWays;
+    // Age all lines until one is predicted to be re-referenced distantly
+    const uint8_t oldest = *std::max_element(first, last);
+    const auto victim = std::find(first, last, oldest);
+    if (oldest < MAX_RRPV) {
+      for (auto it = first; it != last; ++it) {
+        *it += MAX_RRPV - oldest;
+      }
+    }
+    *victim = MAX_RRPV - 1;
+    return victim - first;
   }
 
   virtual void reset() override {
-    int i = 0;
-    for (auto &e : m_lru) {
-      e = i++;
+    for (auto &r : m_rrpv) {
+      r = MAX_RRPV;
     }
   }
 
  private:
+  static const uint8_t MAX_RRPV = 3;  //! Distant re-reference
+
   /* ------ Private variables ------ */
-  std::list<unsigned int> m_lru{};
+  std::vector<uint8_t> m_rrpv;  //! Re-reference prediction values
 };
 
-class CacheReplacementRoundRobin : public CacheReplacementIf {
+/**
+ * Round-robin replacement policy.
+ */
+class CacheReplacementRoundRobin : public CacheReplacementPolicy {
  public:
-  CacheReplacementRoundRobin(const int nLines) : m_nLines(nLines) {}
+  CacheReplacementRoundRobin(const unsigned nSets, const unsigned nWays)
+      : CacheReplacementPolicy(nSets, nWays), m_cnt(nSets, 0) {}
 
-  virtual void hit([[maybe_unused]] const int lineNo,
-                   [[maybe_unused]] bool isWrite) override {
+  void hit([[maybe_unused]] const unsigned set,
+           [[maybe_unused]] const unsigned way) {
     // Do nothing
   }
 
-  virtual int miss([[maybe_unused]] bool isWrite) override {
-    m_cnt = (m_cnt + 1) % m_nLines;
-    return m_cnt;
+  unsigned miss(const unsigned set) {
+    m_cnt[set] = (m_cnt[set] + 1) % m_nWays;
+    return m_cnt[set];
   }
 
-  virtual void reset() override { m_cnt = 0; }
+  virtual void reset() override { std::fill(m_cnt.begin(), m_cnt.end(), 0); }
 
  private:
-  unsigned m_cnt{0};
-  const unsigned m_nLines;
+  std::vector<unsigned> m_cnt;
 };
 
 /**
  * Least frequently used replacement policy
  */
-class CacheReplacementLfu : public CacheReplacementIf {
+class CacheReplacementLfu : public CacheReplacementPolicy {
  public:
-  CacheReplacementLfu(const int nLines, const int saturation)
-      : m_counters(nLines, 0), m_saturation(saturation){};
+  CacheReplacementLfu(const unsigned nSets, const unsigned nWays,
+                      const int saturation = 64)
+      : CacheReplacementPolicy(nSets, nWays),
+        m_counters(nSets * nWays, 0),
+        m_tieBreaker(nSets, false),
+        m_saturation(saturation) {}
 
-  virtual void hit([[maybe_unused]] const int lineNo,
-                   [[maybe_unused]] bool isWrite) override {
-    if (m_counters[lineNo] < m_saturation) {
-      m_counters[lineNo]++;
+  void hit(const unsigned set, const unsigned way) {
+    auto &c = m_counters[set * m_nWays + way];
+    if (c < m_saturation) {
+      c++;
     }
   }
 
-  virtual int miss([[maybe_unused]] bool isWrite) override {
+  unsigned miss(const unsigned set) {
+    const int *counters = &m_counters[set * m_nWays];
     int victim = 0;
     int tie = -1;
-    int min = m_counters[0];
-    for (unsigned int i = 1; i < m_counters.size(); i++) {
-      if (m_counters[i] < min) {
+    int min = counters[0];
+    for (unsigned int i = 1; i < m_nWays; i++) {
+      if (counters[i] < min) {
         victim = i;
-        min = m_counters[i];
+        min = counters[i];
         tie = -1;
-      } else if (m_counters[i] == min) {
+      } else if (counters[i] == min) {
         tie = i;
       }
     }
 
     if (tie > 0) {
       // Break tie
-      victim = m_tieBreaker ? victim : tie;
-      m_tieBreaker = !m_tieBreaker;
+      victim = m_tieBreaker[set] ? victim : tie;
+      m_tieBreaker[set] = !m_tieBreaker[set];
     }
 
-    m_counters[victim] = 0;
+    m_counters[set * m_nWays + victim] = 0;
     return victim;
   }
 
   virtual void reset() override {
-    for (auto &e : m_counters) {
-      e = 0;
-    }
+    std::fill(m_counters.begin(), m_counters.end(), 0);
   }
 
  private:
   /* ------ Private variables ------ */
   std::vector<int> m_counters;
+  std::vector<bool> m_tieBreaker;
   const int m_saturation;
-  bool m_tieBreaker{false};
 };
 
 /**
- * PseudoRandom: Pseudo random replacement using 16-bit LFSR
+ * PseudoRandom: Pseudo random replacement using 16-bit LFSR. Requires a
+ * power-of-two number of ways.
  */
-class CacheReplacementPseudoRandom : public CacheReplacementIf {
+class CacheReplacementPseudoRandom : public CacheReplacementPolicy {
  public:
-  CacheReplacementPseudoRandom(const int nLines) : m_outputMask(nLines - 1) {}
+  CacheReplacementPseudoRandom(const unsigned nSets, const unsigned nWays)
+      : CacheReplacementPolicy(nSets, nWays), m_outputMask(nWays - 1) {}
 
-  virtual void hit([[maybe_unused]] const int lineNo,
-                   [[maybe_unused]] bool isWrite) override {
+  void hit([[maybe_unused]] const unsigned set,
+           [[maybe_unused]] const unsigned way) {
     // Do nothing
   }
 
-  virtual int miss([[maybe_unused]] bool isWrite) override {
+  unsigned miss([[maybe_unused]] const unsigned set) {
     /* taps: 16 14 13 11; feedback polynomial: x^16 + x^14 + x^13 + x^11 + 1
      */
-    static uint16_t lfsr = 0xBEEF;  //! Only need one lfsr for the whole cache
-    uint16_t bit = ((lfsr >> 0) ^ (lfsr >> 2) ^ (lfsr >> 3) ^ (lfsr >> 5));
-    lfsr = (lfsr >> 1) | (bit << 15);
-    return lfsr & m_outputMask;
+    uint16_t bit = ((m_lfsr >> 0) ^ (m_lfsr >> 2) ^ (m_lfsr >> 3) ^
+                    (m_lfsr >> 5));
+    m_lfsr = (m_lfsr >> 1) | (bit << 15);
+    return m_lfsr & m_outputMask;
   }
 
   virtual void reset() override {
@@ -176,4 +275,5 @@ class CacheReplacementPseudoRandom : public CacheReplacementIf {
  private:
   /* ------ Private variables ------ */
   const unsigned m_outputMask;
+  uint16_t m_lfsr{0xBEEF};  //! Only need one lfsr for the whole cache
 };
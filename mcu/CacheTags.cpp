@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "libs/make_unique.hpp"
+#include "mcu/CacheTags.hpp"
+
+CacheTags::CacheTags(const unsigned nSets, const unsigned nWays,
+                     const std::string &replacementPolicy)
+    : tags(nSets * nWays),
+      valid(nSets * nWays),
+      dirty(nSets * nWays),
+      m_nWays(nWays) {
+  const bool powerOfTwo = (nWays & (nWays - 1)) == 0;
+  if (replacementPolicy == "LRU") {
+    m_policy = std::make_unique<CacheReplacementLru>(nSets, nWays);
+    m_lookup = &CacheTags::find<CacheReplacementLru>;
+  } else if (replacementPolicy == "PLRU" && powerOfTwo) {
+    m_policy = std::make_unique<CacheReplacementPlru>(nSets, nWays);
+    m_lookup = &CacheTags::find<CacheReplacementPlru>;
+  } else if (replacementPolicy == "RRIP") {
+    m_policy = std::make_unique<CacheReplacementRrip>(nSets, nWays);
+    m_lookup = &CacheTags::find<CacheReplacementRrip>;
+  } else if (replacementPolicy == "LFU") {
+    m_policy = std::make_unique<CacheReplacementLfu>(nSets, nWays);
+    m_lookup = &CacheTags::find<CacheReplacementLfu>;
+  } else if (replacementPolicy == "RoundRobin") {
+    m_policy = std::make_unique<CacheReplacementRoundRobin>(nSets, nWays);
+    m_lookup = &CacheTags::find<CacheReplacementRoundRobin>;
+  } else if (replacementPolicy == "PseudoRandom" && powerOfTwo) {
+    m_policy = std::make_unique<CacheReplacementPseudoRandom>(nSets, nWays);
+    m_lookup = &CacheTags::find<CacheReplacementPseudoRandom>;
+  } else {
+    throw std::invalid_argument(
+        "invalid replacement policy " + replacementPolicy + " for " +
+        std::to_string(nWays) +
+        " lines per set (PLRU and PseudoRandom require a power of two)");
+  }
+}
+
+template <class Policy>
+unsigned CacheTags::find(const unsigned set, const unsigned tag, bool &hit) {
+  auto &policy = static_cast<Policy &>(*m_policy);
+  const unsigned first = set * m_nWays;
+  for (unsigned way = 0; way < m_nWays; way++) {
+    if (tags[first + way] == tag && valid[first + way]) {
+      hit = true;  // Cache hit
+      policy.hit(set, way);
+      return first + way;
+    }
+  }
+  hit = false;  // Cache miss -- pick victim line
+  const unsigned way = policy.miss(set);
+  assert(way < m_nWays);
+  return first + way;
+}
+
+void CacheTags::reset() {
+  std::fill(tags.begin(), tags.end(), 0);
+  std::fill(valid.begin(), valid.end(), false);
+  std::fill(dirty.begin(), dirty.end(), false);
+  if (m_policy) {
+    m_policy->reset();
+  }
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "mcu/CacheReplacementPolicies.hpp"
+
+/**
+ * @brief CacheTags Tag store of a set-associative cache: the tag, valid and
+ * dirty bit of each line, in arrays indexed by set * nWays + way, and the
+ * replacement policy.
+ */
+class CacheTags {
+ public:
+  CacheTags() = default;
+
+  /**
+   * @brief CacheTags constructor. Throws std::invalid_argument if the
+   * replacement policy is unknown, or not supported for nWays.
+   * @param nSets number of sets
+   * @param nWays number of lines per set
+   * @param replacementPolicy {LRU, PLRU, RRIP, LFU, RoundRobin, PseudoRandom}
+   */
+  CacheTags(const unsigned nSets, const unsigned nWays,
+            const std::string &replacementPolicy);
+
+  /**
+   * @brief lookup find the line holding tag in set, or pick a victim line on a
+   * miss, and update the replacement policy.
+   * @param set set index
+   * @param tag tag
+   * @param hit set to true on a hit, false on a miss
+   * @retval line number (set * nWays + way)
+   */
+  unsigned lookup(const unsigned set, const unsigned tag, bool &hit) {
+    return (this->*m_lookup)(set, tag, hit);
+  }
+
+  /**
+   * @brief reset invalidate all lines, and reset the replacement policy.
+   */
+  void reset();
+
+  /**
+   * @brief size number of lines
+   */
+  unsigned size() const { return tags.size(); }
+
+  /* ------ Public variables ------ */
+  std::vector<unsigned> tags;  //! Tag of each line
+  std::vector<uint8_t> valid;  //! Valid bit of each line
+  std::vector<uint8_t> dirty;  //! Dirty bit of each line
+
+ private:
+  unsigned m_nWays{0};
+  std::unique_ptr<CacheReplacementPolicy> m_policy;
+  //! Lookup instantiated for the type of m_policy
+  unsigned (CacheTags::*m_lookup)(const unsigned set, const unsigned tag,
+                                  bool &hit){nullptr};
+
+  template <class Policy>
+  unsigned find(const unsigned set, const unsigned tag, bool &hit);
+};
@@ -13,9 +13,21 @@
 class ClockSourceChannel : public ClockSourceDriverIf,
                            public sc_core::sc_module {
  public:
+  /**
+   * @brief ClockSourceChannel constructor
+   * @param nm
+   * @param period initial clock period, SC_ZERO_TIME if stopped
+   * @param edgeEvents if false, only the period is tracked and no edge events
+   * are generated. For consumers that count edges from the period.
+   */
   ClockSourceChannel(sc_core::sc_module_name nm,
-                     sc_core::sc_time period = sc_core::SC_ZERO_TIME)
-      : sc_core::sc_module(nm), m_period(period) {
+                     sc_core::sc_time period = sc_core::SC_ZERO_TIME,
+                     bool edgeEvents = true)
+      : sc_core::sc_module(nm), m_period(period), m_edgeEvents(edgeEvents) {
+    if (!m_edgeEvents) {
+      return;
+    }
+
     SC_HAS_PROCESS(ClockSourceChannel);
     SC_METHOD(process);
     sensitive << m_nextEdgeEvent;
@@ -39,7 +51,7 @@ class ClockSourceChannel : public ClockSourceDriverIf,
     }
 
     m_nextEdgeEvent.cancel();  // Cancel queued edge
-    if (period > sc_core::SC_ZERO_TIME) {
+    if (m_edgeEvents && (period > sc_core::SC_ZERO_TIME)) {
       m_nextEdgeEvent.notify(period);  // Queue next edge
     } else {
       // Clock is stopped
@@ -61,6 +73,7 @@ class ClockSourceChannel : public ClockSourceDriverIf,
  private:
   /* ------ Private variables ------ */
   sc_core::sc_time m_period;                             //! Clock period
+  bool m_edgeEvents;                                     //! Notify edge events
   sc_core::sc_event m_nextEdgeEvent{"m_nextEdgeEvent"};  //! Edge event
   sc_core::sc_event m_periodChangedEvent{
       "m_periodChangedEvent"};  //! Period changed event
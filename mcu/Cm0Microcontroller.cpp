@@ -158,5 +158,7 @@ bool Cm0Microcontroller::dbgWriteMem(uint8_t *src, size_t addr, size_t len) {
   trans.set_data_ptr(src);
   trans.set_command(tlm::TLM_WRITE_COMMAND);
 
+  // Program memory may have changed
+  m_cpu.invalidatePredecoded(addr, addr + len - 1);
   return bus.transport_dbg(0, trans);
 }
@@ -82,6 +82,22 @@ public:
    */
   virtual void unstall(void) override { m_cpu.unstall(); }
 
+  /**
+   * @brief Register a function to be called once after the next power-on reset
+   */
+  virtual void setPowerOnHook(std::function<void()> hook) override {
+    m_cpu.setPowerOnHook(std::move(hook));
+  }
+
+  /**
+   * @brief Register a function to be called once at the next instruction
+   * boundary
+   */
+  virtual void setInstructionBoundaryHook(
+      std::function<void(bool powered)> hook) override {
+    m_cpu.setInstructionBoundaryHook(std::move(hook));
+  }
+
   /**
    * @brief Check if CPU is stalled
    * @param true if CPU stalled, false otherwise
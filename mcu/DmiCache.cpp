@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <systemc>
+#include <tlm>
+#include "mcu/DmiCache.hpp"
+
+using namespace sc_core;
+
+bool DmiCache::read(const unsigned addr, uint8_t *const data, const size_t len,
+                    sc_time &latency) {
+  auto *r = lookup(addr, len);
+  if (r == nullptr || !r->dmi.is_read_allowed()) {
+    return false;
+  }
+  std::memcpy(data, r->dmi.get_dmi_ptr() + (addr - r->dmi.get_start_address()),
+              len);
+  r->nReads++;
+  r->nBytesRead += len;
+  latency = r->dmi.get_read_latency();
+  return true;
+}
+
+bool DmiCache::write(const unsigned addr, const uint8_t *const data,
+                     const size_t len, sc_time &latency) {
+  auto *r = lookup(addr, len);
+  if (r == nullptr || !r->dmi.is_write_allowed()) {
+    return false;
+  }
+  std::memcpy(r->dmi.get_dmi_ptr() + (addr - r->dmi.get_start_address()), data,
+              len);
+  r->nWrites++;
+  r->nBytesWritten += len;
+  latency = r->dmi.get_write_latency();
+  return true;
+}
+
+void DmiCache::invalidate(const sc_dt::uint64 start, const sc_dt::uint64 end) {
+  for (auto &r : m_regions) {
+    if ((r.dmi.get_start_address() <= end) &&
+        (r.dmi.get_end_address() >= start)) {
+      flush(r);
+    }
+  }
+  m_regions.erase(std::remove_if(m_regions.begin(), m_regions.end(),
+                                 [start, end](const Region &r) {
+                                   return (r.dmi.get_start_address() <= end) &&
+                                          (r.dmi.get_end_address() >= start);
+                                 }),
+                  m_regions.end());
+  m_lastHit = 0;
+}
+
+void DmiCache::flush() {
+  for (auto &r : m_regions) {
+    flush(r);
+  }
+}
+
+void DmiCache::flush(Region &r) {
+  if ((r.reporter != nullptr) && (r.nReads || r.nWrites)) {
+    r.reporter->reportDmiAccesses(r.nReads, r.nBytesRead, r.nWrites,
+                                  r.nBytesWritten);
+  }
+  r.nReads = 0;
+  r.nBytesRead = 0;
+  r.nWrites = 0;
+  r.nBytesWritten = 0;
+}
+
+DmiCache::Region *DmiCache::lookup(const unsigned addr, const size_t len) {
+  // Accesses tend to hit the same region repeatedly, so check that one first
+  if ((m_lastHit < m_regions.size()) &&
+      m_regions[m_lastHit].contains(addr, len)) {
+    return &m_regions[m_lastHit];
+  }
+  for (unsigned i = 0; i < m_regions.size(); ++i) {
+    if (m_regions[i].contains(addr, len)) {
+      m_lastHit = i;
+      return &m_regions[i];
+    }
+  }
+
+  // Unknown region, ask the target
+  Region r;
+  DmiPowerExtension ext;
+  tlm::tlm_generic_payload trans;
+  trans.set_address(addr);
+  trans.set_data_length(len);
+  trans.set_command(tlm::TLM_READ_COMMAND);
+  trans.set_extension(&ext);
+  m_iSocket->get_direct_mem_ptr(trans, r.dmi);
+  trans.clear_extension(&ext);
+  r.reporter = ext.reporter;
+
+  // Only remember regions that cover the access (granted or denied)
+  if (!r.contains(addr, len)) {
+    return nullptr;
+  }
+  m_regions.push_back(r);
+  m_lastHit = m_regions.size() - 1;
+  return &m_regions.back();
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <systemc>
+#include <tlm>
+#include <vector>
+#include "mcu/DmiPowerExtension.hpp"
+
+/**
+ * @brief The DmiCache class Keeps track of the DMI regions granted to an
+ * initiator, and performs reads and writes through them.
+ *
+ * Regions that were denied are remembered as well, so that peripherals are
+ * not asked for a DMI pointer on every access. Accesses are counted per region
+ * and reported to the granting target in batches by flush().
+ */
+class DmiCache {
+ public:
+  /* ------ Public methods ------ */
+  /**
+   * @brief DmiCache constructor
+   * @param iSocket initiator socket used to request DMI pointers.
+   */
+  explicit DmiCache(tlm::tlm_initiator_socket<> &iSocket)
+      : m_iSocket(iSocket) {}
+
+  /**
+   * @brief read Read from memory through a DMI pointer.
+   * @param addr read address
+   * @param data buffer for read data
+   * @param len number of bytes to read
+   * @param latency set to the read latency of the region if successful
+   * @retval true if the read was done through DMI, false if the caller should
+   * use b_transport instead.
+   */
+  bool read(const unsigned addr, uint8_t *const data, const size_t len,
+            sc_core::sc_time &latency);
+
+  /**
+   * @brief write Write to memory through a DMI pointer.
+   * @param addr write address
+   * @param data data to write
+   * @param len number of bytes to write
+   * @param latency set to the write latency of the region if successful
+   * @retval true if the write was done through DMI, false if the caller should
+   * use b_transport instead.
+   */
+  bool write(const unsigned addr, const uint8_t *const data, const size_t len,
+             sc_core::sc_time &latency);
+
+  /**
+   * @brief invalidate Drop all regions overlapping [start, end]. Pending
+   * access counts are flushed first.
+   */
+  void invalidate(const sc_dt::uint64 start, const sc_dt::uint64 end);
+
+  /**
+   * @brief flush Report pending access counts of all regions to their targets.
+   */
+  void flush();
+
+ private:
+  /* ------ Types ------ */
+  struct Region {
+    tlm::tlm_dmi dmi;
+    DmiAccessReporterIf *reporter{nullptr};
+    unsigned nReads{0};
+    unsigned nBytesRead{0};
+    unsigned nWrites{0};
+    unsigned nBytesWritten{0};
+
+    bool contains(const unsigned addr, const size_t len) const {
+      return (addr >= dmi.get_start_address()) &&
+             (addr + len - 1 <= dmi.get_end_address());
+    }
+  };
+
+  /* ------ Private variables ------ */
+  tlm::tlm_initiator_socket<> &m_iSocket;
+  std::vector<Region> m_regions{};
+  unsigned m_lastHit{0};  //! Index of the most recently used region
+
+  /* ------ Private methods ------ */
+  /**
+   * @brief lookup Find the region containing [addr, addr+len), requesting a
+   * DMI pointer from the target if no region is known yet.
+   * @retval pointer to region, or nullptr if the range can not be cached.
+   */
+  Region *lookup(const unsigned addr, const size_t len);
+
+  /**
+   * @brief flush Report pending access counts of region r.
+   */
+  void flush(Region &r);
+};
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <systemc>
+#include <tlm>
+
+/**
+ * @brief DmiAccessReporterIf Interface used by initiators to report accesses
+ * made through a DMI pointer to the target that granted it, so that the
+ * target can account for them in the power model.
+ */
+class DmiAccessReporterIf {
+ public:
+  /**
+   * @brief reportDmiAccesses report a batch of DMI accesses.
+   * @param nReads number of read accesses
+   * @param nBytesRead total number of bytes read
+   * @param nWrites number of write accesses
+   * @param nBytesWritten total number of bytes written
+   */
+  virtual void reportDmiAccesses(const unsigned nReads,
+                                 const unsigned nBytesRead,
+                                 const unsigned nWrites,
+                                 const unsigned nBytesWritten) = 0;
+};
+
+/**
+ * @brief DmiPowerExtension Payload extension attached to get_direct_mem_ptr
+ * requests. A target that grants DMI fills in the reporter field.
+ */
+struct DmiPowerExtension : public tlm::tlm_extension<DmiPowerExtension> {
+ public:
+  /* ------ Public variables ------ */
+  DmiAccessReporterIf *reporter{nullptr};
+
+  /* ------ Public methods ------ */
+  DmiPowerExtension(void) = default;
+
+  /**
+   * Mandatory function for tlm payload extensions
+   */
+  virtual tlm::tlm_extension_base *clone() const override {
+    auto ext = new DmiPowerExtension();
+    ext->reporter = reporter;
+    return ext;
+  }
+
+  /**
+   * Mandatory function for tlm payload extensions
+   */
+  virtual void copy_from(const tlm::tlm_extension_base &ext) override {
+    reporter = static_cast<const DmiPowerExtension &>(ext).reporter;
+  }
+};
@@ -7,9 +7,15 @@
 
 #include <spdlog/fmt/fmt.h>
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <numeric>
+#include <set>
+#include <stdexcept>
 #include <systemc>
 #include <tlm>
+#include <vector>
 #include "libs/make_unique.hpp"
 #include "mcu/GenericMemory.hpp"
 #include "ps/ConstantEnergyEvent.hpp"
@@ -17,11 +23,24 @@
 
 using namespace sc_core;
 
+const size_t GenericMemory::SNAPSHOT_PAGE_SIZE;
+const size_t GenericMemory::NO_SNAPSHOT;
+
 GenericMemory::GenericMemory(sc_module_name name, unsigned startAddress,
                              unsigned endAddress)
     : BusTarget(name, startAddress, endAddress),
       mem(std::make_unique<uint8_t[]>(endAddress - startAddress + 1)),
-      m_capacity(endAddress - startAddress + 1) {}
+      m_capacity(endAddress - startAddress + 1) {
+  m_trackPages = Config::get().contains("MemorySnapshots") &&
+                 Config::get().getBool("MemorySnapshots");
+  if (m_trackPages) {
+    const size_t nPages =
+        (m_capacity + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE;
+    m_dirtyPages.assign(nPages, true);
+    m_dirtyList.resize(nPages);
+    std::iota(m_dirtyList.begin(), m_dirtyList.end(), 0);
+  }
+}
 
 void GenericMemory::end_of_elaboration() {
   BusTarget::end_of_elaboration();
@@ -33,6 +52,18 @@ void GenericMemory::end_of_elaboration() {
   m_nBytesReadEventId = powerModelPort->registerEvent(
       this->name(),
       std::make_unique<ConstantEnergyEvent>(this->name(), "bytes read"));
+
+  // DMI pointers are only valid while powered, and their latency depends on
+  // the clock period
+  SC_METHOD(invalidateDmi);
+  sensitive << pwrOn << systemClk->periodChangedEvent();
+  dont_initialize();
+
+  if (m_trackPages) {
+    SC_METHOD(powerFailureSnapshot);
+    sensitive << pwrOn.neg();
+    dont_initialize();
+  }
 }
 
 void GenericMemory::b_transport(tlm::tlm_generic_payload &trans,
@@ -43,6 +74,7 @@ void GenericMemory::b_transport(tlm::tlm_generic_payload &trans,
 
   if (trans.get_command() == tlm::TLM_WRITE_COMMAND) {
     std::memcpy(&mem[addr], data, len);
+    markDirty(addr, len);
     m_writeEvent.notify(delay + systemClk->getPeriod());
     powerModelPort->reportEvent(m_writeEventId);
     powerModelPort->reportEvent(m_nBytesWrittenEventId, len);
@@ -67,6 +99,7 @@ unsigned int GenericMemory::transport_dbg(tlm::tlm_generic_payload &trans) {
   // Perform transaction
   if (trans.get_command() == tlm::TLM_WRITE_COMMAND) {
     std::memcpy(&mem[addr], data, len);
+    markDirty(addr, len);
   } else if (trans.get_command() == tlm::TLM_READ_COMMAND) {
     std::memcpy(data, &mem[addr], len);
   } else {
@@ -77,4 +110,139 @@ unsigned int GenericMemory::transport_dbg(tlm::tlm_generic_payload &trans) {
   return len;
 }
 
+bool GenericMemory::get_direct_mem_ptr(tlm::tlm_generic_payload &trans,
+                                       tlm::tlm_dmi &dmi) {
+  dmi.set_start_address(0);
+  dmi.set_end_address(m_capacity - 1);
+  if (!pwrOn.read()) {
+    dmi.allow_none();
+    return false;
+  }
+
+  dmi.set_dmi_ptr(mem.get());
+  if (m_trackPages) {
+    dmi.allow_read();
+  } else {
+    dmi.allow_read_write();
+  }
+  dmi.set_read_latency(systemClk->getPeriod());
+  dmi.set_write_latency(systemClk->getPeriod());
+
+  // Let the initiator report its accesses back to us
+  DmiPowerExtension *ext;
+  trans.get_extension(ext);
+  if (ext != nullptr) {
+    ext->reporter = this;
+  }
+  return true;
+}
+
+void GenericMemory::reportDmiAccesses(const unsigned nReads,
+                                      const unsigned nBytesRead,
+                                      const unsigned nWrites,
+                                      const unsigned nBytesWritten) {
+  if (nReads) {
+    powerModelPort->reportEvent(m_readEventId, nReads);
+    powerModelPort->reportEvent(m_nBytesReadEventId, nBytesRead);
+  }
+  if (nWrites) {
+    powerModelPort->reportEvent(m_writeEventId, nWrites);
+    powerModelPort->reportEvent(m_nBytesWrittenEventId, nBytesWritten);
+  }
+}
+
+void GenericMemory::invalidateDmi() {
+  tSocket->invalidate_direct_mem_ptr(0, m_capacity - 1);
+}
+
+void GenericMemory::saveState(CheckpointOut &out) {
+  BusTarget::saveState(out);
+  out.put<uint64_t>(m_capacity);
+  out.putBytes(mem.get(), m_capacity);
+}
+
+void GenericMemory::restoreState(CheckpointIn &in) {
+  BusTarget::restoreState(in);
+  if (in.get<uint64_t>() != m_capacity) {
+    SC_REPORT_FATAL(this->name(), "Checkpoint memory size mismatch");
+  }
+  in.getBytes(mem.get(), m_capacity);
+  markDirty(0, m_capacity);
+}
+
+size_t GenericMemory::takeSnapshot() {
+  if (!m_trackPages) {
+    throw std::runtime_error(std::string(this->name()) +
+                             ": snapshots require MemorySnapshots: True");
+  }
+  // Store the pages written since the base snapshot
+  Snapshot snapshot{m_base, {}};
+  for (const auto p : m_dirtyList) {
+    const auto *start = &mem[p * SNAPSHOT_PAGE_SIZE];
+    const auto len =
+        std::min(SNAPSHOT_PAGE_SIZE, m_capacity - p * SNAPSHOT_PAGE_SIZE);
+    snapshot.pages.emplace(p, std::vector<uint8_t>(start, start + len));
+    m_dirtyPages[p] = false;
+  }
+  m_dirtyList.clear();
+  m_snapshots.push_back(std::move(snapshot));
+  m_base = m_snapshots.size() - 1;
+  return m_base;
+}
+
+void GenericMemory::restoreSnapshot(const size_t n) {
+  if (n >= m_snapshots.size()) {
+    throw std::out_of_range(std::string(this->name()) + ": no snapshot " +
+                            std::to_string(n));
+  }
+
+  // Pages that may differ from snapshot n: those written since the base
+  // snapshot, and those changed on the way from the base snapshot to n via
+  // their latest common ancestor
+  std::set<size_t> pages(m_dirtyList.begin(), m_dirtyList.end());
+  std::vector<bool> isAncestor(m_snapshots.size(), false);
+  for (size_t s = n; s != NO_SNAPSHOT; s = m_snapshots[s].parent) {
+    isAncestor[s] = true;
+  }
+  size_t common = m_base;
+  for (; (common != NO_SNAPSHOT) && !isAncestor[common];
+       common = m_snapshots[common].parent) {
+    for (const auto &page : m_snapshots[common].pages) {
+      pages.insert(page.first);
+    }
+  }
+  for (size_t s = n; s != common; s = m_snapshots[s].parent) {
+    for (const auto &page : m_snapshots[s].pages) {
+      pages.insert(page.first);
+    }
+  }
+
+  for (const auto p : pages) {
+    const auto &data = pageAt(n, p);
+    std::memcpy(&mem[p * SNAPSHOT_PAGE_SIZE], data.data(), data.size());
+    m_dirtyPages[p] = false;
+  }
+  m_dirtyList.clear();
+  m_base = n;
+}
+
+const std::vector<uint8_t> &GenericMemory::pageAt(size_t n,
+                                                  const size_t p) const {
+  // The first snapshot holds every page
+  while (true) {
+    const auto &snapshot = m_snapshots[n];
+    const auto it = snapshot.pages.find(p);
+    if (it != snapshot.pages.end()) {
+      return it->second;
+    }
+    n = snapshot.parent;
+  }
+}
+
+void GenericMemory::powerFailureSnapshot() {
+  const auto n = takeSnapshot();
+  spdlog::debug("{}: @{} power failure, took snapshot {}", this->name(),
+                sc_time_stamp().to_string(), n);
+}
+
 int GenericMemory::size() const { return m_capacity; }
@@ -7,12 +7,16 @@
 
 #pragma once
 
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <systemc>
 #include <tlm>
+#include <vector>
 #include "mcu/BusTarget.hpp"
+#include "mcu/DmiPowerExtension.hpp"
 
-class GenericMemory : public BusTarget {
+class GenericMemory : public BusTarget, public DmiAccessReporterIf {
   SC_HAS_PROCESS(GenericMemory);
 
  public:
@@ -49,15 +53,114 @@ class GenericMemory : public BusTarget {
    */
   virtual unsigned int transport_dbg(tlm::tlm_generic_payload &trans) override;
 
+  /**
+   * @brief get_direct_mem_ptr Grant read/write DMI to the whole memory, as
+   * long as the memory is powered. With MemorySnapshots enabled, only read
+   * DMI is granted, so that writes can be tracked.
+   * @param trans
+   * @param dmi DMI descriptor
+   * @return true if DMI was granted.
+   */
+  virtual bool get_direct_mem_ptr(tlm::tlm_generic_payload &trans,
+                                  tlm::tlm_dmi &dmi) override;
+
+  /**
+   * @brief reportDmiAccesses Report accesses made by an initiator through a
+   * DMI pointer to the power model.
+   */
+  virtual void reportDmiAccesses(const unsigned nReads,
+                                 const unsigned nBytesRead,
+                                 const unsigned nWrites,
+                                 const unsigned nBytesWritten) override;
+
   /**
    * @brief SystemC callback, used here to register power modelling events.
    */
   virtual void end_of_elaboration() override;
 
+  /**
+   * @brief saveState save the memory contents.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState restore the memory contents.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
+  /**
+   * @brief takeSnapshot Take a snapshot of the memory contents. Only pages
+   * written since the last taken or restored snapshot are copied, all other
+   * pages are looked up in that snapshot. Requires MemorySnapshots to be
+   * enabled.
+   * @retval index of the snapshot
+   */
+  size_t takeSnapshot();
+
+  /**
+   * @brief restoreSnapshot Rewind the memory contents to snapshot n. Only
+   * pages that may differ from the snapshot are copied. Later snapshots are
+   * kept, and snapshots taken after the rewind are based on snapshot n.
+   */
+  void restoreSnapshot(const size_t n);
+
+  //! Number of snapshots taken so far
+  size_t nSnapshots() const { return m_snapshots.size(); }
+
+  //! Granularity of write tracking (bytes)
+  static const size_t SNAPSHOT_PAGE_SIZE = 256;
+
  protected:
   std::unique_ptr<uint8_t[]> mem;  // Pointer to emulated memory
   const size_t m_capacity;         // Memory capacity (bytes)
 
   int m_nBytesWrittenEventId{-1};
   int m_nBytesReadEventId{-1};
+
+  /**
+   * @brief invalidateDmi Invalidate all DMI pointers to this memory. Called
+   * on power and clock period changes.
+   */
+  void invalidateDmi();
+
+  /**
+   * @brief markDirty Record a write to [addr, addr + len) for the next
+   * snapshot.
+   */
+  void markDirty(const size_t addr, const size_t len) {
+    if (m_trackPages) {
+      const size_t last = (addr + len - 1) / SNAPSHOT_PAGE_SIZE;
+      for (size_t p = addr / SNAPSHOT_PAGE_SIZE; p <= last; ++p) {
+        if (!m_dirtyPages[p]) {
+          m_dirtyPages[p] = true;
+          m_dirtyList.push_back(p);
+        }
+      }
+    }
+  }
+
+ private:
+  //! Pages that differ from the parent snapshot, keyed by page index
+  struct Snapshot {
+    size_t parent;
+    std::map<size_t, std::vector<uint8_t>> pages;
+  };
+
+  static const size_t NO_SNAPSHOT = SIZE_MAX;
+
+  bool m_trackPages{false};         //! MemorySnapshots enabled
+  std::vector<bool> m_dirtyPages;   //! Pages written since m_base
+  std::vector<size_t> m_dirtyList;  //! Indices of the pages in m_dirtyPages
+  size_t m_base{NO_SNAPSHOT};       //! Last taken or restored snapshot
+  std::vector<Snapshot> m_snapshots;
+
+  /**
+   * @brief pageAt contents of page p in snapshot n.
+   */
+  const std::vector<uint8_t> &pageAt(size_t n, const size_t p) const;
+
+  /**
+   * @brief powerFailureSnapshot Take a snapshot on power failure.
+   */
+  void powerFailureSnapshot();
 };
@@ -5,8 +5,84 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <spdlog/spdlog.h>
+#include <functional>
+#include <stdexcept>
 #include <systemc>
+#include <vector>
+#include "mcu/Cache.hpp"
+#include "mcu/GenericMemory.hpp"
 #include "mcu/Microcontroller.hpp"
 
+using namespace sc_core;
+
+namespace {
+//! Call f for every object of type T in the hierarchy below parent
+template <class T>
+void forEachChild(sc_object *parent, const std::function<void(T *)> &f) {
+  for (auto *obj : parent->get_child_objects()) {
+    if (auto *t = dynamic_cast<T *>(obj)) {
+      f(t);
+    }
+    forEachChild(obj, f);
+  }
+}
+}  // namespace
+
 Microcontroller::Microcontroller(sc_core::sc_module_name nm)
     : sc_core::sc_module(nm) {}
+
+size_t Microcontroller::takeSnapshot() {
+  const size_t n = nSnapshots();
+  forEachChild<GenericMemory>(this, [n](GenericMemory *m) {
+    if (m->takeSnapshot() != n) {
+      throw std::logic_error(std::string(m->name()) +
+                             ": inconsistent snapshot index");
+    }
+  });
+  if (nReset.read()) {
+    auto &regs = m_snapshotRegs[n];
+    for (uint32_t i = 0; i < n_regs(); ++i) {
+      regs.push_back(dbgReadReg(i));
+    }
+  }
+  spdlog::info("{}: @{} took snapshot {}", this->name(),
+               sc_time_stamp().to_string(), n);
+  return n;
+}
+
+void Microcontroller::rewind(const size_t n) {
+  if (n >= nSnapshots()) {
+    throw std::out_of_range(std::string(this->name()) + ": no snapshot " +
+                            std::to_string(n));
+  }
+  forEachChild<GenericMemory>(this,
+                              [n](GenericMemory *m) { m->restoreSnapshot(n); });
+  forEachChild<Cache>(this, [](Cache *c) {
+    static_cast<BusTarget *>(c)->reset();  // Invalidate
+  });
+  const auto it = m_snapshotRegs.find(n);
+  if (it != m_snapshotRegs.end()) {
+    for (uint32_t i = 0; i < it->second.size(); ++i) {
+      dbgWriteReg(i, it->second[i]);
+    }
+  }
+  spdlog::info("{}: @{} rewound to snapshot {}", this->name(),
+               sc_time_stamp().to_string(), n);
+}
+
+size_t Microcontroller::nSnapshots() {
+  // Snapshot indices are shared between memories, so each must have taken
+  // the same number of snapshots
+  const GenericMemory *first = nullptr;
+  forEachChild<GenericMemory>(this, [this, &first](GenericMemory *m) {
+    if (first == nullptr) {
+      first = m;
+    } else if (m->nSnapshots() != first->nSnapshots()) {
+      throw std::logic_error(fmt::format(
+          "{}: {} has {} snapshots, but {} has {}", this->name(),
+          first->name(), first->nSnapshots(), m->name(), m->nSnapshots()));
+    }
+  });
+  return (first == nullptr) ? 0 : first->nSnapshots();
+}
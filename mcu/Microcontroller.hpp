@@ -7,7 +7,10 @@
 
 #pragma once
 #include <stdint.h>
+#include <functional>
+#include <map>
 #include <systemc>
+#include <vector>
 #include "ps/PowerModelChannelIf.hpp"
 
 /**
@@ -61,6 +64,19 @@ class Microcontroller : public sc_core::sc_module {
    **/
   virtual void reset() = 0;
 
+  /**
+   * @brief Register a function to be called once, after the next power-on
+   * reset of the CPU and before it executes its first instruction.
+   */
+  virtual void setPowerOnHook(std::function<void()> hook) = 0;
+
+  /**
+   * @brief Register a function to be called once, at the CPU's next
+   * instruction boundary, or once it has powered off (powered=false).
+   */
+  virtual void setInstructionBoundaryHook(
+      std::function<void(bool powered)> hook) = 0;
+
   /* ------ Interrogation functions ------ */
   /**
    * @brief dbgReadReg read the value of a CPU register
@@ -124,4 +140,32 @@ class Microcontroller : public sc_core::sc_module {
    * @brief stop simulation
    */
   virtual void kill() { sc_core::sc_stop(); };
+
+  /* ------ Snapshot functions (require MemorySnapshots) ------ */
+
+  /**
+   * @brief takeSnapshot take a copy-on-write snapshot of all memories and, if
+   * the CPU is powered, of its registers. Snapshots are also taken by the
+   * memories at every power failure.
+   * @retval index of the snapshot
+   */
+  virtual size_t takeSnapshot();
+
+  /**
+   * @brief rewind restore memories, and CPU registers if they were saved, to
+   * snapshot n. Caches are invalidated. Should be called while the CPU is
+   * stalled.
+   */
+  virtual void rewind(const size_t n);
+
+  /**
+   * @brief nSnapshots number of snapshots that can be rewound to. Throws
+   * std::logic_error if the memories have taken different numbers of
+   * snapshots, e.g. because they are powered separately.
+   */
+  size_t nSnapshots();
+
+ private:
+  //! CPU registers of snapshots taken while powered
+  std::map<size_t, std::vector<uint32_t>> m_snapshotRegs;
 };
@@ -114,6 +114,23 @@ class Msp430Microcontroller : public Microcontroller {
    */
   virtual void unstall(void) override { m_cpu.unstall(); }
 
+  /**
+   * @brief Register a function to be called once the CPU has taken the next
+   * power-on reset interrupt
+   */
+  virtual void setPowerOnHook(std::function<void()> hook) override {
+    m_cpu.setPowerOnHook(std::move(hook));
+  }
+
+  /**
+   * @brief Register a function to be called once at the next instruction
+   * boundary
+   */
+  virtual void setInstructionBoundaryHook(
+      std::function<void(bool powered)> hook) override {
+    m_cpu.setInstructionBoundaryHook(std::move(hook));
+  }
+
   /**
    * @brief Check if CPU is stalled
    * @param true if CPU stalled, false otherwise
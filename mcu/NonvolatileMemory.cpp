@@ -5,39 +5,152 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
 #include <algorithm>
+#include <fstream>
 #include <iterator>
+#include <string>
+#include "libs/make_unique.hpp"
 #include "mcu/NonvolatileMemory.hpp"
+#include "ps/ConstantEnergyEvent.hpp"
 #include "utilities/Config.hpp"
+#include "utilities/Utilities.hpp"
 
 using namespace sc_core;
 
 NonvolatileMemory::NonvolatileMemory(sc_module_name name, unsigned startAddress,
                                      unsigned endAddress)
-    : GenericMemory(name, startAddress, endAddress) {}
+    : GenericMemory(name, startAddress, endAddress) {
+  SC_METHOD(waitStatesChanged);
+  sensitive << waitStates;
+  dont_initialize();
+
+  // Config
+  const std::string strname = this->name();
+  const auto &config = Config::get();
+  if (config.contains(strname + ".NvmWriteEnergyModel")) {
+    const auto model = config.getString(strname + ".NvmWriteEnergyModel");
+    if (model == "BitFlips") {
+      m_writeModel = WriteEnergyModel::BIT_FLIPS;
+      m_writeModelEvent = "bits flipped";
+    } else if (model == "SetBits") {
+      m_writeModel = WriteEnergyModel::SET_BITS;
+      m_writeModelEvent = "bits set";
+    } else if (model == "Lines") {
+      m_writeModel = WriteEnergyModel::LINES;
+      m_writeModelEvent = "lines written";
+    } else if (model != "Bytes" && model != "none") {
+      spdlog::error("{}: unknown NvmWriteEnergyModel {}", strname, model);
+      SC_REPORT_ERROR(this->name(), "Invalid write energy model.");
+    }
+  }
+  // The event energy would otherwise silently default to 0
+  if (!m_writeModelEvent.empty() &&
+      !config.contains(strname + " " + m_writeModelEvent)) {
+    spdlog::error("{}: NvmWriteEnergyModel needs \"{} {}\" to be set", strname,
+                  strname, m_writeModelEvent);
+    SC_REPORT_ERROR(this->name(), "Missing write energy model energy.");
+  }
+  if (config.contains(strname + ".NvmWriteLineWidth") &&
+      config.getString(strname + ".NvmWriteLineWidth") != "none") {
+    m_lineWidth = config.getUint(strname + ".NvmWriteLineWidth");
+    if (m_lineWidth == 0) {
+      SC_REPORT_ERROR(this->name(), "NvmWriteLineWidth must be > 0.");
+    }
+  }
+  if (config.contains(strname + ".NvmWearPageSize") &&
+      config.getString(strname + ".NvmWearPageSize") != "none") {
+    m_wearPageSize = config.getUint(strname + ".NvmWearPageSize");
+    if (m_wearPageSize == 0) {
+      SC_REPORT_ERROR(this->name(), "NvmWearPageSize must be > 0.");
+    }
+  }
+  if (m_wearPageSize) {
+    m_wear.assign((m_capacity + m_wearPageSize - 1) / m_wearPageSize, 0);
+  }
+}
+
+void NonvolatileMemory::end_of_elaboration() {
+  GenericMemory::end_of_elaboration();
+
+  if (!m_writeModelEvent.empty()) {
+    m_writeModelEventId = powerModelPort->registerEvent(
+        this->name(), std::make_unique<ConstantEnergyEvent>(
+                          this->name(), m_writeModelEvent));
+  }
+}
 
 void NonvolatileMemory::b_transport(tlm::tlm_generic_payload &trans,
                                     sc_time &delay) {
+  if (tracksWrites() && (trans.get_command() == tlm::TLM_WRITE_COMMAND)) {
+    reportWrite(trans.get_address(), trans.get_data_ptr(),
+                trans.get_data_length());
+  }
   sc_time dummyDelay = sc_time(0, SC_NS);  // ignore GenericMemory's delay
   GenericMemory::b_transport(trans, dummyDelay);
   delay += waitStates.read() * systemClk->getPeriod();
 }
 
-unsigned int NonvolatileMemory::countSetBitsArray(const uint8_t *arr,
-                                                  const size_t N) {
-  unsigned res = 0;
-  for (size_t i = 0; i < N; i++) {
-    res += countSetBits(arr[i]);
+bool NonvolatileMemory::get_direct_mem_ptr(tlm::tlm_generic_payload &trans,
+                                           tlm::tlm_dmi &dmi) {
+  const bool granted = GenericMemory::get_direct_mem_ptr(trans, dmi);
+  if (granted && tracksWrites()) {
+    dmi.allow_read();
+  }
+  dmi.set_read_latency(waitStates.read() * systemClk->getPeriod());
+  dmi.set_write_latency(waitStates.read() * systemClk->getPeriod());
+  return granted;
+}
+
+void NonvolatileMemory::reportWrite(const size_t addr,
+                                    const uint8_t *const data,
+                                    const size_t len) {
+  if (len == 0) {
+    return;
+  }
+
+  switch (m_writeModel) {
+    case WriteEnergyModel::BIT_FLIPS:
+      powerModelPort->reportEvent(
+          m_writeModelEventId, Utility::countBitFlips(&mem[addr], data, len));
+      break;
+    case WriteEnergyModel::SET_BITS:
+      powerModelPort->reportEvent(m_writeModelEventId,
+                                  Utility::countSetBits(data, len));
+      break;
+    case WriteEnergyModel::LINES:
+      powerModelPort->reportEvent(
+          m_writeModelEventId,
+          (addr + len - 1) / m_lineWidth - addr / m_lineWidth + 1);
+      break;
+    default:
+      break;
+  }
+
+  if (!m_wear.empty()) {
+    const size_t last = (addr + len - 1) / m_wearPageSize;
+    for (size_t p = addr / m_wearPageSize; p <= last; ++p) {
+      m_wear[p]++;
+    }
   }
-  return res;
 }
 
-// Kernighan's Algorithm
-unsigned int NonvolatileMemory::countSetBits(uint64_t n) {
-  unsigned int count = 0;
-  while (n) {
-    n &= (n - 1);
-    count++;
+void NonvolatileMemory::end_of_simulation() {
+  if (m_wear.empty()) {
+    return;
+  }
+  const auto fileName = fmt::format("{}/{}.wear.csv",
+                                    Config::get().getString("OutputDirectory"),
+                                    this->name());
+  std::ofstream csv(fileName);
+  csv << "page,address,writes\n";
+  for (size_t p = 0; p < m_wear.size(); p++) {
+    csv << fmt::format("{},0x{:08x},{}\n", p,
+                       startAddress() + p * m_wearPageSize, m_wear[p]);
   }
-  return count;
+  const auto worst = std::max_element(m_wear.begin(), m_wear.end());
+  spdlog::info("{}: wear counters written to {}, most written page: {} ({})",
+               this->name(), fileName, std::distance(m_wear.begin(), worst),
+               *worst);
 }
@@ -11,14 +11,26 @@
 #include <iostream>
 #include <list>
 #include <string>
+#include <vector>
 #include "mcu/GenericMemory.hpp"
 #include "utilities/Config.hpp"
 
 class NonvolatileMemory : public GenericMemory {
+  SC_HAS_PROCESS(NonvolatileMemory);
+
  public:
   /* ------ Ports ------ */
   sc_core::sc_in<unsigned int> waitStates{"waitStates"};
 
+  /* ------ Types ------ */
+  //! Data-dependent write energy models, see <name>.NvmWriteEnergyModel
+  enum class WriteEnergyModel {
+    BYTES,      //!< Only "bytes written" (default)
+    BIT_FLIPS,  //!< "bits flipped": bits that change value
+    SET_BITS,   //!< "bits set": bits written as 1
+    LINES,      //!< "lines written": lines touched by a write
+  };
+
   /* ------ Public methods ------ */
   /**
    * @brief NonvolatileMemory constructor
@@ -35,11 +47,58 @@ class NonvolatileMemory : public GenericMemory {
   virtual void b_transport(tlm::tlm_generic_payload &trans,
                            sc_core::sc_time &delay) override;
 
+  /**
+   * @brief get_direct_mem_ptr Overridden to set the DMI latency according to
+   * wait states. Only read DMI is granted while writes are tracked by a
+   * data-dependent write energy model or wear counters.
+   * @param trans
+   * @param dmi DMI descriptor
+   * @return true if DMI was granted.
+   */
+  virtual bool get_direct_mem_ptr(tlm::tlm_generic_payload &trans,
+                                  tlm::tlm_dmi &dmi) override;
+
+  /**
+   * @brief SystemC callback, used here to register the event of the write
+   * energy model.
+   */
+  virtual void end_of_elaboration() override;
+
+  /**
+   * @brief end_of_simulation write the wear counters to
+   * <OutputDirectory>/<name>.wear.csv
+   */
+  virtual void end_of_simulation() override;
+
+  //! Number of write transactions to each page, empty if wear is not tracked
+  const std::vector<uint64_t> &wearCounters() const { return m_wear; }
+
  private:
-  /* ------ Constants ------ */
-  /* ------ Types ------ */
   /* ------ Private variables ------ */
+  WriteEnergyModel m_writeModel{WriteEnergyModel::BYTES};
+  unsigned m_lineWidth{8};       //! Write line width (bytes)
+  unsigned m_wearPageSize{0};    //! Wear tracking granularity (bytes)
+  std::vector<uint64_t> m_wear;  //! Write transactions per page
+  std::string m_writeModelEvent;  //! Event of the write energy model
+  int m_writeModelEventId{-1};
+
   /* ------- Private methods ------ */
-  unsigned int countSetBits(uint64_t n);
-  unsigned int countSetBitsArray(const uint8_t *arr, const size_t N);
+  /**
+   * @brief waitStatesChanged Invalidate DMI pointers, as their latency is no
+   * longer correct.
+   */
+  void waitStatesChanged() { invalidateDmi(); }
+
+  //! Whether writes must go through b_transport
+  bool tracksWrites() const {
+    return (m_writeModel != WriteEnergyModel::BYTES) || !m_wear.empty();
+  }
+
+  /**
+   * @brief reportWrite report the write energy model event and update the
+   * wear counters for a write of data to [addr, addr + len), before mem is
+   * overwritten.
+   */
+  void reportWrite(const size_t addr, const uint8_t *const data,
+                   const size_t len);
 };
@@ -6,10 +6,16 @@
  */
 
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include "mcu/RegisterFile.hpp"
+#include "utilities/Checkpoint.hpp"
 #include "utilities/Utilities.hpp"
 
+const size_t RegisterFile::MAX_SPAN;
+const int RegisterFile::NONE;
+
 bool RegisterFile::testBit(const size_t addr, const size_t n) const {
   assert(n < TARGET_WORD_SIZE * 8);
   return ((read(addr) & (1u << n)) > 0);
@@ -24,39 +30,24 @@ void RegisterFile::setBit(const size_t address, const unsigned bit,
                           const bool force) {
   assert(bit < TARGET_WORD_SIZE * 8);
   auto &r = find(address);
-  assert(r.access == AccessMode::WRITE || r.access == AccessMode::READ_WRITE ||
-         force);
-  write(address, read(address) | (1u << bit), force);
+  write(r, r.val | (1u << bit), force);
 }
 
 void RegisterFile::setBitMask(const size_t address, const uint32_t mask,
                               const bool force) {
-  write(address, read(address) | mask, force);
+  auto &r = find(address);
+  write(r, r.val | mask, force);
 }
 
 void RegisterFile::clearBitMask(const size_t address, const uint32_t mask,
                                 const bool force) {
-  write(address, read(address) & (~mask), force);
+  auto &r = find(address);
+  write(r, r.val & (~mask), force);
 }
 
 void RegisterFile::write(const size_t address, const uint32_t value,
                          const bool force) {
-  auto rit = std::find_if(
-      m_regs.begin(), m_regs.end(),
-      [address](RegisterFile::Register &r) { return r.addr == address; });
-  if (rit == m_regs.end()) {
-    spdlog::error("RegisterFile::write Address 0x{:08x} not found.", address);
-    exit(1);
-  }
-  auto &r = *rit;
-
-  assert(r.access == AccessMode::WRITE || r.access == AccessMode::READ_WRITE ||
-         force);
-  if (!force) {
-    r.val = (r.val & (~r.writeMask)) | (value & r.writeMask);
-  } else {
-    r.val = value;
-  }
+  write(find(address), value, force);
 }
 
 void RegisterFile::write(size_t address, uint8_t *buf, size_t len,
@@ -72,7 +63,7 @@ void RegisterFile::write(size_t address, uint8_t *buf, size_t len,
       uint32_t tmp = Utility::packBytes(buf, 4);
       tmp = Utility::ttohl(tmp);
 
-      write(address, tmp, force);
+      write(find(address), tmp, force);
       len -= 4;
       buf += 4;
       address += 4;
@@ -82,7 +73,7 @@ void RegisterFile::write(size_t address, uint8_t *buf, size_t len,
       uint32_t tmp = Utility::packBytes(buf, 2);
       tmp = Utility::ttohs(tmp);
 
-      write(address, tmp, force);
+      write(find(address), tmp, force);
       len -= 2;
       buf += 2;
       address += 2;
@@ -131,51 +122,77 @@ void RegisterFile::read(size_t address, uint8_t *buf, size_t len) const {
 void RegisterFile::writeByte(const size_t address, const uint8_t value,
                              const bool force) {
   size_t ofs = address % TARGET_WORD_SIZE;
-  size_t addrAligned = address - ofs;
-  uint32_t tmp = read(addrAligned);
+  auto &r = find(address - ofs);
+  assert(r.access == AccessMode::READ || r.access == AccessMode::READ_WRITE);
+  uint32_t tmp = r.val;
   reinterpret_cast<uint8_t *>(&tmp)[ofs] = value;
-  write(addrAligned, tmp, force);
+  write(r, tmp, force);
 }
 
 uint8_t RegisterFile::readByte(const size_t address) const {
   size_t ofs = address % TARGET_WORD_SIZE;
-  auto addrAligned = address - ofs;
-  const auto &r = find(addrAligned);
+  const auto &r = find(address - ofs);
   assert(r.access == AccessMode::READ || r.access == AccessMode::READ_WRITE);
   return reinterpret_cast<const uint8_t *>(&r.val)[ofs];
 }
 
 void RegisterFile::increment(const size_t address, const bool force) {
-  const auto &r = find(address);
+  auto &r = find(address);
   assert(r.access == AccessMode::READ_WRITE || force);
-  write(address, r.val + 1, force);
+  write(r, r.val + 1, force);
 }
 
 void RegisterFile::clearBit(const size_t address, const unsigned bit,
                             const bool force) {
   assert(bit < TARGET_WORD_SIZE * 8);
-  const auto &r = find(address);
-  assert(r.access == AccessMode::WRITE || r.access == AccessMode::READ_WRITE ||
-         force);
-  write(address, r.val & (~(1u << bit)), force);
-}
-
-const RegisterFile::Register &RegisterFile::find(const size_t address) const {
-  auto rit = std::find_if(
-      m_regs.begin(), m_regs.end(),
-      [address](const RegisterFile::Register &r) { return r.addr == address; });
-  if (rit == m_regs.end()) {
-    spdlog::error("RegisterFile::find Address 0x{:08x} not found.", address);
-    exit(1);  // to suppress warning
+  auto &r = find(address);
+  write(r, r.val & (~(1u << bit)), force);
+}
+
+void RegisterFile::index(const size_t i) {
+  const size_t addr = m_regs[i].addr;
+  if (m_index.empty()) {
+    m_base = addr;
+  } else if (addr < m_base) {
+    // Rebase: shift existing entries up
+    m_index.insert(m_index.begin(), m_base - addr, NONE);
+    m_base = addr;
+  }
+  const size_t ofs = addr - m_base;
+  if (ofs >= MAX_SPAN || m_index.size() > MAX_SPAN) {
+    spdlog::error(
+        "RegisterFile::addRegister Registers span more than 0x{:x} bytes "
+        "(0x{:08x}-0x{:08x}).",
+        MAX_SPAN, m_base, m_base + std::max(ofs, m_index.size() - 1));
+    exit(1);
+  }
+  if (ofs >= m_index.size()) {
+    m_index.resize(ofs + 1, NONE);
+  }
+  if (m_index[ofs] == NONE) {  // First register wins, as with a linear search
+    m_index[ofs] = i;
+  }
+}
+
+void RegisterFile::notFound(const size_t address) {
+  spdlog::error("RegisterFile::find Address 0x{:08x} not found.", address);
+  exit(1);
+}
+
+void RegisterFile::saveState(CheckpointOut &out) const {
+  out.put<uint32_t>(m_regs.size());
+  for (const auto &r : m_regs) {
+    out.put<uint32_t>(r.val);
   }
-  return *rit;
 }
 
-bool RegisterFile::contains(unsigned address) const {
-  auto rit = std::find_if(
-      m_regs.begin(), m_regs.end(),
-      [address](const RegisterFile::Register &r) { return r.addr == address; });
-  return (rit != m_regs.end());
+void RegisterFile::restoreState(CheckpointIn &in) {
+  if (in.get<uint32_t>() != m_regs.size()) {
+    throw std::runtime_error("RegisterFile: checkpoint size mismatch");
+  }
+  for (auto &r : m_regs) {
+    r.val = in.get<uint32_t>();
+  }
 }
 
 std::ostream &operator<<(std::ostream &os, const RegisterFile &rhs) {
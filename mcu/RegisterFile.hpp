@@ -7,10 +7,14 @@
 
 #pragma once
 
+#include <assert.h>
 #include <stdint.h>
 #include <iostream>
 #include <vector>
 
+class CheckpointOut;
+class CheckpointIn;
+
 /**
  * @brief The RegisterFile class Convenience class to implement register files
  * for peripherals as signals with access type attribute and
@@ -21,6 +25,10 @@
  * flipped in the b_transport method. Take care to use htotl/htots if writing to
  * or reading from the bus
  *
+ * Registers are looked up through a dense table indexed by (address - lowest
+ * register address), so every access is O(1) regardless of the number of
+ * registers. Access mode checks are asserts, i.e. compiled out of release
+ * builds.
  */
 class RegisterFile {
  public:
@@ -73,6 +81,7 @@ class RegisterFile {
                    const AccessMode access = AccessMode::READ_WRITE,
                    const uint32_t writeMask = 0xffffffff) {
     m_regs.emplace_back(Register(address, resetValue, access, writeMask));
+    index(m_regs.size() - 1);
   }
 
   /**
@@ -193,7 +202,20 @@ class RegisterFile {
    * @param address register address
    * @retval true if a register with the address is found, false otherwise.
    */
-  bool contains(unsigned address) const;
+  bool contains(unsigned address) const {
+    return (address >= m_base) && (address - m_base < m_index.size()) &&
+           (m_index[address - m_base] != NONE);
+  }
+
+  /**
+   * @brief saveState append all register values to a checkpoint.
+   */
+  void saveState(CheckpointOut &out) const;
+
+  /**
+   * @brief restoreState restore register values saved by saveState.
+   */
+  void restoreState(CheckpointIn &in);
 
   /**
    * @brief << debug printout.
@@ -201,13 +223,47 @@ class RegisterFile {
   friend std::ostream &operator<<(std::ostream &os, const RegisterFile &rhs);
 
  private:
+  //! Largest address range spanned by the registers of a register file
+  static const size_t MAX_SPAN = 1u << 16;
+  //! Index table entry of addresses without a register
+  static const int NONE = -1;
+
   /**
-   * @brief find find a register by address
+   * @brief find find a register by address. Exits if there is none.
    * @param address
    * @return register
    */
-  const Register &find(const size_t address) const;
+  const Register &find(const size_t address) const {
+    if (!contains(address)) {
+      notFound(address);
+    }
+    return m_regs[m_index[address - m_base]];
+  }
+  Register &find(const size_t address) {
+    return const_cast<Register &>(
+        static_cast<const RegisterFile *>(this)->find(address));
+  }
+
+  /**
+   * @brief write write value to register r, honouring its write mask unless
+   * force is set.
+   */
+  static void write(Register &r, const uint32_t value, const bool force) {
+    assert(r.access == AccessMode::WRITE ||
+           r.access == AccessMode::READ_WRITE || force);
+    r.val = force ? value : (r.val & ~r.writeMask) | (value & r.writeMask);
+  }
+
+  /**
+   * @brief index add register i to the index table, growing the table (and
+   * rebasing it if the register is below all others) as needed.
+   */
+  void index(const size_t i);
+
+  [[noreturn]] static void notFound(const size_t address);
 
   /* ------ Private variables ------ */
   std::vector<Register> m_regs;  //! Registers
+  size_t m_base{0};              //! Address of m_index[0]
+  std::vector<int> m_index;      //! Register index by address - m_base
 };
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include "mcu/ShadowCache.hpp"
+#include "utilities/Config.hpp"
+
+ShadowCache::ShadowCache(const std::string &cacheName,
+                         const SweepRunner::KeyValues &params) {
+  // Start from the real cache's configuration
+  auto &config = Config::get();
+  std::map<std::string, std::string> p;
+  for (const auto &key :
+       {"CacheNSets", "CacheNLines", "CacheLineWidth",
+        "CacheReplacementPolicy", "CacheWritePolicy"}) {
+    p[key] = config.getString(cacheName + "." + key);
+  }
+  p["MemoryReadEnergy"] = "0.0";
+  p["MemoryWriteEnergy"] = "0.0";
+  for (const auto &kv : params) {
+    if (p.find(kv.first) == p.end()) {
+      throw std::invalid_argument("unknown shadow cache parameter " +
+                                  kv.first);
+    }
+    p[kv.first] = kv.second;
+  }
+
+  const Config::Value nSets(p["CacheNSets"]);
+  const Config::Value nLines(p["CacheNLines"]);
+  const Config::Value lineWidth(p["CacheLineWidth"]);
+  const Config::Value readEnergy(p["MemoryReadEnergy"]);
+  const Config::Value writeEnergy(p["MemoryWriteEnergy"]);
+  const auto powerOfTwo = [](const Config::Value &v) {
+    return v.is(Config::Type::UINT) && v.asUint() > 0 &&
+           (v.asUint() & (v.asUint() - 1)) == 0;
+  };
+  if (!powerOfTwo(nSets) || !powerOfTwo(lineWidth) ||
+      !nLines.is(Config::Type::UINT) || nLines.asUint() == 0) {
+    throw std::invalid_argument(
+        "invalid shadow cache geometry " + p["CacheNSets"] + " sets x " +
+        p["CacheNLines"] + " lines x " + p["CacheLineWidth"] + " bytes");
+  }
+  m_lineWidth = lineWidth.asUint();
+  m_nOffsetBits = static_cast<unsigned>(log2(m_lineWidth));
+  m_nIdBits = static_cast<unsigned>(log2(nSets.asUint()));
+  m_idMask = (nSets.asUint() - 1) << m_nOffsetBits;
+
+  const auto &wp = p["CacheWritePolicy"];
+  if (wp == "WriteThrough") {
+    m_writePolicy = WP_WRITE_THROUGH;
+  } else if (wp == "WriteAround") {
+    m_writePolicy = WP_WRITE_AROUND;
+  } else if (wp == "WriteBack") {
+    m_writePolicy = WP_WRITE_BACK;
+  } else {
+    throw std::invalid_argument("invalid write policy " + wp);
+  }
+
+  m_lines = CacheTags(nSets.asUint(), nLines.asUint(),
+                      p["CacheReplacementPolicy"]);
+
+  m_memoryReadEnergy = readEnergy.asDouble();
+  m_memoryWriteEnergy = writeEnergy.asDouble();
+  const auto eventEnergy = [&](const std::string &event) {
+    return config.getDouble(cacheName + " " + event, 0.0);
+  };
+  m_cacheEnergy.read = eventEnergy("read");
+  m_cacheEnergy.write = eventEnergy("write");
+  m_cacheEnergy.readHit = eventEnergy("read hit");
+  m_cacheEnergy.readMiss = eventEnergy("read miss");
+  m_cacheEnergy.writeHit = eventEnergy("write hit");
+  m_cacheEnergy.writeMiss = eventEnergy("write miss");
+  m_cacheEnergy.byteRead = eventEnergy("bytes read");
+  m_cacheEnergy.byteWritten = eventEnergy("bytes written");
+}
+
+void ShadowCache::access(const unsigned addr, const unsigned len,
+                         const bool isWrite) {
+  const unsigned set = (addr & m_idMask) >> m_nOffsetBits;
+  const unsigned tag = addr >> (m_nOffsetBits + m_nIdBits);
+  bool hit;
+  const unsigned line = m_lines.lookup(set, tag, hit);
+
+  // Same behaviour as Cache::b_transport
+  if (!isWrite) {
+    m_stats.bytesRead += len;
+    if (hit) {
+      m_stats.readHits++;
+    } else {
+      m_stats.readMisses++;
+      fill(line, tag);
+    }
+    return;
+  }
+
+  m_stats.bytesWritten += len;
+  if (hit) {
+    m_stats.writeHits++;
+  } else {
+    m_stats.writeMisses++;
+  }
+  switch (m_writePolicy) {
+    case WP_WRITE_AROUND:  // Update memory only
+      m_stats.memoryBytesWritten += len;
+      if (hit) {
+        m_lines.valid[line] = false;
+      }
+      break;
+    case WP_WRITE_THROUGH:  // Update cache line & memory
+      if (!hit) {
+        fill(line, tag);
+      }
+      m_stats.memoryBytesWritten += len;
+      break;
+    case WP_WRITE_BACK:  // Update cache line only
+      if (!hit) {
+        fill(line, tag);
+      }
+      m_lines.dirty[line] = true;
+      break;
+  }
+}
+
+void ShadowCache::fill(const unsigned line, const unsigned tag) {
+  if (m_lines.valid[line] && m_lines.dirty[line]) {
+    m_stats.writebacks++;
+    m_stats.memoryBytesWritten += m_lineWidth;
+  }
+  m_stats.memoryBytesRead += m_lineWidth;
+  m_lines.tags[line] = tag;
+  m_lines.valid[line] = true;
+  m_lines.dirty[line] = false;
+}
+
+double ShadowCache::energy() const {
+  const auto &s = m_stats;
+  const auto &e = m_cacheEnergy;
+  return (s.readHits + s.readMisses) * e.read +
+         (s.writeHits + s.writeMisses) * e.write + s.readHits * e.readHit +
+         s.readMisses * e.readMiss + s.writeHits * e.writeHit +
+         s.writeMisses * e.writeMiss + s.bytesRead * e.byteRead +
+         s.bytesWritten * e.byteWritten +
+         s.memoryBytesRead * m_memoryReadEnergy +
+         s.memoryBytesWritten * m_memoryWriteEnergy;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include "mcu/CacheTags.hpp"
+#include "utilities/SweepRunner.hpp"
+
+/**
+ * @brief ShadowCache Tag-only model of a cache configuration, fed with the
+ * access stream of a real cache (see Cache) to estimate hits, misses,
+ * writebacks and energy of other configurations in the same simulation. A
+ * shadow cache has no effect on timing or data.
+ */
+class ShadowCache {
+ public:
+  //! Access counters
+  struct Stats {
+    uint64_t readHits{0};
+    uint64_t readMisses{0};
+    uint64_t writeHits{0};
+    uint64_t writeMisses{0};
+    uint64_t bytesRead{0};
+    uint64_t bytesWritten{0};
+    uint64_t writebacks{0};          //! Dirty lines written back
+    uint64_t memoryBytesRead{0};     //! Line fills
+    uint64_t memoryBytesWritten{0};  //! Writebacks & written-through data
+  };
+
+  /**
+   * @brief ShadowCache constructor. Throws std::invalid_argument if a
+   * parameter is unknown or invalid.
+   * @param cacheName name of the real cache. Parameters not in params, and
+   * the energies of cache events, are read from its config keys.
+   * @param params configuration of this shadow cache, any of CacheNSets,
+   * CacheNLines, CacheLineWidth, CacheReplacementPolicy, CacheWritePolicy,
+   * MemoryReadEnergy and MemoryWriteEnergy (J per byte accessed in memory).
+   */
+  ShadowCache(const std::string &cacheName,
+              const SweepRunner::KeyValues &params);
+
+  /**
+   * @brief access simulate an access.
+   * @param addr address
+   * @param len number of bytes accessed
+   * @param isWrite true for writes, false for reads
+   */
+  void access(const unsigned addr, const unsigned len, const bool isWrite);
+
+  /**
+   * @brief reset invalidate all lines (power loss). Counters are kept.
+   */
+  void reset() { m_lines.reset(); }
+
+  const Stats &stats() const { return m_stats; }
+
+  /**
+   * @brief energy estimated dynamic energy (J) of the cache and memory
+   * accesses so far.
+   */
+  double energy() const;
+
+ private:
+  enum WritePolicy { WP_WRITE_THROUGH, WP_WRITE_AROUND, WP_WRITE_BACK };
+
+  /* ------ Private variables ------ */
+  unsigned m_lineWidth;
+  unsigned m_nOffsetBits;
+  unsigned m_nIdBits;
+  unsigned m_idMask;
+  WritePolicy m_writePolicy;
+  CacheTags m_lines;
+  Stats m_stats;
+
+  //! Energy of cache events (J), from the real cache's config
+  struct {
+    double read, write, readHit, readMiss, writeHit, writeMiss;
+    double byteRead, byteWritten;
+  } m_cacheEnergy;
+  double m_memoryReadEnergy{0.0};   //! J per byte read from memory
+  double m_memoryWriteEnergy{0.0};  //! J per byte written to memory
+
+  /**
+   * @brief fill fetch a line from memory, writing back the victim if dirty.
+   */
+  void fill(const unsigned line, const unsigned tag);
+};
@@ -35,6 +35,7 @@ class VolatileMemory : public GenericMemory {
       for (unsigned int i = 0; i < m_capacity; i++) {
         mem[i] = 0xAA;
       }
+      markDirty(0, m_capacity);
     }
   }
 };
@@ -11,7 +11,9 @@
 #include "mcu/cortex-m0/CortexM0Cpu.hpp"
 #include "ps/ConstantCurrentState.hpp"
 #include "ps/ConstantEnergyEvent.hpp"
+#include "utilities/Config.hpp"
 #include "utilities/Utilities.hpp"
+#include <algorithm>
 #include <chrono>
 #include <spdlog/spdlog.h>
 #include <systemc>
@@ -20,21 +22,19 @@
 
 using namespace sc_core;
 
-struct CPU cpu;
-
-CortexM0Cpu *m_ctx =
-    nullptr; //! Simulation context used for hooking callbacks into thumbulator
-
 CortexM0Cpu::CortexM0Cpu(const sc_module_name nm) : sc_module(nm) {
   iSocket.bind(*this);
-  m_ctx = this;
 
   // Register callbacks for reads & writes by emulator
-  cpu_set_write_memory_cb(&CortexM0Cpu::write_cb);
-  cpu_set_read_memory_cb(&CortexM0Cpu::read_cb);
-  cpu_set_consume_cycles_cb(&CortexM0Cpu::consume_cycles_cb);
-  cpu_set_exception_return_cb(&CortexM0Cpu::exception_return_cb);
-  cpu_set_next_pipeline_instr_cb(&CortexM0Cpu::next_pipeline_instr_cb);
+  cpu_set_callback_context(cpu, this);
+  cpu_set_write_memory_cb(cpu, &CortexM0Cpu::write_cb);
+  cpu_set_read_memory_cb(cpu, &CortexM0Cpu::read_cb);
+  cpu_set_consume_cycles_cb(cpu, &CortexM0Cpu::consume_cycles_cb);
+  cpu_set_exception_return_cb(cpu, &CortexM0Cpu::exception_return_cb);
+  cpu_set_next_pipeline_instr_cb(cpu, &CortexM0Cpu::next_pipeline_instr_cb);
+
+  // One predecoded entry per halfword of program memory
+  m_predecoded.resize(ROM_SIZE / 2);
 
   // Set number of pipeline stages
   const auto cm0Version = Config::get().getString("CortexM0Version");
@@ -48,8 +48,23 @@ CortexM0Cpu::CortexM0Cpu(const sc_module_name nm) : sc_module(nm) {
         "Invalid config for CortexM0Version, must be one of {cm0, cm0+}.");
   }
 
-  // Construct & init cpu
-  memset(&cpu, 0, sizeof(struct CPU));
+  // Loosely-timed (temporally decoupled) execution
+  m_temporalDecoupling = Config::get().contains("TemporalDecoupling") &&
+                         Config::get().getBool("TemporalDecoupling");
+  if (m_temporalDecoupling) {
+    tlm_utils::tlm_quantumkeeper::set_global_quantum(
+        sc_time::from_seconds(Config::get().getDouble("GlobalQuantum")));
+    m_qk.reset();
+  }
+
+  // Account for idle cycles while sleeping, blocking on wake-up sources
+  m_idleFastForward = Config::get().contains("IdleFastForward") &&
+                      Config::get().getBool("IdleFastForward");
+  if (m_idleFastForward) {
+    m_idleSyncPeriod = sc_time::from_seconds(
+        std::min(Config::get().getDouble("LogTimestep"),
+                 Config::get().getDouble("PowerModelTimestep")));
+  }
 }
 
 void CortexM0Cpu::end_of_elaboration() {
@@ -82,13 +97,18 @@ void CortexM0Cpu::process() {
   wait(SC_ZERO_TIME); // Wait for start of simulation
 
   // Initialize CPU state
-  cpu.debug = 1;
+  cpu->debug = 1;
 
   // Execute the program
   while (true) {
     if (pwrOn.read() && m_run) {
       uint16_t insn;
 
+      // Instruction boundary: the registers are consistent with memory
+      if (m_boundaryHook) {
+        runBoundaryHook(/*powered=*/true);
+      }
+
       if ((cpu_get_pc() & 0x1) == 0) {
         spdlog::error("PC moved out of thumb mode: 0x{:08x}", cpu_get_pc());
         SC_REPORT_FATAL(this->name(), "PC moved out of thumb mode");
@@ -99,12 +119,19 @@ void CortexM0Cpu::process() {
       returningException.write(0);
 
       if (m_sleeping) {
-        wait(sysTickIrq.value_changed_event() | nvicIrq.value_changed_event() |
-             pwrOn.default_event());
+        if (m_idleFastForward) {
+          idle();
+        } else {
+          syncTime();
+          wait(sysTickIrq.value_changed_event() |
+               nvicIrq.value_changed_event() | pwrOn.default_event() |
+               m_boundaryHookSet);
+        }
       } else {
         // Handle breakpoints
         if (m_bubbles == 0 && m_breakpoints.count(getNextExecutionPc())) {
           // Hit breakpoint
+          syncTime();
           spdlog::info("@{:10s}: Breakpoint hit (0x{:08x})",
                        sc_core::sc_time_stamp().to_string(),
                        getNextExecutionPc());
@@ -120,37 +147,79 @@ void CortexM0Cpu::process() {
         insn = m_instructionQueue.front();
         m_instructionQueue.pop_front();
 
+        // Look up predecoded instruction (pipeline bubbles are not cached)
+        auto *const p =
+            (m_bubbles == 0) ? predecoded(getNextExecutionPc(), insn) : nullptr;
+
         // CM0+ appears to increment PC before execute
         if (m_pipelineStages == 2) {
           cpu_set_pc(cpu_get_pc() + 0x2);
         }
 
+        // Trace retired instructions (pipeline bubbles are not retired)
+        const bool traced =
+            (m_tracer != nullptr) && (m_bubbles == 0) &&
+            m_tracer->instruction(m_qk.get_current_time().value(),
+                                  getNextExecutionPc(), insn,
+                                  ((insn >> 11) >= 0x1d) ? 4 : 2);
+        if ((m_profiler != nullptr) && (m_bubbles == 0)) {
+          // Loosely-timed DMI accesses are only reported on sync, so report
+          // them now for their energy to go to the previous instruction
+          m_dmi.flush();
+          m_profiler->instruction(getNextExecutionPc(),
+                                  m_qk.get_current_time().value(),
+                                  clk->getPeriod().value());
+        }
+        if (traced && m_tracer->tracesRegisters()) {
+          std::copy(std::begin(cpu->gpr), std::end(cpu->gpr),
+                    m_tracedRegs.begin());
+        }
+
         // Decode & execute
-        takenBranch = 0;
-        decode(insn);
-        auto exCycles = exwbmem(insn);
+        cpu->takenBranch = 0;
+        size_t exCycles;
+        if (p != nullptr) {
+          cpu->insn = insn;
+          cpu->decoded = p->decoded;
+          exCycles = p->handler(cpu);
+        } else {
+          decode(cpu, insn);
+          exCycles = exwbmem(cpu, insn);
+        }
         if (exCycles > 0) {
           // Extra cycles spent for special instructions.
-          m_ctx->powerModelPort->reportEvent(m_ctx->m_idleCyclesEventId,
-                                             exCycles);
-          wait(clk->getPeriod() * exCycles);
+          powerModelPort->reportEvent(m_idleCyclesEventId, exCycles);
+          consumeTime(clk->getPeriod() * exCycles);
+        }
+
+        if (traced && m_tracer->tracesRegisters()) {
+          for (unsigned i = 0; i < N_GPR; ++i) {
+            if ((i != PC_REGNUM) && (cpu->gpr[i] != m_tracedRegs[i])) {
+              m_tracer->registerWrite(m_qk.get_current_time().value(), i,
+                                      cpu->gpr[i]);
+            }
+          }
         }
 
         if (insn == OPCODE_WFE || insn == OPCODE_WFI) {
           m_sleeping = true;
           powerModelPort->reportState(m_sleepStateId);
+          if (m_profiler != nullptr) {
+            m_dmi.flush();
+            m_profiler->sleep(m_qk.get_current_time().value());
+          }
         }
 
         if (m_bubbles > 0) {
           m_bubbles--;
         }
 
-        if (takenBranch) {
+        if (cpu->takenBranch) {
           flushPipeline();
         }
 
         // CM0 appears to increment pc after execute if no branches
-        if (!takenBranch && (m_pipelineStages == 3)) {
+        if (!cpu->takenBranch && (m_pipelineStages == 3)) {
           cpu_set_pc(cpu_get_pc() + 0x2);
         }
 
@@ -169,10 +238,23 @@ void CortexM0Cpu::process() {
     }
 
     if (m_run && (!pwrOn.read())) {
+      syncTime();
       powerModelPort->reportState(m_offStateId);
+      if (m_profiler != nullptr) {
+        m_profiler->powerOff(sc_time_stamp().value());
+      }
+      if (m_boundaryHook) {
+        runBoundaryHook(/*powered=*/false);
+      }
       wait(pwrOn.default_event()); // Wait for power
       powerModelPort->reportState(m_onStateId);
       reset(); // Reset CPU
+      if (m_powerOnHook) {
+        wait(SC_ZERO_TIME); // Let peripherals finish their power-on reset
+        const auto hook = std::move(m_powerOnHook);
+        m_powerOnHook = nullptr;
+        hook();
+      }
     }
   }
 }
@@ -188,39 +270,39 @@ void CortexM0Cpu::flushPipeline() {
 
 void CortexM0Cpu::reset() {
   m_sleeping = false;
-  takenBranch = false;
+  cpu->takenBranch = false;
   m_instructionBuffer.valid = 0;
   m_instructionBuffer.address = 0;
   m_instructionBuffer.data = 0;
 
   // Initialize the special-purpose registers
-  cpu.apsr = 0;       // No flags set
-  cpu.ipsr = 0;       // No exception number
-  cpu.espr = ESPR_T;  // Thumb mode
-  cpu.primask = 0;    // No except priority boosting
-  cpu.control = 0;    // Priv mode and main stack
-  cpu.sp_main = 0;    // Stack pointer for exception handling
-  cpu.sp_process = 0; // Stack pointer for process
+  cpu->apsr = 0;       // No flags set
+  cpu->ipsr = 0;       // No exception number
+  cpu->espr = ESPR_T;  // Thumb mode
+  cpu->primask = 0;    // No except priority boosting
+  cpu->control = 0;    // Priv mode and main stack
+  cpu->sp_main = 0;    // Stack pointer for exception handling
+  cpu->sp_process = 0; // Stack pointer for process
 
   // Clear the general purpose registers
-  memset(cpu.gpr, 0, sizeof(cpu.gpr));
+  memset(cpu->gpr, 0, sizeof(cpu->gpr));
 
   // Set the reserved GPRs
-  cpu.gpr[GPR_LR] = 0;
+  cpu->gpr[GPR_LR] = 0;
 
   // Load main stack pointer from the start of program memory
   uint32_t addr = ROM_START;
   cpu_set_sp(0xfffffffc & read32(addr));
-  cpu.sp_process = 0;
+  cpu->sp_process = 0;
 
   // Set the program counter to the address of the reset exception vector
   addr += 4;
   cpu_set_pc(read32(addr));
 
   // No pending exceptions
-  cpu.exceptmask = 0;
+  cpu->exceptmask = 0;
 
-  cpu.debug = 1;
+  cpu->debug = 1;
   cpu_mode_thread();
 
   // Initialize pipeline
@@ -242,6 +324,7 @@ void CortexM0Cpu::exceptionCheck() {
     exceptionId = nvicIrq.read();
   }
   if (exceptionId != 0) {
+    syncTime(); // Acknowledge the exception at the correct time
     spdlog::info("{}: @{:s} handling exception with ID {}", this->name(),
                  sc_time_stamp().to_string(), exceptionId);
     m_sleeping = false;
@@ -254,7 +337,7 @@ void CortexM0Cpu::exceptionEnter(const unsigned exceptionId) {
   const auto nextPc = getNextExecutionPc() | 1u; // |1u to add thumb bit
 
   // Save a snapshot of registers for checking correct irq handling
-  std::copy(std::begin(cpu.gpr), std::end(cpu.gpr),
+  std::copy(std::begin(cpu->gpr), std::end(cpu->gpr),
             std::begin(m_regsAtExceptEnter));
   m_regsAtExceptEnter[15] = nextPc; // Point to next valid instr.
   m_regsAtExceptEnter[16] = cpu_get_apsr();
@@ -302,6 +385,7 @@ void CortexM0Cpu::exceptionEnter(const unsigned exceptionId) {
 }
 
 void CortexM0Cpu::exceptionReturn(const uint32_t EXC_RETURN) {
+  syncTime(); // Signal the exception return at the correct time
   returningException.write(cpu_get_ipsr());
 
   // Return to the mode and stack that were active when the exception started
@@ -346,47 +430,48 @@ void CortexM0Cpu::exceptionReturn(const uint32_t EXC_RETURN) {
   // Set special-purpose registers
   cpu_set_apsr(cpu_get_apsr() & 0xF0000000); // Clear invalid bits
   cpu_set_ipsr(0);                           // Ignore epsr
-  takenBranch = 1;
+  cpu->takenBranch = 1;
   activeException.write(0);
 
   // Check correct state
   for (int i = 0; i < m_regsAtExceptEnter.size(); i++) {
-    if (cpu.gpr[i] != m_regsAtExceptEnter[i]) {
+    if (cpu->gpr[i] != m_regsAtExceptEnter[i]) {
       spdlog::error("{}:exceptionReturn r{} was not restored correctly: is "
                     "0x{:08x}, should be 0x{:08x}",
-                    this->name(), i, cpu.gpr[i], m_regsAtExceptEnter[i]);
+                    this->name(), i, cpu->gpr[i], m_regsAtExceptEnter[i]);
     }
   }
 }
 
-void CortexM0Cpu::read_cb(const uint32_t addr, uint8_t *const data,
+void CortexM0Cpu::read_cb(void *ctx, const uint32_t addr, uint8_t *const data,
                           const size_t bytelen) {
-  m_ctx->readMem(addr, data, bytelen);
+  static_cast<CortexM0Cpu *>(ctx)->readMem(addr, data, bytelen);
 }
 
-void CortexM0Cpu::write_cb(const uint32_t addr, uint8_t *const data,
+void CortexM0Cpu::write_cb(void *ctx, const uint32_t addr, uint8_t *const data,
                            const size_t bytelen) {
-  m_ctx->writeMem(addr, data, bytelen);
+  static_cast<CortexM0Cpu *>(ctx)->writeMem(addr, data, bytelen);
 }
 
-void CortexM0Cpu::consume_cycles_cb(const size_t n) {
-  sc_time delay = n * m_ctx->clk->getPeriod();
-  m_ctx->wait(delay);
-  m_ctx->powerModelPort->reportEvent(m_ctx->m_idleCyclesEventId);
+void CortexM0Cpu::consume_cycles_cb(void *ctx, const size_t n) {
+  auto *self = static_cast<CortexM0Cpu *>(ctx);
+  sc_time delay = n * self->clk->getPeriod();
+  self->consumeTime(delay);
+  self->powerModelPort->reportEvent(self->m_idleCyclesEventId);
 }
 
-void CortexM0Cpu::exception_return_cb(const uint32_t EXC_RETURN) {
-  m_ctx->exceptionReturn(EXC_RETURN);
+void CortexM0Cpu::exception_return_cb(void *ctx, const uint32_t EXC_RETURN) {
+  static_cast<CortexM0Cpu *>(ctx)->exceptionReturn(EXC_RETURN);
 }
 
-uint16_t CortexM0Cpu::next_pipeline_instr_cb() {
-  return m_ctx->getNextPipelineInstr();
+uint16_t CortexM0Cpu::next_pipeline_instr_cb(void *ctx) {
+  return static_cast<CortexM0Cpu *>(ctx)->getNextPipelineInstr();
 }
 
 uint16_t CortexM0Cpu::getNextPipelineInstr() {
   uint16_t result = m_instructionQueue.front();
   m_instructionQueue.pop_front();
-  wait(clk->getPeriod());
+  consumeTime(clk->getPeriod());
   powerModelPort->reportEvent(m_idleCyclesEventId);
   return result;
 }
@@ -397,12 +482,14 @@ unsigned CortexM0Cpu::fetch(const unsigned address) {
   if (!m_instructionBuffer.valid ||
       (addressWordAligned != m_instructionBuffer.address)) {
     // Read from memory
-    m_instructionBuffer.data = read32(addressWordAligned);
+    uint8_t tmp[4];
+    readMem(addressWordAligned, tmp, 4, /*isFetch=*/true);
+    m_instructionBuffer.data = Utility::ttohl(Utility::packBytes(tmp, 4));
     m_instructionBuffer.address = addressWordAligned;
     m_instructionBuffer.valid = true;
   } else {
     // Consume a cycle regardless
-    wait(clk->getPeriod());
+    consumeTime(clk->getPeriod());
     powerModelPort->reportEvent(m_idleCyclesEventId);
   }
 
@@ -417,16 +504,63 @@ unsigned CortexM0Cpu::fetch(const unsigned address) {
   }
 }
 
+CortexM0Cpu::PredecodedInsn *CortexM0Cpu::predecoded(const unsigned pc,
+                                                     const uint16_t insn) {
+  // 32-bit instructions pop their second half from the pipeline while being
+  // decoded, so they are always decoded on the fly
+  if ((pc < ROM_START) || (pc >= ROM_START + ROM_SIZE) ||
+      ((insn >> 11) >= 0x1d)) {
+    return nullptr;
+  }
+
+  // Decoding only depends on the opcode, so an entry decoded from the same
+  // opcode is valid regardless of how the pipeline got there
+  auto &p = m_predecoded[(pc - ROM_START) >> 1];
+  if ((p.handler == nullptr) || (p.insn != insn)) {
+    decode(cpu, insn);
+    p.handler = exwbmem_handler(insn);
+    p.insn = insn;
+    p.decoded = cpu->decoded;
+  }
+  return &p;
+}
+
+void CortexM0Cpu::invalidatePredecoded(const unsigned start,
+                                       const unsigned end) {
+  const unsigned first = std::max(start, unsigned(ROM_START));
+  const unsigned last = std::min(end, unsigned(ROM_START + ROM_SIZE - 1));
+  for (unsigned addr = first & (~1u); addr <= last; addr += 2) {
+    m_predecoded[(addr - ROM_START) >> 1].handler = nullptr;
+  }
+}
+
 void CortexM0Cpu::writeMem(const uint32_t addr, uint8_t *const data,
                            const size_t bytelen) {
   sc_time delay;
   tlm::tlm_generic_payload trans;
 
+  // Drop stale predecoded instructions (self-modifying code)
+  invalidatePredecoded(addr, addr + bytelen - 1);
+
   if (busStall.read()) {
     // Wait for bus to become available
+    syncTime();
     wait(busStall.negedge_event());
   }
 
+  // Memories granting DMI have no side effects, so there is no need to sync
+  if (m_dmi.write(addr, data, bytelen, delay)) {
+    if (m_tracer != nullptr) {
+      m_tracer->access(m_qk.get_current_time().value(), addr, true,
+                       TraceRecord::DMI_TARGET, data, bytelen);
+    }
+    consumeTime(delay);
+    return;
+  }
+
+  // Data accesses may have side effects, so sync before accessing the bus
+  syncTime();
+
   delay = SC_ZERO_TIME;
   trans.set_address(addr);
   trans.set_data_length(bytelen);
@@ -439,7 +573,7 @@ void CortexM0Cpu::writeMem(const uint32_t addr, uint8_t *const data,
     sc_stop();
   }
 
-  wait(delay);
+  consumeTime(delay);
 }
 
 void CortexM0Cpu::write32(const uint32_t addr, const uint32_t val) {
@@ -455,16 +589,33 @@ uint32_t CortexM0Cpu::read32(const uint32_t addr) {
 }
 
 void CortexM0Cpu::readMem(const uint32_t addr, uint8_t *const data,
-                          const size_t bytelen) {
+                          const size_t bytelen, const bool isFetch) {
   sc_time delay;
   tlm::tlm_generic_payload trans;
 
   if (busStall.read()) {
     // Wait for bus to become available
+    syncTime();
     wait(busStall.negedge_event());
   }
 
-  delay = SC_ZERO_TIME;
+  // Memories granting DMI have no side effects, so there is no need to sync
+  if (m_dmi.read(addr, data, bytelen, delay)) {
+    if (m_tracer != nullptr) {
+      m_tracer->access(m_qk.get_current_time().value(), addr, false,
+                       TraceRecord::DMI_TARGET, data, bytelen);
+    }
+    consumeTime(delay);
+    return;
+  }
+
+  // Data accesses may have side effects, so sync before accessing the bus
+  if (!isFetch) {
+    syncTime();
+  }
+
+  // In loosely-timed mode, the transaction is annotated with the local time
+  delay = m_temporalDecoupling ? m_qk.get_local_time() : SC_ZERO_TIME;
   trans.set_address(addr);
   trans.set_data_length(bytelen);
   trans.set_data_ptr(data);
@@ -474,14 +625,77 @@ void CortexM0Cpu::readMem(const uint32_t addr, uint8_t *const data,
     spdlog::error("{} Failed read from address 0x{:08x}.", this->name(), addr);
     sc_stop();
   }
-  wait(delay);
+
+  if (m_temporalDecoupling) {
+    m_qk.set(delay);
+    if (m_qk.need_sync()) {
+      syncTime();
+    }
+  } else {
+    m_dmi.flush();
+    wait(delay);
+  }
+}
+
+void CortexM0Cpu::consumeTime(const sc_time &t) {
+  if (m_temporalDecoupling) {
+    m_qk.inc(t);
+    if (m_qk.need_sync()) {
+      syncTime();
+    }
+  } else {
+    m_dmi.flush();
+    wait(t);
+  }
+}
+
+void CortexM0Cpu::idle() {
+  syncTime();
+  const auto start = sc_time_stamp();
+  const auto p = clk->getPeriod().value();
+  if (p == 0) { // Clock stopped, nothing to count
+    wait(sysTickIrq.value_changed_event() | nvicIrq.value_changed_event() |
+         pwrOn.default_event() | clk->periodChangedEvent() |
+         m_boundaryHookSet);
+    return;
+  }
+
+  // Block until woken, or until the next timestep boundary
+  const auto syncPeriod = m_idleSyncPeriod.value();
+  wait(sc_time::from_value(syncPeriod - (start.value() % syncPeriod)),
+       sysTickIrq.value_changed_event() | nvicIrq.value_changed_event() |
+           pwrOn.default_event() | clk->periodChangedEvent() |
+           m_boundaryHookSet);
+
+  // Round up to a whole number of cycles
+  const uint64_t nCycles =
+      std::max<uint64_t>(1, ((sc_time_stamp() - start).value() + p - 1) / p);
+  const auto end = start + sc_time::from_value(nCycles * p);
+  if (end > sc_time_stamp()) {
+    wait(end - sc_time_stamp());
+  }
+  powerModelPort->reportEvent(m_idleCyclesEventId, static_cast<int>(nCycles));
+}
+
+void CortexM0Cpu::syncTime() {
+  if (m_temporalDecoupling) {
+    m_dmi.flush();
+    m_qk.sync();
+  }
+}
+
+void CortexM0Cpu::runBoundaryHook(const bool powered) {
+  syncTime();
+  const auto hook = std::move(m_boundaryHook);
+  m_boundaryHook = nullptr;
+  hook(powered);
 }
 
 uint32_t CortexM0Cpu::dbg_readReg(size_t addr) {
   if (addr == PC_REGNUM) {
     return getNextExecutionPc();
   } else if (addr == CPSR_REGNUM) {
-    return cpu.apsr;
+    return cpu->apsr;
   } else if (addr <= N_GPR) {
     return cpu_get_gpr(addr);
   } else {
@@ -551,6 +765,44 @@ unsigned CortexM0Cpu::getNextExecutionPc() const {
   return (cpu_get_pc() & (~1u)) - 2 * (m_instructionQueue.size() - m_bubbles);
 }
 
+void CortexM0Cpu::saveState(CheckpointOut &out) {
+  out.put(cpu->gpr);
+  out.put<uint32_t>(getNextExecutionPc());
+  out.put(cpu->apsr);
+  out.put(cpu->ipsr);
+  out.put(cpu->espr);
+  out.put(cpu->primask);
+  out.put(cpu->control);
+  out.put(cpu->sp_main);
+  out.put(cpu->sp_process);
+  out.put(cpu->mode);
+  out.put(cpu->exceptmask);
+  out.put(m_sleeping);
+}
+
+void CortexM0Cpu::restoreState(CheckpointIn &in) {
+  in.getBytes(cpu->gpr, sizeof(cpu->gpr));
+  const auto pc = in.get<uint32_t>();
+  cpu->apsr = in.get<u32>();
+  cpu->ipsr = in.get<u32>();
+  cpu->espr = in.get<u32>();
+  cpu->primask = in.get<u32>();
+  cpu->control = in.get<u32>();
+  cpu->sp_main = in.get<u32>();
+  cpu->sp_process = in.get<u32>();
+  cpu->mode = in.get<u32>();
+  cpu->exceptmask = in.get<u32>();
+  m_sleeping = in.get<bool>();
+
+  cpu->takenBranch = false;
+  cpu_set_pc(pc | 1);
+  flushPipeline();
+  if (m_sleeping && pwrOn.read()) {
+    // Resume sleeping in WFI/WFE until the next exception
+    powerModelPort->reportState(m_sleepStateId);
+  }
+}
+
 std::ostream &operator<<(std::ostream &os, const CortexM0Cpu &rhs) {
   // clang-format off
   os << "<CortexM0Cpu> " << rhs.name()
@@ -568,12 +820,12 @@ std::ostream &operator<<(std::ostream &os, const CortexM0Cpu &rhs) {
   os << "]\n";
   os << "\nCPU regs:";
   for (int i = 0; i <=12; i++) {
-    os << fmt::format("\n\tR{:02d}: 0x{:08x}", i, cpu.gpr[i]);
+    os << fmt::format("\n\tR{:02d}: 0x{:08x}", i, rhs.cpu->gpr[i]);
   }
-  os << fmt::format("\n\tSP:02d}: 0x{:08x}", cpu.gpr[13]);
-  os << fmt::format("\n\tLR:02d}: 0x{:08x}", cpu.gpr[14]);
-  os << fmt::format("\n\tPC[FETCH]:02d}: 0x{:08x}", cpu.gpr[15]);
-  os << fmt::format("\n\tPC[EXECUTE]:02d}: 0x{:08x}", cpu.gpr[15] - 4);
+  os << fmt::format("\n\tSP:02d}: 0x{:08x}", rhs.cpu->gpr[13]);
+  os << fmt::format("\n\tLR:02d}: 0x{:08x}", rhs.cpu->gpr[14]);
+  os << fmt::format("\n\tPC[FETCH]:02d}: 0x{:08x}", rhs.cpu->gpr[15]);
+  os << fmt::format("\n\tPC[EXECUTE]:02d}: 0x{:08x}", rhs.cpu->gpr[15] - 4);
   // clang-format on
   return os;
 }
@@ -8,20 +8,27 @@
 #pragma once
 
 #include "mcu/ClockSourceIf.hpp"
+#include "mcu/DmiCache.hpp"
 #include "ps/PowerModelChannelIf.hpp"
+#include "utilities/Checkpoint.hpp"
+#include "utilities/Profiler.hpp"
+#include "utilities/Tracer.hpp"
 #include <deque>
+#include <functional>
 #include <systemc>
 #include <tlm>
+#include <tlm_utils/tlm_quantumkeeper.h>
 #include <unordered_set>
+#include <vector>
 
 extern "C" {
 #include "mcu/cortex-m0/decode.h"
 #include "mcu/cortex-m0/exmemwb.h"
 }
 
-extern struct CPU cpu;
-
-class CortexM0Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
+class CortexM0Cpu : public sc_core::sc_module,
+                    tlm::tlm_bw_transport_if<>,
+                    public Checkpointable {
   SC_HAS_PROCESS(CortexM0Cpu);
 
 public:
@@ -82,7 +89,7 @@ public:
    * @param data buffer for return value
    * @param bytelen number of bytes to be read
    */
-  static void read_cb(const uint32_t addr, uint8_t *const data,
+  static void read_cb(void *ctx, const uint32_t addr, uint8_t *const data,
                       const size_t bytelen);
 
   /**
@@ -91,26 +98,26 @@ public:
    * @param data buffer for return value
    * @param bytelen number of bytes to be written
    */
-  static void write_cb(const uint32_t addr, uint8_t *const data,
+  static void write_cb(void *ctx, const uint32_t addr, uint8_t *const data,
                        const size_t bytelen);
 
   /**
    * @brief consume_cycles_cb Call SC wait() to wait for n clock cycles
    * @param n number of cycles to consume
    */
-  static void consume_cycles_cb(const size_t n);
+  static void consume_cycles_cb(void *ctx, const size_t n);
 
   /**
    * @brief exception_return_cb Call adds C++ context to C callback of
    * exceptionReturn
    */
-  static void exception_return_cb(const uint32_t EXC_RETURN);
+  static void exception_return_cb(void *ctx, const uint32_t EXC_RETURN);
 
   /**
    * @brief exception_return_cb Call adds C++ context to C callback of
    * getNextPipelineInst
    */
-  static uint16_t next_pipeline_instr_cb();
+  static uint16_t next_pipeline_instr_cb(void *ctx);
 
   /**
    * @brief getNextPipelineInst Used for getting second half of 32-bit
@@ -149,8 +156,12 @@ public:
    * @param addr read address (MCU memory space)
    * @param data buffer for return value
    * @param bytelen number of bytes to be read
+   * @param isFetch true if this is an instruction fetch. In loosely-timed
+   * mode, data accesses synchronise with the kernel before the transaction,
+   * whereas instruction fetches do not.
    */
-  void readMem(const uint32_t addr, uint8_t *const data, const size_t bytelen);
+  void readMem(const uint32_t addr, uint8_t *const data, const size_t bytelen,
+               const bool isFetch = false);
 
   /* ------ Controls for GDB server ------ */
 
@@ -170,6 +181,25 @@ public:
    */
   void dbg_writeReg(size_t addr, uint32_t data);
 
+  /**
+   * @brief setPowerOnHook Register a function to be called once, after the
+   * next power-on reset and before the first instruction is executed.
+   */
+  void setPowerOnHook(std::function<void()> hook) {
+    m_powerOnHook = std::move(hook);
+  }
+
+  /**
+   * @brief setInstructionBoundaryHook Register a function to be called once,
+   * between two instructions, with the local time synchronised. A sleeping
+   * CPU calls it without waking up. If the CPU loses power first, it is
+   * called once the CPU has powered off, with powered=false.
+   */
+  void setInstructionBoundaryHook(std::function<void(bool powered)> hook) {
+    m_boundaryHook = std::move(hook);
+    m_boundaryHookSet.notify(sc_core::SC_ZERO_TIME);
+  }
+
   /**
    * @brief stall Stall processor
    */
@@ -220,17 +250,37 @@ public:
    */
   friend std::ostream &operator<<(std::ostream &os, const CortexM0Cpu &rhs);
 
-  /*------ Dummy methods --------------------------------------------------*/
+  /**
+   * @brief invalidatePredecoded Drop predecoded instructions in the address
+   * range [start, end]. Must be called when program memory is modified.
+   */
+  void invalidatePredecoded(const unsigned start, const unsigned end);
 
-  // Dummy method:
-  [[noreturn]] void invalidate_direct_mem_ptr(sc_dt::uint64 start_range
-                                              [[maybe_unused]],
-                                              sc_dt::uint64 end_range
-                                              [[maybe_unused]]) {
-    SC_REPORT_FATAL(this->name(), "invalidate_direct_mem_ptr not implemented");
-    exit(1);
+  /**
+   * @brief saveState save the architectural state (registers, special
+   * registers, pending exceptions), the address of the next instruction and
+   * whether the core is sleeping.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState restore the architectural state and refill the
+   * pipeline from the saved PC. A core that was sleeping in WFI/WFE goes
+   * back to sleep.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
+  /**
+   * @brief invalidate_direct_mem_ptr Drop cached DMI regions in the given
+   * range.
+   */
+  void invalidate_direct_mem_ptr(sc_dt::uint64 start_range,
+                                 sc_dt::uint64 end_range) {
+    m_dmi.invalidate(start_range, end_range);
   }
 
+  /*------ Dummy methods --------------------------------------------------*/
+
   // Dummy method:
   [[noreturn]] tlm::tlm_sync_enum
   nb_transport_bw(tlm::tlm_generic_payload &trans [[maybe_unused]],
@@ -254,6 +304,10 @@ private:
   static const unsigned OPCODE_NOP = 0x46c0; // 0xbf00;  //! NOP (mov r8, r8)
 
   /* ------ Private variables ------ */
+  struct CPU m_cpuState{}; //! Architectural state of this core
+  //! Used by the thumbulator macros (cpu_get_pc() etc.)
+  struct CPU *const cpu{&m_cpuState};
+
   struct InstructionBuffer {
     unsigned data{0};
     unsigned address{0};
@@ -266,6 +320,9 @@ private:
   bool m_sleeping{false};
   bool m_run{false};
   bool m_doStep{false};
+  std::function<void()> m_powerOnHook; //! Called once after power-on reset
+  std::function<void(bool)> m_boundaryHook; //! Called at next boundary
+  sc_core::sc_event m_boundaryHookSet{"boundaryHookSet"}; //! Wakes sleep
   InstructionBuffer m_instructionBuffer;
   std::unordered_set<unsigned> m_breakpoints; // Set of breakpoint addresses
   std::unordered_set<unsigned> m_watchpoints; // Set of watchpoint addresses
@@ -279,6 +336,30 @@ private:
   int m_onStateId{-1};
   int m_sleepStateId{-1};
 
+  /* Temporal decoupling */
+  bool m_temporalDecoupling{false}; //! Run loosely-timed w/ quantum keeper
+  tlm_utils::tlm_quantumkeeper m_qk; //! Keeps track of local time offset
+
+  /* Idle fast-forward */
+  bool m_idleFastForward{false}; //! Count idle cycles while sleeping
+  sc_core::sc_time m_idleSyncPeriod{
+      sc_core::SC_ZERO_TIME}; //! Max. time spent blocked before reporting
+
+  DmiCache m_dmi{iSocket}; //! DMI regions granted to this CPU
+
+  /* Tracing */
+  Tracer *const m_tracer{Tracer::get()}; //! nullptr if tracing is disabled
+  std::array<uint32_t, N_GPR> m_tracedRegs{{0}}; //! GPRs before execution
+  Profiler *const m_profiler{Profiler::get()}; //! nullptr if not profiling
+
+  /* Predecoded instructions */
+  struct PredecodedInsn {
+    exmemwb_handler_t handler{nullptr}; //! nullptr if not decoded yet
+    uint16_t insn{0};                   //! Opcode the entry was decoded from
+    DECODE_RESULT decoded{};            //! Pre-extracted operands
+  };
+  std::vector<PredecodedInsn> m_predecoded; //! Indexed by (pc-ROM_START)/2
+
   /* ------ Private methods ------ */
 
   /**
@@ -314,6 +395,46 @@ private:
    */
   unsigned fetch(const unsigned address);
 
+  /**
+   * @brief predecoded Look up the predecoded instruction at pc, decoding insn
+   * into the cache if needed.
+   * @param pc address of the instruction
+   * @param insn instruction fetched from pc
+   * @retval pointer to predecoded instruction, or nullptr if insn can not be
+   * predecoded (outside program memory, or 32-bit instruction).
+   */
+  PredecodedInsn *predecoded(const unsigned pc, const uint16_t insn);
+
+  /**
+   * @brief consumeTime advance the CPU's time by t. In cycle-accurate mode
+   * this is a plain wait(t), in loosely-timed mode t is added to the local
+   * time offset, and the CPU only synchronises with the kernel at the end of
+   * each quantum. Pending DMI access counts are reported to the power model
+   * whenever the CPU synchronises.
+   * @param t time to consume
+   */
+  void consumeTime(const sc_core::sc_time &t);
+
+  /**
+   * @brief syncTime synchronise the local time offset with the kernel, i.e.
+   * wait for the accumulated local time. Does nothing in cycle-accurate mode.
+   */
+  void syncTime();
+
+  /**
+   * @brief runBoundaryHook synchronise the local time, then call and clear
+   * the instruction boundary hook.
+   */
+  void runBoundaryHook(const bool powered);
+
+  /**
+   * @brief idle Sleep until a wake-up source (irqs, pwrOn, clk period) changes
+   * or the next power model/log timestep boundary is reached, then report the
+   * elapsed clock cycles as idle cycles in bulk. The CPU stays aligned to
+   * whole clock cycles.
+   */
+  void idle();
+
   /**
    * @brief getNextExecutionPc get the address of the next instruction to be
    * executed. This value is PC adjusted for pipeline and bubbles.
@@ -560,6 +560,44 @@ void DmaChannel::reset() {
   interruptFlag = false;
 }
 
+void DmaChannel::saveState(CheckpointOut &out) {
+  out.put(interruptFlag);
+  out.put(size);
+  out.put(destinationAddress);
+  out.put(sourceAddress);
+  out.put(destinationAutoIncrement);
+  out.put(sourceAutoIncrement);
+  out.put(destinationBytes);
+  out.put(sourceBytes);
+  out.put(enable);
+  out.put(levelSensitive);
+  out.put(interruptEnable);
+  out.put(abort);
+  out.put(transferMode);
+  out.put(m_tSize);
+  out.put(m_tSourceAddress);
+  out.put(m_tDestinationAddress);
+}
+
+void DmaChannel::restoreState(CheckpointIn &in) {
+  interruptFlag = in.get<bool>();
+  size = in.get<int>();
+  destinationAddress = in.get<unsigned>();
+  sourceAddress = in.get<unsigned>();
+  destinationAutoIncrement = in.get<AutoIncrementMode>();
+  sourceAutoIncrement = in.get<AutoIncrementMode>();
+  destinationBytes = in.get<Bytes>();
+  sourceBytes = in.get<Bytes>();
+  enable = in.get<bool>();
+  levelSensitive = in.get<bool>();
+  interruptEnable = in.get<bool>();
+  abort = in.get<bool>();
+  transferMode = in.get<TransferMode>();
+  m_tSize = in.get<int>();
+  m_tSourceAddress = in.get<int>();
+  m_tDestinationAddress = in.get<int>();
+}
+
 std::ostream &operator<<(std::ostream &os, const DmaChannel &rhs) {
   os << "<DmaChannel> " << rhs.name() << "\n";
   os << "Signals:\n";
@@ -57,7 +57,7 @@ public:
 };
 
 // DMA  channel
-SC_MODULE(DmaChannel) {
+class DmaChannel : public sc_core::sc_module, public Checkpointable {
 public:
   /*------ Ports ------*/
   sc_core::sc_port<ClockSourceConsumerIf> systemClk{
@@ -115,6 +115,16 @@ public:
    */
   void reset();
 
+  /**
+   * @brief saveState save configuration, flags, and transfer progress.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState restore state saved by saveState.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
   /**
    * @brief << debug printout.
    */
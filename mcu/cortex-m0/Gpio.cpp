@@ -144,6 +144,16 @@ void Gpio::irqControl() {
   m_setIrq = false;
 }
 
+void Gpio::saveState(CheckpointOut& out) {
+  BusTarget::saveState(out);
+  out.put<unsigned>(m_lastState);
+}
+
+void Gpio::restoreState(CheckpointIn& in) {
+  BusTarget::restoreState(in);
+  m_lastState = in.get<unsigned>();
+}
+
 std::ostream& operator<<(std::ostream& os, const Gpio& rhs) {
   // clang-format off
   os << "<Gpio> " << rhs.name()
@@ -47,6 +47,16 @@ class Gpio : public BusTarget {
    */
   virtual void reset(void) override;
 
+  /**
+   * @brief saveState save registers and the last pin state.
+   */
+  virtual void saveState(CheckpointOut& out) override;
+
+  /**
+   * @brief restoreState restore registers and the last pin state.
+   */
+  virtual void restoreState(CheckpointIn& in) override;
+
   /**
    * @brief ostream operator<< for debug printout.
    */
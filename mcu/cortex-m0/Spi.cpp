@@ -283,6 +283,25 @@ void Spi::irqControl() {
   m_setIrq = false;
 }
 
+void Spi::saveState(CheckpointOut& out) {
+  BusTarget::saveState(out);
+  out.put<bool>(m_enable);
+  for (const auto* fifo : {&m_txFifo, &m_rxFifo}) {
+    out.put<int>(fifo->nValidBytes);
+    out.put<unsigned>(fifo->data);
+  }
+}
+
+void Spi::restoreState(CheckpointIn& in) {
+  BusTarget::restoreState(in);
+  m_enable = in.get<bool>();
+  for (auto* fifo : {&m_txFifo, &m_rxFifo}) {
+    fifo->nValidBytes = in.get<int>();
+    fifo->data = in.get<unsigned>();
+  }
+  m_enableEvent.notify(SC_ZERO_TIME);
+}
+
 std::ostream& operator<<(std::ostream& os, const Spi& rhs) {
   // clang-format off
   os << "Spi: " << rhs.name()
@@ -135,6 +135,17 @@ class Spi : public BusTarget {
    */
   virtual void reset(void) override;
 
+  /**
+   * @brief saveState save registers and FIFOs. Ongoing transfers are not
+   * saved.
+   */
+  virtual void saveState(CheckpointOut& out) override;
+
+  /**
+   * @brief restoreState restore registers and FIFOs.
+   */
+  virtual void restoreState(CheckpointIn& in) override;
+
   friend std::ostream& operator<<(std::ostream& os, const Spi& rhs);
 
  private:
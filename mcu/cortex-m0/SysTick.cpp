@@ -159,6 +159,30 @@ void SysTick::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
   }
 }
 
+void SysTick::saveState(CheckpointOut& out) {
+  BusTarget::saveState(out);
+  out.put(sc_time_stamp() - m_lastTick);
+  out.put<bool>(m_setIrq);
+}
+
+void SysTick::restoreState(CheckpointIn& in) {
+  BusTarget::restoreState(in);
+  const sc_time elapsed = in.getTime();
+  m_setIrq = in.get<bool>();
+  // The simulation restarts from (near) zero, so the last tick may have to be
+  // clamped. The next tick is still scheduled at the right time.
+  m_lastTick = (elapsed < sc_time_stamp()) ? sc_time_stamp() - elapsed
+                                           : SC_ZERO_TIME;
+  m_expiredEvent.cancel();
+  if (m_regs.read(OFS_SYST_CSR) & SYST_CSR_ENABLE) {
+    const sc_time period = clk->getPeriod() * (m_regs.read(OFS_SYST_RVR) + 1);
+    m_expiredEvent.notify(elapsed < period ? period - elapsed : SC_ZERO_TIME);
+  }
+  if (m_setIrq) {
+    m_updateIrqEvent.notify(SC_ZERO_TIME);
+  }
+}
+
 std::ostream& operator<<(std::ostream& os, const SysTick& rhs) {
   bool isEnabled = rhs.m_regs.read(OFS_SYST_CSR) & SYST_CSR_ENABLE;
 
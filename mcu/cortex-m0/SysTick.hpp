@@ -70,6 +70,17 @@ class SysTick : public BusTarget {
    */
   virtual void reset(void) override;
 
+  /**
+   * @brief saveState save registers and the time since the last tick.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState restore registers, and reschedule the next tick if
+   * the timer is enabled.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
   /**
    * @brief b_transport Blocking reads and writes
    * @param trans
@@ -8,79 +8,79 @@
 #include "decode.h"
 #include "exmemwb.h"
 
-// Holds the result of decoding
-// Passed to exmemwb stage
-DECODE_RESULT decoded;
-
 // Various decodings
-void decode_3lo(const u16 pInsn) {
-  decoded.rD = pInsn & 0x7;
-  decoded.rN = (pInsn >> 3) & 0x7;
-  decoded.rM = (pInsn >> 6) & 0x7;
+void decode_3lo(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.rD = pInsn & 0x7;
+  cpu->decoded.rN = (pInsn >> 3) & 0x7;
+  cpu->decoded.rM = (pInsn >> 6) & 0x7;
 }
 
-void decode_2loimm5(const u16 pInsn) {
-  decoded.rD = pInsn & 0x7;
+void decode_2loimm5(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.rD = pInsn & 0x7;
 #if DECODE_SAFE
-  decoded.rM = (pInsn >> 3) & 0x7;  // Just to be safe
+  cpu->decoded.rM = (pInsn >> 3) & 0x7;  // Just to be safe
 #endif
-  decoded.rN = (pInsn >> 3) & 0x7;
-  decoded.imm = (pInsn >> 6) & 0x1F;
+  cpu->decoded.rN = (pInsn >> 3) & 0x7;
+  cpu->decoded.imm = (pInsn >> 6) & 0x1F;
 }
 
-void decode_2loimm3(const u16 pInsn) {
-  decoded.rD = pInsn & 0x7;
+void decode_2loimm3(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.rD = pInsn & 0x7;
 #if DECODE_SAFE
-  decoded.rM = (pInsn >> 3) & 0x7;  // Just to be safe
+  cpu->decoded.rM = (pInsn >> 3) & 0x7;  // Just to be safe
 #endif
-  decoded.rN = (pInsn >> 3) & 0x7;
-  decoded.imm = (pInsn >> 6) & 0x7;
+  cpu->decoded.rN = (pInsn >> 3) & 0x7;
+  cpu->decoded.imm = (pInsn >> 6) & 0x7;
 }
 
-void decode_2lo(const u16 pInsn) {
-  decoded.rD = pInsn & 0x7;
-  decoded.rM = (pInsn >> 3) & 0x7;
-  decoded.rN = (pInsn >> 3) & 0x7;
+void decode_2lo(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.rD = pInsn & 0x7;
+  cpu->decoded.rM = (pInsn >> 3) & 0x7;
+  cpu->decoded.rN = (pInsn >> 3) & 0x7;
 }
 
-void decode_imm8lo(const u16 pInsn) {
-  decoded.rD = (pInsn >> 8) & 0x7;
+void decode_imm8lo(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.rD = (pInsn >> 8) & 0x7;
 #if DECODE_SAFE
-  decoded.rM = decoded.rD;  // Just to be safe
-  decoded.rN = decoded.rD;  // Just to be safe
+  cpu->decoded.rM = cpu->decoded.rD;  // Just to be safe
+  cpu->decoded.rN = cpu->decoded.rD;  // Just to be safe
 #endif
-  decoded.imm = pInsn & 0xFF;
+  cpu->decoded.imm = pInsn & 0xFF;
 }
 
-void decode_imm8(const u16 pInsn) { decoded.imm = pInsn & 0xFF; }
+void decode_imm8(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.imm = pInsn & 0xFF;
+}
 
-void decode_imm8c(const u16 pInsn) {
-  decoded.imm = pInsn & 0xFF;
-  decoded.cond = (pInsn >> 8) & 0xF;
+void decode_imm8c(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.imm = pInsn & 0xFF;
+  cpu->decoded.cond = (pInsn >> 8) & 0xF;
 }
 
-void decode_imm7(const u16 pInsn) {
-  decoded.rD = GPR_SP;
-  decoded.imm = pInsn & 0x7F;
+void decode_imm7(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.rD = GPR_SP;
+  cpu->decoded.imm = pInsn & 0x7F;
 }
 
-void decode_imm11(const u16 pInsn) { decoded.imm = pInsn & 0x7FF; }
+void decode_imm11(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.imm = pInsn & 0x7FF;
+}
 
-void decode_reglistlo(const u16 pInsn) {
-  decoded.rN = (pInsn >> 8) & 0x7;
-  decoded.reg_list = pInsn & 0xFF;
+void decode_reglistlo(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.rN = (pInsn >> 8) & 0x7;
+  cpu->decoded.reg_list = pInsn & 0xFF;
 }
 
-void decode_pop(const u16 pInsn) {
-  decoded.reg_list = ((pInsn & 0x100) << 7) | (pInsn & 0xFF);
+void decode_pop(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.reg_list = ((pInsn & 0x100) << 7) | (pInsn & 0xFF);
 }
 
-void decode_cps_push(const u16 pInsn) {
-  decoded.reg_list = (pInsn & 0xFF) | ((pInsn & 0x100) << 6);
-  decoded.imm = (pInsn >> 4) & 1;  // for CPS
+void decode_cps_push(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.reg_list = (pInsn & 0xFF) | ((pInsn & 0x100) << 6);
+  cpu->decoded.imm = (pInsn >> 4) & 1;  // for CPS
 }
 
-void decode_bl(const u16 pInsn) {
+void decode_bl(cpu_t *const cpu, const u16 pInsn) {
   const u32 BLOP = 0xf000d000;
   const u32 BLMASK = 0xf800d000u;
   const u32 MSROP = 0xf3808800u;
@@ -91,7 +91,7 @@ void decode_bl(const u16 pInsn) {
   const u32 DSBMASK = ~(0x0000000fu);
   const u32 ISBOP = 0xf3bf8f60;
   const u32 ISBMASK = ~(0x0000000fu);
-  u16 secondHalf = next_pipeline_instr_cb();
+  u16 secondHalf = cpu->next_pipeline_instr_cb(cpu->ctx);
   u32 wholeInsn = ((u32)pInsn << 16) | secondHalf;
 
   if ((wholeInsn & BLMASK) == BLOP) {
@@ -103,28 +103,29 @@ void decode_bl(const u16 pInsn) {
     u32 I2 = ~(J2 ^ S) & 0x1;
     u32 imm10 = pInsn & 0x3FF;
     u32 imm11 = secondHalf & 0x7FF;
-    decoded.imm = (S << 23) | (I1 << 22) | (I2 << 21) | (imm10 << 11) | imm11;
+    cpu->decoded.imm =
+        (S << 23) | (I1 << 22) | (I2 << 21) | (imm10 << 11) | imm11;
   } else if ((wholeInsn & MRSMASK) == MRSOP) {
     // Move to Register from Special register
-    decoded.rM = wholeInsn & 0x000000ff;
-    decoded.rD = (wholeInsn & 0x00000f00) >> 8;
-    decoded.imm =
+    cpu->decoded.rM = wholeInsn & 0x000000ff;
+    cpu->decoded.rD = (wholeInsn & 0x00000f00) >> 8;
+    cpu->decoded.imm =
         0x80000000;  // Hack to signal MRS/MSR/DSB/ISB (impossible value for bl)
   } else if ((wholeInsn & MSRMASK) == MSROP) {
     // Move to Special register from Register
-    decoded.rD = wholeInsn & 0x000000ff;
-    decoded.rM = (wholeInsn & 0x000f0000) >> 16;
-    decoded.imm =
+    cpu->decoded.rD = wholeInsn & 0x000000ff;
+    cpu->decoded.rM = (wholeInsn & 0x000f0000) >> 16;
+    cpu->decoded.imm =
         0x80000000;  // Hack to signal MRS/MSR/ISB/DSB (impossible value for bl)
   } else if ((wholeInsn & DSBMASK) == DSBOP) {
     // Data synchronization barrier
-    decoded.rD = 3 << 3u;  // Hack to signal DSB
-    decoded.imm =
+    cpu->decoded.rD = 3 << 3u;  // Hack to signal DSB
+    cpu->decoded.imm =
         0x80000000;  // Hack to signal MRS/MSR/ISB/DSB (impossible value for bl)
   } else if ((wholeInsn & ISBMASK) == ISBOP) {
     // Instruction synchronization barrier
-    decoded.rD = 4 << 3u;  // Hack to signal ISB
-    decoded.imm =
+    cpu->decoded.rD = 4 << 3u;  // Hack to signal ISB
+    cpu->decoded.imm =
         0x80000000;  // Hack to signal MRS/MSR/ISB/DSB (impossible value for bl)
   } else {
     fprintf(stderr, "Unrecognized instruction %08x, exiting.", wholeInsn);
@@ -132,16 +133,18 @@ void decode_bl(const u16 pInsn) {
   }
 }
 
-void decode_1all(const u16 pInsn) { decoded.rM = (pInsn >> 3) & 0xF; }
+void decode_1all(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.rM = (pInsn >> 3) & 0xF;
+}
 
-void decode_mov_r(const u16 pInsn) {
-  decoded.rD = (pInsn & 0x7) | ((pInsn & 0x80) >> 4);
-  decoded.rN = decoded.rD;
-  decoded.rM = (pInsn >> 3) & 0xF;
+void decode_mov_r(cpu_t *const cpu, const u16 pInsn) {
+  cpu->decoded.rD = (pInsn & 0x7) | ((pInsn & 0x80) >> 4);
+  cpu->decoded.rN = cpu->decoded.rD;
+  cpu->decoded.rM = (pInsn >> 3) & 0xF;
 }
 
 // Stop simulation if we cannot decode the instruction
-void decode_error(const u16 pInsn) {
+void decode_error(cpu_t *const cpu, const u16 pInsn) {
   fprintf(stderr,
           "Error: Malformed instruction: Unable to decode: 0x%4.4X at 0x%08X\n",
           pInsn, cpu_get_pc() - 4);
@@ -149,37 +152,37 @@ void decode_error(const u16 pInsn) {
 }
 
 // Decode functions that require more opcode bits than the first 6
-void (*decodeJumpTable17[4])(const u16 pInsn) = {
+void (*decodeJumpTable17[4])(cpu_t *const cpu, const u16 pInsn) = {
     decode_mov_r,               /* 01_0001_0XXX (110 - 117) */
     decode_mov_r, decode_mov_r, /* 01_0001_10XX (118 - 11B) */
     decode_1all                 /* 01_0001_11XX (11C - 11F) */
 };
 
-void (*decodeJumpTable44[4])(const u16 pInsn) = {
+void (*decodeJumpTable44[4])(cpu_t *const cpu, const u16 pInsn) = {
     decode_imm7,              /* 10_1100_00XX (2C0 - 2C3) */
     decode_error, decode_2lo, /* 10_1100_10XX (2C8 - 2CB) */
     decode_error};
 
-void (*decodeJumpTable47[4])(const u16 pInsn) = {
+void (*decodeJumpTable47[4])(cpu_t *const cpu, const u16 pInsn) = {
     decode_pop,              /* 10_1111_0XXX (2F0 - 2F7) */
     decode_pop, decode_imm8, /* 10_1111_10XX (2F8 - 2FB) */
     decode_imm8};
 
-void decode_17(const u16 pInsn) {
-  decodeJumpTable17[(pInsn >> 8) & 0x3](pInsn);
+void decode_17(cpu_t *const cpu, const u16 pInsn) {
+  decodeJumpTable17[(pInsn >> 8) & 0x3](cpu, pInsn);
 }
-void decode_44(const u16 pInsn) {
-  decodeJumpTable44[(pInsn >> 8) & 0x3](pInsn);
+void decode_44(cpu_t *const cpu, const u16 pInsn) {
+  decodeJumpTable44[(pInsn >> 8) & 0x3](cpu, pInsn);
 }
-void decode_47(const u16 pInsn) {
-  decodeJumpTable47[(pInsn >> 8) & 0x3](pInsn);
+void decode_47(cpu_t *const cpu, const u16 pInsn) {
+  decodeJumpTable47[(pInsn >> 8) & 0x3](cpu, pInsn);
 }
 
 // Use a table of function pointers indexed by the instruction
 // to make decoding fast
 // Indices 16, 17, 44, 47, 60, and 62 have multiple conflicting
 // decodings that need to be resolved outside the jump table
-void (*decodeJumpTable[64])(const u16 pInsn) = {
+void (*decodeJumpTable[64])(cpu_t *const cpu, const u16 pInsn) = {
     decode_2loimm5,   decode_2loimm5,   decode_2loimm5,   decode_2loimm5,
     decode_2loimm5,   decode_2loimm5,   decode_3lo,       decode_2loimm3,
     decode_imm8lo,    decode_imm8lo,    decode_imm8lo,    decode_imm8lo,
@@ -206,16 +209,16 @@ void (*decodeJumpTable[64])(const u16 pInsn) = {
 // using the first 6 instruction opcode bits and then
 // executing the function pointed to
 // The decode functions update the global decode structure
-void decode(const u16 pInsn) {
+void decode(cpu_t *const cpu, const u16 pInsn) {
 // Clear the values from the previous decode
 #if DECODE_CLEAR
-  decoded.rD = 0;
-  decoded.rM = 0;
-  decoded.rN = 0;
-  decoded.imm = 0;
-  decoded.cond = 0;
-  decoded.reg_list = 0;
+  cpu->decoded.rD = 0;
+  cpu->decoded.rM = 0;
+  cpu->decoded.rN = 0;
+  cpu->decoded.imm = 0;
+  cpu->decoded.cond = 0;
+  cpu->decoded.reg_list = 0;
 #endif
 
-  decodeJumpTable[pInsn >> 10](pInsn);
+  decodeJumpTable[pInsn >> 10](cpu, pInsn);
 }
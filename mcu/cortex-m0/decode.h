@@ -17,7 +17,7 @@
      // stage uses the wrong one
 
 // Registers that hold the results of instruction decoding
-// Passed to exectue, memory access, and write-back stage in decoded variable
+// Passed to exectue, memory access, and write-back stage in cpu->decoded
 typedef struct {
   unsigned char rD;
   unsigned char rM;
@@ -27,11 +27,9 @@ typedef struct {
   u32 reg_list;
 } DECODE_RESULT;
 
-extern DECODE_RESULT decoded;
-
 // Interface to the decode stage
 // Sets the decode stage registers based upon the passed instruction
 // Prints a message and exits the simulator upon decoding error
-void decode(const u16 pInsn);
+void decode(cpu_t *const cpu, const u16 pInsn);
 
 #endif
@@ -8,21 +8,19 @@
 #include "decode.h"
 #include "exmemwb.h"
 
-u16 insn;
-
 #if HOOK_GPR_ACCESSES
-u32 cpu_get_gpr(u32 gpr) {
-  gprReadHooks[gpr]();
-  return cpu.gpr[gpr];
+u32 cpu_hooked_get_gpr(cpu_t *const cpu, u32 gpr) {
+  gprReadHooks[gpr](cpu);
+  return cpu->gpr[gpr];
 }
 
-void cpu_set_gpr(u32 gpr, u32 value) {
-  gprWriteHooks[gpr]();
-  cpu.gpr[gpr] = value;
+void cpu_hooked_set_gpr(cpu_t *const cpu, u32 gpr, u32 value) {
+  gprWriteHooks[gpr](cpu);
+  cpu->gpr[gpr] = value;
 }
 #endif
 
-void do_cflag(u32 a, u32 b, u32 carry) {
+void do_cflag(cpu_t *const cpu, u32 a, u32 b, u32 carry) {
   u32 result;
 
   result = (a & 0x7FFFFFFF) + (b & 0x7FFFFFFF) + carry;  // carry in
@@ -30,105 +28,111 @@ void do_cflag(u32 a, u32 b, u32 carry) {
   cpu_set_flag_c(result >> 1);
 }
 
-u32 adcs(void);
-u32 adds_i3(void);
-u32 adds_i8(void);
-u32 adds_r(void);
-u32 add_r(void);
-u32 add_sp(void);
-u32 adr(void);
-u32 subs_i3(void);
-u32 subs_i8(void);
-u32 subs(void);
-u32 sub_sp(void);
-u32 sbcs(void);
-u32 rsbs(void);
-u32 muls(void);
-u32 cmn(void);
-u32 cmp_i(void);
-u32 cmp_r(void);
-u32 tst(void);
-u32 b(void);
-u32 b_c(void);
-u32 blx(void);
-u32 bx(void);
-u32 bl(void);
-u32 ands(void);
-u32 bics(void);
-u32 eors(void);
-u32 orrs(void);
-u32 mvns(void);
-u32 asrs_i(void);
-u32 asrs_r(void);
-u32 lsls_i(void);
-u32 lsrs_i(void);
-u32 lsls_r(void);
-u32 lsrs_r(void);
-u32 rors(void);
-u32 ldm(void);
-u32 stm(void);
-u32 pop(void);
-u32 push(void);
-u32 ldr_i(void);
-u32 ldr_sp(void);
-u32 ldr_lit(void);
-u32 ldr_r(void);
-u32 ldrb_i(void);
-u32 ldrb_r(void);
-u32 ldrh_i(void);
-u32 ldrh_r(void);
-u32 ldrsb_r(void);
-u32 ldrsh_r(void);
-u32 str_i(void);
-u32 str_sp(void);
-u32 str_r(void);
-u32 strb_i(void);
-u32 strb_r(void);
-u32 strh_i(void);
-u32 strh_r(void);
-u32 movs_i(void);
-u32 mov_r(void);
-u32 movs_r(void);
-u32 msr(void);
-u32 mrs(void);
-u32 sxtb(void);
-u32 sxth(void);
-u32 uxtb(void);
-u32 uxth(void);
-u32 rev(void);
-u32 rev16(void);
-u32 revsh(void);
-u32 cps(void);
-u32 nop(void);
-
-u32 exmemwb_error() {
+u32 adcs(cpu_t *const cpu);
+u32 adds_i3(cpu_t *const cpu);
+u32 adds_i8(cpu_t *const cpu);
+u32 adds_r(cpu_t *const cpu);
+u32 add_r(cpu_t *const cpu);
+u32 add_sp(cpu_t *const cpu);
+u32 adr(cpu_t *const cpu);
+u32 subs_i3(cpu_t *const cpu);
+u32 subs_i8(cpu_t *const cpu);
+u32 subs(cpu_t *const cpu);
+u32 sub_sp(cpu_t *const cpu);
+u32 sbcs(cpu_t *const cpu);
+u32 rsbs(cpu_t *const cpu);
+u32 muls(cpu_t *const cpu);
+u32 cmn(cpu_t *const cpu);
+u32 cmp_i(cpu_t *const cpu);
+u32 cmp_r(cpu_t *const cpu);
+u32 tst(cpu_t *const cpu);
+u32 b(cpu_t *const cpu);
+u32 b_c(cpu_t *const cpu);
+u32 blx(cpu_t *const cpu);
+u32 bx(cpu_t *const cpu);
+u32 bl(cpu_t *const cpu);
+u32 ands(cpu_t *const cpu);
+u32 bics(cpu_t *const cpu);
+u32 eors(cpu_t *const cpu);
+u32 orrs(cpu_t *const cpu);
+u32 mvns(cpu_t *const cpu);
+u32 asrs_i(cpu_t *const cpu);
+u32 asrs_r(cpu_t *const cpu);
+u32 lsls_i(cpu_t *const cpu);
+u32 lsrs_i(cpu_t *const cpu);
+u32 lsls_r(cpu_t *const cpu);
+u32 lsrs_r(cpu_t *const cpu);
+u32 rors(cpu_t *const cpu);
+u32 ldm(cpu_t *const cpu);
+u32 stm(cpu_t *const cpu);
+u32 pop(cpu_t *const cpu);
+u32 push(cpu_t *const cpu);
+u32 ldr_i(cpu_t *const cpu);
+u32 ldr_sp(cpu_t *const cpu);
+u32 ldr_lit(cpu_t *const cpu);
+u32 ldr_r(cpu_t *const cpu);
+u32 ldrb_i(cpu_t *const cpu);
+u32 ldrb_r(cpu_t *const cpu);
+u32 ldrh_i(cpu_t *const cpu);
+u32 ldrh_r(cpu_t *const cpu);
+u32 ldrsb_r(cpu_t *const cpu);
+u32 ldrsh_r(cpu_t *const cpu);
+u32 str_i(cpu_t *const cpu);
+u32 str_sp(cpu_t *const cpu);
+u32 str_r(cpu_t *const cpu);
+u32 strb_i(cpu_t *const cpu);
+u32 strb_r(cpu_t *const cpu);
+u32 strh_i(cpu_t *const cpu);
+u32 strh_r(cpu_t *const cpu);
+u32 movs_i(cpu_t *const cpu);
+u32 mov_r(cpu_t *const cpu);
+u32 movs_r(cpu_t *const cpu);
+u32 msr(cpu_t *const cpu);
+u32 mrs(cpu_t *const cpu);
+u32 sxtb(cpu_t *const cpu);
+u32 sxth(cpu_t *const cpu);
+u32 uxtb(cpu_t *const cpu);
+u32 uxth(cpu_t *const cpu);
+u32 rev(cpu_t *const cpu);
+u32 rev16(cpu_t *const cpu);
+u32 revsh(cpu_t *const cpu);
+u32 cps(cpu_t *const cpu);
+u32 nop(cpu_t *const cpu);
+
+u32 exmemwb_error(cpu_t *const cpu) {
   fprintf(stderr, "Error: Unsupported instruction: Unable to execute\n");
   sim_exit(1);
   return 0;
 }
 
 // Execute functions that require more opcode bits than the first 6
-u32 (*executeJumpTable6[2])(void) = {
+u32 (*executeJumpTable6[2])(cpu_t *const cpu) = {
     adds_r, /* 060 - 067 */
     subs    /* 068 - 06F */
 };
 
-u32 entry6(void) { return executeJumpTable6[(insn >> 9) & 0x1](); }
+u32 entry6(cpu_t *const cpu) {
+  return executeJumpTable6[(cpu->insn >> 9) & 0x1](cpu);
+}
 
-u32 (*executeJumpTable7[2])(void) = {
+u32 (*executeJumpTable7[2])(cpu_t *const cpu) = {
     adds_i3, /* (070 - 077) */
     subs_i3  /* (078 - 07F) */
 };
 
-u32 entry7(void) { return executeJumpTable7[(insn >> 9) & 0x1](); }
+u32 entry7(cpu_t *const cpu) {
+  return executeJumpTable7[(cpu->insn >> 9) & 0x1](cpu);
+}
 
-u32 (*executeJumpTable16[16])(void) = {
+u32 (*executeJumpTable16[16])(cpu_t *const cpu) = {
     ands, eors, lsls_r, lsrs_r,        asrs_r, adcs, sbcs, rors,
     tst,  rsbs, cmp_r,  exmemwb_error, orrs,   muls, bics, mvns};
 
-u32 entry16(void) { return executeJumpTable16[(insn >> 6) & 0xF](); }
+u32 entry16(cpu_t *const cpu) {
+  return executeJumpTable16[(cpu->insn >> 6) & 0xF](cpu);
+}
 
-u32 (*executeJumpTable17[8])(void) = {
+u32 (*executeJumpTable17[8])(cpu_t *const cpu) = {
     add_r,        /* (110 - 113) */
     add_r, cmp_r, /* (114 - 117) */
     cmp_r, mov_r, /* (118 - 11B) */
@@ -136,179 +140,226 @@ u32 (*executeJumpTable17[8])(void) = {
     blx           /* (11E - 11F) */
 };
 
-u32 entry17(void) { return executeJumpTable17[(insn >> 7) & 0x7](); }
+u32 entry17(cpu_t *const cpu) {
+  return executeJumpTable17[(cpu->insn >> 7) & 0x7](cpu);
+}
 
-u32 (*executeJumpTable20[2])(void) = {
+u32 (*executeJumpTable20[2])(cpu_t *const cpu) = {
     str_r, /* (140 - 147) */
     strh_r /* (148 - 14F) */
 };
 
-u32 entry20(void) { return executeJumpTable20[(insn >> 9) & 0x1](); }
+u32 entry20(cpu_t *const cpu) {
+  return executeJumpTable20[(cpu->insn >> 9) & 0x1](cpu);
+}
 
-u32 (*executeJumpTable21[2])(void) = {
+u32 (*executeJumpTable21[2])(cpu_t *const cpu) = {
     strb_r, /* (150 - 157) */
     ldrsb_r /* (158 - 15F) */
 };
 
-u32 entry21(void) { return executeJumpTable21[(insn >> 9) & 0x1](); }
+u32 entry21(cpu_t *const cpu) {
+  return executeJumpTable21[(cpu->insn >> 9) & 0x1](cpu);
+}
 
-u32 (*executeJumpTable22[2])(void) = {
+u32 (*executeJumpTable22[2])(cpu_t *const cpu) = {
     ldr_r, /* (160 - 167) */
     ldrh_r /* (168 - 16F) */
 };
 
-u32 entry22(void) { return executeJumpTable22[(insn >> 9) & 0x1](); }
+u32 entry22(cpu_t *const cpu) {
+  return executeJumpTable22[(cpu->insn >> 9) & 0x1](cpu);
+}
 
-u32 (*executeJumpTable23[2])(void) = {
+u32 (*executeJumpTable23[2])(cpu_t *const cpu) = {
     ldrb_r, /* (170 - 177) */
     ldrsh_r /* (178 - 17F) */
 };
 
-u32 entry23(void) { return executeJumpTable23[(insn >> 9) & 0x1](); }
+u32 entry23(cpu_t *const cpu) {
+  return executeJumpTable23[(cpu->insn >> 9) & 0x1](cpu);
+}
 
-u32 (*executeJumpTable44[16])(void) = {
+u32 (*executeJumpTable44[16])(cpu_t *const cpu) = {
     add_sp,                /* (2C0 - 2C1) */
     add_sp,        sub_sp, /* (2C2 - 2C3) */
     sub_sp,        exmemwb_error, exmemwb_error, exmemwb_error, exmemwb_error,
     sxth,          sxtb,          uxth,          uxtb,          exmemwb_error,
     exmemwb_error, exmemwb_error, exmemwb_error};
 
-u32 entry44(void) { return executeJumpTable44[(insn >> 6) & 0xF](); }
+u32 entry44(cpu_t *const cpu) {
+  return executeJumpTable44[(cpu->insn >> 6) & 0xF](cpu);
+}
 
-u32 (*executeJumpTable45[2])(void) = {push, cps};
+u32 (*executeJumpTable45[2])(cpu_t *const cpu) = {push, cps};
 
-u32 entry45(void) { return executeJumpTable45[(insn >> 9) & 0x1](); }
+u32 entry45(cpu_t *const cpu) {
+  return executeJumpTable45[(cpu->insn >> 9) & 0x1](cpu);
+}
 
-u32 (*executeJumpTable46[16])(void) = {
+u32 (*executeJumpTable46[16])(cpu_t *const cpu) = {
     exmemwb_error, exmemwb_error, exmemwb_error, exmemwb_error,
     exmemwb_error, exmemwb_error, exmemwb_error, exmemwb_error,
     rev,           rev16,         exmemwb_error, exmemwb_error,
     exmemwb_error, exmemwb_error, exmemwb_error, exmemwb_error};
 
-u32 entry46(void) { return executeJumpTable46[(insn >> 6) & 0xF](); }
+u32 entry46(cpu_t *const cpu) {
+  return executeJumpTable46[(cpu->insn >> 6) & 0xF](cpu);
+}
 
-u32 entry47(void) {
-  if ((insn >> 8) == 0xbf) {  // hint instructions
-    switch (insn & 0xff) {
+u32 entry47(cpu_t *const cpu) {
+  if ((cpu->insn >> 8) == 0xbf) {  // hint instructions
+    switch (cpu->insn & 0xff) {
       case 0:
         // NOP
-        return nop();
+        return nop(cpu);
       case 0x10:
         // YIELD
-        return nop();
+        return nop(cpu);
       case 0x20:
         // WFE
-        return nop();
+        return nop(cpu);
       case 0x30:
         // WFI
-        return nop();
+        return nop(cpu);
       case 0x40:
         // SEV
-        return nop();
+        return nop(cpu);
       default:
-        fprintf(stderr, "UNDEFINED hint instruction 0x%08x", insn);
-        return exmemwb_error();
+        fprintf(stderr, "UNDEFINED hint instruction 0x%08x", cpu->insn);
+        return exmemwb_error(cpu);
     }
-  } else if ((insn >> 8) == 0xbe) {  // Breakpoint
+  } else if ((cpu->insn >> 8) == 0xbe) {  // Breakpoint
     fprintf(stderr, "BKPT not implemented.");
-    return exmemwb_error();
-  } else if ((insn >> 9) == 0x5e) {  // Pop
-    return pop();
+    return exmemwb_error(cpu);
+  } else if ((cpu->insn >> 9) == 0x5e) {  // Pop
+    return pop(cpu);
   } else {
-    return exmemwb_error();
+    return exmemwb_error(cpu);
   }
 }
 
-u32 entry55(void) {
-  if ((insn & 0x0300) != 0x0300) {
-    return b_c();
-  } else if ((insn & 0xbe00) == 0xbe00) {
+u32 entry55(cpu_t *const cpu) {
+  if ((cpu->insn & 0x0300) != 0x0300) {
+    return b_c(cpu);
+  } else if ((cpu->insn & 0xbe00) == 0xbe00) {
     // Breakpoint instruction
     fprintf(stderr, "BKPT not implemented.");
   } else {
-    fprintf(stderr, "Instruction 0x%04x not implemented.", insn);
+    fprintf(stderr, "Instruction 0x%04x not implemented.", cpu->insn);
   }
-  return exmemwb_error();
+  return exmemwb_error(cpu);
 }
 
-u32 entry6061(void) {
-  if (decoded.imm == 0x80000000) {
-    if ((insn & 0xf3e0) == 0xf3e0) {  // MRS
-      return mrs();
-    } else if ((insn & 0xf380) == 0xf380) {  // MSR
-      return msr();
+u32 entry6061(cpu_t *const cpu) {
+  if (cpu->decoded.imm == 0x80000000) {
+    if ((cpu->insn & 0xf3e0) == 0xf3e0) {  // MRS
+      return mrs(cpu);
+    } else if ((cpu->insn & 0xf380) == 0xf380) {  // MSR
+      return msr(cpu);
     }
   } else {
-    return bl();
+    return bl(cpu);
   }
 }
 
-u32 (*executeJumpTable[64])() = {lsls_i,
-                                 lsls_i,
-                                 lsrs_i,
-                                 lsrs_i,
-                                 asrs_i,
-                                 asrs_i,
-                                 entry6, /* 6 */
-                                 entry7, /* 7 */
-                                 movs_i,
-                                 movs_i,
-                                 cmp_i,
-                                 cmp_i,
-                                 adds_i8,
-                                 adds_i8,
-                                 subs_i8,
-                                 subs_i8,
-                                 entry16, /* 16 */
-                                 entry17, /* 17 */
-                                 ldr_lit,
-                                 ldr_lit,
-                                 entry20, /* 20 */
-                                 entry21, /* 21 */
-                                 entry22, /* 22 */
-                                 entry23, /* 23 */
-                                 str_i,
-                                 str_i,
-                                 ldr_i,
-                                 ldr_i,
-                                 strb_i,
-                                 strb_i,
-                                 ldrb_i,
-                                 ldrb_i,
-                                 strh_i,
-                                 strh_i,
-                                 ldrh_i,
-                                 ldrh_i,
-                                 str_sp,
-                                 str_sp,
-                                 ldr_sp,
-                                 ldr_sp,
-                                 adr,
-                                 adr,
-                                 add_sp,
-                                 add_sp,
-                                 entry44, /* 44 */
-                                 entry45, /* 45 */
-                                 entry46, /* 46 */
-                                 entry47, /* 47 */
-                                 stm,
-                                 stm,
-                                 ldm,
-                                 ldm,
-                                 b_c,
-                                 b_c,
-                                 b_c,
-                                 entry55, /* 55 */
-                                 b,
-                                 b,
-                                 exmemwb_error,
-                                 exmemwb_error,
-                                 entry6061, /* 60 bl or mrs/msr */
-                                 entry6061, /* 61 bl or undef */
-                                 exmemwb_error,
-                                 exmemwb_error};
-
-size_t exwbmem(const u16 pInsn) {
-  insn = pInsn;
-  return executeJumpTable[pInsn >> 10]();
+u32 (*executeJumpTable[64])(cpu_t *const cpu) = {
+    lsls_i,
+    lsls_i,
+    lsrs_i,
+    lsrs_i,
+    asrs_i,
+    asrs_i,
+    entry6, /* 6 */
+    entry7, /* 7 */
+    movs_i,
+    movs_i,
+    cmp_i,
+    cmp_i,
+    adds_i8,
+    adds_i8,
+    subs_i8,
+    subs_i8,
+    entry16, /* 16 */
+    entry17, /* 17 */
+    ldr_lit,
+    ldr_lit,
+    entry20, /* 20 */
+    entry21, /* 21 */
+    entry22, /* 22 */
+    entry23, /* 23 */
+    str_i,
+    str_i,
+    ldr_i,
+    ldr_i,
+    strb_i,
+    strb_i,
+    ldrb_i,
+    ldrb_i,
+    strh_i,
+    strh_i,
+    ldrh_i,
+    ldrh_i,
+    str_sp,
+    str_sp,
+    ldr_sp,
+    ldr_sp,
+    adr,
+    adr,
+    add_sp,
+    add_sp,
+    entry44, /* 44 */
+    entry45, /* 45 */
+    entry46, /* 46 */
+    entry47, /* 47 */
+    stm,
+    stm,
+    ldm,
+    ldm,
+    b_c,
+    b_c,
+    b_c,
+    entry55, /* 55 */
+    b,
+    b,
+    exmemwb_error,
+    exmemwb_error,
+    entry6061, /* 60 bl or mrs/msr */
+    entry6061, /* 61 bl or undef */
+    exmemwb_error,
+    exmemwb_error};
+
+size_t exwbmem(cpu_t *const cpu, const u16 pInsn) {
+  cpu->insn = pInsn;
+  return executeJumpTable[pInsn >> 10](cpu);
+}
+
+exmemwb_handler_t exwbmem_handler(const u16 pInsn) {
+  // Resolve the second-level tables, which only depend on opcode bits
+  switch (pInsn >> 10) {
+    case 6:
+      return executeJumpTable6[(pInsn >> 9) & 0x1];
+    case 7:
+      return executeJumpTable7[(pInsn >> 9) & 0x1];
+    case 16:
+      return executeJumpTable16[(pInsn >> 6) & 0xF];
+    case 17:
+      return executeJumpTable17[(pInsn >> 7) & 0x7];
+    case 20:
+      return executeJumpTable20[(pInsn >> 9) & 0x1];
+    case 21:
+      return executeJumpTable21[(pInsn >> 9) & 0x1];
+    case 22:
+      return executeJumpTable22[(pInsn >> 9) & 0x1];
+    case 23:
+      return executeJumpTable23[(pInsn >> 9) & 0x1];
+    case 44:
+      return executeJumpTable44[(pInsn >> 6) & 0xF];
+    case 45:
+      return executeJumpTable45[(pInsn >> 9) & 0x1];
+    case 46:
+      return executeJumpTable46[(pInsn >> 6) & 0xF];
+    default:
+      return executeJumpTable[pInsn >> 10];
+  }
 }
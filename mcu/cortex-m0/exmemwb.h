@@ -7,6 +7,7 @@
 #ifndef EXWBMEM_HEADER
 #define EXWBMEM_HEADER
 
+#include "decode.h"
 #include "sim_support.h"
 
 #define ESPR_T (1 << 24)
@@ -23,9 +24,21 @@ struct CPU {
   u32 debug;
   u32 mode;
   u32 exceptmask;  // Bit mask of pending exceptions
-};
 
-extern struct CPU cpu;
+  // Pipeline state
+  u16 insn;               // Instruction being executed
+  DECODE_RESULT decoded;  // Result of decoding insn
+  bool takenBranch;       // Informs fetch that previous instruction caused a
+                          // control flow change
+
+  // Callbacks into the simulator, all receive ctx as first argument
+  void *ctx;
+  void (*write_cb)(void *, const uint32_t, uint8_t *const, size_t);
+  void (*read_cb)(void *, const uint32_t, uint8_t *const, size_t);
+  void (*consume_cycles_cb)(void *, const size_t);
+  void (*exception_return_cb)(void *, const uint32_t);
+  uint16_t (*next_pipeline_instr_cb)(void *);
+};
 
 struct SYSTICK {
   u32 control;
@@ -48,11 +61,13 @@ extern struct SYSTICK systick;
 
 // GPR setters and getters
 #if HOOK_GPR_ACCESSES
-u32 cpu_get_gpr(u32 gpr);
-void cpu_set_gpr(u32 gpr, u32 value);
+u32 cpu_hooked_get_gpr(cpu_t *const cpu, u32 gpr);
+void cpu_hooked_set_gpr(cpu_t *const cpu, u32 gpr, u32 value);
+#define cpu_get_gpr(x) cpu_hooked_get_gpr(cpu, x)
+#define cpu_set_gpr(x, y) cpu_hooked_set_gpr(cpu, x, y)
 #else
-#define cpu_get_gpr(x) cpu.gpr[x]
-#define cpu_set_gpr(x, y) cpu.gpr[x] = y
+#define cpu_get_gpr(x) cpu->gpr[x]
+#define cpu_set_gpr(x, y) cpu->gpr[x] = y
 #endif
 
 // GPRs with special functions
@@ -67,18 +82,18 @@ void cpu_set_gpr(u32 gpr, u32 value);
 #define cpu_set_pc(x) cpu_set_gpr(GPR_PC, (x))
 
 // Get, set, and compute the CPU flags
-#define cpu_get_flag_z() ((cpu.apsr & FLAG_Z_MASK) >> FLAG_Z_INDEX)
-#define cpu_get_flag_n() ((cpu.apsr & FLAG_N_MASK) >> FLAG_N_INDEX)
-#define cpu_get_flag_c() ((cpu.apsr & FLAG_C_MASK) >> FLAG_C_INDEX)
-#define cpu_get_flag_v() ((cpu.apsr & FLAG_V_MASK) >> FLAG_V_INDEX)
+#define cpu_get_flag_z() ((cpu->apsr & FLAG_Z_MASK) >> FLAG_Z_INDEX)
+#define cpu_get_flag_n() ((cpu->apsr & FLAG_N_MASK) >> FLAG_N_INDEX)
+#define cpu_get_flag_c() ((cpu->apsr & FLAG_C_MASK) >> FLAG_C_INDEX)
+#define cpu_get_flag_v() ((cpu->apsr & FLAG_V_MASK) >> FLAG_V_INDEX)
 #define cpu_set_flag_z(x) \
-  cpu.apsr = ((((x)&0x1) << FLAG_Z_INDEX) | (cpu.apsr & ~FLAG_Z_MASK))
+  cpu->apsr = ((((x)&0x1) << FLAG_Z_INDEX) | (cpu->apsr & ~FLAG_Z_MASK))
 #define cpu_set_flag_n(x) \
-  cpu.apsr = ((((x)&0x1) << FLAG_N_INDEX) | (cpu.apsr & ~FLAG_N_MASK))
+  cpu->apsr = ((((x)&0x1) << FLAG_N_INDEX) | (cpu->apsr & ~FLAG_N_MASK))
 #define cpu_set_flag_c(x) \
-  cpu.apsr = ((((x)&0x1) << FLAG_C_INDEX) | (cpu.apsr & ~FLAG_C_MASK))
+  cpu->apsr = ((((x)&0x1) << FLAG_C_INDEX) | (cpu->apsr & ~FLAG_C_MASK))
 #define cpu_set_flag_v(x) \
-  cpu.apsr = ((((x)&0x1) << FLAG_V_INDEX) | (cpu.apsr & ~FLAG_V_MASK))
+  cpu->apsr = ((((x)&0x1) << FLAG_V_INDEX) | (cpu->apsr & ~FLAG_V_MASK))
 
 #define do_zflag(x) cpu_set_flag_z(((x) == 0) ? 1 : 0)
 #define do_nflag(x) cpu_set_flag_n((x) >> 31)
@@ -86,28 +101,28 @@ void cpu_set_gpr(u32 gpr, u32 value);
   cpu_set_flag_v((((a) & (b) & (~(r))) >> 31) || \
                  (((~(a)) & (~(b)) & (r)) >> 31))
 
-void do_cflag(u32 a, u32 b, u32 carry);
-#define cpu_get_apsr() (cpu.apsr)
-#define cpu_set_apsr(x) cpu.apsr = (x)
+void do_cflag(cpu_t *const cpu, u32 a, u32 b, u32 carry);
+#define cpu_get_apsr() (cpu->apsr)
+#define cpu_set_apsr(x) cpu->apsr = (x)
 
 // Other SPR
 #define CPU_MODE_HANDLER 0
 #define CPU_MODE_THREAD 1
-#define cpu_mode_is_handler() (cpu.mode == 0x0)
-#define cpu_mode_is_thread() (cpu.mode == 0x1)
-#define cpu_mode_handler() cpu.mode = (0x0)
-#define cpu_mode_thread() cpu.mode = (0x1)
-#define cpu_get_ipsr() (cpu.ipsr)
-#define cpu_set_ipsr(x) cpu.ipsr = (x & 0x3F)
+#define cpu_mode_is_handler() (cpu->mode == 0x0)
+#define cpu_mode_is_thread() (cpu->mode == 0x1)
+#define cpu_mode_handler() cpu->mode = (0x0)
+#define cpu_mode_thread() cpu->mode = (0x1)
+#define cpu_get_ipsr() (cpu->ipsr)
+#define cpu_set_ipsr(x) cpu->ipsr = (x & 0x3F)
 #define CPU_STACK_MAIN 0
 #define CPU_STACK_PROCESS 1
-#define cpu_stack_is_main() ((cpu.control & 0x2) == 0x0)
+#define cpu_stack_is_main() ((cpu->control & 0x2) == 0x0)
 #define cpu_stack_is_process() (~cpu_stack_is_main())
-#define cpu_stack_use_main() cpu.control = (cpu.control & ~0x2)
-#define cpu_stack_use_process() cpu.control = (cpu.control | 0x2)
-#define cpu_get_except() (cpu.exceptmask)
-#define cpu_set_except(x) cpu.exceptmask |= (1 << x)
-#define cpu_clear_except(x) cpu.exceptmask &= ~(1 << x)
+#define cpu_stack_use_main() cpu->control = (cpu->control & ~0x2)
+#define cpu_stack_use_process() cpu->control = (cpu->control | 0x2)
+#define cpu_get_except() (cpu->exceptmask)
+#define cpu_set_except(x) cpu->exceptmask |= (1 << x)
+#define cpu_clear_except(x) cpu->exceptmask &= ~(1 << x)
 
 // Sign extension
 #define zeroExtend32(x) (x)
@@ -117,11 +132,19 @@ void do_cflag(u32 a, u32 b, u32 carry);
 // Special write to PC
 #define alu_write_pc(x)    \
   do {                     \
-    takenBranch = 1;       \
+    cpu->takenBranch = 1;  \
     cpu_set_pc((x) | 0x1); \
   } while (0)
 
-size_t exwbmem(const u16 pInsn);
+size_t exwbmem(cpu_t *const cpu, const u16 pInsn);
+
+// Execute, memory access, and write-back of a single decoded instruction
+// Returns the number of extra cycles spent
+typedef u32 (*exmemwb_handler_t)(cpu_t *const cpu);
+
+// Find the handler exwbmem dispatches pInsn to, so that it can be called
+// directly (with cpu->insn and cpu->decoded set up) without dispatching again
+exmemwb_handler_t exwbmem_handler(const u16 pInsn);
 
 // Timing model
 // Extra execution cycles
@@ -11,49 +11,49 @@
 
 ///--- Compare operations --------------------------------------------///
 
-u32 cmn() {
-  u32 opA = cpu_get_gpr(decoded.rM);
-  u32 opB = cpu_get_gpr(decoded.rN);
+u32 cmn(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rM);
+  u32 opB = cpu_get_gpr(cpu->decoded.rN);
   u32 result = opA + opB;
 
   do_nflag(result);
   do_zflag(result);
-  do_cflag(opA, opB, 0);
+  do_cflag(cpu, opA, opB, 0);
   do_vflag(opA, opB, result);
 
   return TIMING_DEFAULT;
 }
 
-u32 cmp_i() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = ~zeroExtend32(decoded.imm);
+u32 cmp_i(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = ~zeroExtend32(cpu->decoded.imm);
   u32 result = opA + opB + 1;
 
   do_nflag(result);
   do_zflag(result);
-  do_cflag(opA, opB, 1);
+  do_cflag(cpu, opA, opB, 1);
   do_vflag(opA, opB, result);
 
   return TIMING_DEFAULT;
 }
 
-u32 cmp_r() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = ~zeroExtend32(cpu_get_gpr(decoded.rM));
+u32 cmp_r(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = ~zeroExtend32(cpu_get_gpr(cpu->decoded.rM));
   u32 result = opA + opB + 1;
 
   do_nflag(result);
   do_zflag(result);
-  do_cflag(opA, opB, 1);
+  do_cflag(cpu, opA, opB, 1);
   do_vflag(opA, opB, result);
 
   return TIMING_DEFAULT;
 }
 
 // TST - Test for matches
-u32 tst() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = cpu_get_gpr(decoded.rM);
+u32 tst(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = cpu_get_gpr(cpu->decoded.rM);
   u32 result = opA & opB;
 
   do_nflag(result);
@@ -65,20 +65,20 @@ u32 tst() {
 ///--- Branch operations --------------------------------------------///
 
 // B - Unconditional branch
-u32 b() {
-  u32 offset = signExtend32(decoded.imm << 1, 12);
+u32 b(cpu_t *const cpu) {
+  u32 offset = signExtend32(cpu->decoded.imm << 1, 12);
   u32 result = offset + cpu_get_pc();
   cpu_set_pc(result);
-  takenBranch = 1;
+  cpu->takenBranch = 1;
 
   return TIMING_DEFAULT;
 }
 
 // B - Conditional branch
-u32 b_c() {
+u32 b_c(cpu_t *const cpu) {
   u32 taken = 0;
 
-  switch (decoded.cond) {
+  switch (cpu->decoded.cond) {
     case 0x0:  // b eq, z set
       if (cpu_get_flag_z()) taken = 1;
       break;
@@ -131,18 +131,18 @@ u32 b_c() {
     return TIMING_DEFAULT;
   }
 
-  u32 offset = signExtend32(decoded.imm << 1, 9);
+  u32 offset = signExtend32(cpu->decoded.imm << 1, 9);
   u32 pc = cpu_get_pc();
   u32 result = offset + pc;
   cpu_set_pc(result);
-  takenBranch = 1;
+  cpu->takenBranch = 1;
 
   return TIMING_DEFAULT;
 }
 
 // BLX - Unconditional branch and link with switch to ARM mode
-u32 blx() {
-  u32 address = cpu_get_gpr(decoded.rM);
+u32 blx(cpu_t *const cpu) {
+  u32 address = cpu_get_gpr(cpu->decoded.rM);
 
   if ((address & 0x1) == 0) {
     fprintf(stderr, "Error: Interworking not supported: 0x%8.8X\n", address);
@@ -151,15 +151,15 @@ u32 blx() {
 
   cpu_set_lr(cpu_get_pc() - 0x2);
   cpu_set_pc(address);
-  takenBranch = 1;
+  cpu->takenBranch = 1;
 
   return TIMING_DEFAULT;
 }
 
 // BX - Unconditional branch with switch to ARM mode
 // Also may be used as exception return
-u32 bx() {
-  u32 address = cpu_get_gpr(decoded.rM);
+u32 bx(cpu_t *const cpu) {
+  u32 address = cpu_get_gpr(cpu->decoded.rM);
   if ((address & 0x1) == 0) {
     fprintf(stderr, "Error: Interworking not supported: 0x%8.8X\n", address);
     sim_exit(1);
@@ -167,24 +167,24 @@ u32 bx() {
 
   // Check for exception return
   if ((address >> 28) == 0xF)
-    exception_return_cb(address);
+    cpu->exception_return_cb(cpu->ctx, address);
   else
     cpu_set_pc(address);
 
-  takenBranch = 1;
+  cpu->takenBranch = 1;
 
   return TIMING_DEFAULT;
 }
 
 // BL - Unconditional branch and link
 // 32 bit instruction
-u32 bl() {
-  u32 result = signExtend32(decoded.imm << 1, 25);
+u32 bl(cpu_t *const cpu) {
+  u32 result = signExtend32(cpu->decoded.imm << 1, 25);
   result += cpu_get_pc();
 
   cpu_set_lr(cpu_get_pc());
   cpu_set_pc(result);
-  takenBranch = 1;
+  cpu->takenBranch = 1;
 
   return TIMING_DEFAULT;
 }
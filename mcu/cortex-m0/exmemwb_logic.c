@@ -10,12 +10,12 @@
 ///--- Logical operations ----------------------------------------///
 
 // AND - logical AND two registers and update flags
-u32 ands() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = cpu_get_gpr(decoded.rM);
+u32 ands(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = cpu_get_gpr(cpu->decoded.rM);
   u32 result = opA & opB;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -25,12 +25,12 @@ u32 ands() {
 
 // BIC - clears the bits in the destination register that are set in
 // the source register
-u32 bics() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = cpu_get_gpr(decoded.rM);
+u32 bics(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = cpu_get_gpr(cpu->decoded.rM);
   u32 result = opA & ~opB;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -39,12 +39,12 @@ u32 bics() {
 }
 
 // EOR - exclusive OR two registers and update the flags
-u32 eors() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = cpu_get_gpr(decoded.rM);
+u32 eors(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = cpu_get_gpr(cpu->decoded.rM);
   u32 result = opA ^ opB;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -53,12 +53,12 @@ u32 eors() {
 }
 
 // ORR - logical OR two registers and update the flags
-u32 orrs() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = cpu_get_gpr(decoded.rM);
+u32 orrs(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = cpu_get_gpr(cpu->decoded.rM);
   u32 result = opA | opB;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -67,11 +67,11 @@ u32 orrs() {
 }
 
 // MVN - Move while negating
-u32 mvns() {
-  u32 opA = cpu_get_gpr(decoded.rM);
+u32 mvns(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rM);
   u32 result = ~opA;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -83,9 +83,9 @@ u32 mvns() {
 ///--------------------------------------------///
 
 // ASR - Arithmetic shift right (immediate)
-u32 asrs_i() {
-  u32 opA = cpu_get_gpr(decoded.rM);
-  u32 opB = decoded.imm;
+u32 asrs_i(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rM);
+  u32 opB = cpu->decoded.imm;
   u32 result;
 
   // 0 really means 32 (A6.4.1)
@@ -103,7 +103,7 @@ u32 asrs_i() {
   }
   cpu_set_flag_c((opA >> (opB - 1)) & 0x1);
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -112,9 +112,9 @@ u32 asrs_i() {
 }
 
 // ASR - Arithmetic shift right (register)
-u32 asrs_r() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = cpu_get_gpr(decoded.rM) & 0xFF;
+u32 asrs_r(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = cpu_get_gpr(cpu->decoded.rM) & 0xFF;
   u32 result = 0;
 
   if (opB == 0) {
@@ -133,7 +133,7 @@ u32 asrs_r() {
     cpu_set_flag_c((opB >= 32) ? (opA >> 31) : (opA >> (opB - 1)) & 0x1);
   }
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -141,12 +141,12 @@ u32 asrs_r() {
   return TIMING_DEFAULT;
 }
 
-u32 lsls_i() {
-  u32 opA = cpu_get_gpr(decoded.rM);
-  u32 opB = decoded.imm;
+u32 lsls_i(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rM);
+  u32 opB = cpu->decoded.imm;
   u32 result = opA << opB;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -155,13 +155,13 @@ u32 lsls_i() {
   return TIMING_DEFAULT;
 }
 
-u32 lsrs_i() {
-  u32 opA = cpu_get_gpr(decoded.rM);
-  u32 opB = decoded.imm;
+u32 lsrs_i(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rM);
+  u32 opB = cpu->decoded.imm;
   // 0 really means 32 (A6.4.1)
   u32 result = opB ? opA >> opB : 0;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -170,12 +170,12 @@ u32 lsrs_i() {
   return TIMING_DEFAULT;
 }
 
-u32 lsls_r() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = cpu_get_gpr(decoded.rM) & 0xFF;
+u32 lsls_r(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = cpu_get_gpr(cpu->decoded.rM) & 0xFF;
   u32 result = (opB >= 32) ? 0 : opA << opB;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -185,12 +185,12 @@ u32 lsls_r() {
   return TIMING_DEFAULT;
 }
 
-u32 lsrs_r() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = cpu_get_gpr(decoded.rM) & 0xFF;
+u32 lsrs_r(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = cpu_get_gpr(cpu->decoded.rM) & 0xFF;
   u32 result = (opB >= 32) ? 0 : opA >> opB;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   do_nflag(result);
   do_zflag(result);
@@ -200,16 +200,16 @@ u32 lsrs_r() {
   return TIMING_DEFAULT;
 }
 
-u32 rors() {
-  u32 opA = cpu_get_gpr(decoded.rD);
-  u32 opB = cpu_get_gpr(decoded.rM) & 0xFF;
+u32 rors(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rD);
+  u32 opB = cpu_get_gpr(cpu->decoded.rM) & 0xFF;
 
   u32 result = opA;
   if (opB != 0) {
     opB &= 0x1F;  // Everything above 32 is a multiple of 32
     result = (opB == 0) ? opA : opA >> opB | opA << (32 - opB);
     cpu_set_flag_c((result >> 31) & 0x1);
-    cpu_set_gpr(decoded.rD, result);
+    cpu_set_gpr(cpu->decoded.rD, result);
   }
 
   do_nflag(result);
@@ -13,48 +13,48 @@
 ///--------------------------------------------///
 
 // LDM - Load multiple registers from the stack
-u32 ldm() {
+u32 ldm(cpu_t *const cpu) {
   u32 numLoaded = 0;
-  u32 rNWritten = (1 << decoded.rN) & decoded.reg_list;
-  u32 address = cpu_get_gpr(decoded.rN);
+  u32 rNWritten = (1 << cpu->decoded.rN) & cpu->decoded.reg_list;
+  u32 address = cpu_get_gpr(cpu->decoded.rN);
 
   for (int i = 0; i < 8; ++i) {
     int mask = 1 << i;
-    if (decoded.reg_list & mask) {
+    if (cpu->decoded.reg_list & mask) {
       u32 data = 0;
-      simLoadWord(address, &data);
+      simLoadWord(cpu, address, &data);
       cpu_set_gpr(i, data);
       address += 4;
       ++numLoaded;
     }
   }
 
-  if (rNWritten == 0) cpu_set_gpr(decoded.rN, address);
+  if (rNWritten == 0) cpu_set_gpr(cpu->decoded.rN, address);
 
   return TIMING_DEFAULT;
 }
 
 // STM - Store multiple registers to the stack
-u32 stm() {
+u32 stm(cpu_t *const cpu) {
   u32 numStored = 0;
-  u32 address = cpu_get_gpr(decoded.rN);
+  u32 address = cpu_get_gpr(cpu->decoded.rN);
 
   for (int i = 0; i < 8; ++i) {
     int mask = 1 << i;
-    if (decoded.reg_list & mask) {
-      if (i == decoded.rN && numStored == 0) {
+    if (cpu->decoded.reg_list & mask) {
+      if (i == cpu->decoded.rN && numStored == 0) {
         fprintf(stderr, "Error: Malformed instruction!\n");
         sim_exit(1);
       }
 
       u32 data = cpu_get_gpr(i);
-      simStoreWord(address, data);
+      simStoreWord(cpu, address, data);
       address += 4;
       ++numStored;
     }
   }
 
-  cpu_set_gpr(decoded.rN, address);
+  cpu_set_gpr(cpu->decoded.rN, address);
 
   return TIMING_DEFAULT;
 }
@@ -62,7 +62,7 @@ u32 stm() {
 ///--- Stack operations --------------------------------------------///
 
 // Pop multiple reg values from the stack and update SP
-u32 pop() {
+u32 pop(cpu_t *const cpu) {
   u32 numLoaded = 0;
   u32 address = cpu_get_sp();
   u32 exceptionReturnAddress = 0;
@@ -70,13 +70,13 @@ u32 pop() {
 
   for (int i = 0; i < 16; ++i) {
     int mask = 1 << i;
-    if (decoded.reg_list & mask) {
+    if (cpu->decoded.reg_list & mask) {
       u32 data = 0;
-      simLoadWord(address, &data);
+      simLoadWord(cpu, address, &data);
       cpu_set_gpr(i, data);
       ++numLoaded;
       if (i == 15) {  // PC is target
-        takenBranch = 1;
+        cpu->takenBranch = 1;
         extraCycles = TIMING_POP_AND_RETURN;
         if ((data & 0xf0000000) == 0xf0000000) {
           // This is an exception return
@@ -92,23 +92,23 @@ u32 pop() {
 
   cpu_set_sp(address);
   if (exceptionReturnAddress != 0) {
-    exception_return_cb(exceptionReturnAddress);
+    cpu->exception_return_cb(cpu->ctx, exceptionReturnAddress);
   }
 
   return extraCycles;
 }
 
 // Push multiple reg values to the stack and update SP
-u32 push() {
+u32 push(cpu_t *const cpu) {
   u32 numStored = 0;
   u32 address = cpu_get_sp();
 
   for (int i = 14; i >= 0; --i) {
     int mask = 1 << i;
-    if (decoded.reg_list & mask) {
+    if (cpu->decoded.reg_list & mask) {
       address -= 4;
       u32 data = cpu_get_gpr(i);
-      simStoreWord(address, data);
+      simStoreWord(cpu, address, data);
       ++numStored;
     }
 
@@ -124,197 +124,197 @@ u32 push() {
 ///--- Single load operations --------------------------------------------///
 
 // LDR - Load from offset from register
-u32 ldr_i() {
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = zeroExtend32(decoded.imm << 2);
+u32 ldr_i(cpu_t *const cpu) {
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = zeroExtend32(cpu->decoded.imm << 2);
   u32 effectiveAddress = base + offset;
 
   u32 result = 0;
-  simLoadWord(effectiveAddress, &result);
+  simLoadWord(cpu, effectiveAddress, &result);
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
 
 // LDR - Load from offset from SP
-u32 ldr_sp() {
+u32 ldr_sp(cpu_t *const cpu) {
   u32 base = cpu_get_sp();
-  u32 offset = zeroExtend32(decoded.imm << 2);
+  u32 offset = zeroExtend32(cpu->decoded.imm << 2);
   u32 effectiveAddress = base + offset;
 
   u32 result = 0;
-  simLoadWord(effectiveAddress, &result);
+  simLoadWord(cpu, effectiveAddress, &result);
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
 
 // LDR - Load from offset from PC
-u32 ldr_lit() {
+u32 ldr_lit(cpu_t *const cpu) {
   u32 base = cpu_get_pc() & 0xFFFFFFFC;
-  u32 offset = zeroExtend32(decoded.imm << 2);
+  u32 offset = zeroExtend32(cpu->decoded.imm << 2);
   u32 effectiveAddress = base + offset;
 
   u32 result = 0;
-  simLoadWord(effectiveAddress, &result);
+  simLoadWord(cpu, effectiveAddress, &result);
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
 
 // LDR - Load from an offset from a reg based on another reg value
-u32 ldr_r() {
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = cpu_get_gpr(decoded.rM);
+u32 ldr_r(cpu_t *const cpu) {
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = cpu_get_gpr(cpu->decoded.rM);
   u32 effectiveAddress = base + offset;
 
   u32 result = 0;
-  simLoadWord(effectiveAddress, &result);
+  simLoadWord(cpu, effectiveAddress, &result);
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
 
 // LDRB - Load byte from offset from register
-u32 ldrb_i() {
+u32 ldrb_i(cpu_t *const cpu) {
   u32 result = 0;
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = zeroExtend32(decoded.imm);
-  simLoadByte(base + offset, &result);
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = zeroExtend32(cpu->decoded.imm);
+  simLoadByte(cpu, base + offset, &result);
   result = zeroExtend32(result & 0xFF);
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
   return TIMING_DEFAULT;
 }
 
 // LDRB - Load byte from an offset from a reg based on another reg value
-u32 ldrb_r() {
+u32 ldrb_r(cpu_t *const cpu) {
   u32 result = 0;
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = cpu_get_gpr(decoded.rM);
-  simLoadByte(base + offset, &result);
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = cpu_get_gpr(cpu->decoded.rM);
+  simLoadByte(cpu, base + offset, &result);
   result = zeroExtend32(result & 0xFF);
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
   return TIMING_DEFAULT;
 }
 
 // LDRH - Load halfword from offset from register
-u32 ldrh_i() {
+u32 ldrh_i(cpu_t *const cpu) {
   u32 result = 0;
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = zeroExtend32(decoded.imm << 1);
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = zeroExtend32(cpu->decoded.imm << 1);
   u32 effectiveAddress = (base + offset) & (~1u);
-  simLoadHalfWord(effectiveAddress, &result);
+  simLoadHalfWord(cpu, effectiveAddress, &result);
   result = zeroExtend32(result & 0xFFFF);
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
   return TIMING_DEFAULT;
 }
 
 // LDRH - Load halfword from an offset from a reg based on another reg value
-u32 ldrh_r() {
+u32 ldrh_r(cpu_t *const cpu) {
   u32 result = 0;
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = cpu_get_gpr(decoded.rM);
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = cpu_get_gpr(cpu->decoded.rM);
   u32 effectiveAddress = (base + offset) & (~1u);
-  simLoadHalfWord(effectiveAddress, &result);
+  simLoadHalfWord(cpu, effectiveAddress, &result);
   result = zeroExtend32(result & 0xFFFF);
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
   return TIMING_DEFAULT;
 }
 
 // LDRSB - Load signed byte from an offset from a reg based on another reg value
-u32 ldrsb_r() {
+u32 ldrsb_r(cpu_t *const cpu) {
   u32 result = 0;
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = cpu_get_gpr(decoded.rM);
-  simLoadByte(base + offset, &result);
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = cpu_get_gpr(cpu->decoded.rM);
+  simLoadByte(cpu, base + offset, &result);
   result = signExtend32(result & 0xFF, 8);
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
   return TIMING_DEFAULT;
 }
 
 // LDRSH - Load signed halfword from an offset from a reg based on another reg
 // value
-u32 ldrsh_r() {
+u32 ldrsh_r(cpu_t *const cpu) {
   u32 result = 0;
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = cpu_get_gpr(decoded.rM);
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = cpu_get_gpr(cpu->decoded.rM);
   u32 effectiveAddress = (base + offset) & (~1u);
-  simLoadHalfWord(effectiveAddress, &result);
+  simLoadHalfWord(cpu, effectiveAddress, &result);
   result = signExtend32(result & 0xFFFF, 16);
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
   return TIMING_DEFAULT;
 }
 
 ///--- Single store operations --------------------------------------------///
 
 // STR - Store to offset from register
-u32 str_i() {
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = zeroExtend32(decoded.imm << 2);
+u32 str_i(cpu_t *const cpu) {
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = zeroExtend32(cpu->decoded.imm << 2);
   u32 effectiveAddress = base + offset;
 
-  simStoreWord(effectiveAddress, cpu_get_gpr(decoded.rD));
+  simStoreWord(cpu, effectiveAddress, cpu_get_gpr(cpu->decoded.rD));
   return TIMING_DEFAULT;
 }
 
 // STR - Store to offset from SP
-u32 str_sp() {
+u32 str_sp(cpu_t *const cpu) {
   u32 base = cpu_get_sp();
-  u32 offset = zeroExtend32(decoded.imm << 2);
+  u32 offset = zeroExtend32(cpu->decoded.imm << 2);
   u32 effectiveAddress = base + offset;
 
-  simStoreWord(effectiveAddress, cpu_get_gpr(decoded.rD));
+  simStoreWord(cpu, effectiveAddress, cpu_get_gpr(cpu->decoded.rD));
 
   return TIMING_DEFAULT;
 }
 
 // STR - Store to an offset from a reg based on another reg value
-u32 str_r() {
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = cpu_get_gpr(decoded.rM);
+u32 str_r(cpu_t *const cpu) {
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = cpu_get_gpr(cpu->decoded.rM);
   u32 effectiveAddress = base + offset;
 
-  simStoreWord(effectiveAddress, cpu_get_gpr(decoded.rD));
+  simStoreWord(cpu, effectiveAddress, cpu_get_gpr(cpu->decoded.rD));
 
   return TIMING_DEFAULT;
 }
 
 // STRB - Store byte to offset from register
-u32 strb_i() {
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = zeroExtend32(decoded.imm);
-  simStoreByte(base + offset, cpu_get_gpr(decoded.rD) & 0xFF);
+u32 strb_i(cpu_t *const cpu) {
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = zeroExtend32(cpu->decoded.imm);
+  simStoreByte(cpu, base + offset, cpu_get_gpr(cpu->decoded.rD) & 0xFF);
   return TIMING_DEFAULT;
 }
 
 // STRB - Store byte to an offset from a reg based on another reg value
-u32 strb_r() {
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = cpu_get_gpr(decoded.rM);
-  simStoreByte(base + offset, cpu_get_gpr(decoded.rD) & 0xFF);
+u32 strb_r(cpu_t *const cpu) {
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = cpu_get_gpr(cpu->decoded.rM);
+  simStoreByte(cpu, base + offset, cpu_get_gpr(cpu->decoded.rD) & 0xFF);
   return TIMING_DEFAULT;
 }
 
 // STRH - Store halfword to offset from register
-u32 strh_i() {
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = zeroExtend32(decoded.imm << 1);
+u32 strh_i(cpu_t *const cpu) {
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = zeroExtend32(cpu->decoded.imm << 1);
   u32 effectiveAddress = (base + offset) & (~1u);
-  u32 data = cpu_get_gpr(decoded.rD) & 0xFFFF;
-  simStoreHalfWord(effectiveAddress, data);
+  u32 data = cpu_get_gpr(cpu->decoded.rD) & 0xFFFF;
+  simStoreHalfWord(cpu, effectiveAddress, data);
   return TIMING_DEFAULT;
 }
 
 // STRH - Store halfword to an offset from a reg based on another reg value
-u32 strh_r() {
-  u32 base = cpu_get_gpr(decoded.rN);
-  u32 offset = cpu_get_gpr(decoded.rM);
+u32 strh_r(cpu_t *const cpu) {
+  u32 base = cpu_get_gpr(cpu->decoded.rN);
+  u32 offset = cpu_get_gpr(cpu->decoded.rM);
   u32 effectiveAddress = (base + offset) & (~1u);
-  u32 data = cpu_get_gpr(decoded.rD) & 0xFFFF;
-  simStoreHalfWord(effectiveAddress, data);
+  u32 data = cpu_get_gpr(cpu->decoded.rD) & 0xFFFF;
+  simStoreHalfWord(cpu, effectiveAddress, data);
   return TIMING_DEFAULT;
 }
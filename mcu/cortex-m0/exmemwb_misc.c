@@ -11,9 +11,9 @@
 ///--- Move operations -------------------------------------------///
 
 // MOVS - write an immediate to the destination register
-u32 movs_i() {
-  u32 opA = zeroExtend32(decoded.imm);
-  cpu_set_gpr(decoded.rD, opA);
+u32 movs_i(cpu_t *const cpu) {
+  u32 opA = zeroExtend32(cpu->decoded.imm);
+  cpu_set_gpr(cpu->decoded.rD, opA);
 
   do_nflag(opA);
   do_zflag(opA);
@@ -22,21 +22,21 @@ u32 movs_i() {
 }
 
 // MOV - copy the source register value to the destination register
-u32 mov_r() {
-  u32 opA = cpu_get_gpr(decoded.rM);
+u32 mov_r(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rM);
 
-  if (decoded.rD == GPR_PC)
+  if (cpu->decoded.rD == GPR_PC)
     alu_write_pc(opA);
   else
-    cpu_set_gpr(decoded.rD, opA);
+    cpu_set_gpr(cpu->decoded.rD, opA);
 
   return TIMING_DEFAULT;
 }
 
 // MOVS - copy the low source register value to the destination low register
-u32 movs_r() {
-  u32 opA = cpu_get_gpr(decoded.rM);
-  cpu_set_gpr(decoded.rD, opA);
+u32 movs_r(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rM);
+  cpu_set_gpr(cpu->decoded.rD, opA);
 
   do_nflag(opA);
   do_zflag(opA);
@@ -45,9 +45,9 @@ u32 movs_r() {
 }
 
 // MRS - Move to Register from Special register
-u32 mrs() {
-  int n = decoded.rM;
-  int d = decoded.rD;
+u32 mrs(cpu_t *const cpu) {
+  int n = cpu->decoded.rM;
+  int d = cpu->decoded.rD;
   int result = 0;
 
   switch ((n & 0xf8) >> 3) {
@@ -77,21 +77,21 @@ u32 mrs() {
       break;
     case 2:
       if ((n & 7u) == 0) {
-        result = cpu.primask & 1u;
+        result = cpu->primask & 1u;
       } else if ((n & 7u) == 4u) {
-        result = cpu.control & 3u;
+        result = cpu->control & 3u;
       }
   }
   cpu_set_gpr(d, result);
-  takenBranch = 1;
+  cpu->takenBranch = 1;
   return TIMING_SPECIAL_REGISTER;
 }
 
 // MSR - Move to Special register from Register
-u32 msr() {
-  int n = decoded.rM;
+u32 msr(cpu_t *const cpu) {
+  int n = cpu->decoded.rM;
   int nval = cpu_get_gpr(n);
-  int d = decoded.rD;
+  int d = cpu->decoded.rD;
   switch ((d & 0xf8) >> 3) {
     case 0:
       if (d & 0b100) {
@@ -123,10 +123,10 @@ u32 msr() {
               "MSR: Warning, we're not checking privelege before "
               "setting CONTROL.\n");
       if ((d & 7u) == 0) {
-        cpu.primask = nval & 1u;
+        cpu->primask = nval & 1u;
       } else if (((d & 7u) == 4u) && cpu_mode_is_thread()) {
-        cpu.control = (cpu.control & (~1u)) | (nval & (~1u));  // nPRIV
-        cpu.control = (cpu.control & (~2u)) | (nval & (~2u));  // SPSEL
+        cpu->control = (cpu->control & (~1u)) | (nval & (~1u));  // nPRIV
+        cpu->control = (cpu->control & (~2u)) | (nval & (~2u));  // SPSEL
       }
       break;
     case 3:
@@ -139,19 +139,19 @@ u32 msr() {
       fprintf(stderr, "MSR: Unrecognized instruction.\n");
       break;
   }
-  takenBranch = 1;  // Because this was a 32-bit instruction
+  cpu->takenBranch = 1;  // Because this was a 32-bit instruction
   return TIMING_SPECIAL_REGISTER;
 }
 
 // CPS - Enable/disable interrupts via PRIMASK
-u32 cps() {
+u32 cps(cpu_t *const cpu) {
   fprintf(stderr,
           "CPS: Warning, not checking privelege before setting PRIMASK.\n");
-  cpu.primask = decoded.imm;
+  cpu->primask = cpu->decoded.imm;
   return TIMING_DEFAULT;
 }
 
-u32 nop() {
+u32 nop(cpu_t *const cpu) {
   // Do nothing
   return TIMING_DEFAULT;
 }
@@ -159,75 +159,75 @@ u32 nop() {
 ///--- Bit twiddling operations -------------------------------------------///
 
 // SXTB - Sign extend a byte to a word
-u32 sxtb() {
-  u32 result = 0xFF & cpu_get_gpr(decoded.rM);
+u32 sxtb(cpu_t *const cpu) {
+  u32 result = 0xFF & cpu_get_gpr(cpu->decoded.rM);
   result = (result & 0x80) != 0 ? (result | 0xFFFFFF00) : result;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
 
 // SXTH - Sign extend a halfword to a word
-u32 sxth() {
-  u32 result = 0xFFFF & cpu_get_gpr(decoded.rM);
+u32 sxth(cpu_t *const cpu) {
+  u32 result = 0xFFFF & cpu_get_gpr(cpu->decoded.rM);
   result = (result & 0x8000) != 0 ? (result | 0xFFFF0000) : result;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
 
 // UXTB - Extend a byte to a word
-u32 uxtb() {
-  u32 result = 0xFF & cpu_get_gpr(decoded.rM);
-  cpu_set_gpr(decoded.rD, result);
+u32 uxtb(cpu_t *const cpu) {
+  u32 result = 0xFF & cpu_get_gpr(cpu->decoded.rM);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
 
 // UXTH - Extend a halfword to a word
-u32 uxth() {
-  u32 result = 0xFFFF & cpu_get_gpr(decoded.rM);
-  cpu_set_gpr(decoded.rD, result);
+u32 uxth(cpu_t *const cpu) {
+  u32 result = 0xFFFF & cpu_get_gpr(cpu->decoded.rM);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
 
 // REV - Reverse ordering of bytes in a word
-u32 rev() {
-  u32 opA = cpu_get_gpr(decoded.rM);
+u32 rev(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rM);
   u32 result = opA << 24;
   result |= (opA << 8) & 0xFF0000;
   result |= (opA >> 8) & 0xFF00;
   result |= (opA >> 24);
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
 
 // REV16 - Reverse ordering of bytes in a packed halfword
-u32 rev16() {
-  u32 opA = cpu_get_gpr(decoded.rM);
+u32 rev16(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rM);
   u32 result = (opA << 8) & 0xFF000000;
   result |= (opA >> 8) & 0xFF0000;
   result |= (opA << 8) & 0xFF00;
   result |= (opA >> 8) & 0xFF;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
 
 // REVSH - Reverse ordering of bytes in a signed halfword
-u32 revsh() {
-  u32 opA = cpu_get_gpr(decoded.rM);
+u32 revsh(cpu_t *const cpu) {
+  u32 opA = cpu_get_gpr(cpu->decoded.rM);
   u32 result = (opA & 0x8) != 0 ? (0xFFFFFF00 | opA) : (0xFF & opA);
   result <<= 8;
   result |= (opA >> 8) & 0xFF;
 
-  cpu_set_gpr(decoded.rD, result);
+  cpu_set_gpr(cpu->decoded.rD, result);
 
   return TIMING_DEFAULT;
 }
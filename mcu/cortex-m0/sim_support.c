@@ -12,40 +12,39 @@
 #error "TARGET_BIG_ENDIAN or TARGET_LITTLE_ENDIAN must be defined"
 #endif
 
-bool takenBranch = 0;
-
-// Callbacks
-void (*write_cb)(const uint32_t, uint8_t *const, size_t);
-void (*read_cb)(const uint32_t, uint8_t *const, size_t);
-void (*consume_cycles_cb)(const size_t);
-void (*exception_return_cb)(const uint32_t);
-uint16_t (*next_pipeline_instr_cb)(void);
+// Set context passed to all callbacks
+void cpu_set_callback_context(cpu_t *const cpu, void *ctx) { cpu->ctx = ctx; }
 
 // Set callback to write data to memory
-void cpu_set_write_memory_cb(void (*fptr)(const uint32_t, uint8_t *const,
-                                          size_t)) {
-  write_cb = fptr;
+void cpu_set_write_memory_cb(cpu_t *const cpu,
+                             void (*fptr)(void *, const uint32_t,
+                                          uint8_t *const, size_t)) {
+  cpu->write_cb = fptr;
 }
 
 // Set callback to read data from memory
-void cpu_set_read_memory_cb(void (*fptr)(const uint32_t, uint8_t *const,
-                                         size_t)) {
-  read_cb = fptr;
+void cpu_set_read_memory_cb(cpu_t *const cpu,
+                            void (*fptr)(void *, const uint32_t,
+                                         uint8_t *const, size_t)) {
+  cpu->read_cb = fptr;
 }
 
 // Set callback to consume clock cycles / simulation time
-void cpu_set_consume_cycles_cb(void (*fptr)(const size_t)) {
-  consume_cycles_cb = fptr;
+void cpu_set_consume_cycles_cb(cpu_t *const cpu,
+                               void (*fptr)(void *, const size_t)) {
+  cpu->consume_cycles_cb = fptr;
 }
 
 // Set callback for exception return
-void cpu_set_exception_return_cb(void (*fptr)(const uint32_t)) {
-  exception_return_cb = fptr;
+void cpu_set_exception_return_cb(cpu_t *const cpu,
+                                 void (*fptr)(void *, const uint32_t)) {
+  cpu->exception_return_cb = fptr;
 }
 
 // Set callback for exception return
-void cpu_set_next_pipeline_instr_cb(uint16_t (*fptr)(void)) {
-  next_pipeline_instr_cb = fptr;
+void cpu_set_next_pipeline_instr_cb(cpu_t *const cpu,
+                                    uint16_t (*fptr)(void *)) {
+  cpu->next_pipeline_instr_cb = fptr;
 }
 
 uint32_t pack32(const uint8_t *const data) {
@@ -91,56 +90,56 @@ void unpack16(uint8_t *const out, const uint16_t in) {
 }
 
 #if HOOK_GPR_ACCESSES
-void do_nothing(void) { ; }
+void do_nothing(cpu_t *const cpu) { ; }
 
-void report_sp(void) {
+void report_sp(cpu_t *const cpu) {
   if (cpu_get_sp() < 0X40010000) {
     fprintf(stderr, "SP crosses heap: 0x%8.8X\n", cpu_get_sp());
     fprintf(stderr, "PC: 0x%8.8X\n", cpu_get_pc());
   }
 }
 
-void (*gprReadHooks[16])(void) = {
+void (*gprReadHooks[16])(cpu_t *const cpu) = {
     do_nothing, do_nothing, do_nothing, do_nothing, do_nothing, do_nothing,
     do_nothing, do_nothing, do_nothing, do_nothing, do_nothing, do_nothing,
     do_nothing, do_nothing, do_nothing, do_nothing};
 
-void (*gprWriteHooks[16])(void) = {
+void (*gprWriteHooks[16])(cpu_t *const cpu) = {
     do_nothing, do_nothing, do_nothing, do_nothing, do_nothing, do_nothing,
     do_nothing, do_nothing, do_nothing, do_nothing, do_nothing, do_nothing,
     do_nothing, do_nothing, report_sp,  do_nothing};
 #endif
 
 // load 16-bit instruction
-char simLoadInsn(u32 address, u16 *value) {
+char simLoadInsn(cpu_t *const cpu, u32 address, u16 *value) {
   uint8_t tmp[2];
-  read_cb(address & (~1u), tmp, 2);  // Mask thumb-bit & read
+  cpu->read_cb(cpu->ctx, address & (~1u), tmp, 2);  // Mask thumb-bit & read
   *value = pack16(tmp);
   return 0;
 }
 
-char simLoadWord(u32 address, u32 *value) {
+char simLoadWord(cpu_t *const cpu, u32 address, u32 *value) {
   uint8_t tmp[4];
-  read_cb(address, tmp, 4);
+  cpu->read_cb(cpu->ctx, address, tmp, 4);
   *value = pack32(tmp);
   return 0;
 }
 
-char simLoadHalfWord(u32 address, u32 *value) {
+char simLoadHalfWord(cpu_t *const cpu, u32 address, u32 *value) {
   uint8_t tmp[2];
-  read_cb(address, tmp, 2);
+  cpu->read_cb(cpu->ctx, address, tmp, 2);
   *value = pack16(tmp);
   return 0;
 }
 
-char simLoadByte(u32 address, u32 *value) {
+char simLoadByte(cpu_t *const cpu, u32 address, u32 *value) {
   uint8_t tmp[1];
-  read_cb(address, tmp, 1);
+  cpu->read_cb(cpu->ctx, address, tmp, 1);
   *value = tmp[0];
   return 0;
 }
 
-char simStoreWord(u32 address, u32 value) {
+char simStoreWord(cpu_t *const cpu, u32 address, u32 value) {
   if ((address & 0x3) != 0)  // Thumb-mode requires LSB = 1
   {
     fprintf(stderr, "Unalinged data memory write: 0x%8.8X\n", address);
@@ -150,11 +149,11 @@ char simStoreWord(u32 address, u32 value) {
   // Unpack data
   uint8_t data[4];
   unpack32(data, value);
-  write_cb(address, data, 4);
+  cpu->write_cb(cpu->ctx, address, data, 4);
   return 0;
 }
 
-char simStoreHalfWord(u32 address, u16 value) {
+char simStoreHalfWord(cpu_t *const cpu, u32 address, u16 value) {
   if ((address & 0x1) != 0) {
     fprintf(stderr, "Unalinged half word write: 0x%8.8X\n", address);
     sim_exit(1);
@@ -163,12 +162,12 @@ char simStoreHalfWord(u32 address, u16 value) {
   // Unpack data
   uint8_t data[2];
   unpack16(data, value);
-  write_cb(address, data, 2);
+  cpu->write_cb(cpu->ctx, address, data, 2);
   return 0;
 }
 
-char simStoreByte(u32 address, u8 value) {
-  write_cb(address, &value, 1);
+char simStoreByte(cpu_t *const cpu, u32 address, u8 value) {
+  cpu->write_cb(cpu->ctx, address, &value, 1);
   return 0;
 }
 
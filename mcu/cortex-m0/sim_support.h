@@ -21,44 +21,44 @@ typedef __uint8_t u8;
 typedef __uint16_t u16;
 typedef struct CPU cpu_t;
 
-// callbacks for memory access
-extern void (*write_cb)(const uint32_t, uint8_t *const, size_t);
-extern void (*read_cb)(const uint32_t, uint8_t *const, size_t);
-extern void (*consume_cycles_cb)(const size_t);
-extern void (*exception_return_cb)(const uint32_t);
-extern uint16_t (*next_pipeline_instr_cb)(void);
+// Register callbacks of a cpu. Each callback receives the context set with
+// cpu_set_callback_context as first argument.
+void cpu_set_callback_context(cpu_t *const cpu, void *ctx);
 
-void cpu_set_write_memory_cb(void (*fptr)(const uint32_t, uint8_t *const,
-                                          size_t));
-void cpu_set_read_memory_cb(void (*fptr)(const uint32_t, uint8_t *const,
-                                         size_t));
-void cpu_set_consume_cycles_cb(void (*fptr)(const size_t));
+void cpu_set_write_memory_cb(cpu_t *const cpu,
+                             void (*fptr)(void *, const uint32_t,
+                                          uint8_t *const, size_t));
+void cpu_set_read_memory_cb(cpu_t *const cpu,
+                            void (*fptr)(void *, const uint32_t,
+                                         uint8_t *const, size_t));
+void cpu_set_consume_cycles_cb(cpu_t *const cpu,
+                               void (*fptr)(void *, const size_t));
 
-void cpu_set_exception_return_cb(void (*fptr)(const uint32_t));
+void cpu_set_exception_return_cb(cpu_t *const cpu,
+                                 void (*fptr)(void *, const uint32_t));
 
-void cpu_set_next_pipeline_instr_cb(uint16_t (*fptr)(void));
+void cpu_set_next_pipeline_instr_cb(cpu_t *const cpu,
+                                    uint16_t (*fptr)(void *));
 
 // Core CPU components
-extern bool takenBranch;    // Informs fetch that previous instruction caused a
-                            // control flow change
 extern void sim_exit(int);  // All sim ends lead through here
-char simLoadInsn(u32 address,
+char simLoadInsn(cpu_t *const cpu, u32 address,
                  u16 *value);  // All memory accesses once simulation starts
                                // should be through these interfaces
-char simLoadWord(u32 address, u32 *value);
-char simLoadHalfWord(u32 address, u32 *value);
-char simLoadByte(u32 address, u32 *value);
-char simStoreWord(u32 address, u32 value);
-char simStoreHalfWord(u32 address, u16 value);
-char simStoreByte(u32 address, u8 value);
+char simLoadWord(cpu_t *const cpu, u32 address, u32 *value);
+char simLoadHalfWord(cpu_t *const cpu, u32 address, u32 *value);
+char simLoadByte(cpu_t *const cpu, u32 address, u32 *value);
+char simStoreWord(cpu_t *const cpu, u32 address, u32 value);
+char simStoreHalfWord(cpu_t *const cpu, u32 address, u16 value);
+char simStoreByte(cpu_t *const cpu, u32 address, u8 value);
 
 // Hooks to run code every time a GPR is accessed
 #define HOOK_GPR_ACCESSES 0
 
 #if HOOK_GPR_ACCESSES
-void do_nothing(void);
-void report_sp(void);
-void (*gprReadHooks[16])(void);
-void (*gprWriteHooks[16])(void);
+void do_nothing(cpu_t *const cpu);
+void report_sp(cpu_t *const cpu);
+void (*gprReadHooks[16])(cpu_t *const cpu);
+void (*gprWriteHooks[16])(cpu_t *const cpu);
 #endif
 #endif
@@ -231,3 +231,13 @@ void ClockSystem::updateClocks(void) {
     modclk->setPeriod(SC_ZERO_TIME);
   }
 }
+
+void ClockSystem::saveState(CheckpointOut &out) {
+  BusTarget::saveState(out);
+  out.put<bool>(locked);
+}
+
+void ClockSystem::restoreState(CheckpointIn &in) {
+  BusTarget::restoreState(in);
+  locked = in.get<bool>();
+}
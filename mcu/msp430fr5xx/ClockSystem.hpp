@@ -48,6 +48,16 @@ class ClockSystem : public BusTarget {
   virtual void b_transport(tlm::tlm_generic_payload &trans,
                            sc_core::sc_time &delay) override;
 
+  /**
+   * @brief saveState save registers and lock state.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState restore registers and lock state, and update clocks.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
   /*------ Static constants ------*/
  private:
   // Base clocks
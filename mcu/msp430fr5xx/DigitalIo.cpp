@@ -133,3 +133,13 @@ void DigitalIo::process(void) {
   }
   return;
 }
+
+void DigitalIo::saveState(CheckpointOut &out) {
+  BusTarget::saveState(out);
+  out.put<unsigned>(m_lastState);
+}
+
+void DigitalIo::restoreState(CheckpointIn &in) {
+  BusTarget::restoreState(in);
+  m_lastState = in.get<unsigned>();
+}
@@ -45,6 +45,16 @@ class DigitalIo : public BusTarget {
    */
   virtual void end_of_elaboration() override;
 
+  /**
+   * @brief saveState save registers and the last pin state.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState restore registers and the last pin state.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
  private:
   /* ------ Private variables ------ */
   int m_pinPosEdgeId{-1};
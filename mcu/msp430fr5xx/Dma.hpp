@@ -47,7 +47,7 @@ SC_MODULE(TriggerMux) {
 };
 
 // DMA  channel
-SC_MODULE(DmaChannel) {
+class DmaChannel : public sc_core::sc_module, public Checkpointable {
  public:
   /*------ Ports ------*/
   sc_core::sc_port<ClockSourceConsumerIf> systemClk{
@@ -105,6 +105,16 @@ SC_MODULE(DmaChannel) {
    */
   void reset();
 
+  /**
+   * @brief saveState save configuration, flags, and transfer progress.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState restore state saved by saveState.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
   /**
    * @brief << debug printout.
    */
@@ -7,6 +7,7 @@
 
 #include <spdlog/spdlog.h>
 #include <stdint.h>
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
@@ -28,11 +29,28 @@ extern "C" {
 
 using namespace sc_core;
 
+const Msp430Cpu::src_loader_t Msp430Cpu::SRC_LOADERS[N_SRC_MODES] = {
+    &Msp430Cpu::loadSrcRegister, &Msp430Cpu::loadSrcConstant,
+    &Msp430Cpu::loadSrcIndexed,  &Msp430Cpu::loadSrcSymbolic,
+    &Msp430Cpu::loadSrcAbsolute, &Msp430Cpu::loadSrcIndirect,
+    &Msp430Cpu::loadSrcAutoincrement, &Msp430Cpu::loadSrcImmediate};
+
+const Msp430Cpu::dst_loader_t Msp430Cpu::DST_LOADERS[N_DST_MODES] = {
+    &Msp430Cpu::loadDstRegister, &Msp430Cpu::loadDstIndexed,
+    &Msp430Cpu::loadDstSymbolic, &Msp430Cpu::loadDstAbsolute,
+    &Msp430Cpu::loadDstInvalid};
+
+const Msp430Cpu::executor_t Msp430Cpu::EXECUTORS[N_FORMATS] = {
+    &Msp430Cpu::executeSingleOpInstruction,
+    &Msp430Cpu::executeConditionalJump,
+    &Msp430Cpu::executeDoubleOpInstruction};
+
 Msp430Cpu::Msp430Cpu(const sc_module_name name, const bool logOperation,
                      const bool logInstructions)
     : sc_module(name),
       m_doLogOperation(logOperation),
-      m_doLogInstructions(logInstructions) {
+      m_doLogInstructions(logInstructions),
+      m_decodeTable(decodeTable()) {
   iSocket.bind(*this);
 
   SC_THREAD(process);
@@ -45,6 +63,24 @@ Msp430Cpu::Msp430Cpu(const sc_module_name name, const bool logOperation,
   if (logInstructions) {
     m_instrLogFile.open(odir + "/cpu_instructions.log");
   }
+
+  // Loosely-timed (temporally decoupled) execution
+  m_temporalDecoupling = Config::get().contains("TemporalDecoupling") &&
+                         Config::get().getBool("TemporalDecoupling");
+  if (m_temporalDecoupling) {
+    tlm_utils::tlm_quantumkeeper::set_global_quantum(
+        sc_time::from_seconds(Config::get().getDouble("GlobalQuantum")));
+    m_qk.reset();
+  }
+
+  // Fast-forward through low-power mode instead of stepping every cycle
+  m_idleFastForward = Config::get().contains("IdleFastForward") &&
+                      Config::get().getBool("IdleFastForward");
+  if (m_idleFastForward) {
+    m_idleSyncPeriod = sc_time::from_seconds(
+        std::min(Config::get().getDouble("LogTimestep"),
+                 Config::get().getDouble("PowerModelTimestep")));
+  }
 }
 
 void Msp430Cpu::end_of_elaboration() {
@@ -100,6 +136,11 @@ void Msp430Cpu::process() {
   while (true) {  // Run emulator
 
     if (pwrOn.read() && m_run) {
+      // Instruction boundary: the registers are consistent with memory
+      if (m_boundaryHook) {
+        runBoundaryHook(/*powered=*/true);
+      }
+
       // Handle interrupts
       if (irq.read()) {
         powerModelPort->reportEvent(m_irqEventId);
@@ -108,6 +149,7 @@ void Msp430Cpu::process() {
 
       // Handle breakpoints
       if (m_breakpoints.count(getPc()) > 0) {  // Hit breakpoint
+        syncTime();
         std::cout << "@" << std::setw(10) << sc_core::sc_time_stamp()
                   << ": Breakpoint hit (0x" << std::hex << getPc() << ")!\n";
         m_run = false;
@@ -119,30 +161,52 @@ void Msp430Cpu::process() {
         if (!m_sleeping) {
           powerModelPort->reportState(m_sleepStateId);
           m_sleeping = true;
+          if (m_profiler != nullptr) {
+            m_dmi.flush();
+            m_profiler->sleep(m_qk.get_current_time().value());
+          }
+        }
+        if (m_idleFastForward) {
+          idle();
+        } else {
+          consumeTime(mclk->getPeriod());
         }
-        wait(mclk->getPeriod());
       } else {
         // Normal mode -- execute instructions
         if (m_sleeping) {
           powerModelPort->reportState(m_onStateId);
           m_sleeping = false;
         }
+        const auto pc = getPc();
         uint16_t opcode = fetch();
+        const bool traced =
+            (m_tracer != nullptr) &&
+            m_tracer->instruction(m_qk.get_current_time().value(), pc, opcode,
+                                  2);
+        if (m_profiler != nullptr) {
+          // Loosely-timed DMI accesses are only reported on sync, so report
+          // them now for their energy to go to the previous instruction
+          m_dmi.flush();
+          m_profiler->instruction(pc, m_qk.get_current_time().value(),
+                                  mclk->getPeriod().value());
+        }
+        if (traced && m_tracer->tracesRegisters()) {
+          m_tracedRegs = m_cpuRegs;
+        }
         static const uint16_t INST_RETI = 0x1300;
         if (m_doLogOperation && opcode == INST_RETI) {
           m_opsLogFile << "@" << sc_time_stamp() << ": RETI\n";
         }
 
-        uint8_t instructionFmt = (opcode & 0xe000) >> 13;
-        if (instructionFmt == 0) {
-          executeSingleOpInstruction(opcode);
-          powerModelPort->reportEvent(m_formatIIEventId);
-        } else if (instructionFmt == 1) {
-          executeConditionalJump(opcode);
-          powerModelPort->reportEvent(m_formatIIIEventId);
-        } else {
-          executeDoubleOpInstruction(opcode);
-          powerModelPort->reportEvent(m_formatIEventId);
+        const auto &d = m_decodeTable[opcode];
+        (this->*EXECUTORS[d.format])(d);
+        if (traced && m_tracer->tracesRegisters()) {
+          for (unsigned i = 0; i < m_cpuRegs.size(); ++i) {
+            if ((i != PC_REGNUM) && (m_cpuRegs[i] != m_tracedRegs[i])) {
+              m_tracer->registerWrite(m_qk.get_current_time().value(), i,
+                                      m_cpuRegs[i]);
+            }
+          }
         }
         if (m_doStep) {  // end single step
           m_run = false;
@@ -156,10 +220,17 @@ void Msp430Cpu::process() {
     }
 
     if (m_run && (!pwrOn.read())) {
+      syncTime();
       powerModelPort->reportState(m_offStateId);
+      if (m_profiler != nullptr) {
+        m_profiler->powerOff(sc_time_stamp().value());
+      }
+      if (m_boundaryHook) {
+        runBoundaryHook(/*powered=*/false);
+      }
       wait(pwrOn.posedge_event());  // Wait for power
       m_sleeping = false;
-      reset();  // Reset
+      reset();  // Reset, the power-on hook runs once the POR has been taken
     }
   }
 }
@@ -167,12 +238,15 @@ void Msp430Cpu::process() {
 void Msp430Cpu::processInterrupt() {
   uint16_t addr;
 
+  // Acknowledge the interrupt at the correct time
+  syncTime();
+
   if (irqIdx.read() == 0) {  // Reset vector (BOR/PUC)
     addr = 0xfffe;
 
     // Acknowledge interrupt source
     ira.write(true);
-    waitCycles(2);
+    wait(2 * mclk->getPeriod());
     ira.write(false);
 
     // Clear all bits of SR except SCG0
@@ -188,6 +262,14 @@ void Msp430Cpu::processInterrupt() {
     }
     powerModelPort->reportState(m_onStateId);
     m_sleeping = false;
+
+    // Restore e.g. a checkpoint now, so that the reset vector doesn't
+    // overwrite the restored PC and SR
+    if (m_powerOnHook) {
+      const auto hook = std::move(m_powerOnHook);
+      m_powerOnHook = nullptr;
+      hook();
+    }
   } else if ((getSr() & GIE) || irqIdx.read() < 3) {  // GIE or NMI
     // Push pc to stack
     setSp(getSp() - 2);
@@ -202,6 +284,7 @@ void Msp430Cpu::processInterrupt() {
 
     // IRQ flag (source) resets if the selected peripheral's IRA is
     // connected
+    syncTime();
     ira.write(true);
     wait(2 * mclk->getPeriod());
     ira.write(false);
@@ -229,9 +312,23 @@ void Msp430Cpu::writeMem(const uint32_t addr, uint8_t *const data,
   tlm::tlm_generic_payload trans;
 
   if (busStall.read()) {
+    syncTime();
     wait(busStall.negedge_event());
   }
 
+  // Memories granting DMI have no side effects, so there is no need to sync
+  if (m_dmi.write(addr, data, bytelen, delay)) {
+    if (m_tracer != nullptr) {
+      m_tracer->access(m_qk.get_current_time().value(), addr, true,
+                       TraceRecord::DMI_TARGET, data, bytelen);
+    }
+    consumeTime(delay);
+    return;
+  }
+
+  // Data accesses may have side effects, so sync before accessing the bus
+  syncTime();
+
   delay = SC_ZERO_TIME;
   trans.set_address(addr);
   trans.set_data_length(bytelen);
@@ -243,19 +340,36 @@ void Msp430Cpu::writeMem(const uint32_t addr, uint8_t *const data,
     spdlog::error("{} Failed write to address 0x{:08x}.", this->name(), addr);
     sc_stop();
   }
-  wait(delay);
+  consumeTime(delay);
 }
 
 void Msp430Cpu::readMem(const uint32_t addr, uint8_t *const data,
-                        const size_t bytelen) {
+                        const size_t bytelen, const bool isFetch) {
   sc_time delay;
   tlm::tlm_generic_payload trans;
 
   if (busStall.read()) {
+    syncTime();
     wait(busStall.negedge_event());
   }
 
-  delay = SC_ZERO_TIME;
+  // Memories granting DMI have no side effects, so there is no need to sync
+  if (m_dmi.read(addr, data, bytelen, delay)) {
+    if (m_tracer != nullptr) {
+      m_tracer->access(m_qk.get_current_time().value(), addr, false,
+                       TraceRecord::DMI_TARGET, data, bytelen);
+    }
+    consumeTime(delay);
+    return;
+  }
+
+  // Data accesses may have side effects, so sync before accessing the bus
+  if (!isFetch) {
+    syncTime();
+  }
+
+  // In loosely-timed mode, the transaction is annotated with the local time
+  delay = m_temporalDecoupling ? m_qk.get_local_time() : SC_ZERO_TIME;
   trans.set_address(addr);
   trans.set_data_length(bytelen);
   trans.set_data_ptr(data);
@@ -267,7 +381,66 @@ void Msp430Cpu::readMem(const uint32_t addr, uint8_t *const data,
     sc_stop();
   }
 
-  wait(delay);
+  if (m_temporalDecoupling) {
+    m_qk.set(delay);
+    if (m_qk.need_sync()) {
+      syncTime();
+    }
+  } else {
+    m_dmi.flush();
+    wait(delay);
+  }
+}
+
+void Msp430Cpu::consumeTime(const sc_time &t) {
+  if (m_temporalDecoupling) {
+    m_qk.inc(t);
+    if (m_qk.need_sync()) {
+      syncTime();
+    }
+  } else {
+    m_dmi.flush();
+    wait(t);
+  }
+}
+
+void Msp430Cpu::syncTime() {
+  if (m_temporalDecoupling) {
+    m_dmi.flush();
+    m_qk.sync();
+  }
+}
+
+void Msp430Cpu::idle() {
+  syncTime();
+  const auto start = sc_time_stamp();
+  const auto p = mclk->getPeriod().value();
+  if (p == 0) {  // Clock stopped, nothing to count
+    wait(irq.value_changed_event() | pwrOn.value_changed_event() |
+         mclk->periodChangedEvent() | m_boundaryHookSet);
+    return;
+  }
+
+  // Block until woken, or until the next timestep boundary
+  const auto syncPeriod = m_idleSyncPeriod.value();
+  wait(sc_time::from_value(syncPeriod - (start.value() % syncPeriod)),
+       irq.value_changed_event() | pwrOn.value_changed_event() |
+           mclk->periodChangedEvent() | m_boundaryHookSet);
+
+  // Round up to a whole number of cycles (at least one, as when stepping)
+  const uint64_t nCycles =
+      std::max<uint64_t>(1, ((sc_time_stamp() - start).value() + p - 1) / p);
+  const auto end = start + sc_time::from_value(nCycles * p);
+  if (end > sc_time_stamp()) {
+    wait(end - sc_time_stamp());
+  }
+}
+
+void Msp430Cpu::runBoundaryHook(const bool powered) {
+  syncTime();
+  const auto hook = std::move(m_boundaryHook);
+  m_boundaryHook = nullptr;
+  hook(powered);
 }
 
 void Msp430Cpu::dbg_writeReg(uint16_t addr, uint16_t val) {
@@ -333,9 +506,10 @@ bool Msp430Cpu::isStalled(void) { return !m_run; }
 
 uint16_t Msp430Cpu::fetch() {
   assert(getPc() % 2 == 0);
-  uint16_t retval = read16(getPc());
+  uint8_t tmp[2];
+  readMem(getPc(), tmp, 2, /*isFetch=*/true);
   setPc(getPc() + 2);
-  return retval;
+  return Utility::ttohs(Utility::packBytes(tmp, 2));
 }
 
 uint16_t Msp430Cpu::read16(size_t addr) {
@@ -411,41 +585,69 @@ bool Msp430Cpu::isZero(uint16_t val, bool byteNotWord) {
   }
 }
 
-Msp430Cpu::operand_t Msp430Cpu::getDestinationOperand(uint16_t opcode) {
-  uint8_t destRegNum = opcode & 0x000f;
-  bool ad = (opcode & (1u << 7));
-  operand_t operand;
-  std::memset(&operand, 0, sizeof(operand_t));
-  operand.byteNotWord = (opcode & (1u << 6));
-  if (ad) {
-    if (destRegNum == CG_REGNUM) {
-      // Invalid instruction
-      spdlog::error(
-          "getDestinationOperand:: Invalid destination register "
-          "3(CG) in opcode 0x{:04x}",
-          opcode);
-      SC_REPORT_FATAL(this->name(), "Invalid destination register.");
-    } else if (destRegNum == PC_REGNUM) {  // Symbolic
-      operand.addr = getPc();              // Store old value of PC first
-      operand.addr += fetch();             // Fetch offset (increments PC)
-    } else if (destRegNum == SR_REGNUM) {  // Absolute
-      operand.addr = fetch();              // Fetch absolute address
-    } else {                               // Indexed
-      operand.addr = getGpr(destRegNum);   // Get base address
-      operand.addr += fetch();             // Fetch offset
-    }
-    operand.inMem = true;
-  } else {  // Register direct
-    operand.inMem = false;
-    operand.addr = destRegNum;
+const std::vector<Msp430Cpu::decoded_t> &Msp430Cpu::decodeTable() {
+  static const std::vector<decoded_t> table = buildDecodeTable();
+  return table;
+}
+
+std::vector<Msp430Cpu::decoded_t> Msp430Cpu::buildDecodeTable() {
+  std::vector<decoded_t> table(0x10000);
+  for (size_t opcode = 0; opcode < table.size(); ++opcode) {
+    table[opcode] = decode(static_cast<uint16_t>(opcode));
   }
+  return table;
+}
 
-  operand.addr = static_cast<uint16_t>(operand.addr);  // Wrap to 16 bit
-  if ((opcode & 0xf000) != OP_MOV) {  // Load value (if not MOV instruction)
-    loadOperand(operand);
+Msp430Cpu::decoded_t Msp430Cpu::decode(uint16_t opcode) {
+  decoded_t d;
+  std::memset(&d, 0, sizeof(decoded_t));
+  d.opcode = opcode;
+  d.byteNotWord = (opcode & (1u << 6));
+  uint8_t as = (opcode & 0x0030) >> 4;  // source address mode
+
+  uint8_t instructionFmt = (opcode & 0xe000) >> 13;
+  if (instructionFmt == 0) {  // Single operand instruction
+    d.format = FMT_SINGLE_OP;
+    d.instrIdx = (opcode & 0x0380) >> 7;
+    if ((opcode & 0xf000) == 0x1000) {
+      d.srcReg = opcode & 0x000f;
+    } else {
+      d.srcReg = (opcode & 0x0f00) >> 8;
+    }
+    d.srcMode = getSourceMode(as, d.srcReg);
+  } else if (instructionFmt == 1) {  // Conditional jump
+    d.format = FMT_JUMP;
+    d.instrIdx = (opcode & 0x1C00) >> 10;
+    int32_t jumpOffset = opcode & 0x03ff;
+    if (jumpOffset & (1u << 9)) {  // negative
+      jumpOffset = jumpOffset - 0x03ff - 1;
+    }
+    d.jumpOffset = jumpOffset * 2;
+  } else {  // Double operand instruction
+    d.format = FMT_DOUBLE_OP;
+    d.instrIdx = (opcode & 0xf000) >> 12;
+    d.srcReg = (opcode & 0x0f00) >> 8;
+    d.srcMode = getSourceMode(as, d.srcReg);
+    d.dstReg = opcode & 0x000f;
+    bool ad = (opcode & (1u << 7));
+    if (!ad) {
+      d.dstMode = DST_REGISTER;
+    } else if (d.dstReg == CG_REGNUM) {
+      d.dstMode = DST_INVALID;
+    } else if (d.dstReg == PC_REGNUM) {
+      d.dstMode = DST_SYMBOLIC;
+    } else if (d.dstReg == SR_REGNUM) {
+      d.dstMode = DST_ABSOLUTE;
+    } else {
+      d.dstMode = DST_INDEXED;
+    }
+    d.loadDst = ((opcode & 0xf000) != OP_MOV);
   }
 
-  return operand;
+  if (d.srcMode == SRC_CONSTANT) {
+    d.constant = getSourceConstant(as, d.srcReg);
+  }
+  return d;
 }
 
 bool Msp430Cpu::isSourceConstant(uint8_t as, uint8_t regIdx) {
@@ -468,89 +670,138 @@ uint16_t Msp430Cpu::getSourceConstant(uint8_t as, uint8_t regIdx) {
     } else {
       spdlog::error(
           "getSourceConstant: invalid as 0x{:01x} for constant generator.", as);
-      SC_REPORT_FATAL(this->name(),
+      SC_REPORT_FATAL("Msp430Cpu",
                       "Invalid source address mode for constant generator");
     }
   }
   return result;
 }
 
-Msp430Cpu::operand_t Msp430Cpu::getSourceOperand(uint16_t opcode) {
-  uint8_t as = (opcode & 0x0030) >> 4;  // address mode
-  operand_t operand;
-  std::memset(&operand, 0, sizeof(operand_t));
-  operand.byteNotWord = (opcode & (1u << 6));
-
-  uint8_t srcRegNum;
-  if ((opcode & 0xf000) == 0x1000) {  // Single operand instruction
-    srcRegNum = opcode & 0x000f;
-  } else {  // Double operand instruction
-    srcRegNum = (opcode & 0x0f00) >> 8;
-  }
-
-  // Special case -- constants
-  if (isSourceConstant(as, srcRegNum)) {
-    operand.inMem = false;
-    operand.addr = srcRegNum;
-    operand.val = getSourceConstant(as, srcRegNum);
-    return operand;
+Msp430Cpu::src_mode_t Msp430Cpu::getSourceMode(uint8_t as, uint8_t regIdx) {
+  if (isSourceConstant(as, regIdx)) {
+    return SRC_CONSTANT;
   }
-
-  // Register/memory access
   switch (as) {
-    case 0:  // Register direct
-      operand.inMem = false;
-      operand.addr = srcRegNum;
-      break;
-    case 1:  // Indexed / Symbolic / Absolute
-      operand.inMem = true;
-      if (srcRegNum == PC_REGNUM) {         // Symbolic
-        operand.addr = getPc();             // base address is PC
-        operand.addr += fetch();            // fetch offset
-      } else if (srcRegNum == SR_REGNUM) {  // Absolute
-        operand.addr = fetch();             // Fetch absolute address
-      } else {                              // Indexed
-        operand.addr = getGpr(srcRegNum);   // Base addres
-        operand.addr += fetch();            // Offset
-      }
-      break;
-    case 2:  // Register indirect (@Rn)
-      operand.inMem = true;
-      operand.addr = getGpr(srcRegNum);
-      break;
-    case 3:  // Indirect autoincrement / immediate
-      operand.inMem = true;
-      if (srcRegNum == PC_REGNUM) {  // Immediate
-        operand.addr = getPc();
-        setPc(getPc() + 2);
-      } else {  // Indirect autoincrement
-        operand.addr = getGpr(srcRegNum);
-        // Autoincrement
-        if ((srcRegNum == SP_REGNUM) | (!operand.byteNotWord)) {
-          setGpr(srcRegNum, getGpr(srcRegNum) + 2);
-        } else {
-          setGpr(srcRegNum, getGpr(srcRegNum) + 1);
-        }
-        break;
+    case 0:
+      return SRC_REGISTER;
+    case 1:
+      if (regIdx == PC_REGNUM) {
+        return SRC_SYMBOLIC;
+      } else if (regIdx == SR_REGNUM) {
+        return SRC_ABSOLUTE;
+      } else {
+        return SRC_INDEXED;
       }
+    case 2:
+      return SRC_INDIRECT;
+    default:
+      return (regIdx == PC_REGNUM) ? SRC_IMMEDIATE : SRC_AUTOINCREMENT;
   }
+}
+
+Msp430Cpu::operand_t Msp430Cpu::loadSrcRegister(const decoded_t &d) {
+  operand_t operand{d.srcReg, 0, false, d.byteNotWord};
+  loadOperand(operand);
+  return operand;
+}
 
+Msp430Cpu::operand_t Msp430Cpu::loadSrcConstant(const decoded_t &d) {
+  return operand_t{d.srcReg, d.constant, false, d.byteNotWord};
+}
+
+Msp430Cpu::operand_t Msp430Cpu::loadSrcIndexed(const decoded_t &d) {
+  operand_t operand{getGpr(d.srcReg), 0, true, d.byteNotWord};  // Base addr
+  operand.addr += fetch();                                       // Offset
   operand.addr = static_cast<uint16_t>(operand.addr);  // Wrap to 16-bit
   loadOperand(operand);
+  return operand;
+}
 
+Msp430Cpu::operand_t Msp430Cpu::loadSrcSymbolic(const decoded_t &d) {
+  operand_t operand{getPc(), 0, true, d.byteNotWord};  // base address is PC
+  operand.addr += fetch();                             // fetch offset
+  operand.addr = static_cast<uint16_t>(operand.addr);  // Wrap to 16-bit
+  loadOperand(operand);
+  return operand;
+}
+
+Msp430Cpu::operand_t Msp430Cpu::loadSrcAbsolute(const decoded_t &d) {
+  operand_t operand{fetch(), 0, true, d.byteNotWord};  // Fetch absolute addr
+  loadOperand(operand);
   return operand;
 }
 
-void Msp430Cpu::executeConditionalJump(uint16_t opcode) {
-  int32_t jumpOffset = opcode & 0x03ff;
-  if (jumpOffset & (1u << 9)) {  // negative
-    jumpOffset = jumpOffset - 0x03ff - 1;
+Msp430Cpu::operand_t Msp430Cpu::loadSrcIndirect(const decoded_t &d) {
+  operand_t operand{getGpr(d.srcReg), 0, true, d.byteNotWord};
+  operand.addr = static_cast<uint16_t>(operand.addr);  // Wrap to 16-bit
+  loadOperand(operand);
+  return operand;
+}
+
+Msp430Cpu::operand_t Msp430Cpu::loadSrcAutoincrement(const decoded_t &d) {
+  operand_t operand{getGpr(d.srcReg), 0, true, d.byteNotWord};
+  if ((d.srcReg == SP_REGNUM) | (!d.byteNotWord)) {
+    setGpr(d.srcReg, getGpr(d.srcReg) + 2);
+  } else {
+    setGpr(d.srcReg, getGpr(d.srcReg) + 1);
   }
-  jumpOffset *= 2;
+  operand.addr = static_cast<uint16_t>(operand.addr);  // Wrap to 16-bit
+  loadOperand(operand);
+  return operand;
+}
 
-  uint8_t condition = (opcode & 0x1C00) >> 10;
+Msp430Cpu::operand_t Msp430Cpu::loadSrcImmediate(const decoded_t &d) {
+  operand_t operand{getPc(), 0, true, d.byteNotWord};
+  setPc(getPc() + 2);
+  operand.addr = static_cast<uint16_t>(operand.addr);  // Wrap to 16-bit
+  loadOperand(operand);
+  return operand;
+}
+
+Msp430Cpu::operand_t Msp430Cpu::loadDstRegister(const decoded_t &d) {
+  operand_t operand{d.dstReg, 0, false, d.byteNotWord};
+  return finishDstOperand(operand, d);
+}
+
+Msp430Cpu::operand_t Msp430Cpu::loadDstIndexed(const decoded_t &d) {
+  operand_t operand{getGpr(d.dstReg), 0, true, d.byteNotWord};  // Base addr
+  operand.addr += fetch();                                       // Offset
+  return finishDstOperand(operand, d);
+}
+
+Msp430Cpu::operand_t Msp430Cpu::loadDstSymbolic(const decoded_t &d) {
+  operand_t operand{getPc(), 0, true, d.byteNotWord};  // Old value of PC
+  operand.addr += fetch();  // Fetch offset (increments PC)
+  return finishDstOperand(operand, d);
+}
+
+Msp430Cpu::operand_t Msp430Cpu::loadDstAbsolute(const decoded_t &d) {
+  operand_t operand{fetch(), 0, true, d.byteNotWord};  // Fetch absolute addr
+  return finishDstOperand(operand, d);
+}
+
+Msp430Cpu::operand_t Msp430Cpu::loadDstInvalid(const decoded_t &d) {
+  spdlog::error(
+      "getDestinationOperand:: Invalid destination register "
+      "3(CG) in opcode 0x{:04x}",
+      d.opcode);
+  SC_REPORT_FATAL(this->name(), "Invalid destination register.");
+  operand_t operand{0, 0, true, d.byteNotWord};
+  return finishDstOperand(operand, d);
+}
+
+Msp430Cpu::operand_t Msp430Cpu::finishDstOperand(operand_t &operand,
+                                                 const decoded_t &d) {
+  operand.addr = static_cast<uint16_t>(operand.addr);  // Wrap to 16 bit
+  if (d.loadDst) {  // Load value (if not MOV instruction)
+    loadOperand(operand);
+  }
+  return operand;
+}
+
+void Msp430Cpu::executeConditionalJump(const decoded_t &d) {
   bool doJump = false;
-  switch (condition) {
+  switch (d.instrIdx) {
     case 0:  // JNE / JNZ
       doJump = (getZeroFlag() == false);
       break;
@@ -577,18 +828,18 @@ void Msp430Cpu::executeConditionalJump(uint16_t opcode) {
       break;
   }
   if (doJump) {
-    setPc(getPc() + jumpOffset);
+    setPc(getPc() + d.jumpOffset);
   }
   waitCycles(1);
+  powerModelPort->reportEvent(m_formatIIIEventId);
 }
 
-void Msp430Cpu::executeSingleOpInstruction(uint16_t opcode) {
-  unsigned instrIdx = (opcode & 0x0380) >> 7;
-  operand_t operand = getSourceOperand(opcode);
+void Msp430Cpu::executeSingleOpInstruction(const decoded_t &d) {
+  operand_t operand = (this->*SRC_LOADERS[d.srcMode])(d);
   bool byteNotWord = operand.byteNotWord;
   uint32_t result;
 
-  switch (instrIdx) {
+  switch (d.instrIdx) {
     case 0:  // RRC Rotate right through carry
       result = operand.val >> 1;
       if (byteNotWord && getCarryFlag()) {
@@ -676,7 +927,7 @@ void Msp430Cpu::executeSingleOpInstruction(uint16_t opcode) {
         // 4/5/6 cycles if operand is in memory
         waitCycles(1);
         // absolute mode requires one more cycle
-        if ((opcode & 0x000f) == SR_REGNUM) {
+        if (d.srcMode == SRC_ABSOLUTE) {
           waitCycles(1);
         }
       }
@@ -696,9 +947,10 @@ void Msp430Cpu::executeSingleOpInstruction(uint16_t opcode) {
 
     case 7:  // INVALID
       spdlog::error("executeSingleOpInstruction: Invalid opcode 0x{:04x}.",
-                    opcode);
+                    d.opcode);
       SC_REPORT_FATAL(this->name(), "Invalid instruction");
   }
+  powerModelPort->reportEvent(m_formatIIEventId);
 }
 
 bool Msp430Cpu::isCarry(uint32_t a, uint32_t b, bool c, bool byteNotWord) {
@@ -720,25 +972,22 @@ bool Msp430Cpu::isOverflow(uint32_t a, uint32_t b, bool c, bool byteNotWord) {
   return (resNeg && (!aNeg) && (!bNeg)) | ((!resNeg) && aNeg && bNeg);
 }
 
-void Msp430Cpu::executeDoubleOpInstruction(uint16_t opcode) {
-  unsigned instrIdx = (opcode & 0xf000) >> 12;
-  operand_t srcOp = getSourceOperand(opcode);
-  operand_t dstOp = getDestinationOperand(opcode);
+void Msp430Cpu::executeDoubleOpInstruction(const decoded_t &d) {
+  operand_t srcOp = (this->*SRC_LOADERS[d.srcMode])(d);
+  operand_t dstOp = (this->*DST_LOADERS[d.dstMode])(d);
   bool byteNotWord = srcOp.byteNotWord;
   uint32_t result;
 
   // Special case when PC is destination
   if (dstOp.addr == PC_REGNUM) {
-    uint8_t as = (opcode & 0x0030) >> 4;
-    uint8_t srcRegNum = (opcode & 0x0f00) >> 8;
-    if ((as == 3) && (srcRegNum == PC_REGNUM)) {
+    if (d.srcMode == SRC_IMMEDIATE) {
       waitCycles(1);
     } else {
       waitCycles(2);
     }
   }
 
-  switch (instrIdx) {
+  switch (d.instrIdx) {
     case 4:  // MOV : dst = src
       dstOp.val = srcOp.val;
       writeback(dstOp);
@@ -839,6 +1088,7 @@ void Msp430Cpu::executeDoubleOpInstruction(uint16_t opcode) {
       writeback(dstOp);
       break;
   }
+  powerModelPort->reportEvent(m_formatIEventId);
 }
 
 void Msp430Cpu::waitForCommand() {
@@ -847,6 +1097,12 @@ void Msp430Cpu::waitForCommand() {
   }
 }
 
+void Msp430Cpu::saveState(CheckpointOut &out) { out.put(m_cpuRegs); }
+
+void Msp430Cpu::restoreState(CheckpointIn &in) {
+  m_cpuRegs = in.get<std::array<uint32_t, 16>>();
+}
+
 std::ostream &operator<<(std::ostream &os, const Msp430Cpu &rhs) {
   std::array<const std::string, 16> registernames = {
       {"r0 (pc)", "r1 (sp)", "r2 (sr)", "r3 (cg)", "r4", "r5", "r6", "r7", "r8",
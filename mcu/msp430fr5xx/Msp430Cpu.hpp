@@ -9,17 +9,26 @@
 
 #include <stdint.h>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <systemc>
 #include <tlm>
+#include <tlm_utils/tlm_quantumkeeper.h>
 #include <unordered_set>
+#include <vector>
 #include "mcu/ClockSourceIf.hpp"
+#include "mcu/DmiCache.hpp"
 #include "ps/PowerModelChannelIf.hpp"
+#include "utilities/Checkpoint.hpp"
+#include "utilities/Profiler.hpp"
+#include "utilities/Tracer.hpp"
 #include "utilities/Utilities.hpp"
 
-class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
+class Msp430Cpu : public sc_core::sc_module,
+                  tlm::tlm_bw_transport_if<>,
+                  public Checkpointable {
  public:
   /*------ Ports ------*/
   tlm::tlm_initiator_socket<> iSocket{"iSocket"};  //! TLM initiator socket
@@ -62,15 +71,19 @@ class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
   /**
    * @brief readMem: Callback function for read operations from memory by
    * emulator
+   * @param isFetch true if this is an instruction fetch. In loosely-timed
+   * mode, data accesses synchronise with the kernel before the transaction,
+   * whereas instruction fetches do not.
    */
-  void readMem(const uint32_t addr, uint8_t *const data, const size_t bytelen);
+  void readMem(const uint32_t addr, uint8_t *const data, const size_t bytelen,
+               const bool isFetch = false);
 
   /**
    * @brief waitCycles wait nCycles clock cycles.
    * @param nCycles  number of clock cycles to wait
    */
   void waitCycles(unsigned nCycles) {
-    sc_core::wait(nCycles * mclk->getPeriod());
+    consumeTime(nCycles * mclk->getPeriod());
   }
 
   /**
@@ -88,6 +101,26 @@ class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
    */
   void dbg_writeReg(uint16_t addr, uint16_t val);
 
+  /**
+   * @brief setPowerOnHook Register a function to be called once, after the
+   * next reset interrupt (POR) has loaded the reset vector and before the
+   * first instruction is executed.
+   */
+  void setPowerOnHook(std::function<void()> hook) {
+    m_powerOnHook = std::move(hook);
+  }
+
+  /**
+   * @brief setInstructionBoundaryHook Register a function to be called once,
+   * between two instructions, with the local time synchronised. A sleeping
+   * CPU calls it within a clock cycle. If the CPU loses power first, it is
+   * called once the CPU has powered off, with powered=false.
+   */
+  void setInstructionBoundaryHook(std::function<void(bool powered)> hook) {
+    m_boundaryHook = std::move(hook);
+    m_boundaryHookSet.notify(sc_core::SC_ZERO_TIME);
+  }
+
   /**
    * @brief stall Stall processor
    */
@@ -142,16 +175,28 @@ class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
    */
   friend std::ostream &operator<<(std::ostream &os, const Msp430Cpu &rhs);
 
-  /*------ Dummy methods --------------------------------------------------*/
+  /**
+   * @brief saveState save the CPU registers.
+   */
+  virtual void saveState(CheckpointOut &out) override;
 
-  // Dummy method:
-  [[noreturn]] void invalidate_direct_mem_ptr(
-      sc_dt::uint64 start_range[[maybe_unused]],
-      sc_dt::uint64 end_range[[maybe_unused]]) {
-    SC_REPORT_FATAL(this->name(), "invalidate_direct_mem_ptr not implemented");
-    exit(1);
+  /**
+   * @brief restoreState restore the CPU registers. The low-power mode is
+   * picked up from SR.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
+  /**
+   * @brief invalidate_direct_mem_ptr Drop cached DMI regions in the given
+   * range.
+   */
+  void invalidate_direct_mem_ptr(sc_dt::uint64 start_range,
+                                 sc_dt::uint64 end_range) {
+    m_dmi.invalidate(start_range, end_range);
   }
 
+  /*------ Dummy methods --------------------------------------------------*/
+
       // Dummy method:
       [[noreturn]] tlm::tlm_sync_enum
       nb_transport_bw(tlm::tlm_generic_payload &trans[[maybe_unused]],
@@ -171,6 +216,59 @@ class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
     bool byteNotWord;  // True if byte-access, false if word access
   } operand_t;
 
+  //! Source operand addressing modes
+  typedef enum : uint8_t {
+    SRC_REGISTER,       // Rn
+    SRC_CONSTANT,       // Constant generator (r2/r3)
+    SRC_INDEXED,        // x(Rn)
+    SRC_SYMBOLIC,       // ADDR (x(PC))
+    SRC_ABSOLUTE,       // &ADDR
+    SRC_INDIRECT,       // @Rn
+    SRC_AUTOINCREMENT,  // @Rn+
+    SRC_IMMEDIATE,      // #N (@PC+)
+    N_SRC_MODES
+  } src_mode_t;
+
+  //! Destination operand addressing modes
+  typedef enum : uint8_t {
+    DST_REGISTER,  // Rn
+    DST_INDEXED,   // x(Rn)
+    DST_SYMBOLIC,  // ADDR (x(PC))
+    DST_ABSOLUTE,  // &ADDR
+    DST_INVALID,   // x(r3)
+    N_DST_MODES
+  } dst_mode_t;
+
+  //! Instruction formats
+  typedef enum : uint8_t {
+    FMT_SINGLE_OP,  // Format II
+    FMT_JUMP,       // Format III
+    FMT_DOUBLE_OP,  // Format I
+    N_FORMATS
+  } format_t;
+
+  /**
+   * @brief decoded_t Everything that can be derived from an opcode alone.
+   * Computed once for every possible opcode by buildDecodeTable().
+   */
+  typedef struct {
+    uint16_t opcode;
+    format_t format;
+    src_mode_t srcMode;
+    dst_mode_t dstMode;
+    uint8_t srcReg;      // Source register index
+    uint8_t dstReg;      // Destination register index
+    uint8_t instrIdx;    // Instruction index within format / jump condition
+    bool byteNotWord;    // True if byte-access, false if word access
+    bool loadDst;        // False if destination is write-only (MOV)
+    uint16_t constant;   // Source value if srcMode is SRC_CONSTANT
+    int16_t jumpOffset;  // Jump offset in bytes (format III)
+  } decoded_t;
+
+  typedef operand_t (Msp430Cpu::*src_loader_t)(const decoded_t &d);
+  typedef operand_t (Msp430Cpu::*dst_loader_t)(const decoded_t &d);
+  typedef void (Msp430Cpu::*executor_t)(const decoded_t &d);
+
   /* ------ Constants ------ */
   const bool m_doLogInstructions;
   const bool m_doLogOperation;
@@ -183,10 +281,18 @@ class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
 
   static const uint16_t OP_MOV = 0x4000;  // Opcode for MOV instruction
 
+  //! Operand loaders and executors, indexed by decoded_t fields
+  static const src_loader_t SRC_LOADERS[N_SRC_MODES];
+  static const dst_loader_t DST_LOADERS[N_DST_MODES];
+  static const executor_t EXECUTORS[N_FORMATS];
+
   /* ------ Private variables ------ */
   bool m_run{false};         //! Signal whether processor should run
   bool m_sleeping{false};    //! Indicate whether cpu is sleeping
   bool m_doStep{false};      //! Set to 1 to single-step, cleared automatically.
+  std::function<void()> m_powerOnHook;  //! Called once after power-on reset
+  std::function<void(bool)> m_boundaryHook;  //! Called at next boundary
+  sc_core::sc_event m_boundaryHookSet{"boundaryHookSet"};  //! Wakes idle()
   uint64_t m_idleCycles{0};  //! Total number of idle cycles (for logging)
 
   /* Event and state ids for power modelling */
@@ -201,6 +307,24 @@ class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
   int m_onStateId{-1};
   int m_sleepStateId{-1};
 
+  /* Temporal decoupling */
+  bool m_temporalDecoupling{false};   //! Run loosely-timed w/ quantum keeper
+  tlm_utils::tlm_quantumkeeper m_qk;  //! Keeps track of local time offset
+
+  /* Idle fast-forward */
+  bool m_idleFastForward{false};  //! Block on wake-up sources while sleeping
+  sc_core::sc_time m_idleSyncPeriod{
+      sc_core::SC_ZERO_TIME};  //! Max. time spent blocked before reporting
+
+  DmiCache m_dmi{iSocket};  //! DMI regions granted to this CPU
+
+  /* Tracing */
+  Tracer *const m_tracer{Tracer::get()};  //! nullptr if tracing is disabled
+  std::array<uint32_t, 16> m_tracedRegs{{0}};  //! Registers before execution
+  Profiler *const m_profiler{Profiler::get()};  //! nullptr if not profiling
+
+  const std::vector<decoded_t> &m_decodeTable;  //! Indexed by opcode
+
   std::array<uint32_t, 16> m_cpuRegs;
 
   std::unordered_set<unsigned> m_breakpoints;  //! Set of breakpoint addresses
@@ -229,22 +353,69 @@ class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
   bool handleBreakpoints(unsigned pc);
 
   /**
-   * @brief executeSingleOpInstruction execute format 1 instruction.
-   * @param opcode
+   * @brief consumeTime advance the CPU's time by t. In cycle-accurate mode
+   * this is a plain wait(t), in loosely-timed mode t is added to the local
+   * time offset, and the CPU only synchronises with the kernel at the end of
+   * each quantum. Pending DMI access counts are reported to the power model
+   * whenever the CPU synchronises.
+   * @param t time to consume
    */
-  void executeSingleOpInstruction(uint16_t opcode);
+  void consumeTime(const sc_core::sc_time &t);
 
   /**
-   * @brief executeDoubleOpInstruction execute format 2 instruction.
-   * @param opcode
+   * @brief syncTime synchronise the local time offset with the kernel, i.e.
+   * wait for the accumulated local time. Does nothing in cycle-accurate mode.
    */
-  void executeDoubleOpInstruction(uint16_t opcode);
+  void syncTime();
+
+  /**
+   * @brief runBoundaryHook synchronise the local time, then call and clear
+   * the instruction boundary hook.
+   */
+  void runBoundaryHook(const bool powered);
+
+  /**
+   * @brief idle Sleep until a wake-up source (irq, pwrOn, mclk period) changes
+   * or the next power model/log timestep boundary is reached. The CPU stays
+   * aligned to whole clock cycles, so it wakes up on the same cycle as when
+   * stepping through every cycle.
+   */
+  void idle();
+
+  /**
+   * @brief decodeTable Get the table of decoded instructions, shared by all
+   * instances. The table is built on first use.
+   * @retval table with one entry per opcode
+   */
+  static const std::vector<decoded_t> &decodeTable();
+
+  /**
+   * @brief buildDecodeTable decode all 64K opcodes.
+   */
+  static std::vector<decoded_t> buildDecodeTable();
+
+  /**
+   * @brief decode decode a single opcode.
+   */
+  static decoded_t decode(uint16_t opcode);
+
+  /**
+   * @brief executeSingleOpInstruction execute format 2 instruction.
+   * @param d decoded instruction
+   */
+  void executeSingleOpInstruction(const decoded_t &d);
+
+  /**
+   * @brief executeDoubleOpInstruction execute format 1 instruction.
+   * @param d decoded instruction
+   */
+  void executeDoubleOpInstruction(const decoded_t &d);
 
   /**
    * @brief executeConditionalJump execute format 3 instruction.
-   * @param opcode
+   * @param d decoded instruction
    */
-  void executeConditionalJump(uint16_t opcode);
+  void executeConditionalJump(const decoded_t &d);
 
   /**
    * @brief read16 read 16-bit value from bus
@@ -310,19 +481,28 @@ class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
    */
   void loadOperand(operand_t &operand);
 
-  /**
-   * @brief getDestinationOperand get destination operand from bus/register
-   * file
-   * @param opcode
-   */
-  operand_t getDestinationOperand(uint16_t opcode);
+  /* Source operand loaders, one per addressing mode (see SRC_LOADERS) */
+  operand_t loadSrcRegister(const decoded_t &d);
+  operand_t loadSrcConstant(const decoded_t &d);
+  operand_t loadSrcIndexed(const decoded_t &d);
+  operand_t loadSrcSymbolic(const decoded_t &d);
+  operand_t loadSrcAbsolute(const decoded_t &d);
+  operand_t loadSrcIndirect(const decoded_t &d);
+  operand_t loadSrcAutoincrement(const decoded_t &d);
+  operand_t loadSrcImmediate(const decoded_t &d);
+
+  /* Destination operand loaders, one per addressing mode (see DST_LOADERS) */
+  operand_t loadDstRegister(const decoded_t &d);
+  operand_t loadDstIndexed(const decoded_t &d);
+  operand_t loadDstSymbolic(const decoded_t &d);
+  operand_t loadDstAbsolute(const decoded_t &d);
+  operand_t loadDstInvalid(const decoded_t &d);
 
   /**
-   * @brief getSourceOperand get source operand from bus/register file
-   * @param opcode
-   * @retval operand
+   * @brief finishDstOperand wrap the destination address to 16 bit and load
+   * its value, unless the instruction only writes the destination (MOV).
    */
-  operand_t getSourceOperand(uint16_t opcode);
+  operand_t finishDstOperand(operand_t &operand, const decoded_t &d);
 
   /**
    * @brief check if source operand is a constant.
@@ -330,7 +510,7 @@ class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
    * @param regIdx register index for source
    * @retval true if the source operand is a constant, false otherwise.
    */
-  bool isSourceConstant(uint8_t as, uint8_t regIdx);
+  static bool isSourceConstant(uint8_t as, uint8_t regIdx);
 
   /**
    * @brief getSoureceConstant get source constant value
@@ -338,7 +518,14 @@ class Msp430Cpu : public sc_core::sc_module, tlm::tlm_bw_transport_if<> {
    * @param regIdx source register index
    * @retval source constant value (16-bit)
    */
-  uint16_t getSourceConstant(uint8_t as, uint8_t regIdx);
+  static uint16_t getSourceConstant(uint8_t as, uint8_t regIdx);
+
+  /**
+   * @brief getSourceMode get source addressing mode
+   * @param as source addressing mode bits
+   * @param regIdx source register index
+   */
+  static src_mode_t getSourceMode(uint8_t as, uint8_t regIdx);
 
   /**
    * @brief isNegative check if a value is negative.
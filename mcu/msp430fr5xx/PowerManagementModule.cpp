@@ -171,3 +171,13 @@ void PowerManagementModule::b_transport(tlm::tlm_generic_payload &trans,
   delay += systemClk->getPeriod();
   trans.set_response_status(tlm::TLM_OK_RESPONSE);
 }
+
+void PowerManagementModule::saveState(CheckpointOut &out) {
+  BusTarget::saveState(out);
+  out.put<bool>(m_locked);
+}
+
+void PowerManagementModule::restoreState(CheckpointIn &in) {
+  BusTarget::restoreState(in);
+  m_locked = in.get<bool>();
+}
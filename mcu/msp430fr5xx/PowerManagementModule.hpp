@@ -45,6 +45,16 @@ class PowerManagementModule : public BusTarget {
    */
   virtual void end_of_elaboration() override;
 
+  /**
+   * @brief saveState save registers and lock state.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState restore registers and lock state.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
  private:
   /* ------ Internal classes ------ */
 
@@ -60,6 +70,12 @@ class PowerManagementModule : public BusTarget {
       return m_current;
     }
 
+    // Current doesn't depend on the supply voltage...
+    virtual bool isVoltageDependent() const override { return false; }
+
+    // ...but is set from the boot-current trace, so it is variable
+    virtual bool isVariable() const override { return true; }
+
     virtual std::string toString() const override {
       return fmt::format(
           FMT_STRING("<BootCurrentState> {:s}: current={:.6} nA (variable)"),
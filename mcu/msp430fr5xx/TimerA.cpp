@@ -69,7 +69,10 @@ void TimerA::end_of_elaboration() {
 
   // Register SC_METHODS here (after events have been constructed)
   SC_METHOD(process);
-  sensitive << timerClock << ira;
+  sensitive << m_triggerEvent << m_updateEvent << m_writeEvent << ira;
+
+  SC_METHOD(updateClkPeriod);
+  sensitive << timerClock.periodChangedEvent();
 
   SC_METHOD(updateClkSource);
   sensitive << sourceChangeEvent;
@@ -79,66 +82,17 @@ void TimerA::end_of_elaboration() {
   dont_initialize();
 }
 
-void TimerA::reset(void) { m_regs.reset(); }
+void TimerA::reset(void) {
+  m_regs.reset();
+  direction = true;
+  m_lastUpdate = sc_time_stamp();
+  m_triggerEvent.cancel();
+}
 
 void TimerA::process(void) {
   if (pwrOn.read()) {
     // Operation
-    bool stopped;
-    unsigned crntCnt = m_regs.read(OFS_TA1R);
-    unsigned modeControl = (m_regs.read(OFS_TA1CTL) & (0b11u << 4)) >> 4;
-    switch (modeControl) {  // Mode control
-      case 0:               // Stop mode: timer is halted.
-        stopped = true;
-        break;
-      case 1:  // Up mode: timer counts up to TAxCCR0
-        stopped = false;
-        if (crntCnt < m_regs.read(OFS_TA1CCR0)) {
-          crntCnt++;
-          m_regs.write(OFS_TA1R, crntCnt);
-        } else {
-          m_regs.setBit(OFS_TA1CTL, 0);  // Set IFG
-          m_regs.write(OFS_TA1R, 0);     // Clear count
-          powerModelPort->reportEvent(m_triggerEventId);
-        }
-        break;
-      case 2:  // Continuous mode: timer counts up to 0xffff
-        stopped = false;
-        if (crntCnt < 0xffff) {
-          crntCnt++;
-          m_regs.write(OFS_TA1R, crntCnt);
-        } else {
-          m_regs.setBitMask(OFS_TA1CTL, TAIFG);
-          m_regs.write(OFS_TA1R, 0);  // Clear count
-          powerModelPort->reportEvent(m_triggerEventId);
-        }
-        break;
-      case 3:  // Up/down mode: timer counts up to TAxCCR0 then down to 0
-        stopped = false;
-        if (direction && (crntCnt < m_regs.read(OFS_TA1CCR0))) {
-          crntCnt++;
-          m_regs.write(OFS_TA1R, crntCnt);
-          direction = !(crntCnt < m_regs.read(OFS_TA1CCR0));
-        } else if ((crntCnt > 0) && (!direction)) {
-          crntCnt--;
-          m_regs.write(OFS_TA1R, crntCnt);
-          direction = (crntCnt == 0);
-        }
-
-        if (crntCnt == 0) {
-          m_regs.setBitMask(OFS_TA1CTL, TAIFG);
-          powerModelPort->reportEvent(m_triggerEventId);
-        }
-        break;
-    }
-
-    if (m_regs.read(OFS_TA1CTL) & TACLR) {  // Clear state (not settings)
-      m_regs.write(OFS_TA1CTL, 0);
-      direction = true;
-      // reset clock dividers (count, not setting)
-      // clkDiv->resetCnt();
-      // Ignored for now
-    }
+    sync();
 
     // Clear interrupt flag if interrupt request accepted (acknowledged)
     const bool irqEnabled =
@@ -157,16 +111,151 @@ void TimerA::process(void) {
       m_regs.clearBitMask(OFS_TA1CTL, TAIFG);  // Auto-cleared
       spdlog::info("{}: @{:s} DMA trigger", this->name(),
                    sc_time_stamp().to_string());
+      // Release the trigger on the next timer tick
+      if (m_clkPeriod > SC_ZERO_TIME) {
+        m_updateEvent.notify(m_clkPeriod);
+      }
     } else {
       dmaTrigger.write(false);
     }
+  }
+}
 
-    if (stopped) {
-      next_trigger(m_writeEvent);
-    } else {
-      next_trigger(timerClock.default_event() | ira.default_event());
+void TimerA::updateClkPeriod() {
+  // Count edges of the old clock up to now before switching
+  if (sync()) {
+    m_updateEvent.notify(SC_ZERO_TIME);
+  }
+  m_clkEpoch = sc_time_stamp();
+  m_clkPeriod = timerClock.getPeriod();
+  scheduleTrigger();
+}
+
+unsigned TimerA::modeControl() const {
+  return (m_regs.read(OFS_TA1CTL) & (0b11u << 4)) >> 4;
+}
+
+uint64_t TimerA::sync() {
+  uint64_t nTriggers = 0;
+  if (pwrOn.read()) {
+    nTriggers = advance(countTicks(m_lastUpdate, sc_time_stamp()));
+    if (nTriggers) {
+      m_regs.setBitMask(OFS_TA1CTL, TAIFG);
+      powerModelPort->reportEvent(m_triggerEventId,
+                                  static_cast<int>(nTriggers));
     }
   }
+  m_lastUpdate = sc_time_stamp();
+  scheduleTrigger();
+  return nTriggers;
+}
+
+uint64_t TimerA::countTicks(const sc_time &from, const sc_time &to) const {
+  if ((m_clkPeriod == SC_ZERO_TIME) || (to <= from)) {
+    return 0;
+  }
+  // Clock edges occur at m_clkEpoch + k * m_clkPeriod, k > 0
+  const auto p = m_clkPeriod.value();
+  return (to - m_clkEpoch).value() / p - (from - m_clkEpoch).value() / p;
+}
+
+uint64_t TimerA::advance(const uint64_t nTicks) {
+  uint64_t cnt = m_regs.read(OFS_TA1R);
+  const uint64_t ccr0 = m_regs.read(OFS_TA1CCR0);
+  uint64_t n = nTicks;
+  uint64_t nTriggers = 0;
+
+  if (n == 0) {
+    return 0;
+  }
+
+  switch (modeControl()) {  // Mode control
+    case 0:                 // Stop mode: timer is halted.
+      return 0;
+    case 1:    // Up mode: timer counts up to TAxCCR0
+    case 2: {  // Continuous mode: timer counts up to 0xffff
+      const uint64_t top = (modeControl() == 1) ? ccr0 : 0xffff;
+      if (cnt > top) {  // E.g. TAxCCR0 lowered: restart from 0 on next tick
+        cnt = 0;
+        nTriggers++;
+        n--;
+      }
+      const uint64_t pos = cnt + n;
+      nTriggers += pos / (top + 1);
+      cnt = pos % (top + 1);
+      break;
+    }
+    case 3:  // Up/down mode: timer counts up to TAxCCR0 then down to 0
+      if (ccr0 == 0) {
+        return 0;  // Halted
+      }
+      if (cnt > ccr0) {  // Above TAxCCR0: count down to 0 first
+        if (n < cnt) {
+          cnt -= n;
+          direction = false;
+          break;
+        }
+        n -= cnt;
+        cnt = 0;
+        nTriggers++;
+        direction = true;
+      }
+      {
+        // Position within one up/down period of 2 * TAxCCR0 ticks, where 0
+        // is the tick at which the count reaches 0 and TAIFG is set
+        const uint64_t period = 2 * ccr0;
+        uint64_t pos = (direction || cnt == 0) ? cnt : period - cnt;
+        pos += n;
+        nTriggers += pos / period;
+        pos %= period;
+        cnt = (pos <= ccr0) ? pos : period - pos;
+        direction = pos < ccr0;
+      }
+      break;
+  }
+
+  m_regs.write(OFS_TA1R, cnt);
+  return nTriggers;
+}
+
+uint64_t TimerA::ticksToTrigger() const {
+  const uint64_t cnt = m_regs.read(OFS_TA1R);
+  const uint64_t ccr0 = m_regs.read(OFS_TA1CCR0);
+
+  switch (modeControl()) {
+    case 1:
+    case 2: {
+      const uint64_t top = (modeControl() == 1) ? ccr0 : 0xffff;
+      return (cnt > top) ? 1 : top - cnt + 1;
+    }
+    case 3: {
+      if (ccr0 == 0) {
+        return 0;
+      }
+      if (cnt > ccr0) {
+        return cnt;
+      }
+      const uint64_t period = 2 * ccr0;
+      return period - ((direction || cnt == 0) ? cnt : period - cnt);
+    }
+    default:
+      return 0;
+  }
+}
+
+void TimerA::scheduleTrigger() {
+  m_triggerEvent.cancel();
+  const auto nTicks = ticksToTrigger();
+  if (!pwrOn.read() || (nTicks == 0) || (m_clkPeriod == SC_ZERO_TIME)) {
+    return;
+  }
+
+  // Time of the nTicks'th clock edge from now
+  const auto p = m_clkPeriod.value();
+  const auto now = sc_time_stamp();
+  const auto lastEdge = (now - m_clkEpoch).value() / p;
+  const auto t = m_clkEpoch + sc_time::from_value((lastEdge + nTicks) * p);
+  m_triggerEvent.notify(t - now);
 }
 
 void TimerA::updateClkSource() {
@@ -201,13 +290,57 @@ void TimerA::updateClkSource() {
 }
 
 void TimerA::b_transport(tlm::tlm_generic_payload &trans, sc_time &delay) {
+  // Bring counter up to date before access
+  if (sync()) {
+    m_updateEvent.notify(SC_ZERO_TIME);
+  }
+
   BusTarget::b_transport(trans, delay);
 
   uint16_t addr = (uint16_t)trans.get_address();
 
   if (trans.get_command() == tlm::TLM_WRITE_COMMAND) {
     if (addr == OFS_TA1CTL) {
+      if (m_regs.read(OFS_TA1CTL) & TACLR) {  // Clear state (not settings)
+        m_regs.write(OFS_TA1R, 0);
+        m_regs.clearBitMask(OFS_TA1CTL, TACLR);  // Auto-cleared
+        direction = true;
+        // reset clock dividers (count, not setting)
+        // clkDiv->resetCnt();
+        // Ignored for now
+      }
       sourceChangeEvent.notify(delay);
     }
+    // Mode, count or TAxCCR0 may have changed
+    scheduleTrigger();
   }
 }
+
+unsigned int TimerA::transport_dbg(tlm::tlm_generic_payload &trans) {
+  if (sync()) {
+    m_updateEvent.notify(SC_ZERO_TIME);
+  }
+  const auto ret = BusTarget::transport_dbg(trans);
+  if (trans.get_command() == tlm::TLM_WRITE_COMMAND) {
+    scheduleTrigger();
+  }
+  return ret;
+}
+
+void TimerA::saveState(CheckpointOut &out) {
+  if (sync()) {
+    m_updateEvent.notify(SC_ZERO_TIME);
+  }
+  BusTarget::saveState(out);
+  out.put<bool>(direction);
+}
+
+void TimerA::restoreState(CheckpointIn &in) {
+  BusTarget::restoreState(in);
+  direction = in.get<bool>();
+  m_lastUpdate = sc_time_stamp();
+  m_clkEpoch = sc_time_stamp();
+  sourceChangeEvent.notify(SC_ZERO_TIME);
+  m_updateEvent.notify(SC_ZERO_TIME);
+  scheduleTrigger();
+}
@@ -48,6 +48,25 @@ class TimerA : public BusTarget {
   virtual void b_transport(tlm::tlm_generic_payload &trans,
                            sc_core::sc_time &delay) override;
 
+  /**
+   * @brief transport_dbg Debug reads and writes. The counter is brought up to
+   * date before the access.
+   * @param trans
+   */
+  virtual unsigned int transport_dbg(tlm::tlm_generic_payload &trans) override;
+
+  /**
+   * @brief saveState Bring the counter up to date, then save registers and
+   * counting direction.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState restore registers and counting direction. Counting
+   * restarts on the current clock edge.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
   /**
    * @brief set up methods, sensitivity, and register power model events and
    * states
@@ -59,9 +78,13 @@ class TimerA : public BusTarget {
   sc_signal<int> clkDivAmount{"aclkDivAmount",
                               1};  //! Amount to divide source clock by
   sc_signal<int> clkMuxSelect{"clkMuxSelect", 0};  //! Mux source select
-  ClockSourceChannel muxOut{"muxOut"};             //! Mux output clock
+  // The counter is computed from the clock period, so the internal clocks
+  // don't generate edge events.
+  ClockSourceChannel muxOut{"muxOut", sc_core::SC_ZERO_TIME,
+                            false};  //! Mux output clock
   ClockSourceChannel timerClock{
-      "timerClock"};  //! Timer Clock (final clock used by timer)
+      "timerClock", sc_core::SC_ZERO_TIME,
+      false};  //! Timer Clock (final clock used by timer)
 
   /*------ Submodules ------*/
   ClockMux<2> clkMux{"clkMux"};     //! Input clock mux
@@ -74,18 +97,78 @@ class TimerA : public BusTarget {
 
  private:
   /*------ Private variables ------*/
-  bool direction;  //! Counting direction
+  bool direction{true};  //! Counting direction (up/down mode), true if up
   sc_core::sc_event
       sourceChangeEvent;  //! Triggered when clock source is changed.
 
   int m_triggerEventId{-1};
 
+  /*
+   * The counter is not advanced on every edge of timerClock. Instead, TA1R
+   * holds the count at m_lastUpdate, and is brought up to date by counting the
+   * clock edges that have passed since then. m_triggerEvent is scheduled at the
+   * edge of the next overflow/CCR0 match.
+   */
+  sc_core::sc_time m_lastUpdate{sc_core::SC_ZERO_TIME};  //! Time of TA1R
+  sc_core::sc_time m_clkEpoch{
+      sc_core::SC_ZERO_TIME};  //! Time at which timerClock period last changed
+  sc_core::sc_time m_clkPeriod{
+      sc_core::SC_ZERO_TIME};  //! timerClock period since m_clkEpoch
+  sc_core::sc_event m_triggerEvent{
+      "triggerEvent"};  //! Notified on next overflow/CCR0 match
+  sc_core::sc_event m_updateEvent{
+      "updateEvent"};  //! Notified to re-evaluate irq & dmaTrigger
+
   /* ------ Private methods ------ */
   /**
-   * @brief process Timer operation
+   * @brief process Timer operation: update counter, irq and dmaTrigger
    */
   void process();
 
+  /**
+   * @brief updateClkPeriod Account for elapsed ticks of the old timer clock,
+   * then switch to the new timer clock period.
+   */
+  void updateClkPeriod();
+
+  /**
+   * @brief sync Advance the counter to the current time, set TAIFG & report
+   * power events on overflow/CCR0 match, and reschedule m_triggerEvent.
+   * @retval Number of overflows/CCR0 matches since the last update.
+   */
+  uint64_t sync();
+
+  /**
+   * @brief advance Advance counter and direction by a number of timer ticks.
+   * @param nTicks number of timer clock edges
+   * @retval Number of overflows/CCR0 matches during those ticks.
+   */
+  uint64_t advance(const uint64_t nTicks);
+
+  /**
+   * @brief ticksToTrigger Number of timer ticks until the next
+   * overflow/CCR0 match.
+   * @retval Number of ticks, or 0 if the timer is halted.
+   */
+  uint64_t ticksToTrigger() const;
+
+  /**
+   * @brief countTicks Count timer clock edges in (from, to].
+   */
+  uint64_t countTicks(const sc_core::sc_time &from,
+                      const sc_core::sc_time &to) const;
+
+  /**
+   * @brief scheduleTrigger (Re)schedule m_triggerEvent based on the current
+   * counter state.
+   */
+  void scheduleTrigger();
+
+  /**
+   * @brief modeControl Read mode control bits (MC) from TA1CTL
+   */
+  unsigned modeControl() const;
+
   /**
    * @brief updateClkSource Update source clock
    */
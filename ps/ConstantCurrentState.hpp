@@ -33,15 +33,17 @@ class ConstantCurrentState : public PowerModelStateBase {
    */
   ConstantCurrentState(const std::string moduleName, const std::string name)
       : PowerModelStateBase(name),
-        current(Config::get().contains(moduleName + " " + name)
-                    ? Config::get().getDouble(moduleName + " " + name)
-                    : 0.0) {}
+        current(Config::get().getDouble(moduleName + " " + name, 0.0)) {}
 
   virtual double calculateCurrent([
       [maybe_unused]] const double supplyVoltage) const override {
     return current;
   }
 
+  virtual bool isVoltageDependent() const override { return false; }
+
+  virtual bool isVariable() const override { return false; }
+
   virtual std::string toString() const override {
     return fmt::format(
         FMT_STRING("<ConstantCurrentState> {:s}: current={:.6} nA"), name,
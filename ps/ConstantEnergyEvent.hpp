@@ -33,15 +33,15 @@ class ConstantEnergyEvent : public PowerModelEventBase {
    */
   ConstantEnergyEvent(const std::string moduleName, const std::string name)
       : PowerModelEventBase(name),
-        energy(Config::get().contains(moduleName + " " + name)
-                   ? Config::get().getDouble(moduleName + " " + name)
-                   : 0.0) {}
+        energy(Config::get().getDouble(moduleName + " " + name, 0.0)) {}
 
   virtual double calculateEnergy([
       [maybe_unused]] const double supplyVoltage) const override {
     return energy;
   }
 
+  virtual bool isVoltageDependent() const override { return false; }
+
   virtual std::string toString() const override {
     return fmt::format(
         FMT_STRING("<ConstantEnergyEvent> {:s}: energy={:.6f} nJ"), name,
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/fmt/fmt.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ps/EventLogWriter.hpp"
+
+namespace {
+/**
+ * @brief openLog Create/overwrite a binary log file and write its header.
+ */
+std::FILE *openLog(const std::string &fileName,
+                   const std::vector<std::string> &columnNames,
+                   const uint64_t timestepPs, const uint32_t format) {
+  std::FILE *f = std::fopen(fileName.c_str(), "wb");
+  if (f == nullptr) {
+    throw std::runtime_error(
+        fmt::format("Can't open eventlog file at {}", fileName));
+  }
+
+  std::string names;
+  for (const auto &n : columnNames) {
+    names += n;
+    names.push_back('\0');
+  }
+  EventLogHeader hdr{};
+  std::memcpy(hdr.magic, EventLogHeader::signature(), sizeof(hdr.magic));
+  hdr.version = EventLogHeader::VERSION;
+  hdr.nColumns = columnNames.size() + 1;
+  hdr.timestepPs = timestepPs;
+  hdr.nameTableSize = names.size();
+  hdr.format = format;
+  std::fwrite(&hdr, sizeof(hdr), 1, f);
+  std::fwrite(names.data(), 1, names.size(), f);
+  return f;
+}
+}  // namespace
+
+EventLogWriter::EventLogWriter(const std::string &fileName,
+                               const std::vector<std::string> &columnNames,
+                               const uint64_t timestepPs,
+                               const size_t rowsPerBlock, const size_t nBlocks)
+    : m_nColumns(columnNames.size() + 1),
+      m_rowsPerBlock(rowsPerBlock),
+      m_capacity(rowsPerBlock * nBlocks),
+      m_buffer(m_capacity * m_nColumns, 0) {
+  m_file =
+      openLog(fileName, columnNames, timestepPs, EventLogHeader::DENSE);
+  m_thread = std::thread(&EventLogWriter::writerLoop, this);
+}
+
+EventLogWriter::~EventLogWriter() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_committed = m_head + 1;  // Include current row
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  m_thread.join();
+  std::fclose(m_file);
+}
+
+void EventLogWriter::nextRow(const int32_t time) {
+  m_head++;
+
+  // Hand completed blocks to the writer
+  if (m_head % m_rowsPerBlock == 0) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_committed = m_head;
+    m_cv.notify_all();
+    // Wait for writer if the ring buffer is full
+    m_cv.wait(lock, [this] { return m_head - m_written < m_capacity; });
+  }
+
+  auto *const r = row();
+  std::fill(r, r + m_nColumns - 1, 0);
+  r[m_nColumns - 1] = time;
+}
+
+void EventLogWriter::writerLoop() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cv.wait(lock, [this] { return m_stop || (m_committed > m_written); });
+    if (m_committed == m_written) {
+      return;  // Stopped, and everything written
+    }
+
+    // Write contiguous rows up to the end of the ring buffer
+    const size_t start = m_written % m_capacity;
+    const size_t n = std::min(m_committed - m_written, m_capacity - start);
+    lock.unlock();
+    std::fwrite(&m_buffer[start * m_nColumns], sizeof(int32_t), n * m_nColumns,
+                m_file);
+    lock.lock();
+    m_written += n;
+    m_cv.notify_all();
+  }
+}
+
+SparseEventLogWriter::SparseEventLogWriter(
+    const std::string &fileName, const std::vector<std::string> &columnNames,
+    const uint64_t timestepPs)
+    : m_nEvents(columnNames.size()) {
+  m_file =
+      openLog(fileName, columnNames, timestepPs, EventLogHeader::SPARSE);
+}
+
+SparseEventLogWriter::~SparseEventLogWriter() {
+  startRun(0, {});  // Write pending record
+  std::fclose(m_file);
+}
+
+void SparseEventLogWriter::addRow(const uint64_t rowIdx,
+                                  int32_t *const counts) {
+  m_pairs.clear();
+  for (size_t i = 0; i < m_nEvents; ++i) {
+    if (counts[i] != 0) {
+      m_pairs.push_back({static_cast<uint32_t>(i), counts[i]});
+      counts[i] = 0;
+    }
+  }
+
+  // Rows skipped since the last row are all zeros
+  const uint64_t nextRow = m_pending.firstRow + m_pending.repeat;
+  if (rowIdx > nextRow) {
+    if (m_pendingPairs.empty()) {
+      m_pending.repeat += rowIdx - nextRow;
+    } else {
+      startRun(nextRow, {});
+      m_pending.repeat = rowIdx - nextRow;
+    }
+  }
+
+  // Extend the current run if the row is identical
+  const bool same =
+      (m_pairs.size() == m_pendingPairs.size()) &&
+      std::equal(m_pairs.begin(), m_pairs.end(), m_pendingPairs.begin(),
+                 [](const SparsePair &a, const SparsePair &b) {
+                   return a.eventId == b.eventId && a.count == b.count;
+                 });
+  if (same) {
+    m_pending.repeat++;
+  } else {
+    startRun(rowIdx, m_pairs);
+    m_pending.repeat = 1;
+  }
+}
+
+void SparseEventLogWriter::startRun(const uint64_t firstRow,
+                                    const std::vector<SparsePair> &pairs) {
+  if (m_pending.repeat > 0) {
+    std::fwrite(&m_pending, sizeof(m_pending), 1, m_file);
+    std::fwrite(m_pendingPairs.data(), sizeof(SparsePair),
+                m_pendingPairs.size(), m_file);
+  }
+  m_pendingPairs = pairs;
+  m_pending.firstRow = firstRow;
+  m_pending.repeat = 0;
+  m_pending.nPairs = pairs.size();
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief EventLogHeader Fixed-width header of a binary event log file.
+ *
+ * File layout (host byte order):
+ *   EventLogHeader
+ *   nameTableSize bytes: nColumns - 1 null-terminated column names
+ *   followed by, for DENSE logs:
+ *     rows of nColumns int32_t values: count0 count1 ... countN time(us)
+ *   or, for SPARSE logs:
+ *     SparseRecord, followed by SparseRecord::nPairs SparsePair
+ *     SparseRecord, ...
+ *
+ * Both hold the same rows as the csv event log, so that the converter tool
+ * can reproduce it exactly.
+ */
+struct EventLogHeader {
+  char magic[8];           //! EventLogHeader::signature() (w/o \0)
+  uint32_t version;        //! EventLogHeader::VERSION
+  uint32_t nColumns;       //! Number of columns per row (incl. time)
+  uint64_t timestepPs;     //! Log timestep in picoseconds
+  uint32_t nameTableSize;  //! Size of the name table following the header
+  uint32_t format;         //! DENSE or SPARSE
+
+  static const char *signature() { return "FUSEDLOG"; }
+  static const uint32_t VERSION = 1;
+  static const uint32_t DENSE = 0;
+  static const uint32_t SPARSE = 1;
+};
+
+/**
+ * @brief SparseRecord A run of repeat identical rows, starting at row
+ * firstRow (row k ends at time (k + 1) * timestep). Events not listed in the
+ * following pairs have a count of 0.
+ */
+struct SparseRecord {
+  uint64_t firstRow;
+  uint64_t repeat;
+  uint32_t nPairs;
+  uint32_t reserved;
+};
+
+//! Non-zero event count in a SparseRecord
+struct SparsePair {
+  uint32_t eventId;
+  int32_t count;
+};
+
+/**
+ * @brief EventLogWriter Writes rows of event counts to a binary log file.
+ *
+ * Rows are filled in place in a preallocated ring buffer, which is split into
+ * blocks of rows. Completed blocks are written to file by a background thread,
+ * so that the simulation does not wait for file I/O unless the writer falls
+ * behind by more than the size of the ring buffer.
+ */
+class EventLogWriter {
+ public:
+  /**
+   * @brief EventLogWriter constructor. Creates/overwrites the log file and
+   * writes the header.
+   * @param fileName path of the log file
+   * @param columnNames names of the event columns (excluding time)
+   * @param timestepPs log timestep in picoseconds
+   * @param rowsPerBlock number of rows handed to the writer thread at once
+   * @param nBlocks number of blocks in the ring buffer
+   */
+  EventLogWriter(const std::string &fileName,
+                 const std::vector<std::string> &columnNames,
+                 const uint64_t timestepPs, const size_t rowsPerBlock = 4096,
+                 const size_t nBlocks = 4);
+
+  //! Destructor. Writes all rows, including the current one, to file.
+  ~EventLogWriter();
+
+  EventLogWriter(const EventLogWriter &) = delete;
+  EventLogWriter &operator=(const EventLogWriter &) = delete;
+
+  /**
+   * @brief row Row currently being filled in.
+   */
+  int32_t *row() { return &m_buffer[(m_head % m_capacity) * m_nColumns]; }
+
+  /**
+   * @brief nextRow Finish the current row, and start a new row of all 0s.
+   * @param time value of the time column of the new row.
+   */
+  void nextRow(const int32_t time);
+
+ private:
+  std::FILE *m_file{nullptr};
+  const size_t m_nColumns;      //! int32_t values per row
+  const size_t m_rowsPerBlock;  //! Rows per block
+  const size_t m_capacity;      //! Rows in the ring buffer
+  std::vector<int32_t> m_buffer;
+
+  size_t m_head{0};       //! Row being filled in (producer only)
+  size_t m_committed{0};  //! Rows ready to be written (guarded by m_mutex)
+  size_t m_written{0};    //! Rows written to file (guarded by m_mutex)
+  bool m_stop{false};     //! Stop writer thread (guarded by m_mutex)
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::thread m_thread;
+
+  /**
+   * @brief writerLoop writer thread, writes committed rows to file.
+   */
+  void writerLoop();
+};
+
+/**
+ * @brief SparseEventLogWriter Writes rows of event counts to a binary log
+ * file, recording only the non-zero counts of each row, and collapsing runs
+ * of identical rows (including runs of all-zero rows) into a single record.
+ */
+class SparseEventLogWriter {
+ public:
+  /**
+   * @brief SparseEventLogWriter constructor. Creates/overwrites the log file
+   * and writes the header.
+   * @param fileName path of the log file
+   * @param columnNames names of the event columns (excluding time)
+   * @param timestepPs log timestep in picoseconds
+   */
+  SparseEventLogWriter(const std::string &fileName,
+                       const std::vector<std::string> &columnNames,
+                       const uint64_t timestepPs);
+
+  //! Destructor. Writes the pending record to file.
+  ~SparseEventLogWriter();
+
+  SparseEventLogWriter(const SparseEventLogWriter &) = delete;
+  SparseEventLogWriter &operator=(const SparseEventLogWriter &) = delete;
+
+  /**
+   * @brief addRow Log a row of event counts, and clear the counts. Rows
+   * skipped since the last call are logged as all-zero rows.
+   * @param rowIdx index of the row, must be larger than that of the last row
+   * @param counts event counts, one per event column
+   */
+  void addRow(const uint64_t rowIdx, int32_t *const counts);
+
+ private:
+  std::FILE *m_file{nullptr};
+  const size_t m_nEvents;
+
+  SparseRecord m_pending{0, 0, 0, 0};  //! Record of the current run of rows
+  std::vector<SparsePair> m_pendingPairs;
+  std::vector<SparsePair> m_pairs;  //! Scratch buffer for the new row
+
+  /**
+   * @brief startRun write the pending record, and start a new run.
+   */
+  void startRun(const uint64_t firstRow, const std::vector<SparsePair> &pairs);
+};
@@ -7,15 +7,30 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <systemc-ams>
 #include <systemc>
+#include <vector>
+#include "libs/make_unique.hpp"
+#include "ps/Harvesters.hpp"
+#include "utilities/Checkpoint.hpp"
 #include "utilities/Config.hpp"
 
 // Load switch with voltage detector and override input.
 // Consumes ext.dc uA  internally
-SCA_TDF_MODULE(VoltageDetectorWithOverride) {
+// The load current (i_out) is the average over the previous step, as measured
+// by PowerModelBridge. It is scaled so that the charge drawn over the current
+// step matches the charge measured, also when the step size changes
+// (AdaptiveTimestep).
+class VoltageDetectorWithOverride : public sca_tdf::sca_module,
+                                    public Checkpointable {
+ public:
   // Consume enable
   // Consume input voltage and output current
   sca_tdf::sc_in<bool> forceOn{"forceOn"};
@@ -25,17 +40,24 @@ SCA_TDF_MODULE(VoltageDetectorWithOverride) {
   // Produce output voltage and input current
   sca_tdf::sc_out<double> v_out{"v_out"};
   sca_tdf::sca_out<double> i_in{"i_in"};
+  sca_tdf::sca_out<bool> on{"on"};
   sca_tdf::sca_de::sca_out<sc_dt::sc_logic> v_warn{"v_warn"};
 
-  void set_attributes(){};
+  void set_attributes() { accept_attribute_changes(); };
+
+  void change_attributes(){};
 
   void initialize(){};
 
   void processing() {
     double crnt_v_in = v_in.read();
+    const double timestep = get_timestep().to_seconds();
+    const double loadScale =
+        (m_lastTimestep > 0.0) ? m_lastTimestep / timestep : 1.0;
+    m_lastTimestep = timestep;
     if (forceOn.read() || (crnt_v_in > m_vOn) ||
         ((crnt_v_in > m_vOff) && m_isOn)) {
-      i_in.write(i_out.read() + m_icc);
+      i_in.write(i_out.read() * loadScale + m_icc);
       v_out.write(crnt_v_in);
       m_isOn = true;
     } else {
@@ -43,6 +65,7 @@ SCA_TDF_MODULE(VoltageDetectorWithOverride) {
       v_out.write(0.0);
       m_isOn = false;
     }
+    on.write(m_isOn);
 
     // Issue voltage warning
     v_warn.write(sc_dt::sc_logic(crnt_v_in < m_vWarn));
@@ -57,83 +80,276 @@ SCA_TDF_MODULE(VoltageDetectorWithOverride) {
     m_vWarn = Config::get().getDouble("VoltageWarning");
   };
 
+  virtual void saveState(CheckpointOut &out) override { out.put(m_isOn); }
+
+  virtual void restoreState(CheckpointIn &in) override {
+    m_isOn = in.get<bool>();
+  }
+
+  virtual bool isPowerSupply() const override { return true; }
+
  private:
   double m_vOn;    // On-threshold [V]
   double m_vOff;   // Off-threshold [V]
   double m_vWarn;  // Voltage warning threshold [V]
   double m_icc;    // Current draw of external circuitry
   bool m_isOn;
+  double m_lastTimestep{0.0};  // [s] Step over which i_out was measured
 };
 
-SCA_TDF_MODULE(CapacitorIdeal) {
+// Ideal capacitor.
+// With AdaptiveTimestep enabled, the capacitor sets the timestep of the TDF
+// cluster: steps grow while the load and supply currents are steady, limited
+// by the maximum voltage change per step, and shrink back to the
+// PowerModelTimestep when a current changes or the voltage approaches one of
+// the thresholds of the supply or the voltage detector. Threshold crossings
+// are therefore resolved to within one PowerModelTimestep: the step ends just
+// past the threshold, and the following step is the PowerModelTimestep, so
+// that the voltage detector (which sees the voltage one step later) reacts as
+// it would with a fixed timestep.
+// While the load is switched off (e.g. recharging after a brown-out), both
+// currents are constant until the next threshold, and the voltage is exactly
+// linear. The capacitor then jumps straight to the next threshold crossing,
+// only stopping every PowerTraceTimestep to produce trace points.
+class CapacitorIdeal : public sca_tdf::sca_module, public Checkpointable {
+ public:
   // Consume input and output current
   sca_tdf::sca_in<double> i_in{"i_in"};
   sca_tdf::sca_in<double> i_out{"i_out"};
 
+  // Consume load switch state
+  sca_tdf::sca_in<bool> load_on{"load_on"};
+
   // Produce output voltage
   sca_tdf::sca_out<double> v{"v"};
 
-  void set_attributes() { v.set_delay(1); };
+  void set_attributes() {
+    v.set_delay(1);
+    if (m_adaptive) {
+      does_attribute_changes();
+    }
+    accept_attribute_changes();
+  };
 
   void initialize() {
     v.initialize(m_crntVoltage);
-    m_timestep = get_timestep().to_seconds();
+    m_nextTimestep = m_minTimestep;
   };
 
   void processing() {
-    m_crntVoltage += m_timestep * (i_in.read() - i_out.read()) / m_capacitance;
+    const double crntIn = i_in.read();
+    const double crntOut = i_out.read();
+    const double timestep = get_timestep().to_seconds();
+    const double lastVoltage = m_crntVoltage;
+    m_crntVoltage += timestep * (crntIn - crntOut) / m_capacitance;
     v.write(m_crntVoltage);
+
+    if (m_adaptive) {
+      m_nextTimestep = nextTimestep(timestep, lastVoltage, crntIn, crntOut,
+                                    load_on.read());
+    }
+    m_lastIn = crntIn;
+    m_lastOut = crntOut;
   }
 
+  void change_attributes() {
+    if (m_adaptive) {
+      request_next_activation(sc_core::sc_time::from_seconds(m_nextTimestep));
+    }
+  };
+
   void ac_processing(){};
 
   SCA_CTOR(CapacitorIdeal) {
     m_capacitance = Config::get().getDouble("CapacitorValue");
     m_crntVoltage = Config::get().getDouble("CapacitorInitialVoltage");
+    m_adaptive = Config::get().contains("AdaptiveTimestep") &&
+                 Config::get().getBool("AdaptiveTimestep");
+    m_minTimestep = Config::get().getDouble("PowerModelTimestep");
+    if (m_adaptive) {
+      m_maxTimestep = Config::get().getDouble("PowerModelMaxTimestep");
+      m_maxVoltageStep = Config::get().getDouble("PowerModelMaxVoltageStep");
+      m_traceTimestep = Config::get().contains("PowerTraceTimestep")
+                            ? Config::get().getDouble("PowerTraceTimestep")
+                            : m_maxTimestep;
+      m_thresholds = {Config::get().getDouble("SVSVon"),
+                      Config::get().getDouble("SVSVoff"),
+                      Config::get().getDouble("VoltageWarning"),
+                      Config::get().getDouble("SupplyVoltageLimit")};
+    }
   };
 
+  virtual void saveState(CheckpointOut &out) override {
+    out.put(m_crntVoltage);
+  }
+
+  // Restored before the simulation starts, so that the first output sample
+  // already holds the restored voltage.
+  virtual void restoreState(CheckpointIn &in) override {
+    m_crntVoltage = in.get<double>();
+  }
+
+  virtual bool isPowerSupply() const override { return true; }
+
  private:
   double m_capacitance;
   double m_crntVoltage;
-  double m_timestep;
+
+  // Adaptive timestep
+  bool m_adaptive{false};
+  double m_minTimestep;     // [s]
+  double m_maxTimestep;     // [s]
+  double m_maxVoltageStep;  // [V] Maximum voltage change per step
+  double m_traceTimestep;   // [s] Maximum step while the load is off
+  double m_nextTimestep;    // [s]
+  double m_lastIn{0.0};     // [A] Input current of the previous step
+  double m_lastOut{0.0};    // [A] Output current of the previous step
+  std::vector<double> m_thresholds;  // [V]
+
+  // Relative change of a current that resets the timestep
+  static constexpr double CURRENT_TOLERANCE = 0.01;
+
+  static bool currentChanged(const double last, const double crnt) {
+    return std::abs(crnt - last) >
+           CURRENT_TOLERANCE * std::max(std::abs(crnt), std::abs(last));
+  }
+
+  double nextTimestep(const double timestep, const double lastVoltage,
+                      const double crntIn, const double crntOut,
+                      const bool loadOn) const {
+    // Restart from the minimum step when either current changes
+    if (currentChanged(m_lastIn, crntIn) ||
+        currentChanged(m_lastOut, crntOut)) {
+      return m_minTimestep;
+    }
+
+    // The voltage detector reads this step's voltage on its next activation,
+    // so take the minimum step after crossing a threshold.
+    for (const double th : m_thresholds) {
+      if ((lastVoltage - th) * (m_crntVoltage - th) < 0.0) {
+        return m_minTimestep;
+      }
+    }
+
+    // Otherwise grow the step, limiting the voltage change per step. With the
+    // load off, the voltage is linear up to the next threshold, so there is
+    // no need to limit the voltage change.
+    double dt =
+        loadOn ? std::min(2.0 * timestep, m_maxTimestep) : m_traceTimestep;
+    const double dvdt = (crntIn - crntOut) / m_capacitance;
+    if (dvdt != 0.0) {
+      if (loadOn) {
+        dt = std::min(dt, m_maxVoltageStep / std::abs(dvdt));
+      }
+
+      // Stop just past the nearest threshold ahead. The voltage detector's
+      // comparisons are strict, so landing exactly on it wouldn't trigger.
+      for (const double th : m_thresholds) {
+        const double tCross = (th - m_crntVoltage) / dvdt;
+        if (tCross > 0.0) {
+          dt = std::min(dt, tCross + m_minTimestep);
+        }
+      }
+    }
+    return std::max(dt, m_minTimestep);
+  }
 };
 
-SCA_TDF_MODULE(ConstantCurrentSupplyTDF) {
+// Power supply/energy harvester charging the storage capacitor. The harvester
+// model is selected by the PowerSupply config key:
+//   ConstantCurrentSupply: SupplyCurrentLimit up to SupplyVoltageLimit
+//   TraceSupply: current/voltage trace streamed from SupplyTraceFile
+//   PvCell: photovoltaic cell
+//   RfRectifier: RF energy harvester
+// With AdaptiveTimestep enabled, the supply limits the timestep to the next
+// sample of a trace, and, for voltage-dependent harvesters, to a change of
+// PowerModelMaxVoltageStep of the capacitor voltage.
+SCA_TDF_MODULE(HarvesterTDF) {
   // Consume voltage
   sca_tdf::sca_in<double> v;
 
-  // Produce contant current
+  // Produce harvested current
   sca_tdf::sca_out<double> i;
 
-  void set_attributes() { set_timestep(m_timestep); }
+  void set_attributes() {
+    set_timestep(m_timestep);
+    if (m_adaptive) {
+      does_attribute_changes();
+    }
+    accept_attribute_changes();
+  }
 
   void initialize(){};
 
   void processing() {
-    if ((v.read() + m_maxStepSize) < m_voltageLimit) {
-      i.write(m_currentSetpoint);
-    } else {
-      i.write(0.0);
+    const double t = get_time().to_seconds();
+    const double crnt = m_harvester->current(v.read(), t);
+    i.write(crnt);
+
+    if (m_adaptive) {
+      m_nextTimestep = std::numeric_limits<double>::infinity();
+      if (m_harvester->isVoltageDependent() && crnt > 0.0) {
+        m_nextTimestep = m_maxVoltageStep * m_capacitance / crnt;
+      }
+      m_nextTimestep = std::min(m_nextTimestep, m_harvester->nextChange() - t);
     }
   }
 
+  void change_attributes() {
+    // Only constrain the timestep chosen by the capacitor when needed
+    if (m_adaptive && std::isfinite(m_nextTimestep)) {
+      request_next_activation(sc_core::sc_time::from_seconds(
+          std::max(m_nextTimestep, m_timestep.to_seconds())));
+    }
+  };
+
   void ac_processing(){};
 
-  SCA_CTOR(ConstantCurrentSupplyTDF) {
-    m_currentSetpoint = Config::get().getDouble("SupplyCurrentLimit");
-    m_voltageLimit = Config::get().getDouble("SupplyVoltageLimit");
-    m_timestep = sc_core::sc_time::from_seconds(
-        Config::get().getDouble("PowerModelTimestep"));
-    m_maxStepSize =
-        m_timestep.to_seconds() *
-        (m_currentSetpoint / Config::get().getDouble("CapacitorValue"));
+  SCA_CTOR(HarvesterTDF) {
+    auto &config = Config::get();
+    m_timestep =
+        sc_core::sc_time::from_seconds(config.getDouble("PowerModelTimestep"));
+    m_capacitance = config.getDouble("CapacitorValue");
+    m_adaptive = config.contains("AdaptiveTimestep") &&
+                 config.getBool("AdaptiveTimestep");
+    if (m_adaptive) {
+      m_maxVoltageStep = config.getDouble("PowerModelMaxVoltageStep");
+    }
+
+    const auto &type = config.getString("PowerSupply");
+    if (type == "ConstantCurrentSupply") {
+      const double crnt = config.getDouble("SupplyCurrentLimit");
+      m_harvester = std::make_unique<ConstantCurrentHarvester>(
+          crnt, config.getDouble("SupplyVoltageLimit"),
+          m_timestep.to_seconds() * (crnt / m_capacitance));
+    } else if (type == "TraceSupply") {
+      m_harvester = std::make_unique<TraceHarvester>(
+          config.getString("SupplyTraceFile"),
+          TraceHarvester::parseTraceType(config.getString("SupplyTraceType")),
+          config.getDouble("SupplyTraceResistance"));
+    } else if (type == "PvCell") {
+      m_harvester = std::make_unique<PvCellHarvester>(
+          config.getDouble("PvShortCircuitCurrent"),
+          config.getDouble("PvOpenCircuitVoltage"),
+          config.getDouble("PvDiodeVoltage"));
+    } else if (type == "RfRectifier") {
+      m_harvester = std::make_unique<RfHarvester>(
+          config.getDouble("RfInputPower"), config.getDouble("RfEfficiency"),
+          config.getDouble("RfOpenCircuitVoltage"));
+    } else {
+      throw std::invalid_argument("Invalid PowerSupply '" + type + "'");
+    }
   };
 
  private:
-  double m_currentSetpoint;     // [Ampere]
-  double m_voltageLimit;        // [Volt]
-  double m_maxStepSize;         // [Volt] Handy to avoid overshoot
+  std::unique_ptr<Harvester> m_harvester;
+  double m_capacitance;         // [F]
   sc_core::sc_time m_timestep;  // Evaluation timestep
+
+  // Adaptive timestep
+  bool m_adaptive{false};
+  double m_maxVoltageStep;  // [V] Maximum voltage change per step
+  double m_nextTimestep;    // [s]
 };
 
 SC_MODULE(ExternalCircuitry) {
@@ -145,7 +361,7 @@ SC_MODULE(ExternalCircuitry) {
   sc_core::sc_out_resolved v_warn{"v_warn"};
 
   // Modules
-  ConstantCurrentSupplyTDF supply{"supply"};
+  HarvesterTDF supply{"supply"};
   CapacitorIdeal c{"c"};
   VoltageDetectorWithOverride svs{"svs"};
 
@@ -156,9 +372,11 @@ SC_MODULE(ExternalCircuitry) {
     c.i_in(i_supply);
     c.v(v_cap);
     c.i_out(i_in_svs);
+    c.load_on(svs_on);
 
     svs.i_out(i_out);
     svs.i_in(i_in_svs);
+    svs.on(svs_on);
     svs.v_in(v_cap);
     svs.v_out(vcc);
     svs.v_warn(v_warn);
@@ -169,4 +387,5 @@ SC_MODULE(ExternalCircuitry) {
   sca_tdf::sca_signal<double> i_in_svs{"i_in_svs"};
   sca_tdf::sca_signal<double> i_supply{"i_supply"};
   sca_tdf::sca_signal<double> v_cap{"v_cap"};
+  sca_tdf::sca_signal<bool> svs_on{"svs_on"};
 };
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include "ps/Harvesters.hpp"
+
+TraceHarvester::TraceHarvester(const std::string &fileName,
+                               const TraceType type, const double resistance)
+    : m_trace(fileName), m_type(type), m_resistance(resistance) {}
+
+TraceHarvester::TraceType TraceHarvester::parseTraceType(const std::string &s) {
+  if (s == "current") {
+    return TraceType::CURRENT;
+  } else if (s == "voltage") {
+    return TraceType::VOLTAGE;
+  }
+  throw std::invalid_argument(fmt::format("Invalid trace type '{}'", s));
+}
+
+double TraceHarvester::current(const double v, const double t) {
+  const double value = m_trace.valueAt(t);
+  if (m_type == TraceType::CURRENT) {
+    return std::max(value, 0.0);
+  }
+  return std::max((value - v) / m_resistance, 0.0);
+}
+
+PvCellHarvester::PvCellHarvester(const double shortCircuitCurrent,
+                                 const double openCircuitVoltage,
+                                 const double diodeVoltage)
+    : m_isc(shortCircuitCurrent),
+      m_vt(diodeVoltage),
+      m_i0(shortCircuitCurrent /
+           std::expm1(openCircuitVoltage / diodeVoltage)) {}
+
+double PvCellHarvester::current(const double v, const double t) {
+  return std::max(m_isc - m_i0 * std::expm1(v / m_vt), 0.0);
+}
+
+RfHarvester::RfHarvester(const double inputPowerDbm, const double efficiency,
+                         const double openCircuitVoltage)
+    : m_voc(openCircuitVoltage),
+      m_resistance(openCircuitVoltage * openCircuitVoltage /
+                   (4.0 * efficiency * 1.0e-3 *
+                    std::pow(10.0, inputPowerDbm / 10.0))) {}
+
+double RfHarvester::current(const double v, const double t) {
+  return std::max((m_voc - v) / m_resistance, 0.0);
+}
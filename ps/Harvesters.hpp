@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <string>
+#include "ps/TraceReader.hpp"
+
+/**
+ * Abstract base class for energy harvesters/power supplies charging the
+ * storage capacitor.
+ */
+class Harvester {
+ public:
+  virtual ~Harvester() = default;
+
+  /**
+   * @brief current calculate the current delivered to the storage capacitor.
+   * @param v capacitor voltage [V]
+   * @param t simulation time [s], must not decrease between calls
+   * @retval current [A]
+   */
+  virtual double current(const double v, const double t) = 0;
+
+  /**
+   * @brief isVoltageDependent whether the current changes continuously with
+   * the capacitor voltage.
+   */
+  virtual bool isVoltageDependent() const { return true; }
+
+  /**
+   * @brief nextChange time [s] at which the current may next change
+   * independently of the capacitor voltage, or infinity.
+   */
+  virtual double nextChange() const {
+    return std::numeric_limits<double>::infinity();
+  }
+};
+
+/**
+ * @brief ConstantCurrentHarvester Constant current source, which switches off
+ * when the capacitor voltage comes within margin of voltageLimit.
+ */
+class ConstantCurrentHarvester : public Harvester {
+ public:
+  ConstantCurrentHarvester(const double current, const double voltageLimit,
+                           const double margin)
+      : m_current(current), m_voltageLimit(voltageLimit), m_margin(margin) {}
+
+  virtual double current(const double v, const double t) override {
+    return ((v + m_margin) < m_voltageLimit) ? m_current : 0.0;
+  }
+
+  virtual bool isVoltageDependent() const override { return false; }
+
+ private:
+  const double m_current;       // [A]
+  const double m_voltageLimit;  // [V]
+  const double m_margin;        // [V] Handy to avoid overshoot
+};
+
+/**
+ * @brief TraceHarvester Replays a current or voltage trace, streamed from file
+ * (see TraceReader).
+ *   - Current traces are delivered as is (negative values are clipped to 0).
+ *   - Voltage traces are interpreted as the open-circuit voltage of a source
+ *     with the given series resistance, feeding the capacitor through an
+ *     ideal diode.
+ */
+class TraceHarvester : public Harvester {
+ public:
+  enum class TraceType { CURRENT, VOLTAGE };
+
+  TraceHarvester(const std::string &fileName, const TraceType type,
+                 const double resistance);
+
+  /**
+   * @brief parseTraceType convert a config string ("current" or "voltage")
+   * to TraceType.
+   */
+  static TraceType parseTraceType(const std::string &s);
+
+  virtual double current(const double v, const double t) override;
+
+  virtual bool isVoltageDependent() const override {
+    return m_type == TraceType::VOLTAGE;
+  }
+
+  virtual double nextChange() const override { return m_trace.nextTime(); }
+
+ private:
+  TraceReader m_trace;
+  const TraceType m_type;
+  const double m_resistance;  // [Ohm]
+};
+
+/**
+ * @brief PvCellHarvester Single-diode model of a photovoltaic cell/module,
+ * feeding the capacitor through an ideal diode:
+ *   I = Isc - I0 * (exp(V / Vt) - 1), I0 = Isc / (exp(Voc / Vt) - 1)
+ * where Vt = n * Ns * kT/q is the diode voltage of the module.
+ */
+class PvCellHarvester : public Harvester {
+ public:
+  /**
+   * @brief PvCellHarvester constructor
+   * @param shortCircuitCurrent short-circuit current Isc [A]
+   * @param openCircuitVoltage open-circuit voltage Voc [V]
+   * @param diodeVoltage diode voltage Vt [V]
+   */
+  PvCellHarvester(const double shortCircuitCurrent,
+                  const double openCircuitVoltage, const double diodeVoltage);
+
+  virtual double current(const double v, const double t) override;
+
+ private:
+  const double m_isc;  // [A]
+  const double m_vt;   // [V]
+  const double m_i0;   // [A] Diode saturation current
+};
+
+/**
+ * @brief RfHarvester RF rectifier, modelled as a Thevenin source whose
+ * open-circuit voltage and source resistance are such that it delivers the
+ * rectified input power (efficiency * input power) into a matched load,
+ * feeding the capacitor through an ideal diode.
+ */
+class RfHarvester : public Harvester {
+ public:
+  /**
+   * @brief RfHarvester constructor
+   * @param inputPowerDbm received RF power [dBm]
+   * @param efficiency RF-to-DC conversion efficiency
+   * @param openCircuitVoltage open-circuit output voltage [V]
+   */
+  RfHarvester(const double inputPowerDbm, const double efficiency,
+              const double openCircuitVoltage);
+
+  virtual double current(const double v, const double t) override;
+
+ private:
+  const double m_voc;         // [V]
+  const double m_resistance;  // [Ohm]
+};
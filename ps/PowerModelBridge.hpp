@@ -7,6 +7,7 @@
 
 #pragma once
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <systemc-ams>
 #include <systemc>
 #include "ps/PowerModelChannelIf.hpp"
@@ -28,21 +29,37 @@ SC_MODULE(PowerModelBridge) {
   }
 
   void process() {
+    const auto now = sc_core::sc_time_stamp();
     if (v_in.read() <= 0.0) {
+      if (m_isOn) {
+        m_onTime += now - m_onSince;
+        m_isOn = false;
+      }
       i_out.write(0.0);
       return;
     }
-    const double timestep =
-        (sc_core::sc_time_stamp() - m_lastReadTime).to_seconds();
-    m_lastReadTime = sc_core::sc_time_stamp();
+    if (!m_isOn) {
+      m_isOn = true;
+      m_onSince = now;
+      m_powerOns++;
+    }
+    const double timestep = (now - m_lastReadTime).to_seconds();
+    m_lastReadTime = now;
 
     // Dynamic current = E/(v*ts)
+    const double dynamicEnergy = powerModelPort->popDynamicEnergy();
     const double dynamicCurrent =
-        powerModelPort->popDynamicEnergy() / (v_in.read() * timestep);
+        (timestep > 0.0) ? dynamicEnergy / (v_in.read() * timestep) : 0.0;
 
-    const double i = powerModelPort->getStaticCurrent() + dynamicCurrent;
+    const double staticCurrent = powerModelPort->getStaticCurrent();
+    const double i = staticCurrent + dynamicCurrent;
     i_out.write(i);
 
+    // Static energy is only consumed while powered
+    const double onTimestep =
+        std::min(timestep, (now - m_onSince).to_seconds());
+    m_energy += dynamicEnergy + staticCurrent * v_in.read() * onTimestep;
+
     // spdlog::info(FMT_STRING(
     // "{:s}: {:010d} us delta {:.1f} us static {:.6f} mA dynamic {:.6f} mA"),
     //             this->name(),
@@ -52,5 +69,30 @@ SC_MODULE(PowerModelBridge) {
     //             1e3 * dynamicCurrent);
   }
 
+  /**
+   * @brief getEnergy total energy [J] consumed by the load so far.
+   */
+  double getEnergy() const { return m_energy; }
+
+  /**
+   * @brief getOnTime total time the load has been powered so far.
+   */
+  sc_core::sc_time getOnTime() const {
+    return m_isOn ? m_onTime + (sc_core::sc_time_stamp() - m_onSince)
+                  : m_onTime;
+  }
+
+  /**
+   * @brief getPowerOns number of times the load has been powered on.
+   */
+  unsigned getPowerOns() const { return m_powerOns; }
+
   sc_core::sc_time m_lastReadTime{sc_core::SC_ZERO_TIME};
+
+ private:
+  double m_energy{0.0};  // [J]
+  bool m_isOn{false};
+  unsigned m_powerOns{0};
+  sc_core::sc_time m_onSince{sc_core::SC_ZERO_TIME};
+  sc_core::sc_time m_onTime{sc_core::SC_ZERO_TIME};
 };
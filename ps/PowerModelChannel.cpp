@@ -8,28 +8,37 @@
 #include <spdlog/fmt/fmt.h>
 #include <spdlog/spdlog.h>
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <memory>
-#include <numeric>
 #include <stdexcept>
 #include <systemc>
 #include <vector>
+#include "libs/make_unique.hpp"
 #include "ps/PowerModelChannel.hpp"
 #include "ps/PowerModelEventBase.hpp"
 
 using namespace sc_core;
 
+const double PowerModelChannel::CURRENT_SCALE = 1.0e15;
+
 PowerModelChannel::PowerModelChannel(const sc_module_name name,
                                      const std::string logFilePath,
-                                     sc_time logTimestep)
+                                     sc_time logTimestep,
+                                     const LogFormat logFormat)
     : sc_module(name),
-      m_eventlogFileName(logFilePath == "none"
-                             ? "none"
-                             : logFilePath + "/" + std::string(name) +
-                                   "_eventlog.csv"),
+      m_eventlogFileName(
+          logFilePath == "none"
+              ? "none"
+              : logFilePath + "/" + std::string(name) +
+                    (logFormat == LogFormat::BINARY
+                         ? "_eventlog.bin"
+                         : logFormat == LogFormat::SPARSE ? "_eventlog.sparse"
+                                                          : "_eventlog.csv")),
+      m_logFormat(logFormat),
       m_logTimestep(logTimestep) {
-  if (logFilePath != "none") {
+  if (logFilePath != "none" && logFormat == LogFormat::CSV) {
     // Create/overwrite log files
     std::ofstream f(m_eventlogFileName, std::ios::out | std::ios::trunc);
     if (!f.good()) {
@@ -43,7 +52,30 @@ PowerModelChannel::PowerModelChannel(const sc_module_name name,
   SC_THREAD(logLoop);
 }
 
-PowerModelChannel::~PowerModelChannel() { dumpEventCsv(); }
+PowerModelChannel::~PowerModelChannel() {
+  if (m_logFormat == LogFormat::CSV) {
+    dumpEventCsv();
+  } else if (m_sparseLog != nullptr) {
+    // Log the current row, like the csv does
+    m_sparseLog->addRow(logRow(sc_time_stamp()), m_crntRow);
+  }
+  // Binary logs are flushed by the writers' destructors
+}
+
+PowerModelChannel::LogFormat PowerModelChannel::parseLogFormat(
+    const std::string &s) {
+  if (s == "csv") {
+    return LogFormat::CSV;
+  } else if (s == "binary") {
+    return LogFormat::BINARY;
+  } else if (s == "sparse") {
+    return LogFormat::SPARSE;
+  }
+  throw std::invalid_argument(fmt::format(
+      FMT_STRING("PowerModelChannel::parseLogFormat invalid log format "
+                 "'{:s}', must be one of {{csv, binary, sparse}}"),
+      s));
+}
 
 int PowerModelChannel::registerEvent(
     const std::string moduleName,
@@ -84,6 +116,7 @@ int PowerModelChannel::registerEvent(
   const int id = m_events.size();
   m_events.emplace_back(std::move(eventPtr), moduleId);
   m_eventRates.push_back(0);
+  m_eventEnergies.push_back(0.0);
   sc_assert(m_events.size() == m_eventRates.size());
   return id;
 }
@@ -126,6 +159,9 @@ int PowerModelChannel::registerState(
   // Add state to m_states
   const int id = m_states.size();
   m_states.emplace_back(std::move(statePtr), moduleId);
+  m_stateCurrents.push_back(0);
+  m_hasVoltageDependentStates |=
+      !m_states.back().variable && m_states.back().state->isVoltageDependent();
 
   // Set default state to first state registered for this module
   if (m_currentStates[moduleId] == -1) {
@@ -142,10 +178,20 @@ void PowerModelChannel::reportEvent(const int eventId, const int n) {
         "simulation has started. Events shall only be reported during "
         "simulation");
   }
-  sc_assert(eventId >= 0 && eventId < m_log.back().size());
+  sc_assert(eventId >= 0 && eventId < m_events.size());
 
   m_eventRates[eventId] += n;
-  m_log.back()[eventId] += n;
+  m_crntRow[eventId] += n;
+  if (m_energyAccumulator != nullptr) {
+    updateEventEnergies();
+    *m_energyAccumulator += m_eventEnergies[eventId] * n;
+  }
+
+  // Wake up the sparse log loop
+  if (!m_logDirty) {
+    m_logDirty = true;
+    m_logDirtyEvent.notify();
+  }
 }
 
 void PowerModelChannel::reportState(const int stateId) {
@@ -157,46 +203,154 @@ void PowerModelChannel::reportState(const int stateId) {
   }
   sc_assert(stateId >= 0 && stateId < m_states.size());
   const auto mid = m_states[stateId].moduleId;
+  const auto oldStateId = m_currentStates[mid];
+  if (oldStateId == stateId) {
+    return;
+  }
   m_currentStates[mid] = stateId;
+
+  // Apply the difference between the old and new state
+  if (oldStateId >= 0) {
+    if (m_states[oldStateId].variable) {
+      m_variableStateModules.erase(std::find(m_variableStateModules.begin(),
+                                             m_variableStateModules.end(),
+                                             mid));
+    } else {
+      m_staticCurrent -= m_stateCurrents[oldStateId];
+    }
+  }
+  if (m_states[stateId].variable) {
+    m_variableStateModules.push_back(mid);
+  } else {
+    m_staticCurrent += m_stateCurrents[stateId];
+  }
 }
 
 int PowerModelChannel::popEventCount(const int eventId) {
-  sc_assert(eventId >= 0 && eventId < m_log.back().size());
+  sc_assert(eventId >= 0 && eventId < m_events.size());
   const auto tmp = m_eventRates[eventId];
   m_eventRates[eventId] = 0;
   return tmp;
 }
 
 double PowerModelChannel::popEventEnergy(const int eventId) {
-  sc_assert(eventId >= 0 && eventId < m_log.back().size());
-  return m_events[eventId].event->calculateEnergy(m_supplyVoltage) *
-         popEventCount(eventId);
+  sc_assert(eventId >= 0 && eventId < m_events.size());
+  updateEventEnergies();
+  return m_eventEnergies[eventId] * popEventCount(eventId);
 }
 
 double PowerModelChannel::popDynamicEnergy() {
-  double result = 0.0;
-  for (int i = 0; i < m_events.size(); ++i) {
-    result += popEventEnergy(i);
+  updateEventEnergies();
+
+  // Dot product of energies & counts. Independent partial sums let the
+  // compiler vectorise the loop without reassociating a single sum.
+  const size_t n = m_eventRates.size();
+  const double *const e = m_eventEnergies.data();
+  const int *const c = m_eventRates.data();
+  double sum[4] = {0.0, 0.0, 0.0, 0.0};
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    sum[0] += e[i] * c[i];
+    sum[1] += e[i + 1] * c[i + 1];
+    sum[2] += e[i + 2] * c[i + 2];
+    sum[3] += e[i + 3] * c[i + 3];
+  }
+  for (; i < n; ++i) {
+    sum[0] += e[i] * c[i];
+  }
+  std::fill(m_eventRates.begin(), m_eventRates.end(), 0);
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+void PowerModelChannel::updateEventEnergies() {
+  if (m_eventEnergiesStale) {
+    for (const auto i : m_voltageDependentEvents) {
+      m_eventEnergies[i] = m_events[i].event->calculateEnergy(m_supplyVoltage);
+    }
+    m_eventEnergiesStale = false;
   }
-  return result;
 }
 
 double PowerModelChannel::getStaticCurrent() {
-  return std::accumulate(
-      m_currentStates.begin(), m_currentStates.end(), 0.0,
-      [=](const double &sum, const int &stateId) {
-        // Ignore invalid (uninitialized) states
-        return stateId >= 0 ? sum + m_states[stateId].state->calculateCurrent(
-                                        m_supplyVoltage)
-                            : sum;
-      });
+  if (m_staticCurrentStale) {
+    recalculateStaticCurrent();
+  }
+  double result = static_cast<double>(m_staticCurrent) / CURRENT_SCALE;
+  for (const auto mid : m_variableStateModules) {
+    result += m_states[m_currentStates[mid]].state->calculateCurrent(
+        m_supplyVoltage);
+  }
+  return result;
+}
+
+void PowerModelChannel::recalculateStaticCurrent() {
+  for (int i = 0; i < m_states.size(); ++i) {
+    if (!m_states[i].variable) {
+      m_stateCurrents[i] = std::llround(
+          m_states[i].state->calculateCurrent(m_supplyVoltage) * CURRENT_SCALE);
+    }
+  }
+
+  m_staticCurrent = 0;
+  m_variableStateModules.clear();
+  for (int mid = 0; mid < m_currentStates.size(); ++mid) {
+    const auto stateId = m_currentStates[mid];
+    if (stateId < 0) {
+      continue;  // Ignore invalid (uninitialized) states
+    } else if (m_states[stateId].variable) {
+      m_variableStateModules.push_back(mid);
+    } else {
+      m_staticCurrent += m_stateCurrents[stateId];
+    }
+  }
+  m_staticCurrentStale = false;
 }
 
 void PowerModelChannel::start_of_simulation() {
+  // Energies of voltage-independent events are calculated only once
+  for (int i = 0; i < m_events.size(); ++i) {
+    if (m_events[i].event->isVoltageDependent()) {
+      m_voltageDependentEvents.push_back(i);
+    } else {
+      m_eventEnergies[i] = m_events[i].event->calculateEnergy(m_supplyVoltage);
+    }
+  }
+  m_eventEnergiesStale = true;
+  m_staticCurrentStale = true;
+
   // Initialize event log
-  m_log.emplace_back(m_events.size() + 1, 0);
+  const size_t rowWidth = m_events.size() + 1;
+  std::vector<std::string> columnNames;
+  for (const auto &e : m_events) {
+    columnNames.push_back(m_moduleNames[e.moduleId] + " " + e.event->name);
+  }
+  if (loggingEnabled() && m_logFormat == LogFormat::BINARY) {
+    try {
+      m_binaryLog = std::make_unique<EventLogWriter>(
+          m_eventlogFileName, columnNames, m_logTimestep.value());
+    } catch (std::runtime_error &e) {
+      SC_REPORT_FATAL(this->name(), e.what());
+    }
+    m_crntRow = m_binaryLog->row();
+  } else if (loggingEnabled() && m_logFormat == LogFormat::SPARSE) {
+    try {
+      m_sparseLog = std::make_unique<SparseEventLogWriter>(
+          m_eventlogFileName, columnNames, m_logTimestep.value());
+    } catch (std::runtime_error &e) {
+      SC_REPORT_FATAL(this->name(), e.what());
+    }
+    m_log.assign(rowWidth, 0);  // Single row, cleared by the writer
+    m_crntRow = m_log.data();
+  } else {
+    // Preallocate, so that rows are not reallocated until the log is dumped
+    if (loggingEnabled()) {
+      m_log.reserve((m_logDumpThreshold + 1) * rowWidth);
+    }
+    m_log.assign(rowWidth, 0);
+    m_crntRow = m_log.data();
+  }
   // Fist entry is at t = timestep
-  m_log.back().back() = static_cast<int>(m_logTimestep.to_seconds() * 1.0e6);
+  m_crntRow[rowWidth - 1] = timeUs(m_logTimestep);
 
   // Print list of events & states
   spdlog::info("-- PowerModelChannel Registered Events & States ------");
@@ -217,26 +371,56 @@ void PowerModelChannel::start_of_simulation() {
 }
 
 void PowerModelChannel::logLoop() {
-  if (m_eventlogFileName == "none" || m_logTimestep == SC_ZERO_TIME) {
+  if (!loggingEnabled()) {
     SC_REPORT_INFO(this->name(), "Logging disabled.");
     return;
   }
 
+  if (m_logFormat == LogFormat::SPARSE) {
+    sparseLogLoop();
+    return;
+  }
+
+  const size_t rowWidth = m_events.size() + 1;
   while (1) {
     // Wait for a timestep
     wait(m_logTimestep);
 
+    // Last column in the new row is the current time step
+    const int time = timeUs(m_logTimestep + sc_time_stamp());
+
+    if (m_logFormat == LogFormat::BINARY) {
+      m_binaryLog->nextRow(time);
+      m_crntRow = m_binaryLog->row();
+      continue;
+    }
+
     // Dump file when log exceeds threshold
-    if (m_log.size() > m_logDumpThreshold) {
+    if (m_log.size() / rowWidth > m_logDumpThreshold) {
       dumpEventCsv();
       m_log.clear();
     }
 
     // Push new timestep
-    m_log.emplace_back(m_events.size() + 1, 0);  // New row of all 0s
-    // Last column in the new row is the current time step
-    m_log.back().back() = static_cast<int>(
-        (m_logTimestep + sc_time_stamp()).to_seconds() * 1.0e6);
+    m_log.resize(m_log.size() + rowWidth, 0);  // New row of all 0s
+    m_crntRow = &m_log[m_log.size() - rowWidth];
+    m_crntRow[rowWidth - 1] = time;
+  }
+}
+
+void PowerModelChannel::sparseLogLoop() {
+  while (1) {
+    // Sleep until an event is reported
+    if (!m_logDirty) {
+      wait(m_logDirtyEvent);
+    }
+
+    // Log the row at the end of the current timestep
+    const auto row = logRow(sc_time_stamp());
+    wait(sc_time::from_value((row + 1) * m_logTimestep.value()) -
+         sc_time_stamp());
+    m_sparseLog->addRow(row, m_crntRow);
+    m_logDirty = false;
   }
 }
 
@@ -255,16 +439,36 @@ void PowerModelChannel::dumpEventCsv() {
   }
 
   // Values
-  for (const auto &row : m_log) {
-    for (const auto &val : row) {
-      f << val << (&val == &row.back() ? '\n' : ',');
-    }
+  const size_t rowWidth = m_events.size() + 1;
+  for (size_t i = 0; i < m_log.size(); ++i) {
+    f << m_log[i] << ((i % rowWidth == rowWidth - 1) ? '\n' : ',');
   }
 }
 
 void PowerModelChannel::setSupplyVoltage(const double val) {
   if (m_supplyVoltage != val) {
     m_supplyVoltage = val;
+    m_eventEnergiesStale |= !m_voltageDependentEvents.empty();
+    m_staticCurrentStale |= m_hasVoltageDependentStates;
     m_supplyVoltageChangedEvent.notify(SC_ZERO_TIME);
   }
 }
+
+void PowerModelChannel::saveState(CheckpointOut &out) {
+  out.put<uint32_t>(m_currentStates.size());
+  for (const auto stateId : m_currentStates) {
+    out.put<int>(stateId);
+  }
+}
+
+void PowerModelChannel::restoreState(CheckpointIn &in) {
+  if (in.get<uint32_t>() != m_currentStates.size()) {
+    SC_REPORT_FATAL(this->name(), "Checkpoint has different power model");
+  }
+  for (size_t i = 0; i < m_currentStates.size(); ++i) {
+    const auto stateId = in.get<int>();
+    if (stateId >= 0) {
+      reportState(stateId);
+    }
+  }
+}
@@ -11,26 +11,42 @@
 #include <string>
 #include <systemc>
 #include <vector>
+#include "ps/EventLogWriter.hpp"
 #include "ps/PowerModelChannelIf.hpp"
 #include "ps/PowerModelEventBase.hpp"
+#include "utilities/Checkpoint.hpp"
 
 /**
  * class PowerModelChannel implementation of power model channel.  See
  * interface PowerModelChannelIf.hpp for description.
  *
- * Logging: This implementation optionally writes a csv-formatted log of event
- * rates and module states at a specified time step.
+ * Logging: This implementation optionally writes a log of event rates at a
+ * specified time step, either as csv or in a (dense or sparse) binary format
+ * (see EventLogWriter.hpp) which can be converted to the same csv with
+ * eventlog2csv. The sparse log only wakes up in timesteps in which events are
+ * reported.
  */
 class PowerModelChannel : public virtual PowerModelChannelOutIf,
                           public virtual PowerModelChannelInIf,
-                          public sc_core::sc_module {
+                          public sc_core::sc_module,
+                          public Checkpointable {
  public:
+  /* ------ Public types ------ */
+
+  //! Event log file formats
+  enum class LogFormat {
+    CSV,     //! <name>_eventlog.csv
+    BINARY,  //! <name>_eventlog.bin
+    SPARSE,  //! <name>_eventlog.sparse, only non-zero counts, run-length coded
+  };
+
   /* ------ Public methods ------ */
 
   //! Constructor
   PowerModelChannel(const sc_core::sc_module_name name,
                     const std::string logfile = "",
-                    const sc_core::sc_time logTimestep = sc_core::SC_ZERO_TIME);
+                    const sc_core::sc_time logTimestep = sc_core::SC_ZERO_TIME,
+                    const LogFormat logFormat = LogFormat::CSV);
 
   //! Destructor
   ~PowerModelChannel();
@@ -71,6 +87,30 @@ class PowerModelChannel : public virtual PowerModelChannelOutIf,
    */
   virtual void start_of_simulation() override;
 
+  /**
+   * @brief parseLogFormat convert a config string to a LogFormat.
+   * @param s one of {csv, binary, sparse}
+   */
+  static LogFormat parseLogFormat(const std::string &s);
+
+  /**
+   * @brief saveState save the current state of each module.
+   */
+  virtual void saveState(CheckpointOut &out) override;
+
+  /**
+   * @brief restoreState report the saved state of each module. Pending event
+   * counts and the event log are not restored.
+   */
+  virtual void restoreState(CheckpointIn &in) override;
+
+  /**
+   * @brief setEnergyAccumulator add the energy of every reported event to
+   * *acc as it is reported, e.g. for attributing energy to code by a
+   * profiler. nullptr disables accumulation.
+   */
+  void setEnergyAccumulator(double *acc) { m_energyAccumulator = acc; }
+
  private:
   //! Supply voltage associated with this channel
   double m_supplyVoltage = 0.0;
@@ -98,14 +138,35 @@ class PowerModelChannel : public virtual PowerModelChannelOutIf,
   //! Keeps track of event counts since the last pop
   std::vector<int> m_eventRates;
 
+  //! Energy per event at the current supply voltage. Same index as m_events.
+  std::vector<double> m_eventEnergies;
+
+  //! Ids of events whose energy depends on the supply voltage
+  std::vector<int> m_voltageDependentEvents;
+
+  //! Set when m_eventEnergies of voltage-dependent events need updating
+  bool m_eventEnergiesStale{true};
+
+  //! Receives the energy of reported events (see setEnergyAccumulator)
+  double *m_energyAccumulator{nullptr};
+
+  /**
+   * @brief updateEventEnergies recalculate m_eventEnergies of voltage-dependent
+   * events if the supply voltage changed since the last update.
+   */
+  void updateEventEnergies();
+
   // ------ States ------
   //! Struct for storing state objects and their module ids
   struct ModuleStateEntry {
     std::shared_ptr<PowerModelStateBase> state;
     const int moduleId;
+    const bool variable;  //! state->isVariable()
     ModuleStateEntry(std::shared_ptr<PowerModelStateBase>&& state_,
                      const int id)
-        : state(std::move(state_)), moduleId(id) {}
+        : state(std::move(state_)),
+          moduleId(id),
+          variable(state->isVariable()) {}
   };
 
   //! Vector for storing state objects and their corresponding module ids. The
@@ -116,18 +177,64 @@ class PowerModelChannel : public virtual PowerModelChannelOutIf,
   //! module. The index is the module id and the value is the state id.
   std::vector<int> m_currentStates;
 
+  //! Static current is kept as an integer number of 1/CURRENT_SCALE A, so
+  //! that the sum is updated incrementally without accumulating rounding
+  //! errors. A scale of 1e15 (fA) keeps int64 sums exact up to ~9.2 kA.
+  static const double CURRENT_SCALE;
+
+  //! Current of each (non-variable) state, scaled by CURRENT_SCALE. The index
+  //! corresponds to state ids.
+  std::vector<int64_t> m_stateCurrents;
+
+  //! Sum of the currents of all modules' current states, except for variable
+  //! states, scaled by CURRENT_SCALE.
+  int64_t m_staticCurrent{0};
+
+  //! Ids of modules whose current state is variable
+  std::vector<int> m_variableStateModules;
+
+  //! Set if any non-variable state is voltage-dependent
+  bool m_hasVoltageDependentStates{false};
+
+  //! Set when m_stateCurrents & m_staticCurrent need recalculating
+  bool m_staticCurrentStale{true};
+
+  /**
+   * @brief recalculateStaticCurrent recalculate m_stateCurrents and
+   * m_staticCurrent at the current supply voltage.
+   */
+  void recalculateStaticCurrent();
+
   // ------ Logging ------
   std::string m_eventlogFileName;
 
+  //! Log file format
+  const LogFormat m_logFormat;
+
   //! Log file timestep
   sc_core::sc_time m_logTimestep;
 
-  //! Keeps log of event counts in the form:
+  //! Keeps log of event counts (csv format) as a flat array of rows:
   //! count0 count1 ... countN TIME0(microseconds)
   //! count0 count1 ... countN TIME1(microseconds)
   //! ...
   //! count0 count1 ... countN TIMEM(microseconds)
-  std::vector<std::vector<int>> m_log;
+  std::vector<int> m_log;
+
+  //! Binary log writer (binary format)
+  std::unique_ptr<EventLogWriter> m_binaryLog;
+
+  //! Sparse log writer (sparse format)
+  std::unique_ptr<SparseEventLogWriter> m_sparseLog;
+
+  //! Set when an event is reported, cleared by the sparse log loop
+  bool m_logDirty{false};
+
+  //! Notified when m_logDirty is set
+  sc_core::sc_event m_logDirtyEvent{"logDirtyEvent"};
+
+  //! Row of the log for the current timestep
+  int *m_crntRow{nullptr};
 
   //! How many log entries to save in memory before dumping to file
   const int m_logDumpThreshold = 100E3;
@@ -137,10 +244,38 @@ class PowerModelChannel : public virtual PowerModelChannelOutIf,
    */
   void dumpEventCsv();
 
+  /**
+   * @brief loggingEnabled check whether the event log is written to file.
+   */
+  bool loggingEnabled() const {
+    return m_eventlogFileName != "none" &&
+           m_logTimestep != sc_core::SC_ZERO_TIME;
+  }
+
+  /**
+   * @brief timeUs time column value for a log row, in microseconds.
+   */
+  static int timeUs(const sc_core::sc_time &t) {
+    return static_cast<int>(t.to_seconds() * 1.0e6);
+  }
+
   /**
    * @brief logLoop systemc thread that records event counts at a specified
    * timestep. The event counts for logging are unaffected reset by the
    * channel's reader.
    */
   void logLoop();
+
+  /**
+   * @brief sparseLogLoop logLoop for the sparse format. Sleeps until an event
+   * is reported, then logs the row of that timestep at its end.
+   */
+  void sparseLogLoop();
+
+  /**
+   * @brief logRow index of the log row at time t.
+   */
+  uint64_t logRow(const sc_core::sc_time &t) const {
+    return t.value() / m_logTimestep.value();
+  }
 };
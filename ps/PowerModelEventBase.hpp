@@ -24,6 +24,12 @@ class PowerModelEventBase {
    */
   virtual double calculateEnergy(double supplyVoltage) const = 0;
 
+  /**
+   * @brief isVoltageDependent whether calculateEnergy depends on the supply
+   * voltage. Energies of voltage-independent events are only calculated once.
+   */
+  virtual bool isVoltageDependent() const { return true; }
+
   /**
    * @brief toString return a one-line string for debug/info print.
    */
@@ -24,6 +24,20 @@ class PowerModelStateBase {
    */
   virtual double calculateCurrent(double supplyVoltage) const = 0;
 
+  /**
+   * @brief isVoltageDependent whether calculateCurrent depends on the supply
+   * voltage.
+   */
+  virtual bool isVoltageDependent() const { return true; }
+
+  /**
+   * @brief isVariable whether the current may change regardless of the supply
+   * voltage (e.g. when replaying a current trace). The current of variable
+   * states is recalculated every time the static current is read, that of
+   * other states only when they are entered or the supply voltage changes.
+   */
+  virtual bool isVariable() const { return true; }
+
   /**
    * @brief toString return a one-line string for debug/info print.
    */
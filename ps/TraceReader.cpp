@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/fmt/fmt.h>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "ps/TraceReader.hpp"
+
+namespace {
+bool endsWith(const std::string &s, const std::string &suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+}  // namespace
+
+TraceReader::TraceReader(const std::string &fileName, const size_t blockSize)
+    : m_isCsv(endsWith(fileName, ".csv")),
+      m_blockSize(blockSize),
+      m_lastTime(-std::numeric_limits<double>::infinity()) {
+  m_file = std::fopen(fileName.c_str(), m_isCsv ? "r" : "rb");
+  if (m_file == nullptr) {
+    throw std::runtime_error(
+        fmt::format("Can't open trace file at {}", fileName));
+  }
+  readBlock();
+  if (m_buffer.empty()) {
+    throw std::runtime_error(fmt::format("Trace file {} is empty", fileName));
+  }
+}
+
+TraceReader::~TraceReader() { std::fclose(m_file); }
+
+double TraceReader::valueAt(const double t) {
+  while (true) {
+    // Read ahead when the next sample is the last one in memory
+    if (m_buffer.size() < 2 && !m_eof) {
+      readBlock();
+    }
+    if (m_buffer.size() < 2 || m_buffer[1].time > t) {
+      return m_buffer[0].value;
+    }
+    m_buffer.pop_front();
+  }
+}
+
+double TraceReader::nextTime() const {
+  return (m_buffer.size() < 2) ? std::numeric_limits<double>::infinity()
+                               : m_buffer[1].time;
+}
+
+void TraceReader::readBlock() {
+  Sample s;
+  for (size_t i = 0; i < m_blockSize; ++i) {
+    if (!readSample(s)) {
+      m_eof = true;
+      return;
+    }
+    if (s.time < m_lastTime) {
+      throw std::runtime_error(fmt::format(
+          "Trace sample at {} s is earlier than the previous sample", s.time));
+    }
+    m_lastTime = s.time;
+    m_buffer.push_back(s);
+  }
+}
+
+bool TraceReader::readSample(Sample &s) {
+  if (!m_isCsv) {
+    double d[2];
+    if (std::fread(d, sizeof(double), 2, m_file) != 2) {
+      return false;
+    }
+    s = {d[0], d[1]};
+    return true;
+  }
+
+  char line[1024];
+  while (std::fgets(line, sizeof(line), m_file) != nullptr) {
+    char *end;
+    s.time = std::strtod(line, &end);
+    if (end == line || *end != ',') {
+      continue;  // Not a sample
+    }
+    char *valueStart = end + 1;
+    s.value = std::strtod(valueStart, &end);
+    if (end != valueStart) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <deque>
+#include <string>
+
+/**
+ * @brief TraceReader Streams a trace of (time, value) samples from file,
+ * holding at most a bounded number of samples in memory, so that arbitrarily
+ * long traces can be replayed.
+ *
+ * Supported formats:
+ *   - csv (file name ending in .csv): one "time,value" sample per line. Lines
+ *     that don't start with a number (e.g. headers) are skipped. Additional
+ *     columns are ignored.
+ *   - binary (any other file name): consecutive pairs of doubles (host byte
+ *     order) holding time and value.
+ * Times are in seconds, and must be non-decreasing.
+ *
+ * The value of the trace is held from one sample to the next (zero-order
+ * hold). Before the first sample, the trace has the value of the first
+ * sample, after the last sample that of the last sample.
+ */
+class TraceReader {
+ public:
+  struct Sample {
+    double time;
+    double value;
+  };
+
+  /**
+   * @brief TraceReader constructor. Opens the trace and reads ahead the first
+   * block of samples.
+   * @param fileName path of the trace file
+   * @param blockSize number of samples read ahead at once. At most
+   * blockSize + 1 samples are held in memory.
+   */
+  TraceReader(const std::string &fileName, const size_t blockSize = 4096);
+
+  //! Destructor. Closes the trace file.
+  ~TraceReader();
+
+  TraceReader(const TraceReader &) = delete;
+  TraceReader &operator=(const TraceReader &) = delete;
+
+  /**
+   * @brief valueAt return the value of the trace at time t. Samples before t
+   * are discarded, so t must not decrease between calls.
+   * @param t time in seconds
+   */
+  double valueAt(const double t);
+
+  /**
+   * @brief nextTime return the time of the first sample after the time of the
+   * last call to valueAt, or infinity if there are no more samples.
+   */
+  double nextTime() const;
+
+  /**
+   * @brief bufferedSamples number of samples currently held in memory.
+   */
+  size_t bufferedSamples() const { return m_buffer.size(); }
+
+ private:
+  std::FILE *m_file{nullptr};
+  const bool m_isCsv;
+  const size_t m_blockSize;
+  std::deque<Sample> m_buffer;  //! m_buffer[0] is the sample being held
+  bool m_eof{false};
+  double m_lastTime;  //! Time of the last sample read from file
+
+  /**
+   * @brief readBlock read up to m_blockSize samples from file.
+   */
+  void readBlock();
+
+  /**
+   * @brief readSample read a single sample from file.
+   * @retval false if the end of the file was reached.
+   */
+  bool readSample(Sample &s);
+};
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <string>
+#include <systemc-ams>
+#include <systemc>
+#include "libs/make_unique.hpp"
+#include "ps/ConstantCurrentState.hpp"
+#include "ps/ConstantEnergyEvent.hpp"
+#include "ps/ExternalCircuitry.hpp"
+#include "ps/PowerModelBridge.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "utilities/Config.hpp"
+
+using namespace sc_core;
+
+static const double CAPACITANCE = 1.0e-3;    // [F]
+static const double INITIAL_VOLTAGE = 3.58;  // [V]
+static const double LOAD_CURRENT = 1.0e-3;   // [A]
+static const double BURST_ENERGY = 10.0e-6;  // [J]
+static const double BURST_PERIOD = 2.0e-3;   // [s]
+
+// Charging from empty
+static const double CHARGE_CAPACITANCE = 10.0e-6;  // [F]
+static const double SUPPLY_CURRENT = 1.0e-3;       // [A]
+
+// Fixed load: constant current, plus a burst of energy every BURST_PERIOD.
+// The bursts make the adaptive timestep fall back to PowerModelTimestep and
+// grow again.
+SC_MODULE(load) {
+ public:
+  PowerModelEventOutPort powerModelPort{"powerModelPort"};
+
+  SC_CTOR(load) { SC_THREAD(process); }
+
+  virtual void end_of_elaboration() override {
+    powerModelPort->registerState(
+        this->name(),
+        std::make_unique<ConstantCurrentState>("on", LOAD_CURRENT));
+    m_burstEventId = powerModelPort->registerEvent(
+        this->name(),
+        std::make_unique<ConstantEnergyEvent>("burst", BURST_ENERGY));
+  }
+
+  void process() {
+    while (true) {
+      wait(sc_time::from_seconds(BURST_PERIOD));
+      powerModelPort->reportEvent(m_burstEventId);
+    }
+  }
+
+ private:
+  int m_burstEventId{-1};
+};
+
+SC_MODULE(dut) {
+ public:
+  // Signals
+  sc_signal<bool> keepAlive{"keepAlive", false};
+  sc_signal<double> vcc{"vcc", 0.0};
+  sc_signal<double> icc{"icc", 0.0};
+  sc_signal_resolved vWarn{"vWarn"};
+  PowerModelChannel powerModelChannel{"powerModelChannel"};
+
+  // Modules
+  ExternalCircuitry ext{"ext"};
+  PowerModelBridge bridge{"bridge"};
+  load ld{"ld"};
+
+  SC_CTOR(dut) {
+    ext.keepAlive.bind(keepAlive);
+    ext.i_out.bind(icc);
+    ext.vcc.bind(vcc);
+    ext.v_warn.bind(vWarn);
+    bridge.i_out.bind(icc);
+    bridge.v_in.bind(vcc);
+    bridge.powerModelPort.bind(powerModelChannel);
+    ld.powerModelPort.bind(powerModelChannel);
+
+    SC_METHOD(recordTurnOn);
+    sensitive << vcc;
+    dont_initialize();
+  }
+
+  void recordTurnOn() {
+    if ((vcc.read() > 0.0) && (onTime == sc_max_time())) {
+      onTime = sc_time_stamp();
+    }
+  }
+
+  sc_time onTime{sc_max_time()};  //! Time at which the load was first on
+
+  /**
+   * @brief energyDrawn energy [J] drawn from the capacitor so far.
+   */
+  double energyDrawn() const {
+    const double v = vcc.read();
+    return 0.5 * CAPACITANCE * (INITIAL_VOLTAGE * INITIAL_VOLTAGE - v * v);
+  }
+};
+
+SC_MODULE(tester) {
+ public:
+  SC_HAS_PROCESS(tester);
+  tester(sc_module_name nm, dut &fixed_, dut &adaptive_, dut &fixedCharge_,
+         dut &adaptiveCharge_)
+      : sc_module(nm),
+        fixed(fixed_),
+        adaptive(adaptive_),
+        fixedCharge(fixedCharge_),
+        adaptiveCharge(adaptiveCharge_) {
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    // Check half-way between two bursts, after 10 of them
+    wait(sc_time::from_seconds(10.5 * BURST_PERIOD));
+
+    // TEST -- The load is powered throughout, in both modes
+    for (dut *d : {&fixed, &adaptive}) {
+      sc_assert(d->vcc.read() > 0.0);
+      sc_assert(d->bridge.getPowerOns() == 1);
+    }
+
+    // TEST -- The load reports the same energy in both modes
+    const double loadEnergy =
+        10 * BURST_ENERGY +
+        LOAD_CURRENT * INITIAL_VOLTAGE * sc_time_stamp().to_seconds();
+    for (dut *d : {&fixed, &adaptive}) {
+      sc_assert(std::abs(d->bridge.getEnergy() - loadEnergy) <
+                0.05 * loadEnergy);
+    }
+
+    // TEST -- The capacitor supplies the same energy in both modes. The load
+    // charge is applied one step late, so allow for one maximum step of the
+    // load current.
+    const double eFixed = fixed.energyDrawn();
+    const double eAdaptive = adaptive.energyDrawn();
+    spdlog::info("Energy drawn: fixed {:.6e} J, adaptive {:.6e} J", eFixed,
+                 eAdaptive);
+    sc_assert(eFixed > 0.9 * loadEnergy);
+    sc_assert(std::abs(eAdaptive - eFixed) < 0.05 * eFixed);
+
+    // TEST -- Charging from empty, the load is switched on at the first
+    // PowerModelTimestep after the voltage exceeds SVSVon, with both timesteps
+    const auto &config = Config::get();
+    const double timestep = config.getDouble("PowerModelTimestep");
+    const double tCross = config.getDouble("SVSVon") * CHARGE_CAPACITANCE /
+                          (SUPPLY_CURRENT - config.getDouble("ext.dc"));
+    wait(sc_time::from_seconds(tCross + 1.0e-3) - sc_time_stamp());
+    for (dut *d : {&fixedCharge, &adaptiveCharge}) {
+      const double tOn = d->onTime.to_seconds();
+      spdlog::info("{}: turned on at {:.6f} ms, threshold at {:.6f} ms",
+                   d->name(), 1e3 * tOn, 1e3 * tCross);
+      sc_assert(tOn > tCross);
+      sc_assert(tOn <= tCross + timestep + 1.0e-9);
+    }
+
+    spdlog::info("AdaptiveTimestep tests PASSED");
+    sc_stop();
+  }
+
+  dut &fixed;
+  dut &adaptive;
+  dut &fixedCharge;
+  dut &adaptiveCharge;
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  auto &config = Config::get();
+  config.parseFile();
+  config.set("PowerSupply", "ConstantCurrentSupply");
+  config.set("SupplyCurrentLimit", "0.0");
+  config.set("CapacitorValue", std::to_string(CAPACITANCE));
+  config.set("CapacitorInitialVoltage", std::to_string(INITIAL_VOLTAGE));
+  config.set("PowerModelTimestep", "10.0e-6");
+  config.set("PowerModelMaxTimestep", "1.0e-3");
+  config.set("PowerModelMaxVoltageStep", "10.0e-3");
+
+  // The mode is picked up when the external circuitry is constructed
+  config.set("AdaptiveTimestep", "False");
+  dut fixed("fixed");
+  config.set("AdaptiveTimestep", "True");
+  dut adaptive("adaptive");
+
+  config.set("SupplyCurrentLimit", std::to_string(SUPPLY_CURRENT));
+  config.set("CapacitorValue", std::to_string(CHARGE_CAPACITANCE));
+  config.set("CapacitorInitialVoltage", "0.0");
+  config.set("AdaptiveTimestep", "False");
+  dut fixedCharge("fixedCharge");
+  config.set("AdaptiveTimestep", "True");
+  dut adaptiveCharge("adaptiveCharge");
+
+  tester t("tester", fixed, adaptive, fixedCharge, adaptiveCharge);
+  sc_start();
+  return false;
+}
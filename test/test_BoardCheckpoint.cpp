@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <string>
+#include <systemc>
+#include "boards/Msp430TestBoard.hpp"
+#include "utilities/Checkpoint.hpp"
+#include "utilities/Config.hpp"
+#include "utilities/Utilities.hpp"
+
+using namespace sc_core;
+
+static const std::string CHECKPOINT_FILE = "/tmp/test_board_checkpoint.bin";
+static const uint32_t PROGRAM_START = 0x4400;
+static const uint32_t COUNTER = 0x1c00;
+static const uint32_t MARKER = 0x1c02;
+static const unsigned PC_REGNUM = 0;
+static const unsigned SR_REGNUM = 2;
+
+// Counts down from 100, incrementing a counter in SRAM and summing the
+// count in r13, then writes a marker and sleeps.
+static const uint16_t PROGRAM[] = {
+    0x403c, 0x0064,          // 0x4400: MOV #100, r12
+    0x5392, 0x1c00,          // 0x4404: ADD #1, &0x1c00
+    0x5c0d,                  // 0x4408: ADD r12, r13
+    0x831c,                  // 0x440a: SUB #1, r12
+    0x23fb,                  // 0x440c: JNZ 0x4404
+    0x40b2, 0xbeef, 0x1c02,  // 0x440e: MOV #0xbeef, &0x1c02
+    0xd032, 0x0010,          // 0x4414: BIS #CPUOFF, SR
+};
+
+static uint16_t read16(Microcontroller &mcu, const uint32_t addr) {
+  uint8_t data[2];
+  sc_assert(mcu.dbgReadMem(data, addr, 2));
+  return Utility::ttohs(Utility::packBytes(data, 2));
+}
+
+static void write16(Microcontroller &mcu, const uint32_t addr,
+                    const uint32_t val) {
+  uint8_t data[2];
+  Utility::unpackBytes(data, Utility::htots(val), 2);
+  sc_assert(mcu.dbgWriteMem(data, addr, 2));
+}
+
+//! Whether the board has run the program to completion
+static bool finished(Microcontroller &mcu) {
+  return read16(mcu, COUNTER) == 100 && read16(mcu, MARKER) == 0xbeef &&
+         mcu.dbgReadReg(12) == 0 && mcu.dbgReadReg(13) == 5050 &&
+         mcu.dbgReadReg(PC_REGNUM) == PROGRAM_START + sizeof(PROGRAM) &&
+         (mcu.dbgReadReg(SR_REGNUM) & 0x0010);  // CPUOFF
+}
+
+//! Load and run the program, saving a checkpoint part-way through
+static void runAndSave() {
+  Msp430TestBoard board("Msp430TestBoard");
+  auto &mcu = board.getMicrocontroller();
+  sc_start(SC_ZERO_TIME);
+  for (unsigned i = 0; i < sizeof(PROGRAM) / sizeof(PROGRAM[0]); i++) {
+    write16(mcu, PROGRAM_START + 2 * i, PROGRAM[i]);
+  }
+  write16(mcu, 0xfffe, PROGRAM_START);  // Reset vector
+  mcu.unstall();
+
+  while (!board.nReset.read()) {
+    sc_start(10, SC_US);
+  }
+  sc_start(40, SC_US);
+  bool saved = false;
+  mcu.setInstructionBoundaryHook([&](const bool powered) {
+    sc_assert(powered);
+    const auto count = read16(mcu, COUNTER);
+    sc_assert(count > 0 && count < 100);  // Part-way through the loop
+    Checkpoint::save(CHECKPOINT_FILE, powered);
+    saved = true;
+  });
+  sc_start(1, SC_MS);
+  sc_assert(saved);
+  sc_assert(finished(mcu));
+}
+
+//! Restore the checkpoint the way main does, and run to completion
+static void restoreAndRun() {
+  Msp430TestBoard board("Msp430TestBoard");
+  auto &mcu = board.getMicrocontroller();
+  Checkpoint checkpoint(CHECKPOINT_FILE);
+  sc_assert(checkpoint.isPowered());
+  checkpoint.restore(/*powerSupply=*/true);
+  sc_start(SC_ZERO_TIME);
+  mcu.setPowerOnHook([&]() { checkpoint.restore(/*powerSupply=*/false); });
+  mcu.unstall();
+
+  // TEST -- The power-on reset doesn't overwrite the restored registers, so
+  // the restored run finishes with the same results as the uninterrupted one
+  sc_start(1, SC_MS);
+  sc_assert(finished(mcu));
+}
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  auto &config = Config::get();
+  config.parseFile();
+  config.set("OutputDirectory", "/tmp");
+  config.set("IdleFastForward", "False");
+  config.set("TemporalDecoupling", "False");
+  config.set("PowerSupply", "ConstantCurrentSupply");
+  config.set("CapacitorInitialVoltage", "3.55");
+
+  // Each board is elaborated in its own process, so that both have the same
+  // hierarchical names
+  const pid_t pid = fork();
+  sc_assert(pid >= 0);
+  if (pid == 0) {
+    runAndSave();
+    std::exit(0);
+  }
+  int status;
+  sc_assert(waitpid(pid, &status, 0) == pid);
+  sc_assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  restoreAndRun();
+  spdlog::info("BoardCheckpoint tests PASSED");
+  return false;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <string>
+#include <systemc>
+#include <tlm>
+#include <utility>
+#include <vector>
+#include "mcu/Bus.hpp"
+#include "mcu/ClockSourceChannel.hpp"
+#include "mcu/DummyPeripheral.hpp"
+#include "mcu/NonvolatileMemory.hpp"
+#include "mcu/VolatileMemory.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "utilities/Config.hpp"
+#include "utilities/Utilities.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(dut) {
+ public:
+  // Signals
+  sc_signal<bool> pwrGood{"pwrGood", false};
+  sc_signal<unsigned> waitStates{"waitStates", 2};
+  tlm_utils::simple_initiator_socket<dut> iSocket{"iSocket"};
+  ClockSourceChannel clk{"clk", sc_time(1, SC_US)};
+  PowerModelChannel powerModelChannel{"powerModelChannel", "/tmp",
+                                      sc_time(1, SC_US)};
+
+  // Modules
+  Bus bus{"bus"};
+  NonvolatileMemory nvm{"nvm", 0x1000, 0x1FFF};
+  VolatileMemory sram{"sram", 0x2000, 0x2FFF};
+  // Two peripherals sharing a page
+  DummyPeripheral periph{"periph", std::vector<unsigned char>(0x20, 0x11),
+                         0x4000, 0x401F};
+  DummyPeripheral periph2{"periph2", std::vector<unsigned char>(0x20, 0x22),
+                          0x4020, 0x403F};
+
+  // Invalidated DMI ranges, as seen by the initiator
+  std::vector<std::pair<sc_dt::uint64, sc_dt::uint64>> invalidated{};
+
+  SC_CTOR(dut) {
+    iSocket.register_invalidate_direct_mem_ptr(this,
+                                               &dut::invalidate_direct_mem_ptr);
+    iSocket.bind(bus.tSocket);
+    bus.bindTarget(nvm);
+    bus.bindTarget(sram);
+    bus.bindTarget(periph);
+    bus.bindTarget(periph2);
+
+    nvm.waitStates.bind(waitStates);
+    for (BusTarget *t :
+         std::vector<BusTarget *>{&nvm, &sram, &periph, &periph2}) {
+      t->pwrOn.bind(pwrGood);
+      t->systemClk.bind(clk);
+      t->powerModelPort.bind(powerModelChannel);
+    }
+  }
+
+  void invalidate_direct_mem_ptr(sc_dt::uint64 start, sc_dt::uint64 end) {
+    invalidated.emplace_back(start, end);
+  }
+};
+
+SC_MODULE(tester) {
+ public:
+  SC_CTOR(tester) { SC_THREAD(runtests); }
+
+  void runtests() {
+    tlm::tlm_dmi dmi;
+
+    // TEST -- DMI is denied while memories are unpowered
+    sc_assert(!getDmi(0x2010, dmi));
+    sc_assert(dmi.get_start_address() == 0x2000);
+    sc_assert(dmi.get_end_address() == 0x2FFF);
+
+    test.pwrGood.write(true);
+    wait(SC_ZERO_TIME);
+    wait(SC_ZERO_TIME);
+    test.invalidated.clear();
+
+    // TEST -- Routing to targets sharing a page
+    sc_assert(read8(0x401F) == 0x11);
+    sc_assert(read8(0x4020) == 0x22);
+    sc_assert(read8(0x4000) == 0x11);
+    sc_assert(read8(0x403F) == 0x22);
+
+    // TEST -- Routing after switching between targets
+    sc_assert(read8(0x2FFF) == 0xAA);
+    sc_assert(read8(0x2000) == 0xAA);
+    sc_assert(read8(0x4001) == 0x11);
+
+    // TEST -- DMI range is translated to bus addresses
+    sc_assert(getDmi(0x2010, dmi));
+    sc_assert(dmi.is_read_write_allowed());
+    sc_assert(dmi.get_start_address() == 0x2000);
+    sc_assert(dmi.get_end_address() == 0x2FFF);
+    sc_assert(dmi.get_read_latency() == test.clk.getPeriod());
+
+    // TEST -- Writes through DMI pointer are visible through b_transport
+    dmi.get_dmi_ptr()[0x10] = 0xab;
+    sc_assert(read8(0x2010) == 0xab);
+
+    // TEST -- NVM DMI latency reflects wait states
+    sc_assert(getDmi(0x1000, dmi));
+    sc_assert(dmi.get_start_address() == 0x1000);
+    sc_assert(dmi.get_end_address() == 0x1FFF);
+    sc_assert(dmi.get_read_latency() == 2 * test.clk.getPeriod());
+
+    // TEST -- Changing wait states invalidates NVM DMI pointers
+    test.waitStates.write(1);
+    wait(SC_ZERO_TIME);
+    wait(SC_ZERO_TIME);
+    sc_assert(test.invalidated.size() == 1);
+    sc_assert(test.invalidated[0].first == 0x1000);
+    sc_assert(test.invalidated[0].second == 0x1FFF);
+    test.invalidated.clear();
+
+    // TEST -- Peripherals deny DMI for their whole range
+    sc_assert(!getDmi(0x4004, dmi));
+    sc_assert(dmi.get_start_address() == 0x4000);
+    sc_assert(dmi.get_end_address() == 0x401F);
+
+    // TEST -- Unmapped addresses are denied for that address only
+    sc_assert(!getDmi(0x3000, dmi));
+    sc_assert(dmi.get_start_address() == 0x3000);
+    sc_assert(dmi.get_end_address() == 0x3000);
+
+    // TEST -- Power loss invalidates DMI pointers to all memories
+    test.pwrGood.write(false);
+    wait(SC_ZERO_TIME);
+    wait(SC_ZERO_TIME);
+    sc_assert(test.invalidated.size() == 2);
+    for (const auto &r : test.invalidated) {
+      sc_assert((r.first == 0x1000 && r.second == 0x1FFF) ||
+                (r.first == 0x2000 && r.second == 0x2FFF));
+    }
+
+    spdlog::info("Tests done.");
+    sc_stop();
+  }
+
+  bool getDmi(const unsigned addr, tlm::tlm_dmi &dmi) {
+    tlm::tlm_generic_payload trans;
+    dmi.init();
+    trans.set_address(addr);
+    trans.set_command(tlm::TLM_READ_COMMAND);
+    return test.iSocket->get_direct_mem_ptr(trans, dmi);
+  }
+
+  uint8_t read8(const unsigned addr) {
+    sc_time delay = SC_ZERO_TIME;
+    tlm::tlm_generic_payload trans;
+    uint8_t data;
+    trans.set_data_ptr(&data);
+    trans.set_data_length(1);
+    trans.set_command(tlm::TLM_READ_COMMAND);
+    trans.set_address(addr);
+    test.iSocket->b_transport(trans, delay);
+    wait(delay);
+    return data;
+  }
+
+  dut test{"dut"};
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  // Parse config file
+  auto &config = Config::get();
+  config.parseFile();
+
+  tester t("tester");
+  sc_start();
+  return false;
+}
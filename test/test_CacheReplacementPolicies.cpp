@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <list>
+#include <random>
+#include <set>
+#include <vector>
+#include "mcu/CacheReplacementPolicies.hpp"
+
+// Tag-level simulation of a cache, returns the number of misses
+template <class Policy>
+unsigned simulate(Policy &policy, const unsigned nSets, const unsigned nWays,
+                  const std::vector<unsigned> &lines) {
+  std::vector<int> tags(nSets * nWays, -1);
+  unsigned misses = 0;
+  for (const auto l : lines) {
+    const unsigned set = l % nSets;
+    const int tag = l / nSets;
+    bool hit = false;
+    for (unsigned way = 0; way < nWays && !hit; way++) {
+      if (tags[set * nWays + way] == tag) {
+        policy.hit(set, way);
+        hit = true;
+      }
+    }
+    if (!hit) {
+      misses++;
+      const unsigned way = policy.miss(set);
+      assert(way < nWays);
+      tags[set * nWays + way] = tag;
+    }
+  }
+  return misses;
+}
+
+// Reference LRU: recency-ordered list of ways per set
+struct ReferenceLru {
+  std::vector<std::list<unsigned>> lru;
+  ReferenceLru(const unsigned nSets, const unsigned nWays) : lru(nSets) {
+    for (auto &l : lru) {
+      for (unsigned i = 0; i < nWays; i++) {
+        l.push_back(i);
+      }
+    }
+  }
+  void hit(const unsigned set, const unsigned way) {
+    lru[set].remove(way);
+    lru[set].push_front(way);
+  }
+  unsigned miss(const unsigned set) {
+    lru[set].push_front(lru[set].back());
+    lru[set].pop_back();
+    return lru[set].front();
+  }
+};
+
+int main() {
+  std::mt19937 rng(1);
+  std::vector<unsigned> lines(20000);
+  for (auto &l : lines) {
+    l = rng() % 300;
+  }
+
+  for (const unsigned nWays : {1u, 2u, 8u, 64u}) {
+    // TEST - LRU evicts exactly like a recency list
+    CacheReplacementLru lru(4, nWays);
+    ReferenceLru ref(4, nWays);
+    assert(simulate(lru, 4, nWays, lines) == simulate(ref, 4, nWays, lines));
+
+    // TEST - Tree-PLRU fills every way of an empty set before evicting
+    CacheReplacementPlru plru(1, nWays);
+    std::set<unsigned> ways;
+    for (unsigned i = 0; i < nWays; i++) {
+      ways.insert(plru.miss(0));
+    }
+    assert(ways.size() == nWays);
+
+    // TEST - All policies return valid ways
+    CacheReplacementRrip rrip(4, nWays);
+    CacheReplacementLfu lfu(4, nWays);
+    CacheReplacementRoundRobin rr(4, nWays);
+    CacheReplacementPseudoRandom rnd(4, nWays);
+    simulate(plru, 1, nWays, lines);
+    simulate(rrip, 4, nWays, lines);
+    simulate(lfu, 4, nWays, lines);
+    simulate(rr, 4, nWays, lines);
+    simulate(rnd, 4, nWays, lines);
+  }
+
+  // TEST - Tree-PLRU is exact LRU for two ways
+  CacheReplacementPlru plru(4, 2);
+  ReferenceLru ref(4, 2);
+  assert(simulate(plru, 4, 2, lines) == simulate(ref, 4, 2, lines));
+
+  // TEST - RRIP: a line that was hit survives a scan of single-use lines
+  CacheReplacementRrip rrip(1, 4);
+  const unsigned hot = rrip.miss(0);
+  rrip.hit(0, hot);
+  for (int i = 0; i < 3; i++) {
+    assert(rrip.miss(0) != hot);
+  }
+
+  // TEST - Reset
+  CacheReplacementLru lru(1, 4);
+  lru.hit(0, 0);
+  lru.reset();
+  assert(lru.miss(0) == 0);
+
+  return 0;
+}
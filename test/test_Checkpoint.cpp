@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <systemc>
+#include <tlm>
+#include <vector>
+#include "mcu/ClockSourceChannel.hpp"
+#include "mcu/GenericMemory.hpp"
+#include "mcu/msp430fr5xx/Msp430Cpu.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "utilities/Checkpoint.hpp"
+#include "utilities/Config.hpp"
+#include "utilities/Utilities.hpp"
+
+extern "C" {
+#include "mcu/msp430fr5xx/device_includes/msp430fr5994.h"
+}
+
+using namespace sc_core;
+
+// Counts down from 100, incrementing a counter in memory and summing the
+// count in r13, then writes a marker and sleeps.
+static const uint16_t PROGRAM[] = {
+    0x403c, 0x0064,          // 0x00: MOV #100, r12
+    0x5392, 0x0100,          // 0x04: ADD #1, &0x0100
+    0x5c0d,                  // 0x08: ADD r12, r13
+    0x831c,                  // 0x0a: SUB #1, r12
+    0x23fb,                  // 0x0c: JNZ 0x04
+    0x40b2, 0xbeef, 0x0102,  // 0x0e: MOV #0xbeef, &0x0102
+    0xd032, 0x0010,          // 0x14: BIS #CPUOFF, SR
+};
+
+SC_MODULE(dut) {
+ public:
+  // Signals
+  sc_signal<bool> nreset{"nreset", false};
+  sc_signal<bool> irq{"irq", false};
+  sc_signal<bool> ira{"ira"};
+  sc_signal<bool> stallCpu{"stallCpu"};
+  sc_signal<unsigned> irqIdx{"irqIdx", 0};  // Only the reset vector
+  sc_signal<bool> iraConnected{"iraConnected"};
+  GenericMemory mem{"mem", 0, 0xFFFF};
+  ClockSourceChannel mclk{"mclk", sc_time(125, SC_NS)};
+  PowerModelChannel powerModelChannel{"powerModelChannel", "/tmp",
+                                      sc_time(1, SC_US)};
+  Msp430Cpu cpu{"cpu"};
+
+  SC_CTOR(dut) {
+    mem.pwrOn.bind(nreset);
+    mem.tSocket.bind(cpu.iSocket);
+    mem.systemClk.bind(mclk);
+    mem.powerModelPort.bind(powerModelChannel);
+    cpu.mclk.bind(mclk);
+    cpu.pwrOn.bind(nreset);
+    cpu.irq.bind(irq);
+    cpu.ira.bind(ira);
+    cpu.irqIdx.bind(irqIdx);
+    cpu.iraConnected.bind(iraConnected);
+    cpu.busStall.bind(stallCpu);
+    cpu.powerModelPort.bind(powerModelChannel);
+
+    SC_METHOD(acknowledge);
+    sensitive << ira.posedge_event();
+    dont_initialize();
+  }
+
+  void acknowledge() { irq.write(false); }
+
+  void load() {
+    for (unsigned i = 0; i < sizeof(PROGRAM) / sizeof(PROGRAM[0]); i++) {
+      write16(2 * i, PROGRAM[i]);
+    }
+  }
+
+  void write16(const uint32_t addr, const uint32_t val) {
+    tlm::tlm_generic_payload trans;
+    unsigned char data[2];
+    trans.set_data_ptr(data);
+    trans.set_data_length(2);
+    trans.set_command(tlm::TLM_WRITE_COMMAND);
+    trans.set_address(addr);
+    Utility::unpackBytes(data, Utility::htots(val), 2);
+    mem.transport_dbg(trans);
+  }
+
+  uint16_t read16(const uint32_t addr) {
+    tlm::tlm_generic_payload trans;
+    unsigned char data[2];
+    trans.set_data_ptr(data);
+    trans.set_data_length(2);
+    trans.set_command(tlm::TLM_READ_COMMAND);
+    trans.set_address(addr);
+    mem.transport_dbg(trans);
+    return Utility::ttohs(Utility::packBytes(data, 2));
+  }
+};
+
+SC_MODULE(tester) {
+ public:
+  SC_HAS_PROCESS(tester);
+  tester(sc_module_name nm, dut &ref_, dut &src_, dut &dst_)
+      : sc_module(nm), ref(ref_), src(src_), dst(dst_) {
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    for (dut *d : {&ref, &src, &dst}) {
+      d->cpu.unstall();
+    }
+    ref.load();
+    src.load();
+    wait(5 * ref.mclk.getPeriod());
+    ref.nreset.write(true);
+    src.nreset.write(true);
+    wait(SC_ZERO_TIME);
+    for (dut *d : {&ref, &src}) {
+      d->cpu.dbg_writeReg(SR_REGNUM, 0x00);  // Clear CPUOFF flag
+    }
+
+    // TEST -- A checkpoint requested part-way through an instruction is
+    // taken at the next instruction boundary
+    const sc_time requestTime(40.3, SC_US);
+    wait(requestTime - sc_time_stamp());
+    bool saved = false;
+    sc_time savedAt;
+    std::vector<uint8_t> cpuState, memState;
+    src.cpu.setInstructionBoundaryHook([&](const bool powered) {
+      sc_assert(powered);
+      CheckpointOut cpuOut, memOut;
+      src.cpu.saveState(cpuOut);
+      src.mem.saveState(memOut);
+      cpuState = cpuOut.data();
+      memState = memOut.data();
+      savedAt = sc_time_stamp();
+      saved = true;
+    });
+    wait(1, SC_US);
+    sc_assert(saved);
+    sc_assert(savedAt >= requestTime);
+    sc_assert(src.cpu.dbg_readReg(12) > 0);  // Still counting
+
+    // TEST -- Restoring the checkpoint into a fresh system and running it to
+    // completion gives the same results as an uninterrupted run. The restore
+    // happens once the power-on reset interrupt has been taken.
+    dst.cpu.setPowerOnHook([&]() {
+      CheckpointIn cpuIn(cpuState), memIn(memState);
+      dst.cpu.restoreState(cpuIn);
+      dst.mem.restoreState(memIn);
+    });
+    dst.nreset.write(true);
+    dst.irq.write(true);  // POR
+    wait(300, SC_US);
+    for (dut *d : {&ref, &src, &dst}) {
+      sc_assert(d->read16(0x0100) == 100);
+      sc_assert(d->read16(0x0102) == 0xbeef);
+      sc_assert(d->cpu.dbg_readReg(12) == 0);
+      sc_assert(d->cpu.dbg_readReg(13) == 5050);
+      sc_assert(d->cpu.dbg_readReg(PC_REGNUM) == 0x18);
+      sc_assert(d->cpu.dbg_readReg(SR_REGNUM) & CPUOFF);
+    }
+
+    spdlog::info("Checkpoint tests PASSED");
+    sc_stop();
+  }
+
+  static const unsigned PC_REGNUM = 0;
+  static const unsigned SR_REGNUM = 2;
+
+  dut &ref;  //! Runs uninterrupted
+  dut &src;  //! Checkpoint is taken from this one
+  dut &dst;  //! ... and restored into this one
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  auto &config = Config::get();
+  config.parseFile();
+  config.set("IdleFastForward", "False");
+  config.set("TemporalDecoupling", "False");
+
+  dut ref("ref");
+  dut src("src");
+  dut dst("dst");
+
+  tester t("tester", ref, src, dst);
+  sc_start();
+  return false;
+}
@@ -23,22 +23,30 @@ SC_MODULE(dut) {
     SC_METHOD(countPeriodChanges);
     sensitive << m_dut.periodChangedEvent();
     dont_initialize();
+
+    SC_METHOD(countNoEdgeEvents);
+    sensitive << m_noEdges << m_noEdges.periodChangedEvent();
+    dont_initialize();
   }
 
   // Count clock edges
   void countClockEdges() { m_edgeCount++; }
   void countPeriodChanges() { m_periodChangeCount++; }
+  void countNoEdgeEvents() { m_noEdgesEventCount++; }
 
   // Reset counters
   void reset() {
     m_edgeCount = 0;
     m_periodChangeCount = 0;
+    m_noEdgesEventCount = 0;
   }
 
   ClockSourceChannel m_dut{"clockSource"};
+  ClockSourceChannel m_noEdges{"noEdges", SC_ZERO_TIME, false};
 
   int m_edgeCount{0};
   int m_periodChangeCount{0};
+  int m_noEdgesEventCount{0};
 };
 
 SC_MODULE(tester) {
@@ -82,6 +90,13 @@ SC_MODULE(tester) {
     sc_assert(test.m_edgeCount == 2 + 1);
     sc_assert(test.m_periodChangeCount == 2);
 
+    // TEST 4 Without edge events, only period changes are notified
+    test.reset();
+    test.m_noEdges.setPeriod(basePeriod);
+    wait(3 * basePeriod);
+    sc_assert(test.m_noEdges.getPeriod() == basePeriod);
+    sc_assert(test.m_noEdgesEventCount == 1);
+
     sc_stop();
   }
 
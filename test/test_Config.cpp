@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <systemc>
+#include "utilities/Config.hpp"
+
+using namespace sc_core;
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  // TEST -- Values are parsed into every type they can represent
+  Config::Value v("8");
+  sc_assert(v.is(Config::Type::UINT) && v.asUint() == 8);
+  sc_assert(v.is(Config::Type::DOUBLE) && v.asDouble() == 8.0);
+  sc_assert(!v.is(Config::Type::BOOL));
+  v = Config::Value("4.7e-6");
+  sc_assert(!v.is(Config::Type::UINT) && v.asDouble() == 4.7e-6);
+  v = Config::Value("-1");
+  sc_assert(!v.is(Config::Type::UINT) && v.asDouble() == -1.0);
+  v = Config::Value("True");
+  sc_assert(v.asBool() && !v.is(Config::Type::DOUBLE));
+  bool threw = false;
+  try {
+    v.asDouble();
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  sc_assert(threw);
+
+  // TEST -- CLI options and -P overrides take precedence over the yaml file
+  const std::string configFile = "/tmp/test_config.yaml";
+  {
+    std::ofstream f(configFile);
+    f << "SVSVon: 3.5\n";
+    f << "SVSVoff: 3.4\n";
+    f << "Board: Cm0TestBoard\n";
+    f << "tester.dut.CacheNSets: 4\n";
+    f << "tester.mcu sram read: 4.0e-10\n";
+  }
+  char *args[] = {const_cast<char *>("fused"), const_cast<char *>("-B"),
+                  const_cast<char *>("Msp430TestBoard"),
+                  const_cast<char *>("-P"), const_cast<char *>("SVSVon=3.2"),
+                  const_cast<char *>("-P"),
+                  const_cast<char *>("tester.mcu sram write=1.0e-9")};
+  auto &config = Config::get();
+  config.parseCli(sizeof(args) / sizeof(args[0]), args);
+  config.parseFile(configFile);
+  sc_assert(config.getString("Board") == "Msp430TestBoard");
+  sc_assert(config.getDouble("SVSVon") == 3.2);
+  sc_assert(config.getDouble("SVSVoff") == 3.4);
+  sc_assert(config.getUint("tester.dut.CacheNSets") == 4);
+  sc_assert(config.getDouble("tester.mcu sram read") == 4.0e-10);
+  sc_assert(config.getDouble("tester.mcu sram write") == 1.0e-9);
+  sc_assert(config.getDouble("tester.mcu sram idle", 0.0) == 0.0);
+
+  // TEST -- Handles reflect later overrides
+  const auto *handle = config.find("SVSVoff");
+  sc_assert(handle != nullptr && handle->asDouble() == 3.4);
+  config.set("SVSVoff", "3.0");
+  sc_assert(handle->asDouble() == 3.0);
+  sc_assert(config.find("NotAKey") == nullptr);
+
+  // TEST -- Overrides are type-checked against the schema
+  threw = false;
+  try {
+    config.set("SVSVoff", "high");
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  sc_assert(threw && handle->asDouble() == 3.0);
+  threw = false;
+  try {
+    config.set("tester.dut.CacheNSets", "4.5");
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  sc_assert(threw);
+  config.set("TraceStopTime", "none");  // Optional values may be none
+
+  return 0;
+}
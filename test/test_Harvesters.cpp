@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <systemc>
+#include "ps/Harvesters.hpp"
+#include "ps/TraceReader.hpp"
+
+using namespace sc_core;
+
+namespace {
+bool near(const double a, const double b) {
+  return std::abs(a - b) <= 1e-9 * std::max(std::abs(a), std::abs(b));
+}
+
+void writeCsvTrace(const std::string &fileName) {
+  std::FILE *f = std::fopen(fileName.c_str(), "w");
+  std::fprintf(f, "time,current\n");
+  for (int k = 0; k < 10; ++k) {
+    std::fprintf(f, "%f,%f\n", 1.0 * k, 10.0 * k);
+  }
+  std::fclose(f);
+}
+}  // namespace
+
+void testTraceReader() {
+  // TEST -- csv trace is held between samples, and streamed in blocks
+  const std::string csvFile = "/tmp/test_harvesters_trace.csv";
+  writeCsvTrace(csvFile);
+  TraceReader csv(csvFile, 2);
+  sc_assert(csv.bufferedSamples() == 2);
+  sc_assert(csv.valueAt(-1.0) == 0.0);
+  sc_assert(csv.nextTime() == 1.0);
+  sc_assert(csv.valueAt(0.5) == 0.0);
+  sc_assert(csv.valueAt(1.0) == 10.0);
+  sc_assert(csv.valueAt(4.5) == 40.0);
+  sc_assert(csv.nextTime() == 5.0);
+  sc_assert(csv.bufferedSamples() <= 3);
+  sc_assert(csv.valueAt(9.0) == 90.0);
+  sc_assert(csv.valueAt(100.0) == 90.0);
+  sc_assert(csv.nextTime() == std::numeric_limits<double>::infinity());
+
+  // TEST -- binary trace
+  const std::string binFile = "/tmp/test_harvesters_trace.bin";
+  std::FILE *f = std::fopen(binFile.c_str(), "wb");
+  const double samples[] = {0.0, 1.5, 2.0, -3.0};
+  std::fwrite(samples, sizeof(double), 4, f);
+  std::fclose(f);
+  TraceReader bin(binFile);
+  sc_assert(bin.valueAt(1.0) == 1.5);
+  sc_assert(bin.valueAt(2.0) == -3.0);
+
+  std::remove(csvFile.c_str());
+  std::remove(binFile.c_str());
+}
+
+void testHarvesters() {
+  // TEST -- Constant current source switches off near the voltage limit
+  ConstantCurrentHarvester cc(1.0e-3, 3.0, 0.1);
+  sc_assert(cc.current(2.8, 0.0) == 1.0e-3);
+  sc_assert(cc.current(2.95, 0.0) == 0.0);
+  sc_assert(!cc.isVoltageDependent());
+
+  // TEST -- Current trace
+  const std::string csvFile = "/tmp/test_harvesters_trace.csv";
+  writeCsvTrace(csvFile);
+  TraceHarvester ct(csvFile, TraceHarvester::TraceType::CURRENT, 1.0);
+  sc_assert(ct.current(0.0, 2.5) == 20.0);
+  sc_assert(ct.nextChange() == 3.0);
+  sc_assert(!ct.isVoltageDependent());
+
+  // TEST -- Voltage trace through a series resistance and diode
+  TraceHarvester vt(csvFile, TraceHarvester::TraceType::VOLTAGE, 10.0);
+  sc_assert(vt.current(5.0, 2.5) == 1.5);
+  sc_assert(vt.current(25.0, 2.5) == 0.0);
+  std::remove(csvFile.c_str());
+
+  // TEST -- PV cell delivers Isc at 0V, and nothing at Voc
+  PvCellHarvester pv(5.0e-3, 4.0, 0.2);
+  sc_assert(near(pv.current(0.0, 0.0), 5.0e-3));
+  sc_assert(std::abs(pv.current(4.0, 0.0)) < 1e-15);
+  sc_assert(pv.current(4.5, 0.0) == 0.0);
+  sc_assert(pv.current(2.0, 0.0) > pv.current(3.5, 0.0));
+
+  // TEST -- RF harvester delivers efficiency * input power into matched load
+  RfHarvester rf(0.0, 0.5, 4.0);  // 1mW
+  sc_assert(near(2.0 * rf.current(2.0, 0.0), 0.5e-3));
+  sc_assert(rf.current(4.0, 0.0) == 0.0);
+}
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  testTraceReader();
+  testHarvesters();
+  spdlog::info("Tests done.");
+  return false;
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <string>
+#include <systemc>
+#include <tlm>
+#include "mcu/ClockSourceChannel.hpp"
+#include "mcu/GenericMemory.hpp"
+#include "mcu/msp430fr5xx/Msp430Cpu.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "utilities/Config.hpp"
+#include "utilities/Utilities.hpp"
+
+extern "C" {
+#include "mcu/msp430fr5xx/device_includes/msp430fr5994.h"
+}
+
+using namespace sc_core;
+
+// Sleeps with interrupts enabled. The interrupt handler wakes the CPU, which
+// writes a marker and goes back to sleep.
+static const uint16_t PROGRAM[] = {
+    0x4031, 0x1000,          // 0x00: MOV #0x1000, SP
+    0xd032, 0x0018,          // 0x04: BIS #(GIE | CPUOFF), SR
+    0x40b2, 0xbeef, 0x0102,  // 0x08: MOV #0xbeef, &0x0102
+    0xd032, 0x0010,          // 0x0e: BIS #CPUOFF, SR
+};
+static const uint16_t ISR_ADDR = 0x20;
+static const uint16_t ISR[] = {
+    0xc0b1, 0x0010, 0x0000,  // 0x20: BIC #CPUOFF, 0(SP)
+    0x1300,                  // 0x26: RETI
+};
+static const unsigned IRQ_IDX = 1;
+
+SC_MODULE(dut) {
+ public:
+  // Signals
+  sc_signal<bool> nreset{"nreset", false};
+  sc_signal<bool> irq{"irq", false};
+  sc_signal<bool> ira{"ira"};
+  sc_signal<bool> stallCpu{"stallCpu"};
+  sc_signal<unsigned> irqIdx{"irqIdx", IRQ_IDX};
+  sc_signal<bool> iraConnected{"iraConnected"};
+  GenericMemory mem{"mem", 0, 0xFFFF};
+  ClockSourceChannel mclk{"mclk", sc_time(125, SC_NS)};
+  PowerModelChannel powerModelChannel{"powerModelChannel", "/tmp",
+                                      sc_time(1, SC_US)};
+  Msp430Cpu cpu{"cpu"};
+
+  sc_time iraTime{SC_ZERO_TIME};  //! Time at which the irq was accepted
+
+  SC_CTOR(dut) {
+    mem.pwrOn.bind(nreset);
+    mem.tSocket.bind(cpu.iSocket);
+    mem.systemClk.bind(mclk);
+    mem.powerModelPort.bind(powerModelChannel);
+    cpu.mclk.bind(mclk);
+    cpu.pwrOn.bind(nreset);
+    cpu.irq.bind(irq);
+    cpu.ira.bind(ira);
+    cpu.irqIdx.bind(irqIdx);
+    cpu.iraConnected.bind(iraConnected);
+    cpu.busStall.bind(stallCpu);
+    cpu.powerModelPort.bind(powerModelChannel);
+
+    SC_METHOD(acknowledge);
+    sensitive << ira.posedge_event();
+    dont_initialize();
+  }
+
+  void acknowledge() {
+    iraTime = sc_time_stamp();
+    irq.write(false);
+  }
+
+  void load() {
+    for (unsigned i = 0; i < sizeof(PROGRAM) / sizeof(PROGRAM[0]); i++) {
+      write16(2 * i, PROGRAM[i]);
+    }
+    for (unsigned i = 0; i < sizeof(ISR) / sizeof(ISR[0]); i++) {
+      write16(ISR_ADDR + 2 * i, ISR[i]);
+    }
+    write16(0xfffe - 2 * IRQ_IDX, ISR_ADDR);
+  }
+
+  void write16(const uint32_t addr, const uint32_t val) {
+    tlm::tlm_generic_payload trans;
+    unsigned char data[2];
+    trans.set_data_ptr(data);
+    trans.set_data_length(2);
+    trans.set_command(tlm::TLM_WRITE_COMMAND);
+    trans.set_address(addr);
+    Utility::unpackBytes(data, Utility::htots(val), 2);
+    mem.transport_dbg(trans);
+  }
+
+  uint16_t read16(const uint32_t addr) {
+    tlm::tlm_generic_payload trans;
+    unsigned char data[2];
+    trans.set_data_ptr(data);
+    trans.set_data_length(2);
+    trans.set_command(tlm::TLM_READ_COMMAND);
+    trans.set_address(addr);
+    mem.transport_dbg(trans);
+    return Utility::ttohs(Utility::packBytes(data, 2));
+  }
+};
+
+SC_MODULE(tester) {
+ public:
+  SC_HAS_PROCESS(tester);
+  tester(sc_module_name nm, dut &step_, dut &ff_)
+      : sc_module(nm), step(step_), ff(ff_) {
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    for (dut *d : {&step, &ff}) {
+      d->cpu.unstall();
+      d->load();
+    }
+    wait(5 * step.mclk.getPeriod());
+    step.nreset.write(true);
+    ff.nreset.write(true);
+    wait(SC_ZERO_TIME);
+    for (dut *d : {&step, &ff}) {
+      d->cpu.dbg_writeReg(SR_REGNUM, 0x00);  // Clear CPUOFF flag
+      d->powerModelChannel.popDynamicEnergy();
+    }
+
+    // TEST -- Both CPUs sleep in the same state
+    wait(20, SC_US);
+    for (dut *d : {&step, &ff}) {
+      sc_assert(d->cpu.dbg_readReg(SR_REGNUM) & CPUOFF);
+      sc_assert(d->cpu.dbg_readReg(PC_REGNUM) == 0x08);
+    }
+    sc_assert(step.powerModelChannel.getStaticCurrent() ==
+              ff.powerModelChannel.getStaticCurrent());
+
+    // TEST -- An interrupt between two clock edges wakes both CPUs on the
+    // same cycle
+    wait(sc_time(37.3, SC_US) - sc_time_stamp());
+    step.irq.write(true);
+    ff.irq.write(true);
+    wait(100, SC_US);
+    sc_assert(step.iraTime > SC_ZERO_TIME);
+    sc_assert(step.iraTime == ff.iraTime);
+    for (dut *d : {&step, &ff}) {
+      sc_assert(d->read16(0x0102) == 0xbeef);
+      sc_assert(d->cpu.dbg_readReg(SR_REGNUM) & CPUOFF);
+      sc_assert(d->cpu.dbg_readReg(PC_REGNUM) == 0x12);
+    }
+    sc_assert(step.powerModelChannel.getStaticCurrent() ==
+              ff.powerModelChannel.getStaticCurrent());
+
+    // TEST -- ... and the idle interval costs the same energy
+    const double energy = step.powerModelChannel.popDynamicEnergy();
+    sc_assert(energy > 0.0);
+    sc_assert(ff.powerModelChannel.popDynamicEnergy() == energy);
+
+    spdlog::info("IdleFastForward tests PASSED");
+    sc_stop();
+  }
+
+  static const unsigned PC_REGNUM = 0;
+  static const unsigned SR_REGNUM = 2;
+
+  dut &step;  //! Steps through every idle cycle
+  dut &ff;    //! Fast-forwards through idle intervals
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  auto &config = Config::get();
+  config.parseFile();
+  for (const std::string cpu : {"step.cpu", "ff.cpu"}) {
+    config.set(cpu + " formatI", "1.0");
+    config.set(cpu + " formatII", "10.0");
+    config.set(cpu + " formatIII", "100.0");
+    config.set(cpu + " irq", "1000.0");
+    config.set(cpu + " idle cycles", "1.0e6");
+    config.set(cpu + " on", "1.0e-3");
+    config.set(cpu + " sleep", "1.0e-6");
+  }
+
+  // The mode is picked up when each CPU is constructed
+  config.set("IdleFastForward", "False");
+  dut step("step");
+  config.set("IdleFastForward", "True");
+  dut ff("ff");
+
+  tester t("tester", step, ff);
+  sc_start();
+  return false;
+}
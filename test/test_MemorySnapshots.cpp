@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <functional>
+#include <stdexcept>
+#include <systemc>
+#include <tlm>
+#include <vector>
+#include "mcu/ClockSourceChannel.hpp"
+#include "mcu/GenericMemory.hpp"
+#include "mcu/Microcontroller.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "utilities/Config.hpp"
+
+using namespace sc_core;
+
+static const size_t PAGE = GenericMemory::SNAPSHOT_PAGE_SIZE;
+
+// Microcontroller without a CPU, holding two memories with separate power
+// supplies
+class TestMcu : public Microcontroller {
+ public:
+  sc_signal<bool> pwrOn{"pwrOn", true};
+  sc_signal<bool> pwrOn2{"pwrOn2", true};
+  ClockSourceChannel clk{"clk", sc_time(1, SC_US)};
+  GenericMemory mem{"mem", 0, 4 * PAGE - 1};
+  GenericMemory mem2{"mem2", 0, PAGE - 1};
+
+  explicit TestMcu(sc_module_name nm) : Microcontroller(nm) {
+    mem.pwrOn.bind(pwrOn);
+    mem2.pwrOn.bind(pwrOn2);
+    for (GenericMemory *m : {&mem, &mem2}) {
+      m->systemClk.bind(clk);
+      m->powerModelPort.bind(powerModelPort);
+    }
+  }
+
+  virtual void stall(void) override {}
+  virtual void unstall(void) override {}
+  virtual bool isStalled(void) override { return true; }
+  virtual void step(void) override {}
+  virtual void reset() override {}
+  virtual void setPowerOnHook(std::function<void()> hook) override {}
+  virtual void setInstructionBoundaryHook(
+      std::function<void(bool powered)> hook) override {}
+  virtual uint32_t dbgReadReg(size_t addr) override { return 0; }
+  virtual void dbgWriteReg(size_t addr, uint32_t val) override {}
+  virtual bool dbgReadMem(uint8_t *out, size_t addr, size_t len) override {
+    return false;
+  }
+  virtual bool dbgWriteMem(uint8_t *src, size_t addr, size_t len) override {
+    return false;
+  }
+  virtual void insertBreakpoint(unsigned addr) override {}
+  virtual void removeBreakpoint(unsigned addr) override {}
+  virtual uint32_t pc_regnum() override { return 0; }
+  virtual uint32_t n_regs() override { return 0; }
+};
+
+SC_MODULE(dut) {
+ public:
+  // Signals
+  sc_signal<bool> nReset{"nReset", false};
+  sc_signal<double> vcc{"vcc", 0.0};
+  PowerModelChannel powerModelChannel{"powerModelChannel", "/tmp",
+                                      sc_time(1, SC_US)};
+
+  // Modules
+  TestMcu mcu{"mcu"};
+
+  SC_CTOR(dut) {
+    mcu.nReset.bind(nReset);
+    mcu.vcc.bind(vcc);
+    mcu.powerModelPort.bind(powerModelChannel);
+  }
+
+  //! Fill [addr, addr + len) of m with val
+  void fill(GenericMemory &m, const size_t addr, const size_t len,
+            uint8_t val) {
+    std::vector<uint8_t> data(len, val);
+    tlm::tlm_generic_payload trans;
+    trans.set_data_ptr(data.data());
+    trans.set_data_length(len);
+    trans.set_command(tlm::TLM_WRITE_COMMAND);
+    trans.set_address(addr);
+    m.transport_dbg(trans);
+  }
+
+  //! Whether [addr, addr + len) of m holds val
+  bool holds(GenericMemory &m, const size_t addr, const size_t len,
+             uint8_t val) {
+    std::vector<uint8_t> data(len);
+    tlm::tlm_generic_payload trans;
+    trans.set_data_ptr(data.data());
+    trans.set_data_length(len);
+    trans.set_command(tlm::TLM_READ_COMMAND);
+    trans.set_address(addr);
+    m.transport_dbg(trans);
+    for (const auto d : data) {
+      if (d != val) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+SC_MODULE(tester) {
+ public:
+  SC_CTOR(tester) { SC_THREAD(runtests); }
+
+  void runtests() {
+    wait(SC_ZERO_TIME);
+    auto &mcu = test.mcu;
+    auto &mem = mcu.mem;
+
+    // TEST -- Write, snapshot, write, rewind restores the first write
+    test.fill(mem, 0, 4 * PAGE, 0x11);
+    sc_assert(mcu.takeSnapshot() == 0);
+    test.fill(mem, PAGE - 2, 4, 0x22);  // Across a page boundary
+    sc_assert(mcu.takeSnapshot() == 1);
+    test.fill(mem, 3 * PAGE, PAGE, 0x33);
+    mcu.rewind(0);
+    sc_assert(test.holds(mem, 0, 4 * PAGE, 0x11));
+
+    // TEST -- ... and rewinding forward restores the later snapshot
+    mcu.rewind(1);
+    sc_assert(test.holds(mem, 0, PAGE - 2, 0x11));
+    sc_assert(test.holds(mem, PAGE - 2, 4, 0x22));
+    sc_assert(test.holds(mem, PAGE + 2, 3 * PAGE - 2, 0x11));
+
+    // TEST -- Snapshots taken after a rewind are based on the rewound
+    // snapshot, and the snapshots on the other branch are kept
+    mcu.rewind(0);
+    test.fill(mem, 2 * PAGE, PAGE, 0x44);
+    sc_assert(mcu.takeSnapshot() == 2);
+    test.fill(mem, 2 * PAGE, 1, 0x55);  // Not in any snapshot
+    mcu.rewind(1);
+    sc_assert(test.holds(mem, PAGE - 2, 4, 0x22));
+    sc_assert(test.holds(mem, 2 * PAGE, PAGE, 0x11));
+    mcu.rewind(2);
+    sc_assert(test.holds(mem, 0, 2 * PAGE, 0x11));
+    sc_assert(test.holds(mem, 2 * PAGE, PAGE, 0x44));
+    sc_assert(test.holds(mem, 3 * PAGE, PAGE, 0x11));
+
+    // TEST -- Nested snapshots rewind to the innermost state
+    test.fill(mem, 0, 1, 0x66);
+    sc_assert(mcu.takeSnapshot() == 3);
+    test.fill(mem, 0, 1, 0x77);
+    mcu.rewind(3);
+    sc_assert(test.holds(mem, 0, 1, 0x66));
+    sc_assert(test.holds(mem, 2 * PAGE, PAGE, 0x44));
+    mcu.rewind(0);
+    sc_assert(test.holds(mem, 0, 4 * PAGE, 0x11));
+    sc_assert(mcu.nSnapshots() == 4);
+
+    // TEST -- In a long chain of snapshots holding a single page each, the
+    // other pages are looked up in the first snapshot
+    for (int i = 0; i < 100; ++i) {
+      test.fill(mem, PAGE, 1, i);
+      mcu.takeSnapshot();
+    }
+    mcu.rewind(50);
+    sc_assert(test.holds(mem, PAGE, 1, 46));
+    sc_assert(test.holds(mem, 3 * PAGE, PAGE, 0x11));
+
+    // TEST -- Memories with a different number of snapshots can't be rewound
+    mcu.pwrOn2.write(false);  // Takes a power failure snapshot of mem2
+    wait(1, SC_NS);
+    sc_assert(mcu.mem2.nSnapshots() == mem.nSnapshots() + 1);
+    bool threw = false;
+    try {
+      mcu.rewind(0);
+    } catch (const std::logic_error &) {
+      threw = true;
+    }
+    sc_assert(threw);
+
+    spdlog::info("MemorySnapshots tests PASSED");
+    sc_stop();
+  }
+
+  dut test{"dut"};
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  auto &config = Config::get();
+  config.parseFile();
+  config.set("MemorySnapshots", "True");
+
+  tester t("tester");
+  sc_start();
+  return false;
+}
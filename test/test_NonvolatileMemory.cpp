@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <random>
+#include <systemc>
+#include <tlm>
+#include <vector>
+#include "mcu/ClockSourceChannel.hpp"
+#include "mcu/NonvolatileMemory.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "utilities/Config.hpp"
+#include "utilities/Utilities.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(dut) {
+ public:
+  // Signals
+  sc_signal<bool> pwrGood{"pwrGood", false};
+  sc_signal<unsigned> waitStates{"waitStates", 1};
+  tlm_utils::simple_initiator_socket<dut> iSocket{"iSocket"};
+  tlm_utils::simple_initiator_socket<dut> iSocket2{"iSocket2"};
+  ClockSourceChannel clk{"clk", sc_time(1, SC_US)};
+  PowerModelChannel powerModelChannel{"powerModelChannel", "/tmp",
+                                      sc_time(1, SC_US)};
+
+  // Modules
+  NonvolatileMemory nvm{"nvm", 0x1000, 0x1FFF};
+  NonvolatileMemory nvm2{"nvm2", 0x2000, 0x2FFF};
+
+  SC_CTOR(dut) {
+    iSocket.bind(nvm.tSocket);
+    iSocket2.bind(nvm2.tSocket);
+    for (NonvolatileMemory *m : {&nvm, &nvm2}) {
+      m->waitStates.bind(waitStates);
+      m->pwrOn.bind(pwrGood);
+      m->systemClk.bind(clk);
+      m->powerModelPort.bind(powerModelChannel);
+    }
+  }
+};
+
+SC_MODULE(tester) {
+ public:
+  SC_CTOR(tester) { SC_THREAD(runtests); }
+
+  void runtests() {
+    test.pwrGood.write(true);
+    wait(SC_ZERO_TIME);
+    test.powerModelChannel.popDynamicEnergy();
+
+    // TEST -- Bit-flip model charges bits that change value
+    write(test.iSocket, 0, {0xff, 0xff, 0xff, 0xff});
+    sc_assert(test.powerModelChannel.popDynamicEnergy() == 32.0);
+    write(test.iSocket, 0, {0x0f, 0x0f, 0x0f, 0x0f});
+    sc_assert(test.powerModelChannel.popDynamicEnergy() == 16.0);
+    write(test.iSocket, 0, {0x0f, 0x0f, 0x0f, 0x0f});
+    sc_assert(test.powerModelChannel.popDynamicEnergy() == 0.0);
+
+    // TEST -- Wear counters count writes to each page touched
+    write(test.iSocket, 14, {0x01, 0x02, 0x03, 0x04});
+    const auto &wear = test.nvm.wearCounters();
+    sc_assert(wear.size() == 0x1000 / 16);
+    sc_assert(wear[0] == 4 && wear[1] == 1 && wear[2] == 0);
+    test.powerModelChannel.popDynamicEnergy();
+
+    // TEST -- Line model charges every line touched
+    write(test.iSocket2, 6, {0x01, 0x02, 0x03, 0x04});
+    sc_assert(test.powerModelChannel.popDynamicEnergy() == 2 * 100.0);
+    write(test.iSocket2, 8, {0x01, 0x02, 0x03, 0x04});
+    sc_assert(test.powerModelChannel.popDynamicEnergy() == 100.0);
+    sc_assert(test.nvm2.wearCounters().empty());
+
+    // TEST -- Only read DMI is granted, so that writes can be counted
+    tlm::tlm_generic_payload trans;
+    tlm::tlm_dmi dmi;
+    trans.set_address(0);
+    trans.set_command(tlm::TLM_READ_COMMAND);
+    sc_assert(test.iSocket->get_direct_mem_ptr(trans, dmi));
+    sc_assert(dmi.is_read_allowed() && !dmi.is_write_allowed());
+
+    spdlog::info("Tests done.");
+    sc_stop();
+  }
+
+  void write(tlm_utils::simple_initiator_socket<dut> &socket,
+             const unsigned addr, std::vector<uint8_t> data) {
+    sc_time delay = SC_ZERO_TIME;
+    tlm::tlm_generic_payload trans;
+    trans.set_data_ptr(data.data());
+    trans.set_data_length(data.size());
+    trans.set_command(tlm::TLM_WRITE_COMMAND);
+    trans.set_address(addr);
+    socket->b_transport(trans, delay);
+    wait(delay);
+  }
+
+  dut test{"dut"};
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  // TEST -- Popcount kernels match a bit-by-bit count for all lengths and
+  // alignments
+  std::mt19937 rng(1);
+  std::vector<uint8_t> a(64), b(64);
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = rng();
+    b[i] = rng();
+  }
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t len = 0; len + offset <= a.size(); len++) {
+      unsigned setBits = 0;
+      unsigned flips = 0;
+      for (size_t i = offset; i < offset + len; i++) {
+        for (int bit = 0; bit < 8; bit++) {
+          setBits += (a[i] >> bit) & 1;
+          flips += ((a[i] ^ b[i]) >> bit) & 1;
+        }
+      }
+      sc_assert(Utility::countSetBits(&a[offset], len) == setBits);
+      sc_assert(Utility::countBitFlips(&a[offset], &b[offset], len) == flips);
+    }
+  }
+
+  // Parse config file
+  auto &config = Config::get();
+  config.parseFile();
+  config.set("tester.dut.nvm.NvmWriteEnergyModel", "BitFlips");
+  config.set("tester.dut.nvm.NvmWearPageSize", "16");
+  config.set("tester.dut.nvm bits flipped", "1.0");
+  config.set("tester.dut.nvm2.NvmWriteEnergyModel", "Lines");
+  config.set("tester.dut.nvm2.NvmWriteLineWidth", "8");
+  config.set("tester.dut.nvm2 lines written", "100.0");
+
+  tester t("tester");
+  sc_start();
+  return false;
+}
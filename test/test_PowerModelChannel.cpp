@@ -6,17 +6,42 @@
  */
 
 #include <spdlog/spdlog.h>
+#include <cstdio>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <systemc>
 #include "libs/make_unique.hpp"
 #include "ps/ConstantCurrentState.hpp"
 #include "ps/ConstantEnergyEvent.hpp"
+#include "ps/EventLogWriter.hpp"
 #include "ps/PowerModelChannel.hpp"
 #include "ps/PowerModelChannelIf.hpp"
 
 using namespace sc_core;
 
+//! Event with energy proportional to supply voltage
+class LinearEnergyEvent : public PowerModelEventBase {
+ public:
+  LinearEnergyEvent(const std::string name) : PowerModelEventBase(name) {}
+  virtual double calculateEnergy(const double supplyVoltage) const override {
+    return supplyVoltage * 1.0e-12;
+  }
+  virtual std::string toString() const override { return name; }
+};
+
+//! State with a current that is changed in place (like a current trace)
+class VariableCurrentState : public PowerModelStateBase {
+ public:
+  VariableCurrentState(const std::string name) : PowerModelStateBase(name) {}
+  virtual double calculateCurrent(const double supplyVoltage) const override {
+    return current;
+  }
+  virtual std::string toString() const override { return name; }
+  double current{0.0};
+};
+
 SC_MODULE(dut) {
  public:
   PowerModelEventInPort inport{"inport"};
@@ -44,6 +69,9 @@ SC_MODULE(tester) {
     eid2 = test.outport->registerEvent(
         "module0", std::make_unique<ConstantEnergyEvent>("event2", 2.0e-12));
     sc_assert(eid2 == 1);
+    eid3 = test.outport->registerEvent(
+        "module1", std::make_unique<LinearEnergyEvent>("event3"));
+    sc_assert(eid3 == 2);
 
     spdlog::info(
         "------ TEST: registering the same event twice throws exception");
@@ -71,6 +99,11 @@ SC_MODULE(tester) {
     sid4 = test.outport->registerState(
         "module1", std::make_unique<ConstantCurrentState>("on", 2.0e-6));
     sc_assert(sid4 == 3);
+    sid5 = test.outport->registerState("module2", variableState);
+    sc_assert(sid5 == 4);
+    sid6 = test.outport->registerState(
+        "module1", std::make_unique<ConstantCurrentState>("burst", 10.0));
+    sc_assert(sid6 == 5);
 
     spdlog::info(
         "------ TEST: registering the same state for the same module twice "
@@ -123,6 +156,15 @@ SC_MODULE(tester) {
     spdlog::info("------ TEST: Multi-channel event energy resets after pop");
     sc_assert(test.inport->popDynamicEnergy() == 0.0);
 
+    spdlog::info("------ TEST: Voltage-dependent event energy follows vcc");
+    test.inport->setSupplyVoltage(2.0);
+    test.outport->reportEvent(eid3, 2);
+    sc_assert(test.inport->popEventEnergy(eid3) == 2 * (2.0 * 1.0e-12));
+    test.inport->setSupplyVoltage(3.0);
+    test.outport->reportEvent(eid1, 1);
+    test.outport->reportEvent(eid3, 1);
+    sc_assert(test.inport->popDynamicEnergy() == 1.0e-12 + 3.0 * 1.0e-12);
+
     spdlog::info("------ TEST: Static current sums up");
     test.outport->reportState(sid2);
     test.outport->reportState(sid4);
@@ -131,15 +173,100 @@ SC_MODULE(tester) {
     test.outport->reportState(sid3);
     sc_assert(test.inport->getStaticCurrent() == 0.0);
 
+    spdlog::info("------ TEST: Static current follows variable states");
+    variableState->current = 4.0e-6;
+    sc_assert(test.inport->getStaticCurrent() == 4.0e-6);
+    test.outport->reportState(sid2);
+    sc_assert(test.inport->getStaticCurrent() == 1.0e-6 + 4.0e-6);
+    variableState->current = 0.0;
+    test.outport->reportState(sid1);
+    sc_assert(test.inport->getStaticCurrent() == 0.0);
+
+    spdlog::info("------ TEST: Static current above 9.2 A does not overflow");
+    test.outport->reportState(sid6);
+    sc_assert(test.inport->getStaticCurrent() == 10.0);
+    test.outport->reportState(sid3);
+    sc_assert(test.inport->getStaticCurrent() == 0.0);
+
+    spdlog::info("------ TEST: Binary event log contains header, names & rows");
+    {
+      EventLogWriter w("/tmp/test_eventlog.bin", {"m e1", "m e2"}, 1000000,
+                       /*rowsPerBlock=*/1, /*nBlocks=*/2);
+      w.row()[0] = 3;
+      w.row()[2] = 1;
+      for (int i = 2; i < 6; ++i) {
+        w.nextRow(i);
+        w.row()[1] = i;
+      }
+    }
+    std::FILE *f = std::fopen("/tmp/test_eventlog.bin", "rb");
+    EventLogHeader hdr;
+    sc_assert(std::fread(&hdr, sizeof(hdr), 1, f) == 1);
+    sc_assert(std::memcmp(hdr.magic, EventLogHeader::signature(), 8) == 0);
+    sc_assert(hdr.nColumns == 3);
+    sc_assert(hdr.timestepPs == 1000000);
+    char names[10];
+    sc_assert(hdr.nameTableSize == sizeof(names));
+    sc_assert(std::fread(names, 1, sizeof(names), f) == sizeof(names));
+    sc_assert(std::string(names) == "m e1");
+    sc_assert(std::string(&names[5]) == "m e2");
+    int32_t rows[5][3];
+    sc_assert(std::fread(rows, sizeof(int32_t), 15, f) == 15);
+    sc_assert(std::fgetc(f) == EOF);
+    std::fclose(f);
+    sc_assert(rows[0][0] == 3 && rows[0][1] == 0 && rows[0][2] == 1);
+    for (int i = 1; i < 5; ++i) {
+      sc_assert(rows[i][0] == 0 && rows[i][1] == i + 1 && rows[i][2] == i + 1);
+    }
+
+    spdlog::info("------ TEST: Sparse event log collapses runs of rows");
+    {
+      SparseEventLogWriter w("/tmp/test_eventlog.sparse", {"m e1", "m e2"},
+                             1000000);
+      int32_t r[2] = {0, 0};
+      w.addRow(0, r);  // Empty rows 0..2
+      w.addRow(2, r);
+      r[1] = 7;
+      w.addRow(3, r);  // Identical rows 3..4
+      sc_assert(r[1] == 0);  // Cleared
+      r[1] = 7;
+      w.addRow(4, r);
+      r[0] = 1;
+      w.addRow(5, r);  // Single row
+    }
+    f = std::fopen("/tmp/test_eventlog.sparse", "rb");
+    sc_assert(std::fread(&hdr, sizeof(hdr), 1, f) == 1);
+    sc_assert(hdr.format == EventLogHeader::SPARSE);
+    sc_assert(std::fread(names, 1, sizeof(names), f) == sizeof(names));
+    SparseRecord rec;
+    SparsePair pair;
+    sc_assert(std::fread(&rec, sizeof(rec), 1, f) == 1);
+    sc_assert(rec.firstRow == 0 && rec.repeat == 3 && rec.nPairs == 0);
+    sc_assert(std::fread(&rec, sizeof(rec), 1, f) == 1);
+    sc_assert(rec.firstRow == 3 && rec.repeat == 2 && rec.nPairs == 1);
+    sc_assert(std::fread(&pair, sizeof(pair), 1, f) == 1);
+    sc_assert(pair.eventId == 1 && pair.count == 7);
+    sc_assert(std::fread(&rec, sizeof(rec), 1, f) == 1);
+    sc_assert(rec.firstRow == 5 && rec.repeat == 1 && rec.nPairs == 1);
+    sc_assert(std::fread(&pair, sizeof(pair), 1, f) == 1);
+    sc_assert(pair.eventId == 0 && pair.count == 1);
+    sc_assert(std::fgetc(f) == EOF);
+    std::fclose(f);
+
     sc_stop();
   }
 
   int eid1;
   int eid2;
+  int eid3;
   int sid1;
   int sid2;
   int sid3;
   int sid4;
+  int sid5;
+  int sid6;
+  std::shared_ptr<VariableCurrentState> variableState{
+      std::make_shared<VariableCurrentState>("variable")};
 
   dut test{"dut"};
 };
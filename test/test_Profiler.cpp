@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <elf.h>
+#include <spdlog/spdlog.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <systemc>
+#include <vector>
+#include "utilities/ElfSymbols.hpp"
+#include "utilities/Profiler.hpp"
+
+using namespace sc_core;
+
+/**
+ * @brief writeElf write a minimal ELF file holding only a symbol table with
+ * the given function symbols (name, value, size).
+ */
+void writeElf(const std::string &fileName,
+              const std::vector<std::pair<std::string, Elf32_Sym>> &syms) {
+  std::string strtab(1, '\0');
+  std::vector<Elf32_Sym> symtab(1);  // Null symbol
+  for (const auto &s : syms) {
+    symtab.push_back(s.second);
+    symtab.back().st_name = strtab.size();
+    strtab += s.first + '\0';
+  }
+
+  Elf32_Ehdr ehdr{};
+  std::memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+  ehdr.e_ident[EI_CLASS] = ELFCLASS32;
+  ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+  ehdr.e_shentsize = sizeof(Elf32_Shdr);
+  ehdr.e_shnum = 3;
+  ehdr.e_shoff = sizeof(ehdr);
+
+  Elf32_Shdr shdrs[3]{};
+  shdrs[1].sh_type = SHT_SYMTAB;
+  shdrs[1].sh_offset = sizeof(ehdr) + sizeof(shdrs);
+  shdrs[1].sh_size = symtab.size() * sizeof(Elf32_Sym);
+  shdrs[1].sh_link = 2;
+  shdrs[2].sh_type = SHT_STRTAB;
+  shdrs[2].sh_offset = shdrs[1].sh_offset + shdrs[1].sh_size;
+  shdrs[2].sh_size = strtab.size();
+
+  std::ofstream f(fileName, std::ios::binary);
+  f.write(reinterpret_cast<const char *>(&ehdr), sizeof(ehdr));
+  f.write(reinterpret_cast<const char *>(shdrs), sizeof(shdrs));
+  f.write(reinterpret_cast<const char *>(symtab.data()),
+          symtab.size() * sizeof(Elf32_Sym));
+  f.write(strtab.data(), strtab.size());
+}
+
+Elf32_Sym func(const uint32_t value, const uint32_t size) {
+  Elf32_Sym s{};
+  s.st_value = value;
+  s.st_size = size;
+  s.st_info = ELF32_ST_INFO(STB_GLOBAL, STT_FUNC);
+  return s;
+}
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  const std::string elfFile = "/tmp/test_profiler.elf";
+  writeElf(elfFile, {{"foo", func(0x111, 0x10)},  // Thumb bit set
+                     {"main", func(0x100, 0x10)},
+                     {"alias", func(0x100, 0x10)},
+                     {"isr", func(0x120, 0x8)}});
+
+  // TEST -- Function symbols are sorted, thumb bits and aliases dropped
+  ElfSymbols symbols(elfFile);
+  const auto &fns = symbols.functions();
+  sc_assert(fns.size() == 3);
+  sc_assert(fns[0].name == "main" && fns[0].start == 0x100);
+  sc_assert(fns[1].name == "foo" && fns[1].start == 0x110);
+  sc_assert(fns[1].end == 0x120);
+  sc_assert(symbols.find(0x10e) == 0);
+  sc_assert(symbols.find(0x110) == 1);
+  sc_assert(symbols.find(0x128) == -1);
+  sc_assert(symbols.find(0x0fe) == -1);
+
+  // TEST -- Cycles, sleep time and energy are attributed to PCs & call stacks
+  Profiler p(symbols);
+  *p.energyAccumulator() += 1.0;  // Before power-up: [off]
+  p.instruction(0x100, 0, 10);    // main
+  *p.energyAccumulator() += 2.0e-12;
+  p.instruction(0x102, 20, 10);   // main, 2 cycles at 0x100
+  p.instruction(0x110, 30, 10);   // call foo, 1 cycle at 0x102
+  p.instruction(0x112, 60, 10);   // 3 cycles at 0x110
+  p.sleep(70);                    // 1 cycle at 0x112
+  p.instruction(0x120, 1070, 10);  // isr, 1000 ps sleep at 0x112
+  p.instruction(0x114, 1080, 10);  // return to foo
+  p.instruction(0x104, 1100, 10);  // return to main
+  p.powerOff(1110);
+  p.instruction(0x100, 5000, 10);  // New boot
+
+  sc_assert(p.pcCounters(0x100).instructions == 2);
+  sc_assert(p.pcCounters(0x100).cycles == 2);
+  sc_assert(p.pcCounters(0x100).energy == 2.0e-12);
+  sc_assert(p.pcCounters(0x112).cycles == 1);
+  sc_assert(p.pcCounters(0x112).sleepPs == 1000);
+  sc_assert(p.pcCounters(0x104).cycles == 1);  // Not counted while off
+  const auto foo = p.functionCounters(1);
+  sc_assert(foo.instructions == 3 && foo.cycles == 6 && foo.sleepPs == 1000);
+
+  const auto cycles =
+      p.foldedStacks([](const Profiler::Counters &c) { return c.cycles; });
+  sc_assert(cycles ==
+            "main 4\n"
+            "main;foo 6\n"
+            "main;foo;isr 1\n");
+  const auto energy = p.foldedStacks([](const Profiler::Counters &c) {
+    return static_cast<uint64_t>(c.energy * 1.0e12 + 0.5);
+  });
+  sc_assert(energy ==
+            "[off] 1000000000000\n"
+            "main 2\n");
+
+  std::remove(elfFile.c_str());
+  spdlog::info("Tests done.");
+  return false;
+}
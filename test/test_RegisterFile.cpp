@@ -6,8 +6,10 @@
  */
 
 #include <assert.h>
+#include <stdexcept>
 #include <string>
 #include "mcu/RegisterFile.hpp"
+#include "utilities/Checkpoint.hpp"
 
 int main() {
   RegisterFile dut;
@@ -47,5 +49,46 @@ int main() {
   dut.write(crntAddr, 0x55555555);
   assert(dut.read(crntAddr) == 0x55550000);
 
+  // TEST - Checkpoint round-trip, including read-only registers
+  dut.addRegister(crntAddr + TARGET_WORD_SIZE, 0,
+                  RegisterFile::AccessMode::READ);
+  dut.write(crntAddr + TARGET_WORD_SIZE, 0x1234, /*force=*/true);
+  CheckpointOut out;
+  dut.saveState(out);
+  const auto before = dut.read(0);
+  dut.reset();
+  CheckpointIn in(out.data());
+  dut.restoreState(in);
+  assert(dut.read(0) == before);
+  assert(dut.read(crntAddr) == 0x55550000);
+  assert(dut.read(crntAddr + TARGET_WORD_SIZE) == 0x1234);
+
+  // TEST - Sparse registers, added below the lowest address
+  RegisterFile sparse;
+  sparse.addRegister(0x300, 0x3);
+  sparse.addRegister(0x100, 0x1);
+  sparse.addRegister(0x180, 0x2);
+  assert(sparse.read(0x100) == 0x1);
+  assert(sparse.read(0x180) == 0x2);
+  assert(sparse.read(0x300) == 0x3);
+  assert(!sparse.contains(0x0));
+  assert(!sparse.contains(0x104));
+  assert(!sparse.contains(0x304));
+  sparse.setBit(0x180, 4);
+  sparse.clearBitMask(0x300, 0x1);
+  assert(sparse.read(0x180) == 0x12);
+  assert(sparse.read(0x300) == 0x2);
+
+  // TEST - Truncated checkpoint
+  std::vector<uint8_t> truncated(out.data().begin(), out.data().end() - 1);
+  CheckpointIn tin(truncated);
+  bool threw = false;
+  try {
+    dut.restoreState(tin);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+
   return 0;
 }
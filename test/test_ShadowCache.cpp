@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <assert.h>
+#include <stdexcept>
+#include "mcu/ShadowCache.hpp"
+#include "utilities/Config.hpp"
+
+int main() {
+  // Configuration of the real cache
+  auto &config = Config::get();
+  config.set("tester.cache.CacheNSets", "2");
+  config.set("tester.cache.CacheNLines", "2");
+  config.set("tester.cache.CacheLineWidth", "8");
+  config.set("tester.cache.CacheReplacementPolicy", "LRU");
+  config.set("tester.cache.CacheWritePolicy", "WriteBack");
+  config.set("tester.cache read hit", "1.0");
+  config.set("tester.cache read miss", "10.0");
+
+  // TEST - Defaults to the real cache's configuration
+  ShadowCache dut("tester.cache", {});
+  for (const unsigned addr : {0, 0, 8, 16, 32, 0}) {
+    dut.access(addr, 2, /*isWrite=*/false);
+  }
+  assert(dut.stats().readHits == 1);
+  assert(dut.stats().readMisses == 5);  // 32 evicts 0 (LRU), 0 evicts 16
+  assert(dut.stats().memoryBytesRead == 5 * 8);
+  assert(dut.energy() == 1.0 + 5 * 10.0);
+
+  // TEST - Write-back: dirty victims are written back
+  ShadowCache wb("tester.cache", {{"CacheNSets", "1"},
+                                  {"CacheNLines", "1"},
+                                  {"MemoryWriteEnergy", "0.5"}});
+  wb.access(0, 2, /*isWrite=*/true);
+  wb.access(2, 2, /*isWrite=*/true);
+  wb.access(8, 2, /*isWrite=*/false);
+  assert(wb.stats().writeMisses == 1 && wb.stats().writeHits == 1);
+  assert(wb.stats().writebacks == 1);
+  assert(wb.stats().memoryBytesWritten == 8);
+  assert(wb.energy() == 10.0 + 8 * 0.5);
+
+  // TEST - Write-around: writes bypass the cache and invalidate hit lines
+  ShadowCache wa("tester.cache", {{"CacheWritePolicy", "WriteAround"},
+                                  {"CacheReplacementPolicy", "PLRU"}});
+  wa.access(0, 2, /*isWrite=*/true);
+  wa.access(0, 2, /*isWrite=*/false);
+  wa.access(0, 2, /*isWrite=*/true);
+  wa.access(0, 2, /*isWrite=*/false);
+  assert(wa.stats().writeMisses == 1 && wa.stats().writeHits == 1);
+  assert(wa.stats().readMisses == 2);
+  assert(wa.stats().memoryBytesWritten == 4 && wa.stats().writebacks == 0);
+
+  // TEST - Power loss invalidates lines, but keeps counters
+  wa.reset();
+  wa.access(0, 2, /*isWrite=*/false);
+  assert(wa.stats().readMisses == 3);
+
+  // TEST - Invalid parameters
+  for (const auto &p : {SweepRunner::KeyValues{{"CacheNSets", "3"}},
+                        SweepRunner::KeyValues{{"CacheNLines", "0"}},
+                        SweepRunner::KeyValues{{"CacheWritePolicy", "No"}},
+                        SweepRunner::KeyValues{{"NotAKey", "1"}}}) {
+    bool threw = false;
+    try {
+      ShadowCache("tester.cache", p);
+    } catch (const std::invalid_argument &) {
+      threw = true;
+    }
+    assert(threw);
+  }
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <systemc>
+#include "utilities/SweepRunner.hpp"
+
+using namespace sc_core;
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  const std::string sweepFile = "/tmp/test_sweep.yaml";
+  const std::string resultsFile = "/tmp/test_sweep.csv";
+  {
+    std::ofstream f(sweepFile);
+    f << "CapacitorValue: [1.0e-6, 4.7e-6, 10.0e-6]\n";
+    f << "SVSVon: [3.0, 3.5]\n";
+    f << "Board: Msp430TestBoard\n";
+  }
+
+  // TEST -- Grid is the cartesian product, last key varies fastest
+  SweepRunner sweep(sweepFile);
+  sc_assert(sweep.nPoints() == 6);
+  auto p = sweep.point(0);
+  sc_assert(p.size() == 3);
+  sc_assert(p[0].first == "CapacitorValue" && p[0].second == "1.0e-6");
+  sc_assert(p[1].first == "SVSVon" && p[1].second == "3.0");
+  sc_assert(p[2].first == "Board" && p[2].second == "Msp430TestBoard");
+  p = sweep.point(3);
+  sc_assert(p[0].second == "4.7e-6" && p[1].second == "3.5");
+  p = sweep.point(5);
+  sc_assert(p[0].second == "10.0e-6" && p[1].second == "3.5");
+
+  // TEST -- Points run in worker processes, metrics are collected in order
+  const pid_t parent = getpid();
+  const bool success = sweep.run(
+      4,
+      [&](const size_t idx) -> SweepRunner::KeyValues {
+        sc_assert(getpid() != parent);
+        if (idx == 4) {
+          std::exit(3);  // Failed run
+        }
+        return {{"idx", std::to_string(idx)},
+                {"von", sweep.point(idx)[1].second}};
+      },
+      resultsFile);
+  sc_assert(!success);
+
+  std::ifstream f(resultsFile);
+  std::stringstream buffer;
+  buffer << f.rdbuf();
+  sc_assert(buffer.str() ==
+            "point,CapacitorValue,SVSVon,Board,status,idx,von\n"
+            "0,1.0e-6,3.0,Msp430TestBoard,ok,0,3.0\n"
+            "1,1.0e-6,3.5,Msp430TestBoard,ok,1,3.5\n"
+            "2,4.7e-6,3.0,Msp430TestBoard,ok,2,3.0\n"
+            "3,4.7e-6,3.5,Msp430TestBoard,ok,3,3.5\n"
+            "4,10.0e-6,3.0,Msp430TestBoard,exit 3,,\n"
+            "5,10.0e-6,3.5,Msp430TestBoard,ok,5,3.5\n");
+
+  // TEST -- Output larger than the pipe buffer doesn't block the worker
+  const std::string big(1 << 20, 'x');
+  sc_assert(sweep.run(
+      2,
+      [&](const size_t) -> SweepRunner::KeyValues {
+        return {{"big", big}};
+      },
+      resultsFile));
+  std::ifstream f2(resultsFile);
+  std::string header, row;
+  std::getline(f2, header);
+  std::getline(f2, row);
+  sc_assert(header == "point,CapacitorValue,SVSVon,Board,status,big");
+  sc_assert(row == "0,1.0e-6,3.0,Msp430TestBoard,ok," + big);
+
+  std::remove(sweepFile.c_str());
+  std::remove(resultsFile.c_str());
+  spdlog::info("Tests done.");
+  return false;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <systemc>
+#include <tlm>
+#include "mcu/ClockSourceChannel.hpp"
+#include "mcu/GenericMemory.hpp"
+#include "mcu/msp430fr5xx/Msp430Cpu.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "utilities/Config.hpp"
+#include "utilities/Utilities.hpp"
+
+extern "C" {
+#include "mcu/msp430fr5xx/device_includes/msp430fr5994.h"
+}
+
+using namespace sc_core;
+
+// Counts down from 10, incrementing a counter in memory, then writes a
+// marker and sleeps.
+static const uint16_t PROGRAM[] = {
+    0x403c, 0x000a,          // 0x00: MOV #10, r12
+    0x5392, 0x0100,          // 0x04: ADD #1, &0x0100
+    0x831c,                  // 0x08: SUB #1, r12
+    0x23fc,                  // 0x0a: JNZ 0x04
+    0x40b2, 0xbeef, 0x0102,  // 0x0c: MOV #0xbeef, &0x0102
+    0xd032, 0x0010,          // 0x12: BIS #CPUOFF, SR
+};
+
+SC_MODULE(dut) {
+ public:
+  // Signals
+  sc_signal<bool> nreset{"nreset", false};
+  sc_signal<bool> irq{"irq"};
+  sc_signal<bool> ira{"ira"};
+  sc_signal<bool> stallCpu{"stallCpu"};
+  sc_signal<unsigned> irqIdx{"irqIdx"};
+  sc_signal<bool> iraConnected{"iraConnected"};
+  GenericMemory mem{"mem", 0, 0xFFFF};
+  ClockSourceChannel mclk{"mclk", sc_time(125, SC_NS)};
+  PowerModelChannel powerModelChannel{"powerModelChannel", "/tmp",
+                                      sc_time(1, SC_US)};
+  Msp430Cpu cpu{"cpu"};
+
+  SC_CTOR(dut) {
+    mem.pwrOn.bind(nreset);
+    mem.tSocket.bind(cpu.iSocket);
+    mem.systemClk.bind(mclk);
+    mem.powerModelPort.bind(powerModelChannel);
+    cpu.mclk.bind(mclk);
+    cpu.pwrOn.bind(nreset);
+    cpu.irq.bind(irq);
+    cpu.ira.bind(ira);
+    cpu.irqIdx.bind(irqIdx);
+    cpu.iraConnected.bind(iraConnected);
+    cpu.busStall.bind(stallCpu);
+    cpu.powerModelPort.bind(powerModelChannel);
+  }
+
+  void load() {
+    for (unsigned i = 0; i < sizeof(PROGRAM) / sizeof(PROGRAM[0]); i++) {
+      write16(2 * i, PROGRAM[i]);
+    }
+  }
+
+  void write16(const uint32_t addr, const uint32_t val) {
+    tlm::tlm_generic_payload trans;
+    unsigned char data[2];
+    trans.set_data_ptr(data);
+    trans.set_data_length(2);
+    trans.set_command(tlm::TLM_WRITE_COMMAND);
+    trans.set_address(addr);
+    Utility::unpackBytes(data, Utility::htots(val), 2);
+    mem.transport_dbg(trans);
+  }
+
+  uint16_t read16(const uint32_t addr) {
+    tlm::tlm_generic_payload trans;
+    unsigned char data[2];
+    trans.set_data_ptr(data);
+    trans.set_data_length(2);
+    trans.set_command(tlm::TLM_READ_COMMAND);
+    trans.set_address(addr);
+    mem.transport_dbg(trans);
+    return Utility::ttohs(Utility::packBytes(data, 2));
+  }
+};
+
+SC_MODULE(tester) {
+ public:
+  SC_HAS_PROCESS(tester);
+  tester(sc_module_name nm, dut &at_, dut &lt_)
+      : sc_module(nm), at(at_), lt(lt_) {
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    for (dut *d : {&at, &lt}) {
+      d->cpu.unstall();
+      d->load();
+    }
+    wait(5 * at.mclk.getPeriod());
+    at.nreset.write(true);
+    lt.nreset.write(true);
+    wait(SC_ZERO_TIME);
+    for (dut *d : {&at, &lt}) {
+      d->cpu.dbg_writeReg(SR_REGNUM, 0x00);  // Clear CPUOFF flag
+      d->powerModelChannel.popDynamicEnergy();
+    }
+
+    // TEST -- Loosely-timed execution gives the same results as
+    // cycle-accurate execution
+    wait(100, SC_US);
+    for (dut *d : {&at, &lt}) {
+      sc_assert(d->read16(0x0100) == 10);
+      sc_assert(d->read16(0x0102) == 0xbeef);
+      sc_assert(d->cpu.dbg_readReg(12) == 0);
+      sc_assert(d->cpu.dbg_readReg(PC_REGNUM) == 0x16);
+      sc_assert(d->cpu.dbg_readReg(SR_REGNUM) & CPUOFF);
+    }
+
+    // TEST -- ... and reports the same events (23 format I instructions at
+    // 1 J and 10 jumps at 100 J each)
+    sc_assert(at.powerModelChannel.popDynamicEnergy() == 23.0 + 1000.0);
+    sc_assert(lt.powerModelChannel.popDynamicEnergy() == 23.0 + 1000.0);
+
+    spdlog::info("TemporalDecoupling tests PASSED");
+    sc_stop();
+  }
+
+  static const unsigned PC_REGNUM = 0;
+  static const unsigned SR_REGNUM = 2;
+
+  dut &at;  //! Cycle-accurate
+  dut &lt;  //! Loosely-timed
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  auto &config = Config::get();
+  config.parseFile();
+  config.set("IdleFastForward", "False");
+  for (const std::string cpu : {"at.cpu", "lt.cpu"}) {
+    config.set(cpu + " formatI", "1.0");
+    config.set(cpu + " formatIII", "100.0");
+  }
+
+  // The mode is picked up when each CPU is constructed
+  config.set("TemporalDecoupling", "False");
+  dut at("at");
+  config.set("TemporalDecoupling", "True");
+  config.set("GlobalQuantum", "1.0e-6");
+  dut lt("lt");
+
+  tester t("tester", at, lt);
+  sc_start();
+  return false;
+}
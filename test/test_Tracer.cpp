@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <systemc>
+#include <vector>
+#include "utilities/Tracer.hpp"
+
+using namespace sc_core;
+
+std::vector<TraceRecord> readTrace(const std::string &fileName) {
+  std::FILE *f = std::fopen(fileName.c_str(), "rb");
+  sc_assert(f != nullptr);
+  char magic[8];
+  uint32_t version, recordSize;
+  sc_assert(std::fread(magic, 1, 8, f) == 8);
+  sc_assert(std::memcmp(magic, TraceRecord::signature(), 8) == 0);
+  sc_assert(std::fread(&version, 4, 1, f) == 1);
+  sc_assert(version == TraceRecord::VERSION);
+  sc_assert(std::fread(&recordSize, 4, 1, f) == 1);
+  sc_assert(recordSize == sizeof(TraceRecord));
+  std::vector<TraceRecord> records;
+  TraceRecord r;
+  while (std::fread(&r, sizeof(r), 1, f) == 1) {
+    records.push_back(r);
+  }
+  std::fclose(f);
+  return records;
+}
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  const std::string traceFile = "/tmp/test_trace.bin";
+  const uint8_t data[4] = {0x78, 0x56, 0x34, 0x12};
+
+  // TEST -- Records survive wrapping around a small ring buffer
+  {
+    Tracer::Options o;
+    o.capacity = 8;
+    Tracer t(traceFile, o);
+    for (uint32_t i = 0; i < 1000; ++i) {
+      sc_assert(t.instruction(i, 2 * i, i & 0xffff, 2));
+      t.access(i, 0x1000 + i, i % 2, 3, data, 4);
+    }
+  }
+  auto records = readTrace(traceFile);
+  sc_assert(records.size() == 2000);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    const auto &insn = records[2 * i];
+    sc_assert(insn.type == TraceRecord::INSTRUCTION);
+    sc_assert(insn.timePs == i && insn.addr == 2 * i && insn.value == i);
+    sc_assert(insn.target == TraceRecord::NO_TARGET);
+    const auto &acc = records[2 * i + 1];
+    sc_assert(acc.type == ((i % 2) ? TraceRecord::WRITE : TraceRecord::READ));
+    sc_assert(acc.addr == 0x1000 + i && acc.value == 0x12345678);
+    sc_assert(acc.size == 4 && acc.target == 3);
+  }
+
+  // TEST -- Time window and PC range triggers
+  {
+    Tracer::Options o;
+    o.startPs = 10;
+    o.stopPs = 20;
+    o.pcLow = 0x100;
+    o.pcHigh = 0x1ff;
+    Tracer t(traceFile, o);
+    sc_assert(!t.instruction(5, 0x100, 0, 2));   // Before window
+    t.access(5, 0x2000, false, 0, data, 2);       // Not recorded
+    sc_assert(!t.instruction(10, 0x200, 0, 2));  // Outside PC range
+    t.access(10, 0x2000, false, 0, data, 2);      // Not recorded
+    sc_assert(t.instruction(11, 0x1fe, 0, 2));
+    t.access(11, 0x2000, true, 0, data, 2);
+    t.registerWrite(11, 4, 42);
+    sc_assert(!t.instruction(20, 0x100, 0, 2));  // After window
+  }
+  records = readTrace(traceFile);
+  sc_assert(records.size() == 3);
+  sc_assert(records[0].type == TraceRecord::INSTRUCTION);
+  sc_assert(records[0].addr == 0x1fe);
+  sc_assert(records[1].type == TraceRecord::WRITE);
+  sc_assert(records[1].value == 0x5678 && records[1].size == 2);
+  sc_assert(records[2].type == TraceRecord::REGISTER);
+  sc_assert(records[2].addr == 4 && records[2].value == 42);
+
+  std::remove(traceFile.c_str());
+  spdlog::info("Tests done.");
+  return false;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <string>
+#include <systemc>
+#include <tlm>
+#include <vector>
+#include "include/cm0-fused.h"
+#include "mcu/Bus.hpp"
+#include "mcu/ClockSourceChannel.hpp"
+#include "mcu/GenericMemory.hpp"
+#include "mcu/cortex-m0/CortexM0Cpu.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "utilities/Checkpoint.hpp"
+#include "utilities/Config.hpp"
+#include "utilities/Utilities.hpp"
+
+using namespace sc_core;
+using namespace Utility;
+
+// Self-modifying loop: the first iteration sets r2 to 1, then overwrites the
+// (already predecoded) MOVS at the top of the loop with "MOVS r2, #2".
+static const std::vector<uint16_t> PATCH_PROGRAM = {
+    0x2401,  // 0x40: MOVS r4, #1
+    0x06e4,  // 0x42: LSLS r4, r4, #27    (r4 = ROM_START)
+    0x344c,  // 0x44: ADDS r4, #0x4c      (r4 = address of loop)
+    0x2322,  // 0x46: MOVS r3, #0x22
+    0x021b,  // 0x48: LSLS r3, r3, #8
+    0x3302,  // 0x4a: ADDS r3, #2         (r3 = "MOVS r2, #2")
+    0x2201,  // 0x4c: MOVS r2, #1         (loop)
+    0x3501,  // 0x4e: ADDS r5, #1
+    0x8023,  // 0x50: STRH r3, [r4, #0]
+    0xe7fb,  // 0x52: B 0x4c
+};
+
+// Adds two constants, then loops forever
+static const std::vector<uint16_t> ADD_PROGRAM = {
+    0x2003,  // 0x40: MOVS r0, #3
+    0x2104,  // 0x42: MOVS r1, #4
+    0x1842,  // 0x44: ADDS r2, r0, r1
+    0xe7fe,  // 0x46: B .
+};
+
+// Sleeps until an exception that never comes
+static const std::vector<uint16_t> SLEEP_PROGRAM = {
+    0x2001,  // 0x40: MOVS r0, #1
+    0xbf30,  // 0x42: WFI
+    0x2002,  // 0x44: MOVS r0, #2
+    0xe7fe,  // 0x46: B .
+};
+
+SC_MODULE(dut) {
+ public:
+  // Signals
+  sc_signal<bool> pwrGood{"pwrGood", false};
+  sc_signal<bool> busStall{"busStall", false};
+  sc_signal<bool> sysTickIrq{"sysTickIrq", false};
+  sc_signal<int> nvicIrq{"nvicIrq", -1};
+  sc_signal<int> returningException{"returningException", 0};
+  sc_signal<int> activeException{"activeException", 0};
+  ClockSourceChannel clk{"clk", sc_time(125, SC_NS)};
+  PowerModelChannel powerModelChannel{"powerModelChannel", "/tmp",
+                                      sc_time(1, SC_US)};
+
+  // Modules
+  Bus bus{"bus"};
+  GenericMemory rom{"rom", ROM_START, ROM_START + ROM_SIZE - 1};
+  CortexM0Cpu cpu{"cpu"};
+
+  SC_CTOR(dut) {
+    cpu.iSocket.bind(bus.tSocket);
+    bus.bindTarget(rom);
+    rom.pwrOn.bind(pwrGood);
+    rom.systemClk.bind(clk);
+    rom.powerModelPort.bind(powerModelChannel);
+
+    cpu.clk.bind(clk);
+    cpu.pwrOn.bind(pwrGood);
+    cpu.busStall.bind(busStall);
+    cpu.sysTickIrq.bind(sysTickIrq);
+    cpu.nvicIrq.bind(nvicIrq);
+    cpu.returningException.bind(returningException);
+    cpu.activeException.bind(activeException);
+    cpu.powerModelPort.bind(powerModelChannel);
+  }
+
+  /**
+   * @brief load write a vector table (initial SP, reset vector) and a program
+   * starting at ROM_START + 0x40.
+   */
+  void load(const std::vector<uint16_t> &program) {
+    write32(0, SRAM_START + SRAM_SIZE);
+    write32(4, (ROM_START + 0x40) | 1);
+    for (unsigned i = 0; i < program.size(); i++) {
+      uint8_t data[2];
+      unpackBytes(data, htots(program[i]), 2);
+      write(0x40 + 2 * i, data, 2);
+    }
+  }
+
+  void write32(const unsigned ofs, const uint32_t val) {
+    uint8_t data[4];
+    unpackBytes(data, htotl(val), 4);
+    write(ofs, data, 4);
+  }
+
+  void write(const unsigned ofs, uint8_t *data, const unsigned len) {
+    tlm::tlm_generic_payload trans;
+    trans.set_data_ptr(data);
+    trans.set_data_length(len);
+    trans.set_command(tlm::TLM_WRITE_COMMAND);
+    trans.set_address(ofs);
+    rom.transport_dbg(trans);  // Bypassing sockets
+  }
+};
+
+SC_MODULE(tester) {
+ public:
+  SC_CTOR(tester) { SC_THREAD(runtests); }
+
+  void runtests() {
+    test.cpu.unstall();
+    test2.cpu.unstall();
+    test3.cpu.unstall();
+    test4.cpu.unstall();
+    test.load(PATCH_PROGRAM);
+    test2.load(ADD_PROGRAM);
+    test3.load(SLEEP_PROGRAM);
+    test4.load(SLEEP_PROGRAM);
+    wait(5 * test.clk.getPeriod());
+    test.pwrGood.write(true);
+    test2.pwrGood.write(true);
+
+    // TEST -- Overwriting a predecoded instruction in ROM takes effect
+    wait(100, SC_US);
+    sc_assert(test.cpu.dbg_readReg(5) > 1);  // Looped more than once
+    sc_assert(test.cpu.dbg_readReg(2) == 2);
+    sc_assert(test.cpu.dbg_readReg(3) == 0x2202);
+
+    // TEST -- Two cores running different programs keep separate state
+    sc_assert(test.cpu.dbg_readReg(0) == 0);
+    sc_assert(test2.cpu.dbg_readReg(0) == 3);
+    sc_assert(test2.cpu.dbg_readReg(1) == 4);
+    sc_assert(test2.cpu.dbg_readReg(2) == 7);
+    sc_assert(test2.cpu.dbg_readReg(5) == 0);
+
+    // TEST -- Powering off one core leaves the other running
+    test2.pwrGood.write(false);
+    const auto count = test.cpu.dbg_readReg(5);
+    wait(10, SC_US);
+    sc_assert(test.cpu.dbg_readReg(5) > count);
+    sc_assert(test2.cpu.dbg_readReg(2) == 7);
+
+    // TEST -- A core checkpointed in WFI is still sleeping after a restore
+    test3.pwrGood.write(true);
+    wait(10, SC_US);
+    sc_assert(test3.cpu.dbg_readReg(0) == 1);
+    CheckpointOut out;
+    test3.cpu.saveState(out);
+    const auto state = out.data();
+    test4.cpu.setPowerOnHook([&]() {
+      CheckpointIn in(state);
+      test4.cpu.restoreState(in);
+    });
+    test4.pwrGood.write(true);
+    wait(10, SC_US);
+    sc_assert(test4.cpu.dbg_readReg(0) == 1);  // MOVS r0, #2 not executed
+
+    spdlog::info("CortexM0Cpu tests PASSED");
+    sc_stop();
+  }
+
+  dut test{"dut"};
+  dut test2{"dut2"};
+  dut test3{"dut3"};  //! Checkpoint is taken from this one
+  dut test4{"dut4"};  //! ... and restored into this one
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  // Parse config file
+  auto &config = Config::get();
+  config.parseFile();
+
+  tester t("tester");
+  sc_start();
+  return false;
+}
@@ -91,9 +91,146 @@ SC_MODULE(tester) {
     wait(sc_time(2, SC_US));
     sc_assert(test.dmaTrigger.read() == false);
 
+    // The tests below start at t0, half-way between two timer clock edges.
+    // Edge n then occurs at t0 + (n - 0.5) * tclk, so n edges have passed at
+    // t0 + n * tclk.
+    const sc_time tclk = test.aclk_sig.getPeriod();
+    sc_time t0;
+
+    // TEST -- Up mode: counter value and CCR0 interrupt time
+    t0 = nextHalfPeriod();
+    waitUntil(t0);
+    write16(OFS_TA1CCR0, 5 - 1);
+    write16(OFS_TA1CCTL0, CCIE);
+    write16(OFS_TA1CTL, MC_1 | TASSEL_1 | TACLR);
+    waitUntil(t0 + 3 * tclk);
+    sc_assert(read16(OFS_TA1R) == 3);
+    waitUntil(t0 + 4 * tclk);
+    sc_assert(read16(OFS_TA1R) == 4);
+    sc_assert(test.irq.read() == false);
+    waitUntil(t0 + 5 * tclk);  // Rolled over to 0 on the 5th edge
+    sc_assert(read16(OFS_TA1R) == 0);
+    sc_assert(test.irq.read() == true);
+    acknowledge();
+    waitUntil(t0 + 9 * tclk);
+    sc_assert(test.irq.read() == false);
+    waitUntil(t0 + 10 * tclk);
+    sc_assert(test.irq.read() == true);
+    acknowledge();
+    write16(OFS_TA1CCTL0, 0);
+
+    // TEST -- TACLR clears the counter, keeps the settings and restarts the
+    // count towards the next CCR0 match
+    t0 = nextHalfPeriod();
+    waitUntil(t0);
+    write16(OFS_TA1CTL, MC_1 | TAIE | TASSEL_1 | TACLR);
+    waitUntil(t0 + 2 * tclk);
+    sc_assert(read16(OFS_TA1R) == 2);
+    write16(OFS_TA1CTL, MC_1 | TAIE | TASSEL_1 | TACLR);
+    sc_assert(read16(OFS_TA1R) == 0);
+    sc_assert(read16(OFS_TA1CTL) == (MC_1 | TAIE | TASSEL_1));
+    // Without TACLR, the CCR0 match would have been at t0 + 5 * tclk
+    waitUntil(t0 + 6 * tclk);
+    sc_assert(read16(OFS_TA1R) == 4);
+    sc_assert(test.irq.read() == false);
+    waitUntil(t0 + 7 * tclk);
+    sc_assert(read16(OFS_TA1R) == 0);
+    sc_assert(test.irq.read() == true);
+    acknowledge();
+
+    // TEST -- Continuous mode: counter value and overflow interrupt time
+    t0 = nextHalfPeriod();
+    waitUntil(t0);
+    write16(OFS_TA1CTL, MC_2 | TAIE | TASSEL_1 | TACLR);
+    waitUntil(t0 + 5 * tclk);  // Counts past TAxCCR0
+    sc_assert(read16(OFS_TA1R) == 5);
+    write16(OFS_TA1R, 0xfff0);
+    waitUntil(t0 + 20 * tclk);
+    sc_assert(read16(OFS_TA1R) == 0xffff);
+    sc_assert(test.irq.read() == false);
+    waitUntil(t0 + 21 * tclk);
+    sc_assert(read16(OFS_TA1R) == 0);
+    sc_assert(test.irq.read() == true);
+    acknowledge();
+    // A full count of 0x10000 ticks until the next overflow
+    waitUntil(t0 + (21 + 0x10000 - 1) * tclk);
+    sc_assert(read16(OFS_TA1R) == 0xffff);
+    sc_assert(test.irq.read() == false);
+    waitUntil(t0 + (21 + 0x10000) * tclk);
+    sc_assert(test.irq.read() == true);
+    acknowledge();
+
+    // TEST -- Up/down mode: counts 0, 1, 2, 3, 2, 1, 0, and sets TAIFG on
+    // reaching 0
+    t0 = nextHalfPeriod();
+    waitUntil(t0);
+    write16(OFS_TA1CCR0, 3);
+    write16(OFS_TA1CTL, MC_3 | TAIE | TASSEL_1 | TACLR);
+    waitUntil(t0 + 3 * tclk);
+    sc_assert(read16(OFS_TA1R) == 3);
+    waitUntil(t0 + 4 * tclk);
+    sc_assert(read16(OFS_TA1R) == 2);
+    waitUntil(t0 + 5 * tclk);
+    sc_assert(read16(OFS_TA1R) == 1);
+    sc_assert(test.irq.read() == false);
+    waitUntil(t0 + 6 * tclk);
+    sc_assert(read16(OFS_TA1R) == 0);
+    sc_assert(test.irq.read() == true);
+    acknowledge();
+    waitUntil(t0 + 8 * tclk);
+    sc_assert(read16(OFS_TA1R) == 2);  // Counting up again
+    waitUntil(t0 + 12 * tclk);
+    sc_assert(test.irq.read() == true);
+    acknowledge();
+
+    // TEST -- TACLR in up/down mode restarts counting up from 0
+    waitUntil(t0 + 16 * tclk);
+    sc_assert(read16(OFS_TA1R) == 2);  // Counting down
+    write16(OFS_TA1CTL, MC_3 | TAIE | TASSEL_1 | TACLR);
+    waitUntil(t0 + 18 * tclk);
+    sc_assert(read16(OFS_TA1R) == 2);  // Counting up
+    waitUntil(t0 + 19 * tclk);
+    sc_assert(read16(OFS_TA1R) == 3);
+    waitUntil(t0 + 21 * tclk);
+    sc_assert(test.irq.read() == false);
+    waitUntil(t0 + 22 * tclk);
+    sc_assert(test.irq.read() == true);
+    acknowledge();
+
+    // TEST -- Stop mode halts the counter
+    write16(OFS_TA1CTL, MC_0 | TASSEL_1);
+    const auto cnt = read16(OFS_TA1R);
+    wait(10 * tclk);
+    sc_assert(read16(OFS_TA1R) == cnt);
+    sc_assert(test.irq.read() == false);
+
+    spdlog::info("TimerA tests PASSED");
     sc_stop();
   }
 
+  /**
+   * @brief nextHalfPeriod Time half-way between the next two timer clock
+   * edges.
+   */
+  sc_time nextHalfPeriod() {
+    const auto p = test.aclk_sig.getPeriod().value();
+    return sc_time::from_value((sc_time_stamp().value() / p + 1) * p + p / 2);
+  }
+
+  void waitUntil(const sc_time &t) { wait(t - sc_time_stamp()); }
+
+  /**
+   * @brief acknowledge Accept the pending interrupt request.
+   */
+  void acknowledge() {
+    test.ira.write(true);
+    wait(SC_ZERO_TIME);
+    wait(SC_ZERO_TIME);
+    sc_assert(test.irq.read() == false);
+    test.ira.write(false);
+    wait(SC_ZERO_TIME);
+  }
+
   void write16(const uint32_t addr, const uint32_t val, bool doWait = true) {
     sc_time delay = SC_ZERO_TIME;
     tlm::tlm_generic_payload trans;
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <systemc>
+#include <vector>
+#include "utilities/Checkpoint.hpp"
+
+using namespace sc_core;
+
+const uint32_t Checkpoint::VERSION;
+
+namespace {
+const char MAGIC[8] = {'F', 'U', 'S', 'E', 'D', 'C', 'K', 'P'};
+
+//! Call f for every Checkpointable object in the design hierarchy
+void forEachCheckpointable(
+    const std::function<void(sc_object *, Checkpointable *)> &f) {
+  std::function<void(const std::vector<sc_object *> &)> visit =
+      [&](const std::vector<sc_object *> &objects) {
+        for (auto *obj : objects) {
+          if (auto *c = dynamic_cast<Checkpointable *>(obj)) {
+            f(obj, c);
+          }
+          visit(obj->get_child_objects());
+        }
+      };
+  visit(sc_get_top_level_objects());
+}
+
+template <class T>
+void write(std::FILE *f, const T &val) {
+  std::fwrite(&val, sizeof(T), 1, f);
+}
+
+template <class T>
+T read(std::FILE *f) {
+  T val;
+  if (std::fread(&val, sizeof(T), 1, f) != 1) {
+    throw std::runtime_error("Checkpoint: truncated checkpoint file");
+  }
+  return val;
+}
+}  // namespace
+
+void Checkpoint::save(const std::string &fileName, const bool powered) {
+  std::map<std::string, std::vector<uint8_t>> states;
+  forEachCheckpointable([&](sc_object *obj, Checkpointable *c) {
+    CheckpointOut out;
+    c->saveState(out);
+    states[obj->name()] = out.data();
+  });
+
+  std::FILE *f = std::fopen(fileName.c_str(), "wb");
+  if (f == nullptr) {
+    throw std::runtime_error("Can't open checkpoint file at " + fileName);
+  }
+  std::fwrite(MAGIC, 1, sizeof(MAGIC), f);
+  write<uint32_t>(f, VERSION);
+  write<uint32_t>(f, powered);
+  write<uint64_t>(f, sc_time_stamp().value());
+  write<uint32_t>(f, states.size());
+  for (const auto &s : states) {
+    write<uint32_t>(f, s.first.size());
+    std::fwrite(s.first.data(), 1, s.first.size(), f);
+    write<uint64_t>(f, s.second.size());
+    std::fwrite(s.second.data(), 1, s.second.size(), f);
+  }
+  std::fclose(f);
+  spdlog::info("Saved checkpoint of {} objects at {} to {}", states.size(),
+               sc_time_stamp().to_string(), fileName);
+}
+
+Checkpoint::Checkpoint(const std::string &fileName) {
+  std::FILE *f = std::fopen(fileName.c_str(), "rb");
+  if (f == nullptr) {
+    throw std::runtime_error("Can't open checkpoint file at " + fileName);
+  }
+  try {
+    char magic[sizeof(MAGIC)];
+    if (std::fread(magic, 1, sizeof(magic), f) != sizeof(magic) ||
+        std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+      throw std::runtime_error(fileName + " is not a checkpoint file");
+    }
+    if (read<uint32_t>(f) != VERSION) {
+      throw std::runtime_error(fileName + ": unsupported checkpoint version");
+    }
+    m_powered = read<uint32_t>(f);
+    m_time = sc_time::from_value(read<uint64_t>(f));
+    const auto n = read<uint32_t>(f);
+    for (uint32_t i = 0; i < n; ++i) {
+      std::string name(read<uint32_t>(f), '\0');
+      std::vector<uint8_t> state;
+      if (std::fread(&name[0], 1, name.size(), f) != name.size()) {
+        throw std::runtime_error("Checkpoint: truncated checkpoint file");
+      }
+      state.resize(read<uint64_t>(f));
+      if (std::fread(state.data(), 1, state.size(), f) != state.size()) {
+        throw std::runtime_error("Checkpoint: truncated checkpoint file");
+      }
+      m_states[name] = std::move(state);
+    }
+  } catch (...) {
+    std::fclose(f);
+    throw;
+  }
+  std::fclose(f);
+}
+
+void Checkpoint::restore(const bool powerSupply) const {
+  forEachCheckpointable([&](sc_object *obj, Checkpointable *c) {
+    if (c->isPowerSupply() != powerSupply) {
+      return;
+    }
+    const auto it = m_states.find(obj->name());
+    if (it == m_states.end()) {
+      throw std::runtime_error(std::string("Checkpoint: no state for ") +
+                               obj->name());
+    }
+    CheckpointIn in(it->second);
+    c->restoreState(in);
+  });
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <systemc>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief CheckpointOut Serialised state of a single object.
+ */
+class CheckpointOut {
+ public:
+  //! Append a trivially copyable value
+  template <class T>
+  void put(const T &val) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "CheckpointOut::put requires a trivially copyable type");
+    putBytes(&val, sizeof(T));
+  }
+
+  //! Append an sc_time
+  void put(const sc_core::sc_time &t) { put<uint64_t>(t.value()); }
+
+  //! Append raw bytes
+  void putBytes(const void *src, const size_t len) {
+    const auto *p = static_cast<const uint8_t *>(src);
+    m_data.insert(m_data.end(), p, p + len);
+  }
+
+  const std::vector<uint8_t> &data() const { return m_data; }
+
+ private:
+  std::vector<uint8_t> m_data;
+};
+
+/**
+ * @brief CheckpointIn Reads back the serialised state of a single object, in
+ * the order in which it was written to a CheckpointOut.
+ */
+class CheckpointIn {
+ public:
+  explicit CheckpointIn(const std::vector<uint8_t> &data)
+      : m_pos(data.data()), m_end(data.data() + data.size()) {}
+
+  //! Read a trivially copyable value
+  template <class T>
+  T get() {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "CheckpointIn::get requires a trivially copyable type");
+    T val;
+    getBytes(&val, sizeof(T));
+    return val;
+  }
+
+  //! Read an sc_time
+  sc_core::sc_time getTime() {
+    return sc_core::sc_time::from_value(get<uint64_t>());
+  }
+
+  //! Read raw bytes
+  void getBytes(void *dst, const size_t len) {
+    if (static_cast<size_t>(m_end - m_pos) < len) {
+      throw std::runtime_error("Checkpoint: truncated object state");
+    }
+    std::memcpy(dst, m_pos, len);
+    m_pos += len;
+  }
+
+ private:
+  const uint8_t *m_pos;
+  const uint8_t *m_end;
+};
+
+/**
+ * @brief Checkpointable Interface for sc_objects whose state is saved in
+ * checkpoints. Checkpoint finds all such objects in the design hierarchy.
+ */
+class Checkpointable {
+ public:
+  virtual ~Checkpointable() = default;
+
+  /**
+   * @brief saveState serialise the object's state.
+   */
+  virtual void saveState(CheckpointOut &out) = 0;
+
+  /**
+   * @brief restoreState restore state saved by saveState. Called on a freshly
+   * elaborated design: for the power supply, before the simulation is
+   * started; for all other objects, once elaboration has finished and, if the
+   * system was powered, after its power-on reset. Timestamps should be
+   * restored relative to the current simulation time.
+   */
+  virtual void restoreState(CheckpointIn &in) = 0;
+
+  /**
+   * @brief isPowerSupply whether the object is part of the power supply.
+   * The power supply is restored first, so that the rest of the system can be
+   * powered up before it is restored.
+   */
+  virtual bool isPowerSupply() const { return false; }
+};
+
+/**
+ * @brief Checkpoint Snapshot of the state of all Checkpointable objects in the
+ * design hierarchy, keyed by their hierarchical names.
+ *
+ * File layout (host byte order):
+ *   char[8] "FUSEDCKP", uint32_t version, uint32_t powered, uint64_t time (ps),
+ *   uint32_t number of objects, followed by, for each object:
+ *   uint32_t name length, name, uint64_t state size, state
+ */
+class Checkpoint {
+ public:
+  /**
+   * @brief save save the state of all Checkpointable objects to file.
+   * @param fileName path of the checkpoint file
+   * @param powered whether the system is powered, i.e. whether it needs to be
+   * powered up before restoring
+   */
+  static void save(const std::string &fileName, const bool powered);
+
+  /**
+   * @brief Checkpoint load a checkpoint from file.
+   */
+  explicit Checkpoint(const std::string &fileName);
+
+  /**
+   * @brief restore restore the state of the power supply (powerSupply=true)
+   * or of all other Checkpointable objects. Throws if an object's state is
+   * missing from the checkpoint.
+   */
+  void restore(const bool powerSupply) const;
+
+  //! Whether the system was powered when the checkpoint was taken
+  bool isPowered() const { return m_powered; }
+
+  //! Simulation time at which the checkpoint was taken
+  sc_core::sc_time getTime() const { return m_time; }
+
+  static const uint32_t VERSION = 1;
+
+ private:
+  bool m_powered{false};
+  sc_core::sc_time m_time;
+  std::map<std::string, std::vector<uint8_t>> m_states;
+};
@@ -7,13 +7,164 @@
 
 #include <spdlog/spdlog.h>
 #include <yaml-cpp/yaml.h>
+#include <climits>
+#include <cstdlib>
 #include <exception>
 #include <iostream>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 #include "utilities/Config.hpp"
 #include "utilities/Utilities.hpp"
 
+namespace {
+using Type = Config::Type;
+
+//! Types of the top-level keys. Keys of optional values may be "none".
+const std::map<std::string, Type> SCHEMA = {
+    {"AccelerometerTraceFile", Type::STRING},
+    {"AdaptiveTimestep", Type::BOOL},
+    {"Bme280TraceFile", Type::STRING},
+    {"Board", Type::STRING},
+    {"BootTracePath", Type::STRING},
+    {"BusTrace", Type::BOOL},
+    {"CapacitorInitialVoltage", Type::DOUBLE},
+    {"CapacitorValue", Type::DOUBLE},
+    {"CheckpointRestoreFile", Type::STRING},
+    {"CheckpointSaveFile", Type::STRING},
+    {"CheckpointSaveTime", Type::DOUBLE},
+    {"ConfigFile", Type::STRING},
+    {"CortexM0Version", Type::STRING},
+    {"CpuCoreVoltage", Type::DOUBLE},
+    {"EventLogFormat", Type::STRING},
+    {"ExtIcc", Type::DOUBLE},
+    {"GdbServer", Type::BOOL},
+    {"GlobalQuantum", Type::DOUBLE},
+    {"IdleFastForward", Type::BOOL},
+    {"IoSimulationStopperTarget", Type::UINT},
+    {"LogTimestep", Type::DOUBLE},
+    {"MasterClockPeriod", Type::DOUBLE},
+    {"MemorySnapshots", Type::BOOL},
+    {"OutputDirectory", Type::STRING},
+    {"PMMOff", Type::DOUBLE},
+    {"PMMOn", Type::DOUBLE},
+    {"PeripheralClockPeriod", Type::DOUBLE},
+    {"PowerModelMaxTimestep", Type::DOUBLE},
+    {"PowerModelMaxVoltageStep", Type::DOUBLE},
+    {"PowerModelTimestep", Type::DOUBLE},
+    {"PowerSupply", Type::STRING},
+    {"PowerTraceTimestep", Type::DOUBLE},
+    {"Profile", Type::BOOL},
+    {"ProfileElfFile", Type::STRING},
+    {"ProgramHexFile", Type::STRING},
+    {"PvDiodeVoltage", Type::DOUBLE},
+    {"PvOpenCircuitVoltage", Type::DOUBLE},
+    {"PvShortCircuitCurrent", Type::DOUBLE},
+    {"RfEfficiency", Type::DOUBLE},
+    {"RfInputPower", Type::DOUBLE},
+    {"RfOpenCircuitVoltage", Type::DOUBLE},
+    {"SVSVoff", Type::DOUBLE},
+    {"SVSVon", Type::DOUBLE},
+    {"SimTimeLimit", Type::DOUBLE},
+    {"SupplyCurrentLimit", Type::DOUBLE},
+    {"SupplyTraceFile", Type::STRING},
+    {"SupplyTraceResistance", Type::DOUBLE},
+    {"SupplyTraceType", Type::STRING},
+    {"SupplyVoltageLimit", Type::DOUBLE},
+    {"SweepFile", Type::STRING},
+    {"SweepJobs", Type::UINT},
+    {"TemporalDecoupling", Type::BOOL},
+    {"Trace", Type::BOOL},
+    {"TracePcHigh", Type::STRING},
+    {"TracePcLow", Type::STRING},
+    {"TraceRegisters", Type::BOOL},
+    {"TraceStartTime", Type::DOUBLE},
+    {"TraceStopTime", Type::DOUBLE},
+    {"VMAX", Type::DOUBLE},
+    {"VccMultiplierPath", Type::STRING},
+    {"VoltageWarning", Type::DOUBLE},
+};
+
+//! Types of module keys "<module name>.<suffix>"
+const std::vector<std::pair<std::string, Type>> MODULE_SCHEMA = {
+    {".CacheLineWidth", Type::UINT},
+    {".CacheNLines", Type::UINT},
+    {".CacheNSets", Type::UINT},
+    {".CacheReplacementPolicy", Type::STRING},
+    {".CacheWritePolicy", Type::STRING},
+    {".NvmWearPageSize", Type::UINT},
+    {".NvmWriteEnergyModel", Type::STRING},
+    {".NvmWriteLineWidth", Type::UINT},
+    {".ShadowCacheFile", Type::STRING},
+};
+
+const char *typeName(const Type t) {
+  switch (t) {
+    case Type::BOOL:
+      return "a boolean (True/False)";
+    case Type::UINT:
+      return "an unsigned integer";
+    case Type::DOUBLE:
+      return "a number";
+    default:
+      return "a string";
+  }
+}
+}  // namespace
+
+Config::Value::Value(const std::string &str) : m_str(str) {
+  m_isBool = (str == "True") || (str == "False");
+  m_bool = (str == "True");
+
+  const char *begin = str.c_str();
+  const char *end = begin + str.size();
+  char *parsed;
+  if (!str.empty() && str[0] != '-') {
+    const unsigned long u = std::strtoul(begin, &parsed, 10);
+    m_isUint = (parsed == end) && (u <= UINT_MAX);
+    m_uint = static_cast<unsigned int>(u);
+  }
+  if (!str.empty()) {
+    m_double = std::strtod(begin, &parsed);
+    m_isDouble = (parsed == end);
+  }
+}
+
+bool Config::Value::is(const Type t) const {
+  switch (t) {
+    case Type::BOOL:
+      return m_isBool;
+    case Type::UINT:
+      return m_isUint;
+    case Type::DOUBLE:
+      return m_isDouble;
+    default:
+      return true;
+  }
+}
+
+unsigned int Config::Value::asUint() const {
+  if (!m_isUint) {
+    throw std::invalid_argument(m_str + " is not an unsigned integer.");
+  }
+  return m_uint;
+}
+
+double Config::Value::asDouble() const {
+  if (!m_isDouble) {
+    throw std::invalid_argument(m_str + " is not a number.");
+  }
+  return m_double;
+}
+
+bool Config::Value::asBool() const {
+  if (!m_isBool) {
+    throw std::invalid_argument(m_str + " is not a boolean value.");
+  }
+  return m_bool;
+}
+
 void Config::parseCli(int argc, char *argv[]) {
   if (argc == 1) {
     return;
@@ -21,32 +172,57 @@ void Config::parseCli(int argc, char *argv[]) {
 
   for (int i = 1; i < argc; i++) {
     if (std::string(argv[i]) == "-h" || std::string(argv[i]) == "--help") {
-      std::cout << "\nusage: fused [-B board] [-O odir] [-x program] [-C config] \n\n";
+      std::cout << "\nusage: fused [-B board] [-O odir] [-x program] [-C config] [-S sweep] [-j jobs] [-P key=value]...\n\n";
       std::cout << "-B, --board \t : which board to run\n";
       std::cout << "-O, --odir \t : path to output directory\n";
       std::cout << "-x, --program \t : path to program hex file\n";
       std::cout << "-C, --config \t : path to config file\n";
+      std::cout << "-S, --sweep \t : path to parameter sweep file\n";
+      std::cout << "-j, --jobs \t : number of parallel sweep workers\n";
+      std::cout << "-P, --param \t : override config key, e.g. -P SVSVon=3.2\n";
       exit(0);
     } else if (std::string(argv[i]) == "-C" || std::string(argv[i]) == "--config") {
-      m_config["ConfigFile"] = std::string(argv[i + 1]);
+      set("ConfigFile", argv[i + 1]);
       spdlog::info("Loading config from file: {:s}", argv[i + 1]);
       i++;
     } else if (std::string(argv[i]) == "-O" ||
                std::string(argv[i]) == "--odir") {
-      m_config["OutputDirectory"] = argv[i + 1];
-      spdlog::info("Writing output to file: {:s}: ",
-                   m_config["OutputDirectory"]);
+      set("OutputDirectory", argv[i + 1]);
+      spdlog::info("Writing output to file: {:s}: ", argv[i + 1]);
       i++;
     } else if ((std::string(argv[i]) == "-x") ||
                (std::string(argv[i]) == "--program")) {
-      m_config["GdbServer"] = "False";
-      m_config["ProgramHexFile"] = std::string(argv[i + 1]);
+      set("GdbServer", "False");
+      set("ProgramHexFile", argv[i + 1]);
       spdlog::info("Loading and immediately running program from: {:s}",
-                   m_config["ProgramHexFile"]);
+                   argv[i + 1]);
       i++;
     } else if ((std::string(argv[i]) == "-B") ||
                (std::string(argv[i]) == "--board")) {
-      m_config["Board"] = std::string(argv[i + 1]);
+      set("Board", argv[i + 1]);
+      i++;
+    } else if ((std::string(argv[i]) == "-S") ||
+               (std::string(argv[i]) == "--sweep")) {
+      set("SweepFile", argv[i + 1]);
+      i++;
+    } else if ((std::string(argv[i]) == "-j") ||
+               (std::string(argv[i]) == "--jobs")) {
+      set("SweepJobs", argv[i + 1]);
+      i++;
+    } else if ((std::string(argv[i]) == "-P") ||
+               (std::string(argv[i]) == "--param")) {
+      const std::string param = argv[i + 1];
+      const auto eq = param.find('=');
+      if (eq == std::string::npos || eq == 0) {
+        spdlog::error("-P: expected key=value, got \"{}\" exiting...", param);
+        exit(1);
+      }
+      try {
+        set(param.substr(0, eq), param.substr(eq + 1));
+      } catch (const std::invalid_argument &e) {
+        spdlog::error("-P: {} exiting...", e.what());
+        exit(1);
+      }
       i++;
     } else {
       // Unrecognized option
@@ -58,24 +234,32 @@ void Config::parseCli(int argc, char *argv[]) {
 }
 
 void Config::parseFile(const std::string &fn) {
-  if (fn == "") {
-    if (m_config.find("ConfigFile") != m_config.end()) {
-      m_configFileName = m_config["ConfigFile"];
-    } else {
-      m_configFileName = "config.yaml";  // Debug convenience
-    }
+  if (fn != "") {
+    m_configFileName = fn;
+  } else if (contains("ConfigFile")) {
+    m_configFileName = getString("ConfigFile");
+  } else {
+    m_configFileName = "config.yaml";  // Debug convenience
   }
   Utility::assertFileExists(m_configFileName);
   auto ymlconfig =
       YAML::LoadFile(m_configFileName).as<std::map<std::string, std::string>>();
-  m_config.insert(ymlconfig.begin(),
-                  ymlconfig.end());  // Note: CLI arguments override yaml-config
+  bool valid = true;
+  for (const auto &kv : ymlconfig) {
+    // Note: CLI arguments override yaml-config
+    const auto it = m_config.emplace(kv.first, Value(kv.second)).first;
+    valid &= validate(it->first, it->second);
+  }
+  if (!valid) {
+    spdlog::error("Invalid config file {:s} exiting...", m_configFileName);
+    exit(1);
+  }
 }
 
 const std::string &Config::getString(const std::string &key) const {
   auto it = m_config.find(key);
   if (it != m_config.end()) {
-    return it->second;
+    return it->second.asString();
   } else {
     throw std::invalid_argument(key + ": not found in config file " +
                                 m_configFileName);
@@ -83,24 +267,96 @@ const std::string &Config::getString(const std::string &key) const {
 }
 
 unsigned int Config::getUint(const std::string &key) const {
-  return static_cast<unsigned int>(std::stoi(getString(key)));
+  const auto *v = find(key);
+  if (v == nullptr) {
+    getString(key);  // Throws
+  }
+  if (!v->is(Type::UINT)) {
+    throw std::invalid_argument(key + " is not an unsigned integer.");
+  }
+  return v->asUint();
 }
 
 double Config::getDouble(const std::string &key) const {
-  return std::stod(getString(key));
+  const auto *v = find(key);
+  if (v == nullptr) {
+    getString(key);  // Throws
+  }
+  if (!v->is(Type::DOUBLE)) {
+    throw std::invalid_argument(key + " is not a number.");
+  }
+  return v->asDouble();
+}
+
+double Config::getDouble(const std::string &key,
+                         const double defaultValue) const {
+  const auto *v = find(key);
+  return (v == nullptr) ? defaultValue : v->asDouble();
 }
 
 bool Config::getBool(const std::string &key) const {
-  const auto &val = getString(key);
-  if (val == "True") {
-    return true;
-  } else if (val == "False") {
-    return false;
-  } else {
+  const auto *v = find(key);
+  if (v == nullptr) {
+    getString(key);  // Throws
+  }
+  if (!v->is(Type::BOOL)) {
     throw std::invalid_argument(key + " is not a boolean value.");
   }
+  return v->asBool();
 }
 
 bool Config::contains(const std::string &key) const {
   return m_config.find(key) != m_config.end();
 }
+
+const Config::Value *Config::find(const std::string &key) const {
+  auto it = m_config.find(key);
+  return (it != m_config.end()) ? &it->second : nullptr;
+}
+
+void Config::set(const std::string &key, const std::string &value) {
+  Value v(value);
+  if (!validate(key, v)) {
+    throw std::invalid_argument(key + ": invalid value \"" + value + "\"");
+  }
+  auto it = m_config.find(key);
+  if (it != m_config.end()) {
+    it->second = std::move(v);  // Keep handles valid
+  } else {
+    m_config.emplace(key, std::move(v));
+  }
+}
+
+bool Config::validate(const std::string &key, const Value &value) {
+  // Module keys, e.g. "Board.mcu.cache.CacheNSets", or power model
+  // events/states "<module name> <event/state name>"
+  if (key.find(' ') != std::string::npos) {
+    if (!value.is(Type::DOUBLE)) {
+      spdlog::error("Config: {} must be a number, got \"{}\"", key,
+                    value.asString());
+      return false;
+    }
+    return true;
+  }
+  Type type = Type::STRING;
+  const auto it = SCHEMA.find(key);
+  if (it != SCHEMA.end()) {
+    type = it->second;
+  } else if (key.find('.') != std::string::npos) {
+    for (const auto &m : MODULE_SCHEMA) {
+      if (key.size() > m.first.size() &&
+          key.compare(key.size() - m.first.size(), m.first.size(), m.first) ==
+              0) {
+        type = m.second;
+      }
+    }
+  } else {
+    spdlog::warn("Config: unknown key \"{}\"", key);
+  }
+  if (!value.is(type) && value.asString() != "none") {
+    spdlog::error("Config: {} must be {}, got \"{}\"", key, typeName(type),
+                  value.asString());
+    return false;
+  }
+  return true;
+}
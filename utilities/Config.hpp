@@ -9,14 +9,48 @@
 
 #include <fstream>
 #include <iostream>
-#include <map>
 #include <string>
+#include <unordered_map>
 
 /**
  * @brief The Config class Singleton class to store CLI and yaml configs
+ *
+ * Values are parsed into all types they can represent when they are set, so
+ * lookups don't parse strings. Known keys are type-checked against a schema
+ * after the config file is read, and unknown keys produce a warning.
  */
 class Config {
  public:
+  //! Value types of the config schema
+  enum class Type { STRING, BOOL, UINT, DOUBLE };
+
+  /**
+   * @brief The Value class A configuration value, parsed once.
+   */
+  class Value {
+   public:
+    explicit Value(const std::string &str);
+
+    /**
+     * @brief is check if the value can be read as type t.
+     */
+    bool is(const Type t) const;
+
+    const std::string &asString() const { return m_str; }
+    unsigned int asUint() const;  //! Throws if the value is not an integer
+    double asDouble() const;      //! Throws if the value is not a number
+    bool asBool() const;          //! Throws if the value is not True/False
+
+   private:
+    std::string m_str;
+    unsigned int m_uint{0};
+    double m_double{0.0};
+    bool m_bool{false};
+    bool m_isUint{false};
+    bool m_isDouble{false};
+    bool m_isBool{false};
+  };
+
   static Config &get() {
     static Config instance;
     return instance;
@@ -30,6 +64,7 @@ class Config {
 
   /**
    * @brief parseCli Parse command line arguments, these override yaml-configs.
+   * Any config key can be overridden with "-P key=value".
    * @param argc
    * @param argv
    */
@@ -56,6 +91,15 @@ class Config {
    */
   double getDouble(const std::string &key) const;
 
+  /**
+   * @brief getDouble get a floating point value from the configuration, or a
+   * default value if the key is not found.
+   * @param key configuration key (yaml key).
+   * @param defaultValue value returned if the key is not found.
+   * @retval configuration double.
+   */
+  double getDouble(const std::string &key, const double defaultValue) const;
+
   /**
    * @brief getBool get a boolean value from the configuration.
    * @param key configuration key (yaml key).
@@ -71,13 +115,35 @@ class Config {
    */
   bool contains(const std::string &key) const;
 
+  /**
+   * @brief find get a handle to a configuration value. The handle stays valid
+   * for the lifetime of the configuration, and reflects later set() calls.
+   * @param key configuration key (yaml key).
+   * @retval pointer to the value, or nullptr if the key is not found.
+   */
+  const Value *find(const std::string &key) const;
+
+  /**
+   * @brief set set/override a configuration value.
+   * @param key configuration key (yaml key).
+   * @param value configuration value, as it would appear in the yaml file.
+   */
+  void set(const std::string &key, const std::string &value);
+
  private:
   /* ------ Private variables ------ */
-  std::map<std::string, std::string> m_config{};  //! Configuration
-  std::string m_configFileName;                   //! Path to Yaml-file
+  std::unordered_map<std::string, Value> m_config{};  //! Configuration
+  std::string m_configFileName;                       //! Path to Yaml-file
 
   /* ------ Private methods ------ */
 
+  /**
+   * @brief validate check a value against the schema. Warns about unknown
+   * keys.
+   * @retval true if the value has the type required by the schema.
+   */
+  static bool validate(const std::string &key, const Value &value);
+
   // Private constructor
   Config() {}
 
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <elf.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "utilities/ElfSymbols.hpp"
+
+ElfSymbols::ElfSymbols(const std::string &fileName) {
+  std::ifstream f(fileName, std::ios::binary);
+  if (!f.good()) {
+    throw std::runtime_error("Can't open ELF file at " + fileName);
+  }
+  const std::vector<char> elf((std::istreambuf_iterator<char>(f)),
+                              std::istreambuf_iterator<char>());
+
+  // Bounds-checked view of a struct at offset off
+  const auto at = [&](const size_t off, const size_t size) -> const char * {
+    if (off + size > elf.size() || off + size < off) {
+      throw std::runtime_error(fileName + ": truncated ELF file");
+    }
+    return &elf[off];
+  };
+
+  Elf32_Ehdr ehdr;
+  std::memcpy(&ehdr, at(0, sizeof(ehdr)), sizeof(ehdr));
+  if (std::memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 ||
+      ehdr.e_ident[EI_CLASS] != ELFCLASS32 ||
+      ehdr.e_ident[EI_DATA] != ELFDATA2LSB) {
+    throw std::runtime_error(fileName +
+                             " is not a 32-bit little-endian ELF file");
+  }
+
+  std::vector<Elf32_Shdr> sections(ehdr.e_shnum);
+  for (size_t i = 0; i < sections.size(); ++i) {
+    std::memcpy(&sections[i],
+                at(ehdr.e_shoff + i * ehdr.e_shentsize, sizeof(Elf32_Shdr)),
+                sizeof(Elf32_Shdr));
+  }
+
+  for (const auto &symtab : sections) {
+    if (symtab.sh_type != SHT_SYMTAB || symtab.sh_link >= sections.size()) {
+      continue;
+    }
+    const auto &strtab = sections[symtab.sh_link];
+    const size_t n = symtab.sh_size / sizeof(Elf32_Sym);
+    for (size_t i = 0; i < n; ++i) {
+      Elf32_Sym sym;
+      std::memcpy(&sym, at(symtab.sh_offset + i * sizeof(sym), sizeof(sym)),
+                  sizeof(sym));
+      if (ELF32_ST_TYPE(sym.st_info) != STT_FUNC || sym.st_size == 0 ||
+          sym.st_name >= strtab.sh_size) {
+        continue;
+      }
+      const char *name = at(strtab.sh_offset + sym.st_name, 1);
+      const size_t maxLen = strtab.sh_size - sym.st_name;
+      const uint32_t start = sym.st_value & ~1u;  // Drop thumb bit
+      m_functions.push_back(
+          {std::string(name, strnlen(name, maxLen)), start,
+           start + sym.st_size});
+    }
+  }
+
+  // Sort, and drop aliases & overlapping symbols
+  std::stable_sort(m_functions.begin(), m_functions.end(),
+                   [](const Function &a, const Function &b) {
+                     return a.start < b.start;
+                   });
+  std::vector<Function> functions;
+  for (const auto &fn : m_functions) {
+    if (functions.empty() || fn.start >= functions.back().end) {
+      functions.push_back(fn);
+    }
+  }
+  m_functions = std::move(functions);
+}
+
+int ElfSymbols::find(const uint32_t addr) const {
+  const auto it = std::upper_bound(
+      m_functions.begin(), m_functions.end(), addr,
+      [](const uint32_t a, const Function &fn) { return a < fn.start; });
+  if (it == m_functions.begin() || addr >= std::prev(it)->end) {
+    return -1;
+  }
+  return std::prev(it) - m_functions.begin();
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief ElfSymbols Function symbols of a 32-bit little-endian ELF file, e.g.
+ * the .elf built next to a target program's .hex.
+ */
+class ElfSymbols {
+ public:
+  struct Function {
+    std::string name;
+    uint32_t start;  //! First address (w/o thumb bit)
+    uint32_t end;    //! One past the last address
+  };
+
+  /**
+   * @brief ElfSymbols constructor. Reads the function symbols (STT_FUNC) of
+   * the symbol table. Throws if the file can't be read.
+   * @param fileName path to the ELF file
+   */
+  explicit ElfSymbols(const std::string &fileName);
+
+  /**
+   * @brief functions function symbols, sorted by start address and without
+   * overlaps. Aliases at the same address are only listed once.
+   */
+  const std::vector<Function> &functions() const { return m_functions; }
+
+  /**
+   * @brief find index of the function containing addr.
+   * @retval index into functions(), or -1 if addr is not in any function.
+   */
+  int find(const uint32_t addr) const;
+
+ private:
+  std::vector<Function> m_functions;
+};
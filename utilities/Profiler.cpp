@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "libs/make_unique.hpp"
+#include "utilities/Config.hpp"
+#include "utilities/ElfSymbols.hpp"
+#include "utilities/Profiler.hpp"
+
+const int Profiler::ROOT;
+const int Profiler::UNKNOWN;
+const int Profiler::NO_FUNCTION;
+
+namespace {
+//! Largest number of per-PC slots, to catch symbol tables spanning the whole
+//! address space (e.g. functions in both flash and RAM)
+const size_t MAX_SLOTS = 1u << 24;
+}  // namespace
+
+Profiler::Profiler(const ElfSymbols &symbols)
+    : m_functions(symbols.functions()),
+      m_nodes{{ROOT, NO_FUNCTION, {}}},
+      m_nodeCounters(1) {
+  // One slot per halfword of the functions' address range, plus one for PCs
+  // outside of it
+  size_t nSlots = 0;
+  if (!m_functions.empty()) {
+    m_base = m_functions.front().start;
+    nSlots = ((m_functions.back().end - m_base) + 1) >> 1;
+  }
+  if (nSlots > MAX_SLOTS) {
+    throw std::runtime_error(
+        fmt::format("Profiler: functions span too large an address range "
+                    "(0x{:08x}-0x{:08x})",
+                    m_base, m_functions.back().end));
+  }
+  m_pcCounters.resize(nSlots + 1);
+  m_pcFunction.assign(nSlots + 1, UNKNOWN);
+  for (size_t fn = 0; fn < m_functions.size(); ++fn) {
+    const auto &f = m_functions[fn];
+    std::fill(m_pcFunction.begin() + ((f.start - m_base) >> 1),
+              m_pcFunction.begin() + ((f.end - m_base + 1) >> 1), fn);
+  }
+}
+
+Profiler *Profiler::get() {
+  static const std::unique_ptr<Profiler> instance = []() {
+    auto &config = Config::get();
+    if (!(config.contains("Profile") && config.getBool("Profile"))) {
+      return std::unique_ptr<Profiler>();
+    }
+    // Default to the .elf built next to the program's .hex
+    std::string elfFile = config.contains("ProfileElfFile")
+                              ? config.getString("ProfileElfFile")
+                              : "none";
+    if (elfFile == "none") {
+      elfFile = config.getString("ProgramHexFile");
+      elfFile = elfFile.substr(0, elfFile.rfind('.')) + ".elf";
+    }
+    const ElfSymbols symbols(elfFile);
+    spdlog::info("Profiling {} functions of {}", symbols.functions().size(),
+                 elfFile);
+    return std::make_unique<Profiler>(symbols);
+  }();
+  return instance.get();
+}
+
+void Profiler::updateStack(const uint32_t pc, const int function) {
+  // Call
+  if ((function != UNKNOWN) && (pc == m_functions[function].start)) {
+    m_node = child(m_node, function);
+    return;
+  }
+
+  // Return
+  for (int n = m_nodes[m_node].parent; n != ROOT; n = m_nodes[n].parent) {
+    if (m_nodes[n].function == function) {
+      m_node = n;
+      return;
+    }
+  }
+
+  // Jump (tail call, or unknown code)
+  m_node = child((m_node == ROOT) ? ROOT : m_nodes[m_node].parent, function);
+}
+
+int Profiler::child(const int node, const int function) {
+  for (const auto &c : m_nodes[node].children) {
+    if (c.first == function) {
+      return c.second;
+    }
+  }
+  const int id = m_nodes.size();
+  m_nodes.push_back({node, function, {}});
+  m_nodes[node].children.emplace_back(function, id);
+  m_nodeCounters.emplace_back();
+  return id;
+}
+
+Profiler::Counters Profiler::functionCounters(const int fn) const {
+  Counters sum;
+  const auto &f = m_functions.at(fn);
+  for (uint32_t pc = f.start; pc < f.end; pc += 2) {
+    const auto &c = pcCounters(pc);
+    sum.instructions += c.instructions;
+    sum.cycles += c.cycles;
+    sum.sleepPs += c.sleepPs;
+    sum.energy += c.energy;
+  }
+  return sum;
+}
+
+std::string Profiler::foldedStacks(
+    uint64_t (*value)(const Counters &c)) const {
+  std::string result;
+  std::function<void(const int, const std::string &)> visit =
+      [&](const int node, const std::string &stack) {
+        const auto v = value(m_nodeCounters[node]);
+        if (v > 0) {
+          result += fmt::format("{} {}\n", stack, v);
+        }
+        for (const auto &c : m_nodes[node].children) {
+          const auto &name = (c.first == UNKNOWN)
+                                 ? std::string("[unknown]")
+                                 : m_functions[c.first].name;
+          visit(c.second, (node == ROOT) ? name : stack + ';' + name);
+        }
+      };
+  visit(ROOT, "[off]");
+  return result;
+}
+
+void Profiler::write(const std::string &outputDirectory) {
+  closeInterval(m_lastPs);  // Attribute pending energy
+
+  std::ofstream csv(outputDirectory + "/profile.csv");
+  csv << "function,address,instructions,cycles,sleep(s),energy(J)\n";
+  for (size_t fn = 0; fn < m_functions.size(); ++fn) {
+    const auto c = functionCounters(fn);
+    if (c.instructions > 0) {
+      csv << fmt::format("{},0x{:08x},{},{},{:.9g},{:.9g}\n",
+                         m_functions[fn].name, m_functions[fn].start,
+                         c.instructions, c.cycles, c.sleepPs * 1.0e-12,
+                         c.energy);
+    }
+  }
+
+  std::ofstream(outputDirectory + "/profile_cycles.folded")
+      << foldedStacks([](const Counters &c) { return c.cycles; });
+  std::ofstream(outputDirectory + "/profile_energy.folded")
+      << foldedStacks([](const Counters &c) {
+           return static_cast<uint64_t>(c.energy * 1.0e12 + 0.5);  // pJ
+         });
+  std::ofstream(outputDirectory + "/profile_sleep.folded")
+      << foldedStacks([](const Counters &c) { return c.sleepPs / 1000; });
+  spdlog::info("Profile written to {}/profile*", outputDirectory);
+}
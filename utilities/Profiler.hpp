@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "utilities/ElfSymbols.hpp"
+
+/**
+ * @brief Profiler Attributes cycles, retired instructions, sleep time and
+ * dynamic energy to the functions of the target program.
+ *
+ * The CPU reports every retired instruction. Everything that happens until
+ * the next instruction (cycles, or sleep time after sleep(), and the energy of
+ * power model events) is attributed to the PC of the previous instruction, in
+ * flat per-PC counters, and to the current node of a call tree.
+ *
+ * The call tree is reconstructed from control flow: entering a function at
+ * its first address is a call (this includes interrupt handlers), arriving in
+ * a function further up the stack is a return, and any other jump into
+ * another function replaces the top of the stack (e.g. a tail call).
+ */
+class Profiler {
+ public:
+  //! Counters of a PC or a call tree node
+  struct Counters {
+    uint64_t instructions{0};
+    uint64_t cycles{0};
+    uint64_t sleepPs{0};  //! Time spent sleeping
+    double energy{0.0};   //! Dynamic energy (J)
+  };
+
+  /**
+   * @brief Profiler constructor.
+   * @param symbols function symbols of the target program
+   */
+  explicit Profiler(const ElfSymbols &symbols);
+
+  /**
+   * @brief get the profiler configured by the Profile* config keys, or
+   * nullptr if profiling is disabled.
+   */
+  static Profiler *get();
+
+  /**
+   * @brief instruction report a retired instruction.
+   * @param pc address of the instruction
+   * @param timePs current time (ps)
+   * @param periodPs current clock period (ps)
+   */
+  void instruction(const uint32_t pc, const uint64_t timePs,
+                   const uint64_t periodPs) {
+    closeInterval(timePs);
+    const auto slot = pcSlot(pc);
+    if (m_pcFunction[slot] != m_nodes[m_node].function) {
+      updateStack(pc, m_pcFunction[slot]);
+    }
+    m_slot = slot;
+    m_periodPs = periodPs;
+    m_sleeping = false;
+    m_pcCounters[slot].instructions++;
+    m_nodeCounters[m_node].instructions++;
+  }
+
+  /**
+   * @brief sleep report that the CPU went to sleep after the last
+   * instruction. Time until the next instruction is counted as sleep time.
+   */
+  void sleep(const uint64_t timePs) {
+    closeInterval(timePs);
+    m_sleeping = true;
+  }
+
+  /**
+   * @brief powerOff report a power failure. Time until the next instruction
+   * is not counted, and the call stack starts from scratch on power-up.
+   */
+  void powerOff(const uint64_t timePs) {
+    closeInterval(timePs);
+    m_off = true;
+    m_node = ROOT;
+  }
+
+  /**
+   * @brief energyAccumulator dynamic energy (J) reported to this accumulator
+   * is attributed to the current instruction.
+   */
+  double *energyAccumulator() { return &m_energy; }
+
+  /**
+   * @brief pcCounters counters of the instruction at pc.
+   */
+  const Counters &pcCounters(const uint32_t pc) const {
+    return m_pcCounters[pcSlot(pc)];
+  }
+
+  /**
+   * @brief functionCounters sum of the counters of the instructions of
+   * function fn (index into ElfSymbols::functions()), excluding callees.
+   */
+  Counters functionCounters(const int fn) const;
+
+  /**
+   * @brief foldedStacks call stacks and their (self) counter values, in the
+   * "folded" format of flamegraph.pl, i.e. one "main;foo;bar value" line per
+   * stack.
+   * @param value counter value to report
+   */
+  std::string foldedStacks(uint64_t (*value)(const Counters &c)) const;
+
+  /**
+   * @brief write write profile.csv (per function) and the folded stacks of
+   * cycles, energy (pJ) and sleep time (ns) to outputDirectory.
+   */
+  void write(const std::string &outputDirectory);
+
+ private:
+  static const int ROOT = 0;          //! Call tree root node
+  static const int UNKNOWN = -1;      //! Function of PCs outside of functions
+  static const int NO_FUNCTION = -2;  //! Function of the root node
+
+  struct Node {
+    int parent;
+    int function;
+    std::vector<std::pair<int, int>> children;  //! (function, node)
+  };
+
+  std::vector<ElfSymbols::Function> m_functions;
+  uint32_t m_base{0};                  //! Address of per-PC slot 0
+  std::vector<Counters> m_pcCounters;  //! Indexed by pcSlot(pc)
+  std::vector<int> m_pcFunction;       //! Function of each slot
+  std::vector<Node> m_nodes;           //! Call tree
+  std::vector<Counters> m_nodeCounters;
+
+  size_t m_slot{0};       //! Slot of the last instruction
+  int m_node{ROOT};       //! Current call tree node
+  uint64_t m_lastPs{0};   //! Time of the last instruction/sleep
+  uint64_t m_periodPs{1};  //! Clock period at the last instruction
+  bool m_sleeping{false};
+  bool m_off{true};       //! No instruction since power-on
+  double m_energy{0.0};   //! Energy since the last interval was closed
+
+  /**
+   * @brief pcSlot per-PC counter slot of pc. PCs outside of all functions
+   * share the last slot.
+   */
+  size_t pcSlot(const uint32_t pc) const {
+    const size_t slot = (pc - m_base) >> 1;
+    return (pc < m_base || slot >= m_pcCounters.size() - 1)
+               ? m_pcCounters.size() - 1
+               : slot;
+  }
+
+  /**
+   * @brief closeInterval attribute time and energy since the last
+   * instruction/sleep to the last instruction.
+   */
+  void closeInterval(const uint64_t timePs) {
+    if (!m_off) {
+      const uint64_t dt = timePs - m_lastPs;
+      auto &pcc = m_pcCounters[m_slot];
+      auto &nc = m_nodeCounters[m_node];
+      if (m_sleeping) {
+        pcc.sleepPs += dt;
+        nc.sleepPs += dt;
+      } else {
+        const uint64_t cycles = (dt + m_periodPs / 2) / m_periodPs;
+        pcc.cycles += cycles;
+        nc.cycles += cycles;
+      }
+      pcc.energy += m_energy;
+      nc.energy += m_energy;
+    } else {
+      m_nodeCounters[ROOT].energy += m_energy;
+      m_off = false;
+    }
+    m_energy = 0.0;
+    m_lastPs = timePs;
+  }
+
+  /**
+   * @brief updateStack update the current call tree node when the PC moves
+   * to another function.
+   */
+  void updateStack(const uint32_t pc, const int function);
+
+  /**
+   * @brief child get/create the child of node for function.
+   */
+  int child(const int node, const int function);
+};
@@ -75,6 +75,12 @@ class SimulationController : public SimulationControlInterface {
     return Utility::ttohl(targetVal);
   }
 
+  // Snapshots, see Microcontroller::takeSnapshot. Not part of
+  // SimulationControlInterface, exposed for debug server front-ends.
+  size_t takeSnapshot() { return m_mcu->takeSnapshot(); }
+  void rewind(const size_t n) { m_mcu->rewind(n); }
+  size_t nSnapshots() { return m_mcu->nSnapshots(); }
+
   // Control debugger
   virtual void stopServer() override { m_stopServer = true; }
 
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "utilities/SweepRunner.hpp"
+#include "utilities/Utilities.hpp"
+
+namespace {
+struct WorkerResult {
+  std::string status{"not run"};
+  SweepRunner::KeyValues metrics;
+};
+
+struct Worker {
+  size_t point;        //! Index of the point being simulated
+  int fd;              //! Read end of the worker's pipe
+  std::string output;  //! Serialised metrics received so far
+};
+
+//! Serialise metrics as one "name\tvalue" line per metric
+std::string serialise(const SweepRunner::KeyValues &kvs) {
+  std::string s;
+  for (const auto &kv : kvs) {
+    s += kv.first + '\t' + kv.second + '\n';
+  }
+  return s;
+}
+
+SweepRunner::KeyValues deserialise(const std::string &s) {
+  SweepRunner::KeyValues kvs;
+  size_t start = 0;
+  while (start < s.size()) {
+    const size_t tab = s.find('\t', start);
+    const size_t nl = s.find('\n', start);
+    if (tab == std::string::npos || nl == std::string::npos || tab > nl) {
+      break;
+    }
+    kvs.emplace_back(s.substr(start, tab - start),
+                     s.substr(tab + 1, nl - tab - 1));
+    start = nl + 1;
+  }
+  return kvs;
+}
+
+//! Append available data from fd to s. Returns false at end of file.
+bool readSome(const int fd, std::string &s) {
+  char buf[4096];
+  const ssize_t n = read(fd, buf, sizeof(buf));
+  if (n > 0) {
+    s.append(buf, n);
+    return true;
+  }
+  return (n < 0) && (errno == EINTR);
+}
+}  // namespace
+
+SweepRunner::SweepRunner(const std::string &sweepFile) {
+  Utility::assertFileExists(sweepFile);
+  const auto yml = YAML::LoadFile(sweepFile);
+  for (const auto &kv : yml) {
+    std::vector<std::string> values;
+    if (kv.second.IsSequence()) {
+      values = kv.second.as<std::vector<std::string>>();
+    } else {
+      values.push_back(kv.second.as<std::string>());
+    }
+    if (values.empty()) {
+      throw std::invalid_argument(kv.first.as<std::string>() +
+                                  ": no values in sweep file " + sweepFile);
+    }
+    m_grid.emplace_back(kv.first.as<std::string>(), values);
+  }
+}
+
+size_t SweepRunner::nPoints() const {
+  size_t n = 1;
+  for (const auto &p : m_grid) {
+    n *= p.second.size();
+  }
+  return n;
+}
+
+SweepRunner::KeyValues SweepRunner::point(const size_t idx) const {
+  KeyValues kvs(m_grid.size());
+  size_t rem = idx;
+  for (size_t i = m_grid.size(); i-- > 0;) {
+    const auto &values = m_grid[i].second;
+    kvs[i] = {m_grid[i].first, values[rem % values.size()]};
+    rem /= values.size();
+  }
+  return kvs;
+}
+
+bool SweepRunner::run(const unsigned nJobs,
+                      const std::function<KeyValues(const size_t)> &runPoint,
+                      const std::string &resultsFile) const {
+  const size_t n = nPoints();
+  std::vector<WorkerResult> results(n);
+  std::map<pid_t, Worker> workers;
+  size_t next = 0;
+  bool success = true;
+
+  spdlog::info("Sweep: {} points, {} workers", n, nJobs);
+  while (next < n || !workers.empty()) {
+    // Start workers
+    while (next < n && workers.size() < std::max(nJobs, 1u)) {
+      int fds[2];
+      if (pipe(fds) != 0) {
+        throw std::runtime_error("Sweep: failed to create pipe");
+      }
+      std::fflush(nullptr);  // Don't duplicate buffered output
+      const pid_t pid = fork();
+      if (pid < 0) {
+        throw std::runtime_error("Sweep: failed to fork worker");
+      } else if (pid == 0) {
+        // Worker
+        close(fds[0]);
+        int status = 0;
+        try {
+          const auto s = serialise(runPoint(next));
+          if (write(fds[1], s.data(), s.size()) != (ssize_t)s.size()) {
+            status = 1;
+          }
+        } catch (const std::exception &e) {
+          spdlog::error("Sweep point {}: {}", next, e.what());
+          status = 1;
+        }
+        close(fds[1]);
+        std::exit(status);  // End like a normal run
+      }
+      close(fds[1]);
+      workers[pid] = {next, fds[0], ""};
+      next++;
+    }
+
+    // Drain the workers' pipes. A worker is only collected once its pipe is
+    // closed, so that it never blocks writing to a full pipe while we wait.
+    std::vector<pollfd> pfds;
+    std::vector<pid_t> pids;
+    for (const auto &w : workers) {
+      pfds.push_back({w.second.fd, POLLIN, 0});
+      pids.push_back(w.first);
+    }
+    if (poll(pfds.data(), pfds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Sweep: failed to poll workers");
+    }
+    for (size_t i = 0; i < pfds.size(); ++i) {
+      const auto it = workers.find(pids[i]);
+      auto &w = it->second;
+      if ((pfds[i].revents == 0) || readSome(w.fd, w.output)) {
+        continue;
+      }
+
+      // End of file: collect the finished worker
+      close(w.fd);
+      int wstatus;
+      waitpid(it->first, &wstatus, 0);
+      auto &r = results[w.point];
+      r.metrics = deserialise(w.output);
+      if (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0) {
+        r.status = "ok";
+      } else {
+        r.status = WIFSIGNALED(wstatus)
+                       ? "signal " + std::to_string(WTERMSIG(wstatus))
+                       : "exit " + std::to_string(WEXITSTATUS(wstatus));
+        success = false;
+      }
+      spdlog::info("Sweep point {}/{}: {}", w.point + 1, n, r.status);
+      workers.erase(it);
+    }
+  }
+
+  // Write results, with the metric columns of the first complete run
+  KeyValues metricNames;
+  for (const auto &r : results) {
+    if (!r.metrics.empty()) {
+      metricNames = r.metrics;
+      break;
+    }
+  }
+  std::ofstream out(resultsFile);
+  out << "point";
+  for (const auto &p : m_grid) {
+    out << ',' << p.first;
+  }
+  out << ",status";
+  for (const auto &m : metricNames) {
+    out << ',' << m.first;
+  }
+  out << '\n';
+  for (size_t i = 0; i < n; ++i) {
+    out << i;
+    for (const auto &kv : point(i)) {
+      out << ',' << kv.second;
+    }
+    out << ',' << results[i].status;
+    const auto &metrics = results[i].metrics;
+    for (size_t j = 0; j < metricNames.size(); ++j) {
+      out << ',';
+      if (j < metrics.size()) {
+        out << metrics[j].second;
+      }
+    }
+    out << '\n';
+  }
+  spdlog::info("Sweep results written to {}", resultsFile);
+  return success;
+}
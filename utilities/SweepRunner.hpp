@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief SweepRunner Runs one simulation per point of a parameter grid.
+ *
+ * SystemC can't restart its kernel, so each point is simulated in a worker
+ * process forked from the current process. Anything loaded before calling
+ * run() (config, program, traces) is shared copy-on-write with the workers.
+ *
+ * The grid is read from a yaml file mapping config keys to lists of values,
+ * e.g.
+ *   CapacitorValue: [1.0e-6, 4.7e-6, 10.0e-6]
+ *   SVSVon: [3.0, 3.5]
+ * which defines the 6 points of the cartesian product of the values. The last
+ * key varies fastest.
+ */
+class SweepRunner {
+ public:
+  //! Config key/value pairs of a sweep point, or metric name/value pairs.
+  typedef std::vector<std::pair<std::string, std::string>> KeyValues;
+
+  /**
+   * @brief SweepRunner constructor. Parses the sweep file.
+   * @param sweepFile path to the sweep yaml file.
+   */
+  explicit SweepRunner(const std::string &sweepFile);
+
+  /**
+   * @brief nPoints number of points in the grid.
+   */
+  size_t nPoints() const;
+
+  /**
+   * @brief point config overrides of point idx.
+   */
+  KeyValues point(const size_t idx) const;
+
+  /**
+   * @brief run simulate all points, and write one row per point to a csv
+   * results file, holding the point index, the swept values, the exit status
+   * of the worker, and the metrics returned by runPoint.
+   * @param nJobs maximum number of concurrent worker processes.
+   * @param runPoint called in a fresh worker process for each point index.
+   * Returns summary metrics of the run.
+   * @param resultsFile path to the results file.
+   * @retval true if all workers succeeded.
+   */
+  bool run(const unsigned nJobs,
+           const std::function<KeyValues(const size_t)> &runPoint,
+           const std::string &resultsFile) const;
+
+ private:
+  //! Swept config keys and their values
+  std::vector<std::pair<std::string, std::vector<std::string>>> m_grid;
+};
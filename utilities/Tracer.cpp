@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "libs/make_unique.hpp"
+#include "utilities/Config.hpp"
+#include "utilities/Tracer.hpp"
+
+namespace {
+//! Whether an optional config key is set (i.e. present and not "none")
+bool isSet(const std::string &key) {
+  return Config::get().contains(key) && Config::get().getString(key) != "none";
+}
+}  // namespace
+
+const uint8_t TraceRecord::INSTRUCTION;
+const uint8_t TraceRecord::READ;
+const uint8_t TraceRecord::WRITE;
+const uint8_t TraceRecord::REGISTER;
+const uint16_t TraceRecord::DMI_TARGET;
+const uint16_t TraceRecord::NO_TARGET;
+const uint32_t TraceRecord::VERSION;
+
+Tracer::Tracer(const std::string &fileName, const Options &options)
+    : m_options(options),
+      m_ring(options.capacity),
+      m_mask(options.capacity - 1) {
+  if ((options.capacity == 0) || (options.capacity & m_mask) != 0) {
+    throw std::invalid_argument("Tracer: capacity must be a power of 2");
+  }
+  m_file = std::fopen(fileName.c_str(), "wb");
+  if (m_file == nullptr) {
+    throw std::runtime_error("Can't open trace file at " + fileName);
+  }
+  const uint32_t version = TraceRecord::VERSION;
+  const uint32_t recordSize = sizeof(TraceRecord);
+  std::fwrite(TraceRecord::signature(), 1, 8, m_file);
+  std::fwrite(&version, sizeof(version), 1, m_file);
+  std::fwrite(&recordSize, sizeof(recordSize), 1, m_file);
+  m_thread = std::thread(&Tracer::writerLoop, this);
+}
+
+Tracer::~Tracer() {
+  m_stop.store(true, std::memory_order_release);
+  m_thread.join();
+  std::fclose(m_file);
+}
+
+Tracer *Tracer::get() {
+  static const std::unique_ptr<Tracer> instance = []() {
+    if (!(Config::get().contains("Trace") && Config::get().getBool("Trace"))) {
+      return std::unique_ptr<Tracer>();
+    }
+    Options o;
+    o.startPs = static_cast<uint64_t>(
+        Config::get().getDouble("TraceStartTime") * 1.0e12);
+    if (isSet("TraceStopTime")) {
+      o.stopPs = static_cast<uint64_t>(
+          Config::get().getDouble("TraceStopTime") * 1.0e12);
+    }
+    if (isSet("TracePcLow")) {
+      o.pcLow = std::stoul(Config::get().getString("TracePcLow"), nullptr, 0);
+    }
+    if (isSet("TracePcHigh")) {
+      o.pcHigh =
+          std::stoul(Config::get().getString("TracePcHigh"), nullptr, 0);
+    }
+    o.registers = Config::get().contains("TraceRegisters") &&
+                  Config::get().getBool("TraceRegisters");
+    const auto fileName =
+        Config::get().getString("OutputDirectory") + "/trace.bin";
+    spdlog::info("Tracing to {}", fileName);
+    return std::make_unique<Tracer>(fileName, o);
+  }();
+  return instance.get();
+}
+
+void Tracer::waitForSpace(const size_t head) {
+  while (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+    std::this_thread::yield();
+  }
+}
+
+void Tracer::writerLoop() {
+  while (true) {
+    const bool stop = m_stop.load(std::memory_order_acquire);
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    const size_t head = m_head.load(std::memory_order_acquire);
+    if (head == tail) {
+      if (stop) {
+        return;  // Stopped, and everything written
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      continue;
+    }
+
+    // Write contiguous records up to the end of the ring buffer
+    const size_t start = tail & m_mask;
+    const size_t n = std::min(head - tail, m_ring.size() - start);
+    std::fwrite(&m_ring[start], sizeof(TraceRecord), n, m_file);
+    m_tail.store(tail + n, std::memory_order_release);
+  }
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief TraceRecord Fixed-width record of a binary execution trace.
+ *
+ * File layout (host byte order):
+ *   char[8] "FUSEDTRC", uint32_t version, uint32_t sizeof(TraceRecord),
+ *   followed by TraceRecords until the end of the file.
+ */
+struct TraceRecord {
+  uint64_t timePs;  //! Simulation time (incl. local time offset) in ps
+  uint32_t addr;    //! PC, access address, or register number
+  uint32_t value;   //! Opcode (1st halfword), access data, or register value
+  uint16_t target;  //! Bus port of the access target, or DMI_TARGET
+  uint8_t type;     //! INSTRUCTION, READ, WRITE or REGISTER
+  uint8_t size;     //! Access/opcode size (bytes)
+  uint32_t reserved;
+
+  static const uint8_t INSTRUCTION = 0;  //! Retired instruction at addr
+  static const uint8_t READ = 1;         //! Bus read from addr
+  static const uint8_t WRITE = 2;        //! Bus write to addr
+  static const uint8_t REGISTER = 3;     //! Register addr written by the
+                                         //! preceding instruction
+  //! Target of accesses through DMI, which bypass the bus
+  static const uint16_t DMI_TARGET = 0xffff;
+  //! Target of instructions and register writes
+  static const uint16_t NO_TARGET = 0xfffe;
+
+  static const char *signature() { return "FUSEDTRC"; }
+  static const uint32_t VERSION = 1;
+};
+
+/**
+ * @brief Tracer Records retired instructions, register writes and bus accesses
+ * to a binary trace file.
+ *
+ * Records are pushed into a lock-free single-producer/single-consumer ring
+ * buffer, which is drained to file by a background thread. The simulation only
+ * waits for the writer if it falls behind by more than the ring's capacity.
+ *
+ * Tracing is active within the time window [startTime, stopTime), and only
+ * while the PC of the last retired instruction is in [pcLow, pcHigh]. Bus
+ * accesses are attributed to the last retired instruction.
+ */
+class Tracer {
+ public:
+  struct Options {
+    uint64_t startPs{0};  //! Start of the trace window
+    uint64_t stopPs{std::numeric_limits<uint64_t>::max()};  //! End of window
+    uint32_t pcLow{0};                                       //! PC trigger
+    uint32_t pcHigh{std::numeric_limits<uint32_t>::max()};   //! PC trigger
+    bool registers{false};  //! Record register writes
+    size_t capacity{1u << 16};  //! Ring buffer size (records), power of 2
+  };
+
+  /**
+   * @brief Tracer constructor. Creates/overwrites the trace file, writes the
+   * header and starts the writer thread.
+   */
+  Tracer(const std::string &fileName, const Options &options);
+
+  //! Destructor. Writes all records to file.
+  ~Tracer();
+
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+
+  /**
+   * @brief get the tracer configured by the Trace* config keys, or nullptr if
+   * tracing is disabled. Writes to OutputDirectory/trace.bin.
+   */
+  static Tracer *get();
+
+  //! Whether register writes should be recorded
+  bool tracesRegisters() const { return m_options.registers; }
+
+  /**
+   * @brief instruction record a retired instruction, and update the trigger.
+   * @retval true if the instruction was recorded, i.e. its register writes
+   * should be recorded too.
+   */
+  bool instruction(const uint64_t timePs, const uint32_t pc,
+                   const uint32_t opcode, const uint8_t size) {
+    m_active = (timePs >= m_options.startPs) && (timePs < m_options.stopPs) &&
+               (pc >= m_options.pcLow) && (pc <= m_options.pcHigh);
+    if (m_active) {
+      push({timePs, pc, opcode, TraceRecord::NO_TARGET,
+            TraceRecord::INSTRUCTION, size, 0});
+    }
+    return m_active;
+  }
+
+  /**
+   * @brief registerWrite record a register write of the last instruction.
+   */
+  void registerWrite(const uint64_t timePs, const uint32_t reg,
+                     const uint32_t value) {
+    push({timePs, reg, value, TraceRecord::NO_TARGET, TraceRecord::REGISTER,
+          4, 0});
+  }
+
+  /**
+   * @brief access record a bus access, if the trigger is active.
+   * @param target bus port of the target, or TraceRecord::DMI_TARGET
+   * @param data accessed bytes (target byte order)
+   */
+  void access(const uint64_t timePs, const uint32_t addr, const bool isWrite,
+              const uint16_t target, const uint8_t *const data,
+              const size_t len) {
+    if (m_active && (timePs < m_options.stopPs)) {
+      uint32_t value = 0;
+      for (size_t i = 0; i < len && i < sizeof(value); ++i) {
+        value |= static_cast<uint32_t>(data[i]) << (8 * i);
+      }
+      push({timePs, addr, value, target,
+            isWrite ? TraceRecord::WRITE : TraceRecord::READ,
+            static_cast<uint8_t>(len), 0});
+    }
+  }
+
+ private:
+  std::FILE *m_file{nullptr};
+  const Options m_options;
+  std::vector<TraceRecord> m_ring;
+  const size_t m_mask;  //! m_ring.size() - 1
+  bool m_active{false};  //! Trigger state (producer only)
+
+  std::atomic<size_t> m_head{0};  //! Next record to be pushed (producer)
+  std::atomic<size_t> m_tail{0};  //! Next record to be written (consumer)
+  std::atomic<bool> m_stop{false};
+  std::thread m_thread;
+
+  /**
+   * @brief push append a record to the ring buffer, waiting for the writer if
+   * the buffer is full.
+   */
+  void push(const TraceRecord &r) {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+      waitForSpace(head);
+    }
+    m_ring[head & m_mask] = r;
+    m_head.store(head + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief waitForSpace spin until the writer has freed a slot.
+   */
+  void waitForSpace(const size_t head);
+
+  /**
+   * @brief writerLoop writer thread, drains the ring buffer to file.
+   */
+  void writerLoop();
+};
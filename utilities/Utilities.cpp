@@ -9,6 +9,7 @@
 #include <spdlog/spdlog.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <cstring>
 #include <fstream>
 #include "utilities/Utilities.hpp"
 
@@ -115,6 +116,38 @@ uint32_t Utility::setBit(size_t bitIdx, uint32_t word, bool value) {
   return word | (static_cast<uint32_t>(value) << bitIdx);
 }
 
+// Both kernels work on 64-bit words, which the compiler turns into a single
+// popcount instruction per word when the host has one (e.g. -mpopcnt).
+unsigned Utility::countSetBits(const uint8_t *const data, const size_t len) {
+  unsigned res = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t w;
+    std::memcpy(&w, &data[i], sizeof(w));
+    res += __builtin_popcountll(w);
+  }
+  for (; i < len; i++) {
+    res += __builtin_popcount(data[i]);
+  }
+  return res;
+}
+
+unsigned Utility::countBitFlips(const uint8_t *const a, const uint8_t *const b,
+                                const size_t len) {
+  unsigned res = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t wa, wb;
+    std::memcpy(&wa, &a[i], sizeof(wa));
+    std::memcpy(&wb, &b[i], sizeof(wb));
+    res += __builtin_popcountll(wa ^ wb);
+  }
+  for (; i < len; i++) {
+    res += __builtin_popcount(a[i] ^ b[i]);
+  }
+  return res;
+}
+
 bool Utility::assertFileExists(const std::string &filename) {
   std::ifstream ifile(filename.c_str());
   if (!(bool)ifile) {
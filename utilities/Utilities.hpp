@@ -66,6 +66,23 @@ uint32_t ttohs(uint32_t targetVal);
  */
 uint32_t setBit(size_t bitIdx, uint32_t word, bool value);
 
+/**
+ * @brief countSetBits count the bits that are set in an array of bytes.
+ * @param data pointer to array of bytes
+ * @param len number of bytes
+ */
+unsigned countSetBits(const uint8_t *const data, const size_t len);
+
+/**
+ * @brief countBitFlips count the bits that differ between two arrays of
+ * bytes, i.e. the bits flipped by overwriting a with b.
+ * @param a pointer to first array of bytes
+ * @param b pointer to second array of bytes
+ * @param len number of bytes in each array
+ */
+unsigned countBitFlips(const uint8_t *const a, const uint8_t *const b,
+                       const size_t len);
+
 /**
  * @brief assertFileExists Assert that file exists, exit with error otherwise.
  * @param filename
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * eventlog2csv: convert a binary (dense or sparse) event log (see
+ * ps/EventLogWriter.hpp) to the csv layout written by PowerModelChannel.
+ *
+ * Usage: eventlog2csv <input>_eventlog.{bin,sparse} [output.csv]
+ * If no output file is given, the csv is written to stdout.
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ps/EventLogWriter.hpp"
+
+namespace {
+void printRow(std::FILE *out, const std::vector<int32_t> &row) {
+  for (size_t i = 0; i < row.size(); ++i) {
+    std::fprintf(out, "%d%c", row[i], (i == row.size() - 1) ? '\n' : ',');
+  }
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <eventlog> [eventlog.csv]\n";
+    return 1;
+  }
+
+  std::FILE *in = std::fopen(argv[1], "rb");
+  if (in == nullptr) {
+    std::cerr << "Can't open " << argv[1] << "\n";
+    return 1;
+  }
+  std::FILE *out = (argc == 3) ? std::fopen(argv[2], "w") : stdout;
+  if (out == nullptr) {
+    std::cerr << "Can't open " << argv[2] << "\n";
+    return 1;
+  }
+
+  // Header
+  EventLogHeader hdr;
+  if (std::fread(&hdr, sizeof(hdr), 1, in) != 1 ||
+      std::memcmp(hdr.magic, EventLogHeader::signature(),
+                  sizeof(hdr.magic)) != 0) {
+    std::cerr << argv[1] << " is not a binary event log\n";
+    return 1;
+  }
+  if (hdr.version != EventLogHeader::VERSION) {
+    std::cerr << "Unsupported event log version " << hdr.version << "\n";
+    return 1;
+  }
+
+  // Column names
+  std::vector<char> names(hdr.nameTableSize);
+  if (std::fread(names.data(), 1, names.size(), in) != names.size()) {
+    std::cerr << "Truncated event log header\n";
+    return 1;
+  }
+  for (size_t i = 0; i < names.size(); i += std::strlen(&names[i]) + 1) {
+    std::fprintf(out, "%s,", &names[i]);
+  }
+  std::fprintf(out, "time(us)\n");
+
+  // Rows
+  std::vector<int32_t> row(hdr.nColumns);
+  if (hdr.format == EventLogHeader::DENSE) {
+    while (std::fread(row.data(), sizeof(int32_t), row.size(), in) ==
+           row.size()) {
+      printRow(out, row);
+    }
+  } else {
+    SparseRecord rec;
+    std::vector<SparsePair> pairs;
+    while (std::fread(&rec, sizeof(rec), 1, in) == 1) {
+      pairs.resize(rec.nPairs);
+      if (std::fread(pairs.data(), sizeof(SparsePair), pairs.size(), in) !=
+          pairs.size()) {
+        std::cerr << "Truncated sparse record\n";
+        return 1;
+      }
+      std::fill(row.begin(), row.end(), 0);
+      for (const auto &p : pairs) {
+        row[p.eventId] = p.count;
+      }
+      for (uint64_t k = rec.firstRow; k < rec.firstRow + rec.repeat; ++k) {
+        // Row k ends at (k + 1) * timestep
+        row.back() = static_cast<int32_t>((k + 1) * hdr.timestepPs / 1000000);
+        printRow(out, row);
+      }
+    }
+  }
+
+  std::fclose(in);
+  if (out != stdout) {
+    std::fclose(out);
+  }
+  return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * trace2csv: convert a binary execution trace (see utilities/Tracer.hpp) to
+ * csv, with one row per record.
+ *
+ * Usage: trace2csv <trace.bin> [trace.csv]
+ * If no output file is given, the csv is written to stdout.
+ */
+
+#include <stdint.h>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include "utilities/Tracer.hpp"
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <trace.bin> [trace.csv]\n";
+    return 1;
+  }
+
+  std::FILE *in = std::fopen(argv[1], "rb");
+  if (in == nullptr) {
+    std::cerr << "Can't open " << argv[1] << "\n";
+    return 1;
+  }
+  std::FILE *out = (argc == 3) ? std::fopen(argv[2], "w") : stdout;
+  if (out == nullptr) {
+    std::cerr << "Can't open " << argv[2] << "\n";
+    return 1;
+  }
+
+  // Header
+  char magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+  if (std::fread(magic, 1, sizeof(magic), in) != sizeof(magic) ||
+      std::memcmp(magic, TraceRecord::signature(), sizeof(magic)) != 0 ||
+      std::fread(&version, sizeof(version), 1, in) != 1 ||
+      std::fread(&recordSize, sizeof(recordSize), 1, in) != 1) {
+    std::cerr << argv[1] << " is not a binary trace\n";
+    return 1;
+  }
+  if (version != TraceRecord::VERSION || recordSize != sizeof(TraceRecord)) {
+    std::cerr << "Unsupported trace version " << version << "\n";
+    return 1;
+  }
+
+  // Records
+  static const char *const TYPES[] = {"insn", "read", "write", "reg"};
+  std::fprintf(out, "time(ps),type,addr,value,size,target\n");
+  TraceRecord r;
+  while (std::fread(&r, sizeof(r), 1, in) == 1) {
+    std::fprintf(out, "%" PRIu64 ",%s,0x%08x,0x%08x,%u,", r.timePs,
+                 (r.type < 4) ? TYPES[r.type] : "?", r.addr, r.value, r.size);
+    if (r.target == TraceRecord::DMI_TARGET) {
+      std::fprintf(out, "dmi\n");
+    } else if (r.target == TraceRecord::NO_TARGET) {
+      std::fprintf(out, "\n");
+    } else {
+      std::fprintf(out, "%u\n", r.target);
+    }
+  }
+
+  std::fclose(in);
+  if (out != stdout) {
+    std::fclose(out);
+  }
+  return 0;
+}